@@ -0,0 +1,109 @@
+#include "analyzer/analyzerfingerprint.h"
+
+#include <chromaprint.h>
+
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerFingerprint");
+
+const ConfigKey kEnabledConfigKey("[Library]", "FingerprintAnalyzerEnabled");
+
+// See ChromaPrinter
+#if (CHROMAPRINT_VERSION_MINOR > 3) || (CHROMAPRINT_VERSION_MAJOR > 1)
+typedef uint32_t* uint32_p;
+#else
+typedef void* uint32_p;
+#endif
+
+} // anonymous namespace
+
+AnalyzerFingerprint::AnalyzerFingerprint(const QSqlDatabase& dbConnection)
+        : m_pContext(nullptr),
+          m_remainingSamples(0) {
+    m_fingerprintDao.initialize(dbConnection);
+}
+
+AnalyzerFingerprint::~AnalyzerFingerprint() {
+    cleanup();
+}
+
+// static
+bool AnalyzerFingerprint::isEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig->getValue(kEnabledConfigKey, false);
+}
+
+bool AnalyzerFingerprint::initialize(TrackPointer pTrack,
+        mixxx::audio::SampleRate sampleRate,
+        int totalSamples) {
+    if (totalSamples == 0 || !pTrack->getId().isValid()) {
+        return false;
+    }
+    if (m_fingerprintDao.hasFingerprint(pTrack->getId())) {
+        kLogger.debug() << "Skipping" << pTrack->getLocation();
+        return false;
+    }
+
+    DEBUG_ASSERT(!m_pContext);
+    m_pContext = chromaprint_new(CHROMAPRINT_ALGORITHM_DEFAULT);
+    if (!chromaprint_start(m_pContext,
+                static_cast<int>(sampleRate),
+                mixxx::kAnalysisChannels)) {
+        kLogger.warning() << "Failed to start fingerprinting" << pTrack->getLocation();
+        cleanup();
+        return false;
+    }
+    m_remainingSamples = mixxx::AudioFingerprint::kDurationSeconds *
+            static_cast<int>(sampleRate) * mixxx::kAnalysisChannels;
+    return true;
+}
+
+bool AnalyzerFingerprint::processSamples(const CSAMPLE* pIn, const int iLen) {
+    const int numSamples = math_min(iLen, m_remainingSamples);
+    if (numSamples <= 0) {
+        // The fingerprint is complete, ignore the remaining samples
+        return true;
+    }
+    m_samples.resize(numSamples);
+    SampleUtil::convertFloat32ToS16(m_samples.data(), pIn, numSamples);
+    m_remainingSamples -= numSamples;
+    return chromaprint_feed(m_pContext, m_samples.data(), numSamples) != 0;
+}
+
+void AnalyzerFingerprint::storeResults(TrackPointer pTrack) {
+    if (!chromaprint_finish(m_pContext)) {
+        kLogger.warning() << "Failed to finish fingerprinting" << pTrack->getLocation();
+        return;
+    }
+    uint32_p pItems = nullptr;
+    int numItems = 0;
+    if (!chromaprint_get_raw_fingerprint(m_pContext, &pItems, &numItems)) {
+        kLogger.warning() << "Failed to get fingerprint" << pTrack->getLocation();
+        return;
+    }
+    const uint32_t* pBegin = static_cast<const uint32_t*>(pItems);
+    QVector<uint32_t> items(numItems);
+    std::copy(pBegin, pBegin + numItems, items.begin());
+    chromaprint_dealloc(pItems);
+
+    if (items.isEmpty()) {
+        return;
+    }
+    m_fingerprintDao.saveFingerprint(
+            pTrack->getId(), mixxx::AudioFingerprint(std::move(items)));
+}
+
+void AnalyzerFingerprint::cleanup() {
+    if (m_pContext) {
+        chromaprint_free(m_pContext);
+        m_pContext = nullptr;
+    }
+    m_remainingSamples = 0;
+}
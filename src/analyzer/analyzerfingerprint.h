@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "library/dao/fingerprintdao.h"
+#include "preferences/usersettings.h"
+
+struct ChromaprintContext;
+
+/// Computes a Chromaprint fingerprint of the beginning of a track for
+/// detecting duplicates in the library, see FingerprintDAO.
+///
+/// Unlike the ChromaPrinter of the tag fetcher this analyzer does not
+/// decode the file again but uses the samples of the analysis. It is
+/// disabled by default.
+class AnalyzerFingerprint : public Analyzer {
+  public:
+    explicit AnalyzerFingerprint(const QSqlDatabase& dbConnection);
+    ~AnalyzerFingerprint() override;
+
+    static bool isEnabled(const UserSettingsPointer& pConfig);
+
+    bool initialize(TrackPointer pTrack,
+            mixxx::audio::SampleRate sampleRate,
+            int totalSamples) override;
+    bool processSamples(const CSAMPLE* pIn, const int iLen) override;
+    void storeResults(TrackPointer pTrack) override;
+    void cleanup() override;
+
+  private:
+    FingerprintDAO m_fingerprintDao;
+    ChromaprintContext* m_pContext;
+    std::vector<SAMPLE> m_samples;
+    int m_remainingSamples;
+};
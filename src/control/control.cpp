@@ -1,7 +1,11 @@
 #include "control/control.h"
 
+#include <QSet>
+#include <QVector>
+
 #include "control/controlobject.h"
 #include "moc_control.cpp"
+#include "util/compatibility/qatomic.h"
 #include "util/stat.h"
 
 namespace {
@@ -13,17 +17,49 @@ namespace {
 /// configuration object would be arduous.
 UserSettingsPointer s_pUserConfig;
 
-/// Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-MMutex s_qCOHashMutex;
+/// Lock guarding access to the control registry. Lookups of existing
+/// controls only need to acquire it for reading and don't block each other.
+/// Exclusive access is only needed for creating and deleting controls.
+MReadWriteLock s_qCOHashLock;
+
+/// Interned ConfigKeys, mapped to the index of their control in
+/// s_qCOByHandle. Entries are never removed, so ControlHandles stay valid
+/// for the whole runtime. Aliases map to the index of the aliased control
+/// and are only removed by takeAllInstances().
+QHash<ConfigKey, int> s_qCOHandleHash
+        GUARDED_BY(s_qCOHashLock);
 
-/// Hash of ControlDoublePrivate instantiations.
-QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash
-        GUARDED_BY(s_qCOHashMutex);
+/// ControlDoublePrivate instantiations indexed by ControlHandle.
+QVector<QWeakPointer<ControlDoublePrivate>> s_qCOByHandle
+        GUARDED_BY(s_qCOHashLock);
 
 /// Hash of aliases between ConfigKeys. Solely used for looking up the first
 /// alias associated with a key.
 QHash<ConfigKey, ConfigKey> s_qCOAliasHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOHashLock);
+
+/// Aliases that have been inserted into s_qCOHandleHash with the index of
+/// the aliased control.
+QSet<ConfigKey> s_qCOAliasKeys
+        GUARDED_BY(s_qCOHashLock);
+
+/// Returns the index of the interned key or -1 if the key has not been
+/// interned yet.
+inline int lookupHandle(const ConfigKey& key) REQUIRES_SHARED(s_qCOHashLock) {
+    return s_qCOHandleHash.value(key, -1);
+}
+
+/// Interns the key if needed and returns its index.
+int internHandle(const ConfigKey& key) REQUIRES(s_qCOHashLock) {
+    const auto it = s_qCOHandleHash.constFind(key);
+    if (it != s_qCOHandleHash.constEnd()) {
+        return it.value();
+    }
+    const int handle = s_qCOByHandle.size();
+    s_qCOByHandle.append(QWeakPointer<ControlDoublePrivate>());
+    s_qCOHandleHash.insert(key, handle);
+    return handle;
+}
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
@@ -84,10 +120,15 @@ void ControlDoublePrivate::initialize(double defaultValue) {
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
-    //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
-    s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    s_qCOHashLock.lockForWrite();
+    //qDebug() << "ControlDoublePrivate::s_qCOByHandle.remove(" << m_key.group << "," << m_key.item << ")";
+    const int handle = lookupHandle(m_key);
+    // The key stays interned. Only release the expired reference if it has
+    // not already been replaced by a new instance with the same key.
+    if (handle >= 0 && s_qCOByHandle.at(handle).isNull()) {
+        s_qCOByHandle[handle].clear();
+    }
+    s_qCOHashLock.unlock();
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
@@ -106,22 +147,81 @@ void ControlDoublePrivate::setUserConfig(const UserSettingsPointer& pConfig) {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MWriteLocker locker(&s_qCOHashLock);
 
-    auto it = s_qCOHash.constFind(key);
-    VERIFY_OR_DEBUG_ASSERT(it != s_qCOHash.constEnd()) {
+    const int handle = lookupHandle(key);
+    VERIFY_OR_DEBUG_ASSERT(handle >= 0) {
         qWarning() << "cannot create alias for null control" << key;
         return;
     }
 
-    QSharedPointer<ControlDoublePrivate> pControl = it.value();
+    QSharedPointer<ControlDoublePrivate> pControl = s_qCOByHandle.at(handle);
     VERIFY_OR_DEBUG_ASSERT(!pControl.isNull()) {
         qWarning() << "cannot create alias for expired control" << key;
         return;
     }
 
+    const auto it = s_qCOHandleHash.constFind(alias);
+    if (it == s_qCOHandleHash.constEnd()) {
+        s_qCOHandleHash.insert(alias, handle);
+        s_qCOAliasKeys.insert(alias);
+    } else if (it.value() != handle) {
+        // The alias has already been interned, e.g. by resolving it before
+        // the aliased control was created. Handles that have been resolved
+        // for it must keep working, so the alias shares the aliased control
+        // with the existing handle instead of being remapped.
+        QWeakPointer<ControlDoublePrivate>& pAliasControl = s_qCOByHandle[it.value()];
+        VERIFY_OR_DEBUG_ASSERT(!pAliasControl.lock()) {
+            qWarning() << "cannot create alias" << alias << "for" << key
+                       << "because a control with this key already exists";
+            return;
+        }
+        pAliasControl = pControl;
+    }
     s_qCOAliasHash.insert(key, alias);
-    s_qCOHash.insert(alias, pControl);
+}
+
+// static
+ControlHandle ControlDoublePrivate::resolveHandle(const ConfigKey& key) {
+    if (!key.isValid()) {
+        return ControlHandle();
+    }
+    {
+        const MReadLocker locker(&s_qCOHashLock);
+        const int handle = lookupHandle(key);
+        if (handle >= 0) {
+            return ControlHandle(handle);
+        }
+    }
+    const MWriteLocker locker(&s_qCOHashLock);
+    return ControlHandle(internHandle(key));
+}
+
+// static
+QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
+        ControlHandle handle,
+        ControlFlags flags) {
+    QSharedPointer<ControlDoublePrivate> pControl;
+    if (handle.valid()) {
+        const MReadLocker locker(&s_qCOHashLock);
+        VERIFY_OR_DEBUG_ASSERT(handle.handle() < s_qCOByHandle.size()) {
+            return nullptr;
+        }
+        pControl = s_qCOByHandle.at(handle.handle()).lock();
+    } else {
+        if (!flags.testFlag(ControlFlag::AllowInvalidKey)) {
+            qWarning() << "ControlDoublePrivate::getControl returning nullptr"
+                       << "for invalid" << handle;
+            DEBUG_ASSERT(!"Unexpected invalid handle");
+        }
+        return nullptr;
+    }
+    if (!pControl && !flags.testFlag(ControlFlag::NoWarnIfMissing)) {
+        qWarning() << "ControlDoublePrivate::getControl returning NULL for"
+                   << handle;
+        DEBUG_ASSERT(flags.testFlag(ControlFlag::NoAssertIfMissing));
+    }
+    return pControl;
 }
 
 // static
@@ -142,12 +242,13 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
+    // Scope for MReadLocker. Looking up existing controls is the common
+    // case and must not block concurrent lookups from other threads.
     {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.find(key);
-        if (it != s_qCOHash.end()) {
-            auto pControl = it.value().lock();
+        const MReadLocker locker(&s_qCOHashLock);
+        const int handle = lookupHandle(key);
+        if (handle >= 0) {
+            auto pControl = s_qCOByHandle.at(handle).lock();
             if (pControl) {
                 // Control object already exists
                 if (pCreatorCO) {
@@ -159,9 +260,6 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                     return nullptr;
                 }
                 return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
             }
         }
     }
@@ -174,9 +272,10 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
-        //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
-        s_qCOHash.insert(key, pControl);
+        const MWriteLocker locker(&s_qCOHashLock);
+        //qDebug() << "ControlDoublePrivate::s_qCOByHandle.insert(" << key.group << "," << key.item << ")";
+        const int handle = internHandle(key);
+        s_qCOByHandle[handle] = pControl;
         return pControl;
     }
 
@@ -195,7 +294,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
         // Try again with the mutex locked to protect against creating two
         // ControlDoublePrivateConst objects. Access to s_defaultCO itself is
         // thread save.
-        MMutexLocker locker(&s_qCOHashMutex);
+        MWriteLocker locker(&s_qCOHashLock);
         defaultCO = s_pDefaultCO.lock();
         if (!defaultCO) {
             defaultCO = QSharedPointer<ControlDoublePrivate>(new ControlDoublePrivateConst());
@@ -208,15 +307,12 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
     QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
+    MReadLocker locker(&s_qCOHashLock);
+    result.reserve(s_qCOByHandle.size());
+    for (const auto& pWeakControl : std::as_const(s_qCOByHandle)) {
+        auto pControl = pWeakControl.lock();
         if (pControl) {
             result.append(std::move(pControl));
-        } else {
-            // The weak pointer has become invalid and can be cleaned up
-            s_qCOHash.erase(it);
         }
     }
     return result;
@@ -225,21 +321,31 @@ QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstance
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
     QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
+    MWriteLocker locker(&s_qCOHashLock);
+    result.reserve(s_qCOByHandle.size());
+    for (auto& pWeakControl : s_qCOByHandle) {
+        auto pControl = pWeakControl.lock();
         if (pControl) {
             result.append(std::move(pControl));
         }
+        // Keep the handle interned for subsequently created instances
+        pWeakControl.clear();
     }
-    s_qCOHash.clear();
+    // Aliases must not map to the handles of the removed controls, otherwise
+    // a control that is created with the key of an alias later would be
+    // unreachable.
+    for (const auto& alias : std::as_const(s_qCOAliasKeys)) {
+        s_qCOHandleHash.remove(alias);
+    }
+    s_qCOAliasKeys.clear();
+    s_qCOAliasHash.clear();
     return result;
 }
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
     // Implicitly shared classes can safely be copied across threads
+    const MReadLocker locker(&s_qCOHashLock);
     return s_qCOAliasHash;
 }
 
@@ -277,6 +383,9 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
+    if (atomicLoadRelaxed(m_coalescedChangeTracking)) {
+        m_coalescedChangePending.storeRelease(1);
+    }
     emit valueChanged(value, pSender);
 
     if (m_bTrack) {
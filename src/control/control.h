@@ -7,6 +7,7 @@
 #include <QString>
 
 #include "control/controlbehavior.h"
+#include "control/controlhandle.h"
 #include "control/controlvalue.h"
 #include "preferences/usersettings.h"
 #include "util/mutex.h"
@@ -24,6 +25,10 @@ enum class ControlFlag {
     /// Don't log a warning when trying to access a non-existing CO.
     NoWarnIfMissing = (1 << 2) | NoAssertIfMissing,
     AllowMissingOrInvalid = AllowInvalidKey | NoAssertIfMissing,
+    /// Don't queue an event for every value change. Instead, value changes are
+    /// coalesced and delivered once per GUI tick by the ControlChangeBus.
+    /// Only supported by ControlProxy objects that live in the main thread.
+    CoalesceChanges = 1 << 3,
 };
 
 Q_DECLARE_FLAGS(ControlFlags, ControlFlag)
@@ -57,6 +62,18 @@ class ControlDoublePrivate : public QObject {
             double defaultValue = 0.0);
     static QSharedPointer<ControlDoublePrivate> getDefaultControl();
 
+    // Interns the given ConfigKey and returns its handle. The control does not
+    // need to exist yet. Returns an invalid handle for invalid keys. Resolve
+    // the handle once and use getControl(ControlHandle) for repeated lookups
+    // to avoid hashing the group and item strings every time.
+    static ControlHandle resolveHandle(const ConfigKey& key);
+
+    // Gets the ControlDoublePrivate for a handle obtained by resolveHandle().
+    // Returns nullptr if the control does not exist (anymore).
+    static QSharedPointer<ControlDoublePrivate> getControl(
+            ControlHandle handle,
+            ControlFlags flags = ControlFlag::None);
+
     // Returns a list of all existing instances.
     static QList<QSharedPointer<ControlDoublePrivate>> getAllInstances();
     // Clears all existing instances and returns them as a list.
@@ -133,6 +150,18 @@ class ControlDoublePrivate : public QObject {
         return m_key;
     }
 
+    // Enables marking value changes as pending for the ControlChangeBus.
+    // Thread safe, non-blocking.
+    void setCoalescedChangeTracking(bool enabled) {
+        m_coalescedChangeTracking.storeRelease(enabled ? 1 : 0);
+    }
+
+    // Returns true if the value has changed since the last call and resets
+    // the pending state. Thread safe, non-blocking.
+    bool takeCoalescedChange() {
+        return m_coalescedChangePending.fetchAndStoreAcquire(0) != 0;
+    }
+
     // Connects a slot to the ValueChange request for CO validation. All change
     // requests issued by set are routed though the connected slot. This can
     // decide with its own thread safe solution if the requested value can be
@@ -204,6 +233,10 @@ class ControlDoublePrivate : public QObject {
     ControlValueAtomic<double> m_defaultValue;
 
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
+
+    // Coalesced change notification, see ControlChangeBus
+    QAtomicInt m_coalescedChangeTracking;
+    QAtomicInt m_coalescedChangePending;
 };
 
 /// The constant ControlDoublePrivate version is used as dummy for default
@@ -0,0 +1,114 @@
+#include "control/controlchangebus.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include "control/control.h"
+#include "control/controlproxy.h"
+#include "moc_controlchangebus.cpp"
+#include "util/assert.h"
+
+namespace {
+
+// Slightly longer than the period of the slowest configurable waveform frame
+// rate, so the timer never fires as long as GuiTick or the QML windows are
+// rendering frames.
+constexpr int kFallbackIntervalMillis = 50;
+
+QPointer<ControlChangeBus> s_pInstance;
+
+} // namespace
+
+// static
+ControlChangeBus* ControlChangeBus::instance() {
+    if (!s_pInstance) {
+        QCoreApplication* pApp = QCoreApplication::instance();
+        VERIFY_OR_DEBUG_ASSERT(pApp) {
+            return nullptr;
+        }
+        DEBUG_ASSERT(QThread::currentThread() == pApp->thread());
+        // Owned and deleted by the application object
+        s_pInstance = new ControlChangeBus(pApp);
+    }
+    return s_pInstance;
+}
+
+// static
+ControlChangeBus* ControlChangeBus::existingInstance() {
+    return s_pInstance;
+}
+
+ControlChangeBus::ControlChangeBus(QObject* pParent)
+        : QObject(pParent) {
+    m_fallbackTimer.setInterval(kFallbackIntervalMillis);
+    connect(&m_fallbackTimer,
+            &QTimer::timeout,
+            this,
+            &ControlChangeBus::slotFallbackTimeout);
+}
+
+void ControlChangeBus::subscribe(ControlProxy* pProxy) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    ControlDoublePrivate* pControl = pProxy->m_pControl.data();
+    VERIFY_OR_DEBUG_ASSERT(pControl) {
+        return;
+    }
+    QList<ControlProxy*>& proxies = m_subscriptions[pControl];
+    DEBUG_ASSERT(!proxies.contains(pProxy));
+    if (proxies.isEmpty()) {
+        pControl->setCoalescedChangeTracking(true);
+        // Discard changes from a previous subscription
+        pControl->takeCoalescedChange();
+    }
+    proxies.append(pProxy);
+    if (!m_fallbackTimer.isActive()) {
+        m_fallbackTimer.start();
+    }
+}
+
+void ControlChangeBus::unsubscribe(ControlProxy* pProxy) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    ControlDoublePrivate* pControl = pProxy->m_pControl.data();
+    auto it = m_subscriptions.find(pControl);
+    VERIFY_OR_DEBUG_ASSERT(it != m_subscriptions.end()) {
+        return;
+    }
+    it.value().removeOne(pProxy);
+    if (it.value().isEmpty()) {
+        pControl->setCoalescedChangeTracking(false);
+        m_subscriptions.erase(it);
+    }
+    if (m_subscriptions.isEmpty()) {
+        m_fallbackTimer.stop();
+    }
+}
+
+void ControlChangeBus::process() {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    if (m_subscriptions.isEmpty()) {
+        return;
+    }
+    // Postpone the fallback while we are driven by the GUI tick
+    m_fallbackTimer.start();
+
+    // Collect all notifications before emitting any signal, because the
+    // receivers might create or delete subscribed proxies.
+    DEBUG_ASSERT(m_pendingNotifications.isEmpty());
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+        if (it.key()->takeCoalescedChange()) {
+            for (ControlProxy* pProxy : it.value()) {
+                m_pendingNotifications.append(pProxy);
+            }
+        }
+    }
+    for (const auto& pProxy : std::as_const(m_pendingNotifications)) {
+        if (pProxy) {
+            pProxy->emitValueChanged();
+        }
+    }
+    m_pendingNotifications.clear();
+}
+
+void ControlChangeBus::slotFallbackTimeout() {
+    process();
+}
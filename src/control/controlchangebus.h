@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class ControlDoublePrivate;
+class ControlProxy;
+
+/// Delivers coalesced value changes to ControlProxy objects that have been
+/// created with ControlFlag::CoalesceChanges.
+///
+/// Regular ControlProxy connections queue one event per value change, which
+/// floods the GUI event loop for controls that are updated by the engine in
+/// every callback (play position, VU meters). Subscribed controls only mark
+/// their value as changed, which is lock-free and does not allocate. The bus
+/// drains the pending changes once per GUI tick and notifies each subscribed
+/// proxy once with the latest value.
+///
+/// The bus is processed by GuiTick in the widget GUI and once per frame of
+/// the QML windows. Only if neither occurs for a while, e.g. while the QML
+/// scene graph does not render any frames, a fallback timer takes over.
+///
+/// All methods must be called from the main thread.
+class ControlChangeBus : public QObject {
+    Q_OBJECT
+  public:
+    /// Returns the instance, which is created on first use
+    static ControlChangeBus* instance();
+    /// Returns the instance or nullptr if it does not exist (anymore)
+    static ControlChangeBus* existingInstance();
+
+    void subscribe(ControlProxy* pProxy);
+    void unsubscribe(ControlProxy* pProxy);
+
+    /// Notifies all subscribed proxies of controls that have changed since
+    /// the last call.
+    void process();
+
+    int numSubscribedControls() const {
+        return m_subscriptions.size();
+    }
+
+  private slots:
+    void slotFallbackTimeout();
+
+  private:
+    explicit ControlChangeBus(QObject* pParent);
+
+    QHash<ControlDoublePrivate*, QList<ControlProxy*>> m_subscriptions;
+    // Reused to avoid allocations on every tick
+    QVector<QPointer<ControlProxy>> m_pendingNotifications;
+    QTimer m_fallbackTimer;
+};
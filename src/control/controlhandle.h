@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QtDebug>
+
+#include "util/compatibility/qhash.h"
+
+/// A wrapper around an integer handle that refers to an interned ConfigKey
+/// of a control.
+///
+/// Looking up a control by its ConfigKey requires hashing and comparing both
+/// the group and the item string. Code that accesses the same controls over
+/// and over again (skins, controller mappings) can resolve the ConfigKey once
+/// with ControlDoublePrivate::resolveHandle() and use the handle for all
+/// subsequent lookups, which are plain array accesses.
+///
+/// Handles are never released. A resolved handle stays valid for the whole
+/// lifetime of the application, even if the control is deleted and created
+/// again. Aliases of a control share the handle of the aliased control.
+class ControlHandle {
+  public:
+    ControlHandle()
+            : m_iHandle(-1) {
+    }
+
+    inline bool valid() const {
+        return m_iHandle >= 0;
+    }
+
+    inline int handle() const {
+        return m_iHandle;
+    }
+
+  private:
+    explicit ControlHandle(int iHandle)
+            : m_iHandle(iHandle) {
+    }
+
+    int m_iHandle;
+
+    friend class ControlDoublePrivate;
+};
+
+inline bool operator==(const ControlHandle& h1, const ControlHandle& h2) {
+    return h1.handle() == h2.handle();
+}
+
+inline bool operator!=(const ControlHandle& h1, const ControlHandle& h2) {
+    return h1.handle() != h2.handle();
+}
+
+inline QDebug operator<<(QDebug stream, const ControlHandle& h) {
+    stream << "ControlHandle(" << h.handle() << ")";
+    return stream;
+}
+
+inline qhash_seed_t qHash(
+        const ControlHandle& handle,
+        qhash_seed_t seed = 0) {
+    return qHash(handle.handle(), seed);
+}
@@ -67,6 +67,15 @@ ControlObject* ControlObject::getControl(const ConfigKey& key, ControlFlags flag
     return nullptr;
 }
 
+// static
+ControlObject* ControlObject::getControl(ControlHandle handle, ControlFlags flags) {
+    QSharedPointer<ControlDoublePrivate> pCDP = ControlDoublePrivate::getControl(handle, flags);
+    if (pCDP) {
+        return pCDP->getCreatorCO();
+    }
+    return nullptr;
+}
+
 void ControlObject::setValueFromMidi(MidiOpCode o, double v) {
     m_pControl->setValueFromMidi(o, v);
 }
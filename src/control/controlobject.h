@@ -26,6 +26,8 @@ class ControlObject : public QObject {
 
     // Returns a pointer to the ControlObject matching the given ConfigKey
     static ControlObject* getControl(const ConfigKey& key, ControlFlags flags = ControlFlag::None);
+    static ControlObject* getControl(ControlHandle handle,
+            ControlFlags flags = ControlFlag::None);
     static ControlObject* getControl(const QString& group,
             const QString& item,
             ControlFlags flags = ControlFlag::None) {
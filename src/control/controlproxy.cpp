@@ -3,6 +3,7 @@
 #include <QtDebug>
 
 #include "control/control.h"
+#include "control/controlchangebus.h"
 #include "moc_controlproxy.cpp"
 
 ControlProxy::ControlProxy(const QString& g, const QString& i, QObject* pParent, ControlFlags flags)
@@ -10,17 +11,44 @@ ControlProxy::ControlProxy(const QString& g, const QString& i, QObject* pParent,
 }
 
 ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags flags)
-        : QObject(pParent) {
+        : QObject(pParent),
+          m_bCoalesceChanges(false) {
     m_pControl = ControlDoublePrivate::getControl(key, flags);
+    initialize(flags);
+}
+
+ControlProxy::ControlProxy(ControlHandle handle, QObject* pParent, ControlFlags flags)
+        : QObject(pParent),
+          m_bCoalesceChanges(false) {
+    m_pControl = ControlDoublePrivate::getControl(handle, flags);
+    initialize(flags);
+}
+
+void ControlProxy::initialize(ControlFlags flags) {
     if (!m_pControl) {
         DEBUG_ASSERT(flags & ControlFlag::AllowMissingOrInvalid);
         m_pControl = ControlDoublePrivate::getDefaultControl();
+        // Nothing to subscribe to
+        return;
+    }
+    if (flags.testFlag(ControlFlag::CoalesceChanges)) {
+        ControlChangeBus* pBus = ControlChangeBus::instance();
+        if (pBus) {
+            pBus->subscribe(this);
+            m_bCoalesceChanges = true;
+        }
     }
-    DEBUG_ASSERT(m_pControl);
 }
 
 ControlProxy::~ControlProxy() {
     //qDebug() << "ControlProxy::~ControlProxy()";
+    if (m_bCoalesceChanges) {
+        // The bus might already be gone during shutdown
+        ControlChangeBus* pBus = ControlChangeBus::existingInstance();
+        if (pBus) {
+            pBus->unsubscribe(this);
+        }
+    }
 }
 
 const ConfigKey& ControlProxy::getKey() const {
@@ -25,6 +25,11 @@ class ControlProxy : public QObject {
     ControlProxy(const ConfigKey& key,
             QObject* pParent = nullptr,
             ControlFlags flags = ControlFlag::None);
+    /// Creates a proxy for a pre-resolved handle, see
+    /// ControlDoublePrivate::resolveHandle().
+    ControlProxy(ControlHandle handle,
+            QObject* pParent = nullptr,
+            ControlFlags flags = ControlFlag::None);
     ~ControlProxy() override;
 
     const ConfigKey& getKey() const;
@@ -69,6 +74,11 @@ class ControlProxy : public QObject {
             return false;
         }
 
+        if (m_bCoalesceChanges) {
+            // Value changes are delivered by the ControlChangeBus
+            return true;
+        }
+
         // Connect to ControlObjectPrivate only if required. Do not allow
         // duplicate connections.
 
@@ -186,4 +196,12 @@ class ControlProxy : public QObject {
   protected:
     /// Pointer to connected control.
     QSharedPointer<ControlDoublePrivate> m_pControl;
+
+  private:
+    void initialize(ControlFlags flags);
+
+    /// Subscribed to the ControlChangeBus, see ControlFlag::CoalesceChanges
+    bool m_bCoalesceChanges;
+
+    friend class ControlChangeBus;
 };
@@ -3,10 +3,13 @@
 #include <QApplication>
 #include <QJSValue>
 #include <QRegularExpression>
+#include <cmath>
 
 #include "controllers/defs_controllers.h"
 #include "moc_controller.cpp"
 #include "util/screensaver.h"
+#include "util/stat.h"
+#include "util/time.h"
 
 namespace {
 QString loggingCategoryPrefix(const QString& deviceName) {
@@ -24,7 +27,9 @@ Controller::Controller(const QString& deviceName)
           m_bIsOutputDevice(false),
           m_bIsInputDevice(false),
           m_bIsOpen(false),
-          m_bLearning(false) {
+          m_bLearning(false),
+          m_inputLatencyStatKey(
+                  QStringLiteral("Controller input latency ") + deviceName) {
     m_userActivityInhibitTimer.start();
 }
 
@@ -113,6 +118,15 @@ void Controller::triggerActivity()
         m_userActivityInhibitTimer.start();
     }
 }
+void Controller::trackInputLatency(mixxx::Duration arrivalTime) {
+    const mixxx::Duration latency = mixxx::Time::elapsed() - arrivalTime;
+    // Round to 0.1 ms to limit the number of distinct histogram values
+    Stat::track(m_inputLatencyStatKey,
+            Stat::DURATION_MSEC,
+            Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX | Stat::HISTOGRAM,
+            std::round(latency.toDoubleMillis() * 10) / 10);
+}
+
 void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
     if (!m_pScriptEngineLegacy) {
         //qWarning() << "Controller::receive called with no active engine!";
@@ -147,4 +161,5 @@ void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
     }
 
     m_pScriptEngineLegacy->handleIncomingData(data);
+    trackInputLatency(timestamp);
 }
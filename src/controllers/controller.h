@@ -3,6 +3,7 @@
 #include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QTimerEvent>
+#include <atomic>
 
 #include "controllers/controllermappinginfo.h"
 #include "controllers/legacycontrollermapping.h"
@@ -37,8 +38,10 @@ class Controller : public QObject {
     /// Clone the mapping before passing to setMapping for use in the controller polling thread.
     virtual void setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) = 0;
 
+    /// Thread-safe, the controller might be opened and closed in its
+    /// ControllerThread.
     inline bool isOpen() const {
-        return m_bIsOpen;
+        return m_bIsOpen.load(std::memory_order_acquire);
     }
     inline bool isOutputDevice() const {
         return m_bIsOutputDevice;
@@ -46,6 +49,7 @@ class Controller : public QObject {
     inline bool isInputDevice() const {
         return m_bIsInputDevice;
     }
+    /// Thread-safe, the name never changes after construction.
     inline const QString& getName() const {
         return m_sDeviceName;
     }
@@ -117,6 +121,12 @@ class Controller : public QObject {
     // To be called when receiving events
     void triggerActivity();
 
+    /// To be called after input data has been processed by the mapping.
+    /// Tracks the time since the input arrived at Mixxx (based on
+    /// mixxx::Time::elapsed()) as a histogram in the developer stats.
+    /// Not used for MIDI messages to keep their dispatch path short.
+    void trackInputLatency(mixxx::Duration arrivalTime);
+
     inline ControllerScriptEngineLegacy* getScriptEngine() const {
         return m_pScriptEngineLegacy;
     }
@@ -130,8 +140,8 @@ class Controller : public QObject {
         m_bIsInputDevice = inputDevice;
     }
     inline void setOpen(bool open) {
-        m_bIsOpen = open;
-        emit openChanged(m_bIsOpen);
+        m_bIsOpen.store(open, std::memory_order_release);
+        emit openChanged(open);
     }
 
     const QString m_sDeviceName;
@@ -164,13 +174,17 @@ class Controller : public QObject {
     // Flag indicating if this device supports input (sending data to Mixxx)
     bool m_bIsInputDevice;
     // Indicates whether or not the device has been opened for input/output.
-    bool m_bIsOpen;
+    // Written in the thread of the controller, read from other threads by
+    // the ControllerManager and the preferences.
+    std::atomic<bool> m_bIsOpen;
     bool m_bLearning;
     QElapsedTimer m_userActivityInhibitTimer;
+    const QString m_inputLatencyStatKey;
 
     friend class ControllerJSProxy;
     // accesses lots of our stuff, but in the same thread
     friend class ControllerManager;
+    friend class ControllerThread;
     // For testing
     friend class LegacyControllerMappingValidationTest;
 };
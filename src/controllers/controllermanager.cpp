@@ -4,6 +4,7 @@
 #include <QThread>
 
 #include "controllers/controllerlearningeventfilter.h"
+#include "controllers/controllerthread.h"
 #include "controllers/defs_controllers.h"
 #include "controllers/midi/portmidienumerator.h"
 #include "moc_controllermanager.cpp"
@@ -61,6 +62,9 @@ QFileInfo findMappingFile(const QString& pathOrFilename, const QStringList& path
 // kept for backwards compatibility.
 const QString kSettingsGroup = QLatin1String("[ControllerPreset]");
 
+const ConfigKey kDedicatedThreadsConfigKey =
+        ConfigKey(QStringLiteral("[Controller]"), QStringLiteral("DedicatedThreads"));
+
 } // anonymous namespace
 
 QString firstAvailableFilename(QSet<QString>& filenames,
@@ -87,7 +91,8 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
           // its own event loop.
           m_pControllerLearningEventFilter(new ControllerLearningEventFilter()),
           m_pollTimer(this),
-          m_skipPoll(false) {
+          m_skipPoll(false),
+          m_bDedicatedThreads(m_pConfig->getValue<bool>(kDedicatedThreadsConfigKey, false)) {
     qRegisterMetaType<std::shared_ptr<LegacyControllerMapping>>(
             "std::shared_ptr<LegacyControllerMapping>");
 
@@ -161,6 +166,17 @@ void ControllerManager::slotInitialize() {
 void ControllerManager::slotShutdown() {
     stopPolling();
 
+    // Close controllers with a dedicated thread in their thread and move them
+    // back, before they are deleted by their enumerator in this thread.
+    for (const auto& [pController, pThread] : m_controllerThreads) {
+        pThread->invokeBlocking([pController = pController] {
+            if (pController->isOpen()) {
+                pController->close();
+            }
+        });
+    }
+    m_controllerThreads.clear();
+
     // Clear m_enumerators before deleting the enumerators to prevent other code
     // paths from accessing them.
     auto locker = lockMutex(&m_mutex);
@@ -242,7 +258,10 @@ void ControllerManager::slotSetUpDevices() {
         QString name = pController->getName();
 
         if (pController->isOpen()) {
-            pController->close();
+            invokeInControllerThread(pController, [pController] {
+                pController->close();
+            });
+            updatePolling(pController);
         }
 
         // The filename for this device name.
@@ -275,8 +294,13 @@ void ControllerManager::slotSetUpDevices() {
             continue;
         }
 
+        maybeCreateControllerThread(pController);
+
         // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-        pController->setMapping(pMapping->clone());
+        std::shared_ptr<LegacyControllerMapping> pClonedMapping = pMapping->clone();
+        invokeInControllerThread(pController, [pController, &pClonedMapping] {
+            pController->setMapping(std::move(pClonedMapping));
+        });
 
         // If we are in safe mode, skip opening controllers.
         if (CmdlineArgs::Instance().getSafeMode()) {
@@ -286,17 +310,52 @@ void ControllerManager::slotSetUpDevices() {
 
         qDebug() << "Opening controller:" << name;
 
-        int value = pController->open();
+        int value = -1;
+        invokeInControllerThread(pController, [pController, &value] {
+            value = pController->open();
+            if (value == 0) {
+                pController->applyMapping();
+            }
+        });
         if (value != 0) {
             qWarning() << "There was a problem opening" << name;
             continue;
         }
-        pController->applyMapping();
+        updatePolling(pController);
     }
 
     pollIfAnyControllersOpen();
 }
 
+void ControllerManager::invokeInControllerThread(Controller* pController,
+        const std::function<void()>& function) {
+    const auto it = m_controllerThreads.find(pController);
+    if (it == m_controllerThreads.end()) {
+        function();
+        return;
+    }
+    it->second->invokeBlocking(function);
+}
+
+void ControllerManager::maybeCreateControllerThread(Controller* pController) {
+    if (!m_bDedicatedThreads ||
+            m_controllerThreads.find(pController) != m_controllerThreads.end()) {
+        return;
+    }
+    qDebug() << "Creating dedicated thread for controller" << pController->getName();
+    m_controllerThreads.emplace(pController,
+            std::make_unique<ControllerThread>(pController, kPollInterval));
+}
+
+void ControllerManager::updatePolling(Controller* pController) {
+    const auto it = m_controllerThreads.find(pController);
+    if (it == m_controllerThreads.end()) {
+        pollIfAnyControllersOpen();
+        return;
+    }
+    it->second->updatePolling();
+}
+
 void ControllerManager::pollIfAnyControllersOpen() {
     auto locker = lockMutex(&m_mutex);
     QList<Controller*> controllers = m_controllers;
@@ -304,6 +363,10 @@ void ControllerManager::pollIfAnyControllersOpen() {
 
     bool shouldPoll = false;
     for (Controller* pController : controllers) {
+        if (m_controllerThreads.find(pController) != m_controllerThreads.end()) {
+            // Polled in its dedicated thread
+            continue;
+        }
         if (pController->isOpen() && pController->isPolling()) {
             shouldPoll = true;
         }
@@ -358,6 +421,10 @@ void ControllerManager::pollDevices() {
 
     mixxx::Duration start = mixxx::Time::elapsed();
     for (Controller* pDevice : qAsConst(m_controllers)) {
+        if (m_controllerThreads.find(pDevice) != m_controllerThreads.end()) {
+            // Polled in its dedicated thread
+            continue;
+        }
         if (pDevice->isOpen() && pDevice->isPolling()) {
             pDevice->poll();
         }
@@ -374,17 +441,22 @@ void ControllerManager::openController(Controller* pController) {
     if (!pController) {
         return;
     }
-    if (pController->isOpen()) {
-        pController->close();
-    }
-    int result = pController->open();
-    pollIfAnyControllersOpen();
+    maybeCreateControllerThread(pController);
+    int result = -1;
+    invokeInControllerThread(pController, [pController, &result] {
+        if (pController->isOpen()) {
+            pController->close();
+        }
+        result = pController->open();
+        // If successfully opened the device, apply the mapping
+        if (result == 0) {
+            pController->applyMapping();
+        }
+    });
+    updatePolling(pController);
 
-    // If successfully opened the device, apply the mapping and save the
-    // preference setting.
+    // If successfully opened the device, save the preference setting.
     if (result == 0) {
-        pController->applyMapping();
-
         // Update configuration to reflect controller is enabled.
         m_pConfig->setValue(
                 ConfigKey("[Controller]", sanitizeDeviceName(pController->getName())), 1);
@@ -395,8 +467,10 @@ void ControllerManager::closeController(Controller* pController) {
     if (!pController) {
         return;
     }
-    pController->close();
-    pollIfAnyControllersOpen();
+    invokeInControllerThread(pController, [pController] {
+        pController->close();
+    });
+    updatePolling(pController);
     // Update configuration to reflect controller is disabled.
     m_pConfig->setValue(
             ConfigKey("[Controller]", sanitizeDeviceName(pController->getName())), 0);
@@ -428,7 +502,10 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     m_pConfig->set(key, pMapping->filePath());
 
     // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-    pController->setMapping(pMapping->clone());
+    std::shared_ptr<LegacyControllerMapping> pClonedMapping = pMapping->clone();
+    invokeInControllerThread(pController, [pController, &pClonedMapping] {
+        pController->setMapping(std::move(pClonedMapping));
+    });
 
     if (bEnabled) {
         openController(pController);
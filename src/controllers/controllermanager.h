@@ -3,6 +3,9 @@
 #include <QMutex>
 #include <QSharedPointer>
 #include <QTimer>
+#include <functional>
+#include <map>
+#include <memory>
 
 #include "controllers/controllerenumerator.h"
 #include "controllers/controllermappinginfo.h"
@@ -13,6 +16,7 @@
 // Forward declaration(s)
 class Controller;
 class ControllerLearningEventFilter;
+class ControllerThread;
 
 /// Function to sort controllers by name
 bool controllerCompare(Controller *a, Controller *b);
@@ -73,6 +77,17 @@ class ControllerManager : public QObject {
     void pollIfAnyControllersOpen();
 
   private:
+    /// Runs the function in the thread of the controller. This is either the
+    /// ControllerManager thread or the dedicated thread of the controller.
+    void invokeInControllerThread(Controller* pController,
+            const std::function<void()>& function);
+    /// Creates the dedicated thread for the controller, if enabled and not
+    /// yet existing.
+    void maybeCreateControllerThread(Controller* pController);
+    /// Starts or stops polling the controller in its dedicated thread or in
+    /// the ControllerManager thread.
+    void updatePolling(Controller* pController);
+
     UserSettingsPointer m_pConfig;
     ControllerLearningEventFilter* m_pControllerLearningEventFilter;
     QTimer m_pollTimer;
@@ -83,4 +98,8 @@ class ControllerManager : public QObject {
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadUserMappingEnumerator;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadSystemMappingEnumerator;
     bool m_skipPoll;
+    /// Run every controller in its own thread instead of the
+    /// ControllerManager thread
+    const bool m_bDedicatedThreads;
+    std::map<Controller*, std::unique_ptr<ControllerThread>> m_controllerThreads;
 };
@@ -0,0 +1,67 @@
+#include "controllers/controllerthread.h"
+
+#include <QTimer>
+
+#include "controllers/controller.h"
+#include "moc_controllerthread.cpp"
+#include "util/time.h"
+
+ControllerThread::ControllerThread(Controller* pController, mixxx::Duration pollInterval)
+        : m_pController(pController),
+          m_pollInterval(pollInterval),
+          m_pPollTimer(new QTimer),
+          m_skipPoll(false) {
+    m_thread.setObjectName(QStringLiteral("Controller ") + pController->getName());
+
+    m_pPollTimer->setInterval(m_pollInterval.toIntegerMillis());
+    // The controller is the context object, so the poll is executed in the
+    // controller thread.
+    connect(m_pPollTimer, &QTimer::timeout, m_pController, [this] { poll(); });
+
+    m_pController->moveToThread(&m_thread);
+    m_pPollTimer->moveToThread(&m_thread);
+
+    // Controller processing needs to be prioritized since it can affect the
+    // audio directly, like when scratching
+    m_thread.start(QThread::HighPriority);
+}
+
+ControllerThread::~ControllerThread() {
+    QThread* pOwnerThread = thread();
+    invokeBlocking([this, pOwnerThread] {
+        delete m_pPollTimer;
+        m_pPollTimer = nullptr;
+        // Objects can only be pushed to another thread from their own thread
+        m_pController->moveToThread(pOwnerThread);
+    });
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void ControllerThread::updatePolling() {
+    invokeBlocking([this] {
+        if (m_pController->isOpen() && m_pController->isPolling()) {
+            if (!m_pPollTimer->isActive()) {
+                m_pPollTimer->start();
+                qDebug() << "Controller polling started in" << m_thread.objectName();
+            }
+        } else if (m_pPollTimer->isActive()) {
+            m_pPollTimer->stop();
+            qDebug() << "Controller polling stopped in" << m_thread.objectName();
+        }
+    });
+}
+
+void ControllerThread::poll() {
+    // Same overload strategy as ControllerManager::pollDevices(), but only
+    // this controller is affected when its mapping can't keep up.
+    if (m_skipPoll) {
+        m_skipPoll = false;
+        return;
+    }
+    mixxx::Duration start = mixxx::Time::elapsed();
+    m_pController->poll();
+    if (mixxx::Time::elapsed() - start > m_pollInterval) {
+        m_skipPoll = true;
+    }
+}
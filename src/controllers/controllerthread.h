@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QMetaObject>
+#include <QObject>
+#include <QThread>
+#include <utility>
+
+#include "util/assert.h"
+#include "util/duration.h"
+
+class Controller;
+class QTimer;
+
+/// Runs the script engine, the input polling and the output of a single
+/// controller in a thread of its own. A heavy mapping (e.g. one that renders
+/// HID displays) then no longer adds latency to the input of other
+/// controllers, that are otherwise all serviced by the ControllerManager
+/// thread.
+///
+/// The controller is moved into the thread on construction and moved back to
+/// the thread that created the ControllerThread on destruction. Only use the
+/// controller through invokeBlocking() in the meantime. Controls are accessed
+/// from the thread through the thread-safe control registry.
+class ControllerThread : public QObject {
+    Q_OBJECT
+  public:
+    ControllerThread(Controller* pController, mixxx::Duration pollInterval);
+    ~ControllerThread() override;
+
+    Controller* controller() const {
+        return m_pController;
+    }
+
+    /// Runs the function in the controller thread and waits until it returns.
+    template<typename Function>
+    void invokeBlocking(Function&& function) {
+        DEBUG_ASSERT(QThread::currentThread() != &m_thread);
+        QMetaObject::invokeMethod(m_pController,
+                std::forward<Function>(function),
+                Qt::BlockingQueuedConnection);
+    }
+
+    /// Starts or stops polling the controller, depending on whether it is
+    /// open and a polling device.
+    void updatePolling();
+
+  private:
+    void poll();
+
+    Controller* const m_pController;
+    const mixxx::Duration m_pollInterval;
+    QThread m_thread;
+    // Lives in m_thread
+    QTimer* m_pPollTimer;
+    bool m_skipPoll;
+};
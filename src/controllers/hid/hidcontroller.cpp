@@ -5,16 +5,30 @@
 #include "controllers/defs_controllers.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 #include "moc_hidcontroller.cpp"
+#include "util/math.h"
 #include "util/string.h"
 #include "util/time.h"
 #include "util/trace.h"
 
+namespace {
+constexpr int kOutputStatisticsIntervalMillis = 1000;
+} // namespace
+
 HidController::HidController(
         mixxx::hid::DeviceInfo&& deviceInfo)
         : Controller(deviceInfo.formatName()),
-          m_deviceInfo(std::move(deviceInfo)) {
+          m_deviceInfo(std::move(deviceInfo)),
+          m_outputStatisticsGroup(QStringLiteral("[HidController ") + getName() +
+                  QStringLiteral("]")),
+          m_outputStatisticsTimer(this) {
     setDeviceCategory(mixxx::hid::DeviceCategory::guessFromDeviceInfo(m_deviceInfo));
 
+    m_outputStatisticsTimer.setInterval(kOutputStatisticsIntervalMillis);
+    connect(&m_outputStatisticsTimer,
+            &QTimer::timeout,
+            this,
+            &HidController::slotUpdateOutputStatistics);
+
     // All HID devices are full-duplex
     setInputDevice(true);
     setOutputDevice(true);
@@ -105,8 +119,16 @@ int HidController::open() {
 
     setOpen(true);
 
+    // The mapping may already set the bandwidth limit in its init function
+    createOutputStatisticsControls();
+
     m_pHidIoThread = std::make_unique<HidIoThread>(pHidDevice, m_deviceInfo);
     m_pHidIoThread->setObjectName(QStringLiteral("HidIoThread ") + getName());
+    if (m_pOutputBandwidthLimit) {
+        // The control may keep its value from before the device was reopened
+        m_pHidIoThread->setOutputBandwidthLimit(
+                static_cast<int>(m_pOutputBandwidthLimit->get()));
+    }
 
     connect(m_pHidIoThread.get(),
             &HidIoThread::receive,
@@ -191,6 +213,8 @@ int HidController::close() {
         m_pHidIoThread.reset();
     }
 
+    destroyOutputStatisticsControls();
+
     // Close device
     setOpen(false);
     qCInfo(m_logBase) << "Device closed";
@@ -206,6 +230,66 @@ void HidController::sendBytes(const QByteArray& data) {
     m_pHidIoThread->updateCachedOutputReportData(0, data, false);
 }
 
+void HidController::createOutputStatisticsControls() {
+    const ConfigKey bandwidthLimitKey(m_outputStatisticsGroup,
+            QStringLiteral("output_bandwidth_limit"));
+    if (ControlObject::getControl(bandwidthLimitKey, ControlFlag::NoWarnIfMissing)) {
+        // Can only happen for identical devices without serial number
+        qCWarning(m_logBase) << "Output statistics controls already exist for"
+                             << m_outputStatisticsGroup;
+        return;
+    }
+
+    m_pOutputBandwidthLimit = std::make_unique<ControlObject>(bandwidthLimitKey);
+    m_pOutputBandwidthLimit->connectValueChangeRequest(this, [this](double value) {
+        m_pOutputBandwidthLimit->setAndConfirm(math_max(0.0, value));
+        if (m_pHidIoThread) {
+            m_pHidIoThread->setOutputBandwidthLimit(
+                    static_cast<int>(m_pOutputBandwidthLimit->get()));
+        }
+    });
+    m_pOutputBytesPerSecond = std::make_unique<ControlObject>(ConfigKey(
+            m_outputStatisticsGroup, QStringLiteral("output_bytes_per_second")));
+    m_pOutputBytesPerSecond->setReadOnly();
+    m_pOutputSkippedIdenticalReports = std::make_unique<ControlObject>(ConfigKey(
+            m_outputStatisticsGroup,
+            QStringLiteral("output_skipped_identical_reports")));
+    m_pOutputSkippedIdenticalReports->setReadOnly();
+    m_pOutputSupersededReports = std::make_unique<ControlObject>(ConfigKey(
+            m_outputStatisticsGroup, QStringLiteral("output_superseded_reports")));
+    m_pOutputSupersededReports->setReadOnly();
+
+    m_lastOutputStatistics = HidIoOutputStatistics();
+    m_lastOutputStatisticsTime = mixxx::Time::elapsed();
+    m_outputStatisticsTimer.start();
+}
+
+void HidController::destroyOutputStatisticsControls() {
+    m_outputStatisticsTimer.stop();
+    m_pOutputBytesPerSecond.reset();
+    m_pOutputSkippedIdenticalReports.reset();
+    m_pOutputSupersededReports.reset();
+    m_pOutputBandwidthLimit.reset();
+}
+
+void HidController::slotUpdateOutputStatistics() {
+    if (!m_pHidIoThread || !m_pOutputBytesPerSecond) {
+        return;
+    }
+    const HidIoOutputStatistics statistics = m_pHidIoThread->outputStatistics();
+    const auto now = mixxx::Time::elapsed();
+    const double elapsedSeconds = (now - m_lastOutputStatisticsTime).toDoubleSeconds();
+    if (elapsedSeconds > 0) {
+        m_pOutputBytesPerSecond->forceSet(
+                (statistics.bytesSent - m_lastOutputStatistics.bytesSent) /
+                elapsedSeconds);
+    }
+    m_pOutputSkippedIdenticalReports->forceSet(statistics.skippedIdenticalReports);
+    m_pOutputSupersededReports->forceSet(statistics.supersededReports);
+    m_lastOutputStatistics = statistics;
+    m_lastOutputStatisticsTime = now;
+}
+
 ControllerJSProxy* HidController::jsProxy() {
     return new HidControllerJSProxy(this);
 }
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <QThread>
+#include <QTimer>
+#include <memory>
 
+#include "control/controlobject.h"
 #include "controllers/controller.h"
 #include "controllers/hid/hiddevice.h"
 #include "controllers/hid/hidiothread.h"
@@ -36,7 +39,15 @@ class HidController final : public Controller {
     int open() override;
     int close() override;
 
+    void slotUpdateOutputStatistics();
+
   private:
+    /// Creates the controls that report the OutputReport traffic of this
+    /// device to the mapping, in the group returned by
+    /// HidControllerJSProxy::getOutputStatisticsGroup().
+    void createOutputStatisticsControls();
+    void destroyOutputStatisticsControls();
+
     // For devices which only support a single report, reportID must be set to
     // 0x0.
     void sendBytes(const QByteArray& data) override;
@@ -46,6 +57,15 @@ class HidController final : public Controller {
     std::unique_ptr<HidIoThread> m_pHidIoThread;
     std::shared_ptr<LegacyHidControllerMapping> m_pMapping;
 
+    const QString m_outputStatisticsGroup;
+    QTimer m_outputStatisticsTimer;
+    HidIoOutputStatistics m_lastOutputStatistics;
+    mixxx::Duration m_lastOutputStatisticsTime;
+    std::unique_ptr<ControlObject> m_pOutputBytesPerSecond;
+    std::unique_ptr<ControlObject> m_pOutputSkippedIdenticalReports;
+    std::unique_ptr<ControlObject> m_pOutputSupersededReports;
+    std::unique_ptr<ControlObject> m_pOutputBandwidthLimit;
+
     friend class HidControllerJSProxy;
 };
 
@@ -136,6 +156,15 @@ class HidControllerJSProxy : public ControllerJSProxy {
         return m_pHidController->m_pHidIoThread->getFeatureReport(reportID);
     }
 
+    /// @brief Returns the group of the output statistics controls of this device
+    /// @details The group contains the controls output_bytes_per_second,
+    ///          output_skipped_identical_reports, output_superseded_reports and
+    ///          output_bandwidth_limit (bytes per second, 0 means unlimited),
+    ///          which can be set by the mapping to throttle the OutputReports.
+    Q_INVOKABLE QString getOutputStatisticsGroup() const {
+        return m_pHidController->m_outputStatisticsGroup;
+    }
+
   private:
     HidController* m_pHidController;
 };
@@ -0,0 +1,37 @@
+#include "controllers/hid/hidiooutputbandwidthlimiter.h"
+
+#include "util/compatibility/qatomic.h"
+#include "util/math.h"
+
+HidIoOutputBandwidthLimiter::HidIoOutputBandwidthLimiter()
+        : m_limit(0),
+          m_budget(0) {
+}
+
+void HidIoOutputBandwidthLimiter::setLimit(int bytesPerSecond) {
+    atomicStoreRelaxed(m_limit, math_max(0, bytesPerSecond));
+}
+
+int HidIoOutputBandwidthLimiter::limit() const {
+    return atomicLoadRelaxed(m_limit);
+}
+
+bool HidIoOutputBandwidthLimiter::isBudgetAvailable(mixxx::Duration now) {
+    const int bytesPerSecond = limit();
+    if (bytesPerSecond <= 0) {
+        return true;
+    }
+    m_budget = math_min(static_cast<double>(bytesPerSecond),
+            m_budget + bytesPerSecond * (now - m_budgetTime).toDoubleSeconds());
+    m_budgetTime = now;
+    return m_budget > 0;
+}
+
+void HidIoOutputBandwidthLimiter::consume(int bytes) {
+    if (limit() <= 0) {
+        // Otherwise the traffic while unlimited would block the output for
+        // a long time after setting a limit
+        return;
+    }
+    m_budget -= bytes;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QAtomicInt>
+
+#include "util/duration.h"
+
+/// Token bucket that limits the OutputReport traffic of a HidIoThread.
+/// The budget is refilled with the limit per second and holds at most one
+/// second of traffic, which allows short bursts, e.g. after all LEDs have
+/// been updated at once.
+class HidIoOutputBandwidthLimiter {
+  public:
+    HidIoOutputBandwidthLimiter();
+
+    /// Can be called from any thread, 0 means unlimited
+    void setLimit(int bytesPerSecond);
+    int limit() const;
+
+    /// Called from the run loop. Refills the budget for the time elapsed
+    /// since the last call and returns true if a report may be sent.
+    bool isBudgetAvailable(mixxx::Duration now);
+
+    /// Called from the run loop after a report has been sent
+    void consume(int bytes);
+
+  private:
+    QAtomicInt m_limit;
+    /// Remaining bytes that may be sent, only accessed by the run loop
+    double m_budget;
+    mixxx::Duration m_budgetTime;
+};
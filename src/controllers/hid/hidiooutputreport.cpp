@@ -4,6 +4,7 @@
 
 #include "controllers/defs_controllers.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
+#include "util/compatibility/qatomic.h"
 #include "util/compatibility/qbytearray.h"
 #include "util/string.h"
 #include "util/time.h"
@@ -38,6 +39,7 @@ void HidIoOutputReport::updateCachedData(const QByteArray& data,
 
     } else {
         if (m_possiblyUnsentDataCached) {
+            m_supersededReports.fetchAndAddRelaxed(1);
             qCDebug(logOutput) << "t:" << mixxx::Time::elapsed().formatMillisWithUnit()
                                << "Skipped superseded OutputReport"
                                << deviceInfo.formatName() << "serial #"
@@ -95,6 +97,7 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
 
         cacheLock.unlock();
 
+        m_skippedIdenticalReports.fetchAndAddRelaxed(1);
         qCDebug(logOutput) << "t:" << startOfHidWrite.formatMillisWithUnit()
                            << " Skipped identical Output Report for"
                            << deviceInfo.formatName() << "serial #"
@@ -119,9 +122,7 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
 
     // hid_write can take several milliseconds, because hidapi synchronizes
     // the asyncron HID communication from the OS
-    int result = hid_write(pHidDevice,
-            reinterpret_cast<const unsigned char*>(m_lastSentData.constData()),
-            m_lastSentData.size());
+    int result = writeReport(pHidDevice, m_lastSentData);
     if (result == -1) {
         qCWarning(logOutput) << "Unable to send data to" << deviceInfo.formatName() << ":"
                              << mixxx::convertWCStringToQString(
@@ -146,6 +147,7 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
         return true;
     }
 
+    m_bytesSent.fetchAndAddRelaxed(result);
     qCDebug(logOutput) << "t:" << startOfHidWrite.formatMillisWithUnit() << " "
                        << result << "bytes sent to" << deviceInfo.formatName()
                        << "serial #" << deviceInfo.serialNumber()
@@ -155,3 +157,17 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
     // Return with true, to signal the caller, that the time consuming hid_write operation was executed
     return true;
 }
+
+int HidIoOutputReport::writeReport(hid_device* pHidDevice, const QByteArray& reportData) {
+    return hid_write(pHidDevice,
+            reinterpret_cast<const unsigned char*>(reportData.constData()),
+            reportData.size());
+}
+
+HidIoOutputStatistics HidIoOutputReport::statistics() const {
+    HidIoOutputStatistics statistics;
+    statistics.bytesSent = atomicLoadRelaxed(m_bytesSent);
+    statistics.skippedIdenticalReports = atomicLoadRelaxed(m_skippedIdenticalReports);
+    statistics.supersededReports = atomicLoadRelaxed(m_supersededReports);
+    return statistics;
+}
@@ -1,13 +1,25 @@
 #pragma once
 
+#include <QAtomicInteger>
+
 #include "controllers/controller.h"
 #include "controllers/hid/hiddevice.h"
 #include "util/compatibility/qmutex.h"
 #include "util/duration.h"
 
+/// Output counters of one or more OutputReports
+struct HidIoOutputStatistics {
+    quint32 bytesSent = 0;
+    /// Reports not sent, because the data were identical to the last sent data
+    quint32 skippedIdenticalReports = 0;
+    /// Reports replaced by newer data for the same report before sending
+    quint32 supersededReports = 0;
+};
+
 class HidIoOutputReport {
   public:
     HidIoOutputReport(const quint8& reportId, const unsigned int& reportDataSize);
+    virtual ~HidIoOutputReport() = default;
 
     /// Caches new report data, which will later send by the IO thread
     void updateCachedData(const QByteArray& data,
@@ -23,6 +35,14 @@ class HidIoOutputReport {
             const mixxx::hid::DeviceInfo& deviceInfo,
             const RuntimeLoggingCategory& logOutput);
 
+    /// Returns the counters since construction, can be called from any thread
+    HidIoOutputStatistics statistics() const;
+
+  protected:
+    /// Writes the report data including the report ID to the device.
+    /// Returns the number of bytes written or -1 on error.
+    virtual int writeReport(hid_device* pHidDevice, const QByteArray& reportData);
+
   private:
     const quint8 m_reportId;
     QByteArray m_lastSentData;
@@ -38,4 +58,8 @@ class HidIoOutputReport {
     /// Due to swapping of the QbyteArrays, we need to store
     /// this information independent of the QBytearray size
     int m_lastCachedDataSize;
+
+    QAtomicInteger<quint32> m_bytesSent;
+    QAtomicInteger<quint32> m_skippedIdenticalReports;
+    QAtomicInteger<quint32> m_supersededReports;
 };
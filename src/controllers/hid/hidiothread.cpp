@@ -69,7 +69,7 @@ void HidIoThread::run() {
         // for the backend/kernel for confirmation of success
         // Depending on the OS this takes several several milli seconds
         // This operation doesn't take many CPU cycles, most time HIDAPI is in idle state
-        if (!sendNextCachedOutputReport()) {
+        if (!isOutputBandwidthBudgetAvailable() || !sendNextCachedOutputReport()) {
             if (testAndSetThreadState(HidIoThreadState::StopWhenAllReportsSent,
                         HidIoThreadState::Stopped)) {
                 break;
@@ -227,8 +227,12 @@ bool HidIoThread::sendNextCachedOutputReport() {
         // by std::map<Key,T,Compare,Allocator>::operator[]
         // The standard says that "No iterators or references are invalidated." using this operator.
         // Therefore m_outputReportIterator doesn't require Mutex protection.
-        if (m_outputReportIterator->second->sendCachedData(
+        HidIoOutputReport* pOutputReport = m_outputReportIterator->second.get();
+        const quint32 bytesSentBefore = pOutputReport->statistics().bytesSent;
+        if (pOutputReport->sendCachedData(
                     &m_hidDeviceAndPollMutex, m_pHidDevice, m_deviceInfo, m_logOutput)) {
+            m_outputBandwidthLimiter.consume(
+                    pOutputReport->statistics().bytesSent - bytesSentBefore);
             // Return after each time consuming sendCachedData
             return true;
         }
@@ -237,6 +241,32 @@ bool HidIoThread::sendNextCachedOutputReport() {
     return false;
 }
 
+bool HidIoThread::isOutputBandwidthBudgetAvailable() {
+    if (m_state.loadAcquire() ==
+            static_cast<int>(HidIoThreadState::StopWhenAllReportsSent)) {
+        // The last reports on shutdown are always sent
+        return true;
+    }
+    return m_outputBandwidthLimiter.isBudgetAvailable(mixxx::Time::elapsed());
+}
+
+void HidIoThread::setOutputBandwidthLimit(int bytesPerSecond) {
+    m_outputBandwidthLimiter.setLimit(bytesPerSecond);
+}
+
+HidIoOutputStatistics HidIoThread::outputStatistics() {
+    HidIoOutputStatistics sum;
+    auto mapLock = lockMutex(&m_outputReportMapMutex);
+    for (const auto& [reportId, pOutputReport] : m_outputReports) {
+        Q_UNUSED(reportId);
+        const HidIoOutputStatistics statistics = pOutputReport->statistics();
+        sum.bytesSent += statistics.bytesSent;
+        sum.skippedIdenticalReports += statistics.skippedIdenticalReports;
+        sum.supersededReports += statistics.supersededReports;
+    }
+    return sum;
+}
+
 void HidIoThread::sendFeatureReport(
         quint8 reportID, const QByteArray& reportData) {
     auto startOfHidSendFeatureReport = mixxx::Time::elapsed();
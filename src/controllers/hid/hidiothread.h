@@ -7,6 +7,7 @@
 
 #include "controllers/controller.h"
 #include "controllers/hid/hiddevice.h"
+#include "controllers/hid/hidiooutputbandwidthlimiter.h"
 #include "controllers/hid/hidiooutputreport.h"
 #include "util/compatibility/qmutex.h"
 #include "util/duration.h"
@@ -49,12 +50,21 @@ class HidIoThread : public QThread {
     void sendFeatureReport(quint8 reportID, const QByteArray& reportData);
     QByteArray getFeatureReport(quint8 reportID);
 
+    /// Returns the sum of the counters of all OutputReports
+    HidIoOutputStatistics outputStatistics();
+
+    /// Limits the OutputReport traffic to the device, 0 means unlimited.
+    /// Reports that are updated while the budget is exhausted are coalesced
+    /// and sent when the budget allows it again.
+    void setOutputBandwidthLimit(int bytesPerSecond);
+
   signals:
     /// Signals that a HID InputReport received by Interrupt triggered from HID device
     void receive(const QByteArray& data, mixxx::Duration timestamp);
 
   private:
     bool sendNextCachedOutputReport();
+    bool isOutputBandwidthBudgetAvailable();
 
     void pollBufferedInputReports();
     void processInputReport(int bytesRead);
@@ -92,6 +102,8 @@ class HidIoThread : public QThread {
     OutputReportMap m_outputReports;
     OutputReportMap::iterator m_outputReportIterator;
 
+    HidIoOutputBandwidthLimiter m_outputBandwidthLimiter;
+
     /// State of the HidIoThread lifecycle
     QAtomicInt m_state;
 
@@ -1,5 +1,6 @@
 #include "controllers/midi/midicontroller.h"
 
+#include "control/control.h"
 #include "control/controlobject.h"
 #include "controllers/defs_controllers.h"
 #include "controllers/midi/midiutils.h"
@@ -10,8 +11,28 @@
 #include "util/math.h"
 #include "util/screensaver.h"
 
+namespace {
+
+// Only keys of well-formed messages are compiled, i.e. a status byte with
+// the MSB set and either a data byte without or 0xFF if the second byte is
+// part of the payload (see MidiKey).
+constexpr int kNumCompiledControls = 128 + 1;
+constexpr int kNumCompiledKeys = 128 * kNumCompiledControls;
+
+inline bool isCompiledKey(MidiKey key) {
+    return (key.status & 0x80) && (!(key.control & 0x80) || key.control == 0xFF);
+}
+
+inline int compiledKeyIndex(MidiKey key) {
+    return (key.status & 0x7F) * kNumCompiledControls +
+            (key.control == 0xFF ? 128 : key.control);
+}
+
+} // namespace
+
 MidiController::MidiController(const QString& deviceName)
-        : Controller(deviceName) {
+        : Controller(deviceName),
+          m_compiledInputMappingsDirty(true) {
     setDeviceCategory(tr("MIDI Controller"));
 }
 
@@ -31,6 +52,7 @@ QString MidiController::mappingExtension() {
 
 void MidiController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMapping = downcastAndTakeOwnership<LegacyMidiControllerMapping>(std::move(pMapping));
+    m_compiledInputMappingsDirty = true;
 }
 
 std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
@@ -207,6 +229,49 @@ void MidiController::commitTemporaryInputMappings() {
         m_pMapping->addInputMapping(it.key(), it.value());
     }
     m_temporaryInputMappings.clear();
+    m_compiledInputMappingsDirty = true;
+}
+
+void MidiController::compileInputMappings() {
+    m_compiledInputMappingsDirty = false;
+    m_compiledInputMappings.clear();
+    m_compiledInputMappingOffsets.assign(kNumCompiledKeys + 1, 0);
+    if (!m_pMapping) {
+        return;
+    }
+    const auto& inputMappings = m_pMapping->getInputMappings();
+
+    // Count the mappings per key first, the offsets are the prefix sums
+    for (auto it = inputMappings.constBegin(); it != inputMappings.constEnd(); ++it) {
+        MidiKey key;
+        key.key = it.key();
+        if (isCompiledKey(key)) {
+            ++m_compiledInputMappingOffsets[compiledKeyIndex(key) + 1];
+        }
+    }
+    for (int i = 0; i < kNumCompiledKeys; ++i) {
+        m_compiledInputMappingOffsets[i + 1] += m_compiledInputMappingOffsets[i];
+    }
+
+    // Mappings with the same key keep the order in which they are processed
+    // by the hash lookup in receivedShortMessage().
+    m_compiledInputMappings.resize(m_compiledInputMappingOffsets[kNumCompiledKeys]);
+    std::vector<uint32_t> nextIndex(m_compiledInputMappingOffsets.begin(),
+            m_compiledInputMappingOffsets.end() - 1);
+    for (auto it = inputMappings.constBegin(); it != inputMappings.constEnd(); ++it) {
+        MidiKey key;
+        key.key = it.key();
+        if (!isCompiledKey(key)) {
+            continue;
+        }
+        const MidiInputMapping& mapping = it.value();
+        CompiledInputMapping& compiled =
+                m_compiledInputMappings[nextIndex[compiledKeyIndex(key)]++];
+        compiled.mapping = mapping;
+        if (!mapping.options.testFlag(MidiOption::Script)) {
+            compiled.control = ControlDoublePrivate::resolveHandle(mapping.control);
+        }
+    }
 }
 
 void MidiController::receivedShortMessage(unsigned char status,
@@ -238,19 +303,44 @@ void MidiController::receivedShortMessage(unsigned char status,
         auto it = m_temporaryInputMappings.constFind(mappingKey.key);
         if (it != m_temporaryInputMappings.constEnd()) {
             for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), status, control, value, timestamp);
+                processInputMapping(it.value(),
+                        ControlHandle(),
+                        status,
+                        control,
+                        value,
+                        timestamp);
             }
             return;
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    if (isCompiledKey(mappingKey)) {
+        if (m_compiledInputMappingsDirty) {
+            compileInputMappings();
+        }
+        const int index = compiledKeyIndex(mappingKey);
+        for (uint32_t i = m_compiledInputMappingOffsets[index];
+                i < m_compiledInputMappingOffsets[index + 1];
+                ++i) {
+            const CompiledInputMapping& compiled = m_compiledInputMappings[i];
+            processInputMapping(compiled.mapping,
+                    compiled.control,
+                    status,
+                    control,
+                    value,
+                    timestamp);
+        }
+    } else {
+        auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
+        for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key;
+                ++it) {
+            processInputMapping(it.value(), ControlHandle(), status, control, value, timestamp);
+        }
     }
 }
 
 void MidiController::processInputMapping(const MidiInputMapping& mapping,
+                                         ControlHandle controlHandle,
                                          unsigned char status,
                                          unsigned char control,
                                          unsigned char value,
@@ -280,9 +370,15 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
     }
 
     // Only pass values on to valid ControlObjects.
-    ControlObject* pCO = ControlObject::getControl(mapping.control);
+    ControlObject* pCO = controlHandle.valid()
+            ? ControlObject::getControl(controlHandle, ControlFlag::NoWarnIfMissing)
+            : nullptr;
     if (pCO == nullptr) {
-        return;
+        // Also handles the warning if the control does not exist
+        pCO = ControlObject::getControl(mapping.control);
+        if (pCO == nullptr) {
+            return;
+        }
     }
 
     double newValue = value;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+
+#include "control/controlhandle.h"
 #include "controllers/controller.h"
 #include "controllers/midi/legacymidicontrollermapping.h"
 #include "controllers/midi/legacymidicontrollermappingfilehandler.h"
@@ -71,8 +74,14 @@ class MidiController : public Controller {
     void commitTemporaryInputMappings();
 
   private:
+    /// Resolves the controls of all input mappings to handles and sorts the
+    /// mappings into a table indexed by the status and control byte, so a
+    /// message is dispatched without hashing any strings.
+    void compileInputMappings();
+
     void processInputMapping(
             const MidiInputMapping& mapping,
+            ControlHandle controlHandle,
             unsigned char status,
             unsigned char control,
             unsigned char value,
@@ -87,6 +96,18 @@ class MidiController : public Controller {
     void updateAllOutputs();
     void destroyOutputHandlers();
 
+    struct CompiledInputMapping {
+        MidiInputMapping mapping;
+        // Invalid for script mappings
+        ControlHandle control;
+    };
+    // The compiled mappings, grouped by MIDI key
+    std::vector<CompiledInputMapping> m_compiledInputMappings;
+    // m_compiledInputMappings[m_compiledInputMappingOffsets[i]] is the first
+    // mapping for compiled key index i, the range ends at index i + 1.
+    std::vector<uint32_t> m_compiledInputMappingOffsets;
+    bool m_compiledInputMappingsDirty;
+
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
     QList<MidiOutputHandler*> m_outputs;
     std::shared_ptr<LegacyMidiControllerMapping> m_pMapping;
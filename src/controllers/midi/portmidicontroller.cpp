@@ -1,7 +1,11 @@
 #include "controllers/midi/portmidicontroller.h"
 
+#include <porttime.h>
+
 #include "controllers/midi/midiutils.h"
+#include "controllers/midi/portmidiinputthread.h"
 #include "moc_portmidicontroller.cpp"
+#include "util/time.h"
 
 namespace {
 const QString kUnknownControllerName = QStringLiteral("Unknown PortMidiController");
@@ -16,6 +20,7 @@ PortMidiController::PortMidiController(const PmDeviceInfo* inputDeviceInfo,
                                             ? inputDeviceInfo->name
                                             : outputDeviceInfo->name)
                           : kUnknownControllerName),
+          m_bUseInputThread(true),
           m_cReceiveMsg_index(0),
           m_bInSysex(false) {
     for (unsigned int k = 0; k < MIXXX_PORTMIDI_BUFFER_LEN; ++k) {
@@ -68,6 +73,19 @@ int PortMidiController::open() {
             qCWarning(m_logBase) << "PortMidi error:" << Pm_GetErrorText(err);
             return -2;
         }
+
+        if (m_bUseInputThread) {
+            m_pInputThread = std::make_unique<PortMidiInputThread>(
+                    m_pInputDevice.data(), m_logInput);
+            m_pInputThread->setObjectName(QStringLiteral("PortMidi ") + getName());
+            // The events are processed in the thread of the controller
+            connect(m_pInputThread.get(),
+                    &PortMidiInputThread::eventsReceived,
+                    this,
+                    &PortMidiController::slotEventsReceived,
+                    Qt::QueuedConnection);
+            m_pInputThread->start(QThread::HighPriority);
+        }
     }
     if (m_pOutputDevice && isOutputDevice()) {
         qCInfo(m_logBase) << "PortMidiController: Opening"
@@ -97,6 +115,12 @@ int PortMidiController::close() {
 
     int result = 0;
 
+    if (m_pInputThread) {
+        // The input device must not be read anymore when it is closed
+        m_pInputThread->stop();
+        m_pInputThread.reset();
+    }
+
     if (m_pInputDevice && m_pInputDevice->isOpen()) {
         PmError err = m_pInputDevice->close();
         if (err != pmNoError) {
@@ -132,9 +156,29 @@ bool PortMidiController::poll() {
         return false;
     }
 
+    processInputEvents(m_midiBuffer, numEvents);
+    return numEvents > 0;
+}
+
+void PortMidiController::slotEventsReceived(const QVector<PmEvent>& events) {
+    // Events that are still queued when the device has been closed are dropped
+    if (!isOpen()) {
+        return;
+    }
+    processInputEvents(events.constData(), events.size());
+}
+
+void PortMidiController::processInputEvents(const PmEvent* events, int numEvents) {
+    // PortMidi timestamps are based on PortTime. Convert them to the time base
+    // of mixxx::Time, so the input latency of all controllers is comparable.
+    const mixxx::Duration portTimeOffset =
+            mixxx::Time::elapsed() - mixxx::Duration::fromMillis(Pt_Time());
+
     for (int i = 0; i < numEvents; i++) {
-        unsigned char status = Pm_MessageStatus(m_midiBuffer[i].message);
-        mixxx::Duration timestamp = mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp);
+        unsigned char status = Pm_MessageStatus(events[i].message);
+        mixxx::Duration timestamp =
+                mixxx::Duration::fromMillis(events[i].timestamp) +
+                portTimeOffset;
 
         if ((status & 0xF8) == 0xF8) {
             // Handle real-time MIDI messages at any time
@@ -150,8 +194,8 @@ bool PortMidiController::poll() {
                 status = 0;
             } else {
                 //unsigned char channel = status & 0x0F;
-                unsigned char note = Pm_MessageData1(m_midiBuffer[i].message);
-                unsigned char velocity = Pm_MessageData2(m_midiBuffer[i].message);
+                unsigned char note = Pm_MessageData1(events[i].message);
+                unsigned char velocity = Pm_MessageData2(events[i].message);
                 receivedShortMessage(status, note, velocity, timestamp);
             }
         }
@@ -174,7 +218,7 @@ bool PortMidiController::poll() {
                 // TODO(rryan): This prevents buffer overflow if the sysex is
                 // larger than 1024 bytes. I don't want to radically change
                 // anything before the 2.0 release so this will do for now.
-                data = (m_midiBuffer[i].message >> shift) & 0xFF;
+                data = (events[i].message >> shift) & 0xFF;
                 if (m_cReceiveMsg_index < MIXXX_SYSEX_BUFFER_LEN) {
                     m_cReceiveMsg[m_cReceiveMsg_index++] = data;
                 }
@@ -190,7 +234,6 @@ bool PortMidiController::poll() {
             }
         }
     }
-    return numEvents > 0;
 }
 
 void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
@@ -3,10 +3,14 @@
 #include <portmidi.h>
 
 #include <QScopedPointer>
+#include <QVector>
+#include <memory>
 
 #include "controllers/midi/midicontroller.h"
 #include "controllers/midi/portmididevice.h"
 
+class PortMidiInputThread;
+
 // Note:
 // A standard Midi device runs at 31.25 kbps, with 10 bits / byte
 // 1 byte / 320 microseconds
@@ -55,6 +59,10 @@ class PortMidiController : public MidiController {
             int outputDeviceIndex);
     ~PortMidiController() override;
 
+  public slots:
+    /// Processes the events read by the PortMidiInputThread.
+    void slotEventsReceived(const QVector<PmEvent>& events);
+
   private slots:
     int open() override;
     int close() override;
@@ -70,10 +78,15 @@ class PortMidiController : public MidiController {
     // 0xf7.
     void sendBytes(const QByteArray& data) override;
 
+    /// The input is only polled by the ControllerManager if it is not read
+    /// by a PortMidiInputThread.
     bool isPolling() const override {
-        return true;
+        return !m_pInputThread;
     }
 
+    /// Parses the events read from the input device and dispatches them.
+    void processInputEvents(const PmEvent* events, int numEvents);
+
     // For testing only so that test fixtures can install mock PortMidiDevices.
     void setPortMidiInputDevice(PortMidiDevice* device) {
         m_pInputDevice.reset(device);
@@ -81,10 +94,18 @@ class PortMidiController : public MidiController {
     void setPortMidiOutputDevice(PortMidiDevice* device) {
         m_pOutputDevice.reset(device);
     }
+    // For testing only so that test fixtures can control when the input
+    // device is read.
+    void setUseInputThread(bool useInputThread) {
+        m_bUseInputThread = useInputThread;
+    }
 
     QScopedPointer<PortMidiDevice> m_pInputDevice;
     QScopedPointer<PortMidiDevice> m_pOutputDevice;
 
+    bool m_bUseInputThread;
+    std::unique_ptr<PortMidiInputThread> m_pInputThread;
+
     PmEvent m_midiBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
 
     // Storage for SysEx messages
@@ -2,6 +2,8 @@
 
 #include <portmidi.h>
 
+#include "util/compatibility/qmutex.h"
+
 class PortMidiDevice {
   public:
     PortMidiDevice(const PmDeviceInfo* deviceInfo,
@@ -27,6 +29,7 @@ class PortMidiDevice {
     }
 
     virtual PmError openInput(int32_t bufferSize) {
+        const auto locker = lockMutex(portMidiMutex());
         return Pm_OpenInput(&m_pStream, m_deviceIndex,
                             NULL, // no drive hacks
                             bufferSize,
@@ -35,6 +38,7 @@ class PortMidiDevice {
     }
 
     virtual PmError openOutput() {
+        const auto locker = lockMutex(portMidiMutex());
         return Pm_OpenOutput(&m_pStream,
                              m_deviceIndex,
                              NULL, // No driver hacks
@@ -45,28 +49,47 @@ class PortMidiDevice {
     }
 
     virtual PmError close() {
+        const auto locker = lockMutex(portMidiMutex());
         PmError err = Pm_Close(m_pStream);
         m_pStream = NULL;
         return err;
     }
 
     virtual PmError poll() {
+        const auto locker = lockMutex(portMidiMutex());
         return Pm_Poll(m_pStream);
     }
 
     virtual int read(PmEvent* buffer, int32_t length) {
+        const auto locker = lockMutex(portMidiMutex());
         return Pm_Read(m_pStream, buffer, length);
     }
 
     virtual PmError writeShort(int32_t message) {
+        const auto locker = lockMutex(portMidiMutex());
         return Pm_WriteShort(m_pStream, 0, message);
     }
 
     virtual PmError writeSysEx(unsigned char* message) {
+        const auto locker = lockMutex(portMidiMutex());
         return Pm_WriteSysEx(m_pStream, 0, message);
     }
 
   private:
+    /// PortMidi is not thread-safe, but the input of a device is read by a
+    /// PortMidiInputThread while output is sent from the controller thread.
+    ///
+    /// The mutex has to be global rather than per stream: PortMidi keeps
+    /// global state that is shared by all streams. Opening and closing
+    /// modify the global descriptor table, and some backends (e.g. ALSA)
+    /// read the input of all devices from a single sequencer handle, which
+    /// is drained by Pm_Read/Pm_Poll of any stream. All calls are
+    /// non-blocking, so they are only held for a short time.
+    static QMutex* portMidiMutex() {
+        static QMutex s_mutex;
+        return &s_mutex;
+    }
+
     const PmDeviceInfo* m_pDeviceInfo;
     int m_deviceIndex;
     PortMidiStream* m_pStream;
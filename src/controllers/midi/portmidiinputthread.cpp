@@ -0,0 +1,84 @@
+#include "controllers/midi/portmidiinputthread.h"
+
+#include <algorithm>
+
+#include "controllers/midi/portmidicontroller.h"
+#include "controllers/midi/portmididevice.h"
+#include "moc_portmidiinputthread.cpp"
+
+namespace {
+
+// Upper limit of the latency added by this thread to the first message after
+// a pause, which is about the time it takes to transmit a 3 byte message at
+// MIDI speed. PortMidi has neither a blocking read nor a handle of the
+// underlying ALSA/CoreMIDI/WinMM input that could be waited on, so the
+// device is read after sleeping at most this long.
+constexpr unsigned long kLatencyTargetMicros = 1000;
+
+// Sleep time of the run loop when no messages are available while the
+// device is in use. This is well below the ~320 us it takes to transmit a
+// single byte at MIDI speed, so the latency added by this thread is
+// negligible.
+constexpr unsigned long kMinSleepTimeWhenIdleMicros = 250;
+
+// Upper limit of the sleep time when the device has been idle for a while.
+// This halves the number of wakeups of an unused device without exceeding the
+// latency target.
+constexpr unsigned long kMaxSleepTimeWhenIdleMicros = kLatencyTargetMicros;
+static_assert(kMinSleepTimeWhenIdleMicros <= kMaxSleepTimeWhenIdleMicros);
+
+// Time without any messages until the sleep time is increased. Messages of a
+// knob or fader that is moved arrive much more frequently.
+constexpr unsigned long kIdleTimeBeforeBackoffMicros = 100000;
+
+// Sleep time after an error, to prevent spamming the log
+constexpr unsigned long kSleepTimeAfterErrorMillis = 100;
+
+} // namespace
+
+PortMidiInputThread::PortMidiInputThread(PortMidiDevice* pInputDevice,
+        const RuntimeLoggingCategory& logger)
+        : m_pInputDevice(pInputDevice),
+          m_logger(logger) {
+    qRegisterMetaType<QVector<PmEvent>>("QVector<PmEvent>");
+}
+
+PortMidiInputThread::~PortMidiInputThread() {
+    stop();
+}
+
+void PortMidiInputThread::stop() {
+    m_stopRequested.storeRelease(1);
+    wait();
+}
+
+void PortMidiInputThread::run() {
+    PmEvent buffer[MIXXX_PORTMIDI_BUFFER_LEN];
+    unsigned long sleepTimeMicros = kMinSleepTimeWhenIdleMicros;
+    unsigned long idleTimeMicros = 0;
+    while (!m_stopRequested.loadAcquire()) {
+        const int numEvents = m_pInputDevice->read(buffer, MIXXX_PORTMIDI_BUFFER_LEN);
+        if (numEvents < 0) {
+            qCWarning(m_logger) << "PortMidi error:"
+                                << Pm_GetErrorText(static_cast<PmError>(numEvents));
+            msleep(kSleepTimeAfterErrorMillis);
+            continue;
+        }
+        if (numEvents == 0) {
+            usleep(sleepTimeMicros);
+            idleTimeMicros += sleepTimeMicros;
+            if (idleTimeMicros >= kIdleTimeBeforeBackoffMicros) {
+                sleepTimeMicros = std::min(sleepTimeMicros * 2, kMaxSleepTimeWhenIdleMicros);
+            }
+            continue;
+        }
+        sleepTimeMicros = kMinSleepTimeWhenIdleMicros;
+        idleTimeMicros = 0;
+        QVector<PmEvent> events;
+        events.reserve(numEvents);
+        for (int i = 0; i < numEvents; ++i) {
+            events.append(buffer[i]);
+        }
+        emit eventsReceived(events);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <portmidi.h>
+
+#include <QAtomicInt>
+#include <QMetaType>
+#include <QThread>
+#include <QVector>
+
+#include "util/runtimeloggingcategory.h"
+
+class PortMidiDevice;
+
+Q_DECLARE_METATYPE(PmEvent)
+
+/// Reads the input of a PortMidi device in a thread of its own.
+///
+/// PortMidi has no blocking read, so the device used to be polled together
+/// with all other controllers by the ControllerManager poll timer, with an
+/// interval of up to 5 ms. This thread checks the device far more
+/// frequently while it is in use, so new messages are picked up (and
+/// timestamped by PortMidi) almost immediately. When no messages arrive for
+/// a while, the sleep time in between is increased up to 1 ms to keep the
+/// wakeups of idle devices low, which still picks up the first message after
+/// a pause within the transmission time of a single MIDI message. All messages read at once are handed over
+/// to the controller as a single batch.
+class PortMidiInputThread : public QThread {
+    Q_OBJECT
+  public:
+    PortMidiInputThread(PortMidiDevice* pInputDevice,
+            const RuntimeLoggingCategory& logger);
+    ~PortMidiInputThread() override;
+
+    /// Stops the run loop and waits until the thread has finished. The input
+    /// device must not be closed before.
+    void stop();
+
+  signals:
+    void eventsReceived(const QVector<PmEvent>& events);
+
+  protected:
+    void run() override;
+
+  private:
+    PortMidiDevice* const m_pInputDevice;
+    const RuntimeLoggingCategory m_logger;
+    QAtomicInt m_stopRequested;
+};
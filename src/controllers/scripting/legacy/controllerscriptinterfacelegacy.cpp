@@ -1,5 +1,6 @@
 #include "controllerscriptinterfacelegacy.h"
 
+#include "control/control.h"
 #include "control/controlobject.h"
 #include "control/controlobjectscript.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
@@ -125,13 +126,83 @@ void ControllerScriptInterfaceLegacy::setValue(
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl &&
-                !m_st.ignore(
-                        pControl, coScript->getParameterForValue(newValue))) {
-            coScript->set(newValue);
+        setValueInternal(coScript, ControlHandle(), newValue);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setValueInternal(
+        ControlObjectScript* coScript, ControlHandle handle, double newValue) {
+    ControlObject* pControl = handle.valid()
+            ? ControlObject::getControl(handle, ControlFlag::AllowMissingOrInvalid)
+            : ControlObject::getControl(
+                      coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
+    if (pControl &&
+            !m_st.ignore(
+                    pControl, coScript->getParameterForValue(newValue))) {
+        coScript->set(newValue);
+    }
+}
+
+int ControllerScriptInterfaceLegacy::getControlHandle(
+        const QString& group, const QString& name) {
+    const ConfigKey key(group, name);
+    const auto it = m_scriptControlHandleIndices.constFind(key);
+    if (it != m_scriptControlHandleIndices.constEnd()) {
+        return it.value();
+    }
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+    if (coScript == nullptr) {
+        qCWarning(m_logger) << "Unknown control" << group << name
+                            << ", returning invalid handle -1";
+        return -1;
+    }
+    const int index = m_scriptControlHandles.size();
+    m_scriptControlHandles.append(ScriptControlHandle{
+            coScript, ControlDoublePrivate::resolveHandle(key)});
+    m_scriptControlHandleIndices.insert(key, index);
+    return index;
+}
+
+QList<double> ControllerScriptInterfaceLegacy::getValues(const QList<int>& handles) {
+    QList<double> values;
+    values.reserve(handles.size());
+    for (const int handle : handles) {
+        if (handle < 0 || handle >= m_scriptControlHandles.size()) {
+            qCWarning(m_logger) << "Invalid control handle" << handle
+                                << ", returning 0.0";
+            values.append(0.0);
+            continue;
+        }
+        values.append(m_scriptControlHandles.at(handle).pControlScript->get());
+    }
+    return values;
+}
+
+void ControllerScriptInterfaceLegacy::setValues(
+        const QList<int>& handles, const QList<double>& values) {
+    if (handles.size() != values.size()) {
+        m_pScriptEngineLegacy->throwJSError(
+                QStringLiteral("engine.setValues: got %1 handles but %2 values")
+                        .arg(QString::number(handles.size()),
+                                QString::number(values.size())));
+        return;
+    }
+    for (int i = 0; i < handles.size(); ++i) {
+        const int handle = handles.at(i);
+        if (handle < 0 || handle >= m_scriptControlHandles.size()) {
+            qCWarning(m_logger) << "Invalid control handle" << handle
+                                << ", ignoring.";
+            continue;
+        }
+        const ScriptControlHandle& control = m_scriptControlHandles.at(handle);
+        const double newValue = values.at(i);
+        if (util_isnan(newValue)) {
+            qCWarning(m_logger) << "script setting [" << control.pControlScript->getKey().group
+                                << "," << control.pControlScript->getKey().item
+                                << "] to NotANumber, ignoring.";
+            continue;
         }
+        setValueInternal(control.pControlScript, control.control, newValue);
     }
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <QJSValue>
+#include <QList>
 #include <QObject>
+#include <QVector>
 
+#include "control/controlhandle.h"
 #include "controllers/softtakeover.h"
 #include "util/alphabetafilter.h"
 #include "util/runtimeloggingcategory.h"
@@ -24,6 +27,14 @@ class ControllerScriptInterfaceLegacy : public QObject {
 
     Q_INVOKABLE double getValue(const QString& group, const QString& name);
     Q_INVOKABLE void setValue(const QString& group, const QString& name, double newValue);
+    /// Resolves a control for getValues() and setValues(). Returns -1 if
+    /// the control does not exist.
+    Q_INVOKABLE int getControlHandle(const QString& group, const QString& name);
+    /// Reads the values of many controls with a single call from JS.
+    Q_INVOKABLE QList<double> getValues(const QList<int>& handles);
+    /// Sets the values of many controls with a single call from JS. Each
+    /// value is handled like by setValue().
+    Q_INVOKABLE void setValues(const QList<int>& handles, const QList<double>& values);
     Q_INVOKABLE double getParameter(const QString& group, const QString& name);
     Q_INVOKABLE void setParameter(const QString& group, const QString& name, double newValue);
     Q_INVOKABLE double getParameterForValue(
@@ -82,6 +93,17 @@ class ControllerScriptInterfaceLegacy : public QObject {
             bool skipSuperseded = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    void setValueInternal(ControlObjectScript* coScript,
+            ControlHandle handle,
+            double newValue);
+
+    /// Controls resolved by getControlHandle(), the JS handle is the index
+    struct ScriptControlHandle {
+        ControlObjectScript* pControlScript;
+        ControlHandle control;
+    };
+    QVector<ScriptControlHandle> m_scriptControlHandles;
+    QHash<ConfigKey, int> m_scriptControlHandleIndices;
 
     SoftTakeoverCtrl m_st;
 
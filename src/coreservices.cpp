@@ -2,8 +2,13 @@
 
 #include <QApplication>
 #include <QFileDialog>
+#include <QFuture>
+#include <QMutex>
 #include <QPushButton>
 #include <QStandardPaths>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <functional>
 
 #ifdef __BROADCAST__
 #include "broadcast/broadcastmanager.h"
@@ -12,6 +17,10 @@
 #include "controllers/controllermanager.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
+#include "database/mixxxdbmaintenance.h"
+#ifdef __LILV__
+#include "effects/backends/lv2/lv2backend.h"
+#endif
 #include "effects/effectsmanager.h"
 #include "engine/enginemaster.h"
 #include "library/coverartcache.h"
@@ -26,8 +35,10 @@
 #include "soundio/soundmanager.h"
 #include "sources/soundsourceproxy.h"
 #include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/font.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
 #include "util/screensaver.h"
 #include "util/screensavermanager.h"
 #include "util/statsmanager.h"
@@ -92,6 +103,101 @@ Bool __xErrorHandler(Display* display, XErrorEvent* event, xError* error) {
 
 #endif
 
+// Executes the stages of the startup and reports how long each of them took.
+//
+// Stages that neither create QObjects nor access objects of the GUI thread
+// are started concurrently in a dedicated thread pool. All other stages are
+// executed in sequence on the GUI thread and join the concurrent stages they
+// depend on with waitFor().
+class StartupStages {
+  public:
+    StartupStages() {
+        // One thread per concurrent stage
+        m_threadPool.setMaxThreadCount(kMaxConcurrentStages);
+        m_timer.start();
+    }
+    ~StartupStages() {
+        m_threadPool.waitForDone();
+    }
+
+    void startConcurrent(
+            const QString& name,
+            std::function<bool()> stage) {
+        DEBUG_ASSERT(!m_stages.contains(name));
+        DEBUG_ASSERT(m_stages.size() < kMaxConcurrentStages);
+        m_stages.insert(name,
+                QtConcurrent::run(&m_threadPool,
+                        [this, name, stage = std::move(stage)] {
+                            PerformanceTimer timer;
+                            timer.start();
+                            const bool result = stage();
+                            report(name, timer.elapsed(), false);
+                            return result;
+                        }));
+    }
+
+    // Returns the result of a concurrent stage
+    bool waitFor(const QString& name) {
+        VERIFY_OR_DEBUG_ASSERT(m_stages.contains(name)) {
+            return false;
+        }
+        QFuture<bool> future = m_stages.value(name);
+        if (!future.isFinished()) {
+            PerformanceTimer timer;
+            timer.start();
+            future.waitForFinished();
+            report(QStringLiteral("waiting for ") + name, timer.elapsed(), true);
+        }
+        return future.result();
+    }
+
+    // Ends the previous stage on the GUI thread
+    void beginStage(const QString& name) {
+        endStage();
+        m_stageName = name;
+        m_stageTimer.start();
+    }
+
+    void endStage() {
+        if (!m_stageName.isEmpty()) {
+            report(m_stageName, m_stageTimer.elapsed(), true);
+            m_stageName.clear();
+        }
+    }
+
+    void logReport() {
+        const QMutexLocker locker(&m_reportMutex);
+        kLogger.info()
+                << "Startup took"
+                << m_timer.elapsed().debugMillisWithUnit();
+        for (const auto& line : std::as_const(m_report)) {
+            kLogger.info() << line;
+        }
+    }
+
+  private:
+    static constexpr int kMaxConcurrentStages = 8;
+
+    void report(const QString& name, mixxx::Duration duration, bool guiThread) {
+        const QMutexLocker locker(&m_reportMutex);
+        m_report.append(QStringLiteral("%1 %2: %3")
+                                .arg(guiThread ? QStringLiteral("[GUI]")
+                                               : QStringLiteral("[concurrent]"),
+                                        name,
+                                        duration.formatMillisWithUnit()));
+    }
+
+    QThreadPool m_threadPool;
+    QHash<QString, QFuture<bool>> m_stages;
+    PerformanceTimer m_timer;
+
+    QString m_stageName;
+    PerformanceTimer m_stageTimer;
+
+    QMutex m_reportMutex;
+    QStringList m_report;
+};
+
 inline QLocale inputLocale() {
     // Use the default config for local keyboard
     QInputMethod* pInputMethod = QGuiApplication::inputMethod();
@@ -233,26 +339,71 @@ void CoreServices::initialize(QApplication* pApp) {
 
     QString resourcePath = pConfig->getResourcePath();
 
-    emit initializationProgressUpdate(0, tr("fonts"));
+    m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
+    if (!m_pDbConnectionPool) {
+        exit(-1);
+    }
 
+    // Stages that are independent of each other and of the GUI thread are
+    // started first and joined right before the first stage that needs them.
+    auto schemaUpgradeResult = SchemaManager::Result::SchemaError;
+    StartupStages startupStages;
+
+    startupStages.startConcurrent(QStringLiteral("database"),
+            [pDbConnectionPool = m_pDbConnectionPool, &schemaUpgradeResult] {
+                kLogger.info() << "Connecting to database";
+                // Closes the connection of this thread afterwards
+                const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool);
+                const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
+                if (!dbConnection.isOpen()) {
+                    return false;
+                }
+                kLogger.info() << "Initializing or upgrading database schema";
+                schemaUpgradeResult = SchemaManager(dbConnection)
+                                              .upgradeToSchemaVersion(
+                                                      MixxxDb::kRequiredSchemaVersion,
+                                                      MixxxDb::kDefaultSchemaFile);
+                return true;
+            });
+#ifdef __LILV__
+    startupStages.startConcurrent(QStringLiteral("LV2 plugin discovery"), [] {
+        LV2Backend::preloadWorld();
+        return true;
+    });
+#endif
+#ifndef __WINDOWS__
+    // On Windows PortAudio must be terminated by the same thread
+    // that has initialized it
+    startupStages.startConcurrent(QStringLiteral("sound device enumeration"), [] {
+        SoundManager::preinitializePortAudio();
+        return true;
+    });
+#endif
+
+    // QFontDatabase must only be used by the GUI thread
+    emit initializationProgressUpdate(0, tr("fonts"));
+    startupStages.beginStage(QStringLiteral("fonts"));
     FontUtils::initializeFonts(resourcePath); // takes a long time
 
     emit initializationProgressUpdate(10, tr("database"));
-    m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
-    if (!m_pDbConnectionPool) {
+    startupStages.beginStage(QStringLiteral("database"));
+    const bool dbConnectionOpened = startupStages.waitFor(QStringLiteral("database"));
+    if (!initializeDatabase(dbConnectionOpened, schemaUpgradeResult)) {
         exit(-1);
     }
     // Create a connection for the main thread
     m_pDbConnectionPool->createThreadLocalConnection();
-    if (!initializeDatabase()) {
-        exit(-1);
-    }
+    m_pDbMaintenance = std::make_shared<MixxxDbMaintenance>(m_pDbConnectionPool);
 
     m_pControlIndicatorTimer = std::make_shared<mixxx::ControlIndicatorTimer>(this);
 
     auto pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
 
     emit initializationProgressUpdate(20, tr("effects"));
+    startupStages.beginStage(QStringLiteral("effects"));
+#ifdef __LILV__
+    startupStages.waitFor(QStringLiteral("LV2 plugin discovery"));
+#endif
     m_pEffectsManager = std::make_shared<EffectsManager>(pConfig, pChannelHandleFactory);
 
     m_pEngine = std::make_shared<EngineMaster>(
@@ -263,6 +414,10 @@ void CoreServices::initialize(QApplication* pApp) {
             true);
 
     emit initializationProgressUpdate(30, tr("audio interface"));
+    startupStages.beginStage(QStringLiteral("audio interface"));
+#ifndef __WINDOWS__
+    startupStages.waitFor(QStringLiteral("sound device enumeration"));
+#endif
     // Although m_pSoundManager is created here, m_pSoundManager->setupDevices()
     // needs to be called after m_pPlayerManager registers sound IO for each EngineChannel.
     m_pSoundManager = std::make_shared<SoundManager>(pConfig, m_pEngine.get());
@@ -283,6 +438,7 @@ void CoreServices::initialize(QApplication* pApp) {
 #endif
 
     emit initializationProgressUpdate(40, tr("decks"));
+    startupStages.beginStage(QStringLiteral("decks"));
     // Create the player manager. (long)
     m_pPlayerManager = std::make_shared<PlayerManager>(
             pConfig,
@@ -321,7 +477,18 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
+    startupStages.beginStage(QStringLiteral("library"));
     CoverArtCache::createInstance();
+    {
+        const int coverArtDiskCacheSizeMB = pConfig->getValue(
+                mixxx::library::prefs::kCoverArtDiskCacheSizeConfigKey,
+                mixxx::library::prefs::kCoverArtDiskCacheSizeDefault);
+        if (coverArtDiskCacheSizeMB > 0) {
+            CoverArtCache::instance()->enableDiskCache(
+                    QDir(pConfig->getSettingsPath()).filePath("coverart"),
+                    static_cast<qint64>(coverArtDiskCacheSizeMB) * 1024 * 1024);
+        }
+    }
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
             this,
@@ -364,6 +531,7 @@ void CoreServices::initialize(QApplication* pApp) {
     }
 
     emit initializationProgressUpdate(60, tr("controllers"));
+    startupStages.beginStage(QStringLiteral("controllers"));
     // Initialize controller sub-system,
     // but do not set up controllers until the end of the application startup
     // (long)
@@ -374,6 +542,8 @@ void CoreServices::initialize(QApplication* pApp) {
     // controllers
     m_pControllerManager->setUpDevices();
 
+    startupStages.beginStage(QStringLiteral("finishing"));
+
     // Scan the library for new files and directories
     bool rescan = pConfig->getValue<bool>(
             library::prefs::kRescanOnStartupConfigKey);
@@ -461,6 +631,9 @@ void CoreServices::initialize(QApplication* pApp) {
         }
     }
 
+    startupStages.endStage();
+    startupStages.logReport();
+
     m_isInitialized = true;
 }
 
@@ -526,10 +699,10 @@ void CoreServices::slotOptionsKeyboard(bool toggle) {
     }
 }
 
-bool CoreServices::initializeDatabase() {
-    kLogger.info() << "Connecting to database";
-    QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
-    if (!dbConnection.isOpen()) {
+bool CoreServices::initializeDatabase(
+        bool dbConnectionOpened,
+        SchemaManager::Result schemaUpgradeResult) {
+    if (!dbConnectionOpened) {
         QMessageBox::critical(nullptr,
                 tr("Cannot open database"),
                 tr("Unable to establish a database connection.\n"
@@ -541,8 +714,7 @@ bool CoreServices::initializeDatabase() {
         return false;
     }
 
-    kLogger.info() << "Initializing or upgrading database schema";
-    return MixxxDb::initDatabaseSchema(dbConnection);
+    return MixxxDb::checkSchemaUpgradeResult(schemaUpgradeResult);
 }
 
 void CoreServices::finalize() {
@@ -620,6 +792,11 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "detaching all track collections";
     CLEAR_AND_CHECK_DELETED(m_pTrackCollectionManager);
 
+    // Depends on the database connection pool. Must be stopped after all
+    // pending modifications have been saved by TrackCollectionManager.
+    qDebug() << t.elapsed(false).debugMillisWithUnit() << "stopping database maintenance";
+    CLEAR_AND_CHECK_DELETED(m_pDbMaintenance);
+
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "closing database connection(s)";
     m_pDbConnectionPool->destroyThreadLocalConnection();
     m_pDbConnectionPool.reset(); // should drop the last reference
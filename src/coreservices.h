@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "control/controlpushbutton.h"
+#include "database/schemamanager.h"
 #include "preferences/configobject.h"
 #include "preferences/constants.h"
 #include "preferences/settingsmanager.h"
@@ -26,6 +27,7 @@ class VinylControlManager;
 class TrackCollectionManager;
 class Library;
 class LV2Backend;
+class MixxxDbMaintenance;
 
 namespace mixxx {
 
@@ -116,7 +118,10 @@ class CoreServices : public QObject {
     void slotOptionsKeyboard(bool toggle);
 
   private:
-    bool initializeDatabase();
+    // Reports errors of the database stage of the startup
+    bool initializeDatabase(
+            bool dbConnectionOpened,
+            SchemaManager::Result schemaUpgradeResult);
     void initializeKeyboard();
     void initializeSettings();
     void initializeScreensaverManager();
@@ -142,6 +147,7 @@ class CoreServices : public QObject {
     std::shared_ptr<VinylControlManager> m_pVCManager;
 
     std::shared_ptr<DbConnectionPool> m_pDbConnectionPool;
+    std::shared_ptr<MixxxDbMaintenance> m_pDbMaintenance;
     std::shared_ptr<TrackCollectionManager> m_pTrackCollectionManager;
     std::shared_ptr<Library> m_pLibrary;
 
@@ -1,8 +1,10 @@
 #include "database/mixxxdb.h"
 
 #include <QDir>
+#include <QStorageInfo>
 
 #include "database/schemamanager.h"
+#include "library/library_prefs.h"
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
@@ -12,7 +14,7 @@
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 39;
+const int MixxxDb::kRequiredSchemaVersion = 42;
 
 namespace {
 
@@ -30,6 +32,60 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// Tuning of each connection. The page cache of SQLite is private per
+// connection and memory mapped I/O avoids copying pages from the page
+// cache of the OS.
+const QStringList kPragmas = {
+        QStringLiteral("PRAGMA cache_size=-16384"), // 16 MiB
+        QStringLiteral("PRAGMA temp_store=MEMORY"),
+};
+
+const QStringList kFilePragmas = {
+        QStringLiteral("PRAGMA mmap_size=268435456"), // 256 MiB
+};
+
+// Writers don't block readers and commits don't wait for the data
+// to be written to disk. The log is checkpointed on an idle thread
+// by MixxxDbMaintenance. The auto-checkpoint on commit remains as
+// a safety net for bulk updates, e.g. while scanning the library.
+const QStringList kWriteAheadLogPragmas = {
+        QStringLiteral("PRAGMA journal_mode=WAL"),
+        QStringLiteral("PRAGMA synchronous=NORMAL"),
+        QStringLiteral("PRAGMA wal_autocheckpoint=4000"),
+};
+
+// The journal mode is persistent and needs to be reset explicitly
+const QStringList kRollbackJournalPragmas = {
+        QStringLiteral("PRAGMA journal_mode=DELETE"),
+};
+
+// The write-ahead log requires shared memory between all connections,
+// which doesn't work on network filesystems.
+// https://www.sqlite.org/wal.html
+const QList<QByteArray> kNetworkFileSystemTypes = {
+        QByteArrayLiteral("9p"),
+        QByteArrayLiteral("afpfs"),
+        QByteArrayLiteral("cifs"),
+        QByteArrayLiteral("davfs"),
+        QByteArrayLiteral("fuse.sshfs"),
+        QByteArrayLiteral("ncpfs"),
+        QByteArrayLiteral("nfs"),
+        QByteArrayLiteral("nfs4"),
+        QByteArrayLiteral("smb2"),
+        QByteArrayLiteral("smb3"),
+        QByteArrayLiteral("smbfs"),
+        QByteArrayLiteral("webdav"),
+};
+
+bool isOnNetworkFileSystem(const QString& dirPath) {
+    // UNC paths on Windows, e.g. \\server\share
+    if (QDir::toNativeSeparators(dirPath).startsWith(QStringLiteral("\\\\"))) {
+        return true;
+    }
+    const QByteArray fileSystemType = QStorageInfo(dirPath).fileSystemType().toLower();
+    return kNetworkFileSystemTypes.contains(fileSystemType);
+}
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -58,6 +114,25 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    params.pragmas = kPragmas;
+    if (!inMemoryConnection) {
+        params.pragmas += kFilePragmas;
+        bool writeAheadLog = pConfig->getValue(
+                mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey,
+                mixxx::library::prefs::kDatabaseWriteAheadLogDefault);
+        if (writeAheadLog && isOnNetworkFileSystem(pConfig->getSettingsPath())) {
+            kLogger.warning()
+                    << "Using the rollback journal instead of the write-ahead"
+                    << "log for the database on a network filesystem:"
+                    << pConfig->getSettingsPath();
+            writeAheadLog = false;
+        }
+        if (writeAheadLog) {
+            params.pragmas += kWriteAheadLogPragmas;
+        } else {
+            params.pragmas += kRollbackJournalPragmas;
+        }
+    }
     return params;
 }
 
@@ -73,6 +148,14 @@ bool MixxxDb::initDatabaseSchema(
         const QSqlDatabase& database,
         int schemaVersion,
         const QString& schemaFile) {
+    return checkSchemaUpgradeResult(
+            SchemaManager(database).upgradeToSchemaVersion(schemaVersion, schemaFile),
+            schemaVersion);
+}
+
+bool MixxxDb::checkSchemaUpgradeResult(
+        SchemaManager::Result result,
+        int schemaVersion) {
     QString okToExit = tr("Click OK to exit.");
     QString upgradeFailed = tr("Cannot upgrade database schema");
     QString upgradeToVersionFailed =
@@ -81,7 +164,7 @@ bool MixxxDb::initDatabaseSchema(
     QString helpContact = tr("For help with database issues consult:") + "\n" +
             "https://www.mixxx.org/support";
 
-    switch (SchemaManager(database).upgradeToSchemaVersion(schemaVersion, schemaFile)) {
+    switch (result) {
     case SchemaManager::Result::CurrentVersion:
     case SchemaManager::Result::UpgradeSucceeded:
     case SchemaManager::Result::NewerVersionBackwardsCompatible:
@@ -2,6 +2,7 @@
 
 #include <QSqlDatabase>
 
+#include "database/schemamanager.h"
 #include "preferences/usersettings.h"
 
 #include "util/db/dbconnectionpool.h"
@@ -20,6 +21,13 @@ class MixxxDb : public QObject {
             int schemaVersion = kRequiredSchemaVersion,
             const QString& schemaFile = kDefaultSchemaFile);
 
+    // Displays an error message if the upgrade of the database schema
+    // has failed, e.g. after the upgrade has been performed on a
+    // different thread. Must be called from the GUI thread.
+    static bool checkSchemaUpgradeResult(
+            SchemaManager::Result result,
+            int schemaVersion = kRequiredSchemaVersion);
+
     explicit MixxxDb(
             const UserSettingsPointer& pConfig,
             bool inMemoryConnection = false);
@@ -0,0 +1,173 @@
+#include "database/mixxxdbmaintenance.h"
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+#include "util/stat.h"
+
+namespace {
+
+const mixxx::Logger kLogger("MixxxDbMaintenance");
+
+constexpr unsigned long kCheckpointIntervalMillis = 30 * 1000;
+
+constexpr qint64 kOptimizeIntervalMillis = 60 * 60 * 1000;
+
+// The database is not optimized again when stopping shortly
+// after it has been optimized
+constexpr qint64 kMinOptimizeIntervalMillis = 10 * 60 * 1000;
+
+// Limits the number of rows that are examined per index by
+// PRAGMA optimize, as recommended by the SQLite documentation.
+// This bounds the time needed for large libraries.
+const QString kAnalysisLimitPragma = QStringLiteral("PRAGMA analysis_limit=400");
+
+const QString kPassiveCheckpointMode = QStringLiteral("PASSIVE");
+
+// Resets the log file to zero size after all frames have been
+// written back into the database
+const QString kTruncateCheckpointMode = QStringLiteral("TRUNCATE");
+
+// Changes whenever another connection has committed a transaction
+qint64 queryDataVersion(const QSqlDatabase& database) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("PRAGMA data_version")) || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toLongLong();
+}
+
+} // anonymous namespace
+
+MixxxDbMaintenance::MixxxDbMaintenance(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_checkpointedDataVersion(-1),
+          m_bStopThread(false) {
+    start(QThread::IdlePriority);
+}
+
+MixxxDbMaintenance::~MixxxDbMaintenance() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_bStopThread = true;
+        m_stopRequested.wakeAll();
+    }
+    wait();
+}
+
+void MixxxDbMaintenance::checkpoint(
+        const QSqlDatabase& database,
+        const QString& mode) {
+    const qint64 dataVersion = queryDataVersion(database);
+    if (mode == kPassiveCheckpointMode &&
+            dataVersion >= 0 &&
+            dataVersion == m_checkpointedDataVersion) {
+        // Nothing has been committed since the last checkpoint
+        return;
+    }
+    PerformanceTimer time;
+    time.start();
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("PRAGMA wal_checkpoint(%1)").arg(mode)) ||
+            !query.next()) {
+        kLogger.warning()
+                << "Failed to checkpoint the write-ahead log:"
+                << query.lastError();
+        return;
+    }
+    m_checkpointedDataVersion = dataVersion;
+    // The number of frames in the log or -1 if not in WAL mode
+    const int logFrames = query.value(1).toInt();
+    if (logFrames < 0) {
+        return;
+    }
+    const bool busy = query.value(0).toInt() != 0;
+    const int checkpointedFrames = query.value(2).toInt();
+    Stat::track(QStringLiteral("MixxxDb write-ahead log frames"),
+            Stat::UNSPECIFIED,
+            Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+            logFrames);
+    kLogger.debug()
+            << mode
+            << "checkpoint of"
+            << checkpointedFrames
+            << '/'
+            << logFrames
+            << "frame(s) took"
+            << time.elapsed().debugMillisWithUnit()
+            << (busy ? "(blocked by another connection)" : "");
+}
+
+void MixxxDbMaintenance::optimize(const QSqlDatabase& database) {
+    PerformanceTimer time;
+    time.start();
+    QSqlQuery query(database);
+    // Only analyzes the tables whose statistics are outdated,
+    // see https://www.sqlite.org/pragma.html#pragma_optimize
+    if (!query.exec(QStringLiteral("PRAGMA optimize"))) {
+        kLogger.warning()
+                << "Failed to optimize the database:"
+                << query.lastError();
+        return;
+    }
+    kLogger.debug()
+            << "Optimizing the database took"
+            << time.elapsed().debugMillisWithUnit();
+}
+
+void MixxxDbMaintenance::run() {
+    QThread::currentThread()->setObjectName("MixxxDbMaintenance");
+    // The pooler limits the lifetime of the thread-local database
+    // connection to the lifetime of this thread.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    VERIFY_OR_DEBUG_ASSERT(database.isOpen()) {
+        kLogger.warning() << "No database connection available";
+        return;
+    }
+
+    {
+        QSqlQuery query(database);
+        if (!query.exec(kAnalysisLimitPragma)) {
+            kLogger.info()
+                    << "Failed to limit the analysis of the database:"
+                    << query.lastError();
+        }
+    }
+
+    // Measures the time since the thread has been started
+    // or since the last optimization
+    QElapsedTimer optimizeTimer;
+    optimizeTimer.start();
+    bool optimized = false;
+    QMutexLocker locker(&m_mutex);
+    while (!m_bStopThread) {
+        m_stopRequested.wait(&m_mutex, kCheckpointIntervalMillis);
+        if (m_bStopThread) {
+            break;
+        }
+        locker.unlock();
+        checkpoint(database, kPassiveCheckpointMode);
+        if (optimizeTimer.hasExpired(kOptimizeIntervalMillis)) {
+            optimize(database);
+            optimizeTimer.start();
+            optimized = true;
+        }
+        locker.relock();
+    }
+    locker.unlock();
+
+    if (optimized && !optimizeTimer.hasExpired(kMinOptimizeIntervalMillis)) {
+        kLogger.debug() << "Skipping the optimization of the recently optimized database";
+    } else {
+        optimize(database);
+    }
+    checkpoint(database, kTruncateCheckpointMode);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "util/db/dbconnectionpool.h"
+
+/// Performs the periodic maintenance of the Mixxx database on an idle
+/// thread with a separate connection.
+///
+/// In write-ahead log mode the log would otherwise be checkpointed by
+/// the connection that commits a transaction, i.e. often the GUI thread.
+/// Checkpoints are only performed if other connections have committed
+/// changes in the meantime. The query planner statistics are updated
+/// once per hour and before stopping, unless they have been updated
+/// recently. The analysis is limited to a sample of each index to
+/// bound the time needed for large libraries.
+class MixxxDbMaintenance : public QThread {
+  public:
+    explicit MixxxDbMaintenance(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    /// Truncates the write-ahead log before returning.
+    ~MixxxDbMaintenance() override;
+
+  protected:
+    void run() override;
+
+  private:
+    void checkpoint(const QSqlDatabase& database, const QString& mode);
+    void optimize(const QSqlDatabase& database);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    // Only accessed by this thread
+    qint64 m_checkpointedDataVersion;
+
+    // You must hold m_mutex to touch the following members
+    QMutex m_mutex;
+    QWaitCondition m_stopRequested;
+    bool m_bStopThread;
+};
@@ -5,6 +5,10 @@
 namespace {
 constexpr double kMaxCornerHz = 500;
 constexpr double kMinCornerHz = 16;
+// The balance and width are applied without delay. Only the impulse
+// response of the crossover filters rings for a few periods of the
+// lowest bypass frequency.
+constexpr double kTailLengthSeconds = 8 / kMinCornerHz;
 } // anonymous namespace
 
 // static
@@ -23,6 +27,7 @@ EffectManifestPointer BalanceEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Adjust the left/right balance and stereo width"));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(kTailLengthSeconds);
     pManifest->setMetaknobDefault(0.5);
 
     EffectManifestParameterPointer balance = pManifest->addParameter();
@@ -23,6 +23,7 @@ EffectManifestPointer Bessel4LVMixEQEffect::getManifest() {
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setIsMixingEQ(true);
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.5);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
     return pManifest;
@@ -63,6 +63,7 @@ EffectManifestPointer BiquadFullKillEQEffect::getManifest() {
                     "Isolator circuit to offer gentle slopes and full kill.") +
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.5);
     pManifest->setIsMixingEQ(true);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
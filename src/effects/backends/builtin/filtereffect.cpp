@@ -23,6 +23,7 @@ EffectManifestPointer FilterEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Allows only high or low frequencies to play."));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.5);
     pManifest->setMetaknobDefault(0.5);
 
     EffectManifestParameterPointer lpf = pManifest->addParameter();
@@ -98,22 +99,70 @@ void FilterEffect::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
-    double hpf;
-    double lpf;
-    double q = m_pQ->value();
-
     const double minCornerNormalized = kMinCorner / engineParameters.sampleRate();
     const double maxCornerNormalized = kMaxCorner / engineParameters.sampleRate();
 
     if (enableState == EffectEnableState::Disabling) {
         // Ramp to dry, when disabling, this will ramp from dry when enabling as well
-        hpf = minCornerNormalized;
-        lpf = maxCornerNormalized;
-    } else {
-        hpf = m_pHPF->value() / engineParameters.sampleRate();
-        lpf = m_pLPF->value() / engineParameters.sampleRate();
+        processSegment(pState,
+                pInput,
+                pOutput,
+                engineParameters.samplesPerBuffer(),
+                maxCornerNormalized,
+                m_pQ->value(),
+                minCornerNormalized,
+                minCornerNormalized,
+                maxCornerNormalized);
+        return;
+    }
+
+    if (!m_pLPF->isRamping() && !m_pQ->isRamping() && !m_pHPF->isRamping()) {
+        processSegment(pState,
+                pInput,
+                pOutput,
+                engineParameters.samplesPerBuffer(),
+                m_pLPF->value() / engineParameters.sampleRate(),
+                m_pQ->value(),
+                m_pHPF->value() / engineParameters.sampleRate(),
+                minCornerNormalized,
+                maxCornerNormalized);
+        return;
     }
 
+    // The knobs have been moved since the last callback. Sweep the corners
+    // in short segments through the buffer instead of jumping to the new
+    // values at once, which is audible as zipper noise with large buffers.
+    const SINT framesPerBuffer = engineParameters.framesPerBuffer();
+    for (SINT frame = 0; frame < framesPerBuffer; frame += kRampSegmentFrames) {
+        const SINT segmentFrames = math_min(kRampSegmentFrames, framesPerBuffer - frame);
+        // Target the values at the end of each segment, so the last segment
+        // reaches the current values.
+        const SINT segmentEnd = frame + segmentFrames;
+        const SINT sampleOffset = frame * engineParameters.channelCount();
+        processSegment(pState,
+                pInput + sampleOffset,
+                pOutput + sampleOffset,
+                segmentFrames * engineParameters.channelCount(),
+                m_pLPF->valueAt(segmentEnd, framesPerBuffer) /
+                        engineParameters.sampleRate(),
+                m_pQ->valueAt(segmentEnd, framesPerBuffer),
+                m_pHPF->valueAt(segmentEnd, framesPerBuffer) /
+                        engineParameters.sampleRate(),
+                minCornerNormalized,
+                maxCornerNormalized);
+    }
+}
+
+void FilterEffect::processSegment(
+        FilterGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT numSamples,
+        double lpf,
+        double q,
+        double hpf,
+        double minCornerNormalized,
+        double maxCornerNormalized) {
     if ((pState->m_loFreq != lpf) ||
             (pState->m_q != q) ||
             (pState->m_hiFreq != hpf)) {
@@ -146,12 +195,12 @@ void FilterEffect::processChannel(
 
     if (hpf > minCornerNormalized) {
         // hpf enabled, fade-in is handled in the filter when starting from pause
-        pState->m_pHighFilter->process(pInput, pHpfOutput, engineParameters.samplesPerBuffer());
+        pState->m_pHighFilter->process(pInput, pHpfOutput, numSamples);
     } else if (pState->m_hiFreq > minCornerNormalized) {
         // hpf disabling
         pState->m_pHighFilter->processAndPauseFilter(pInput,
                 pHpfOutput,
-                engineParameters.samplesPerBuffer());
+                numSamples);
     } else {
         // paused LP uses input directly
         pLpfInput = pInput;
@@ -159,17 +208,17 @@ void FilterEffect::processChannel(
 
     if (lpf < maxCornerNormalized) {
         // lpf enabled, fade-in is handled in the filter when starting from pause
-        pState->m_pLowFilter->process(pLpfInput, pOutput, engineParameters.samplesPerBuffer());
+        pState->m_pLowFilter->process(pLpfInput, pOutput, numSamples);
     } else if (pState->m_loFreq < maxCornerNormalized) {
         // hpf disabling
         pState->m_pLowFilter->processAndPauseFilter(pLpfInput,
                 pOutput,
-                engineParameters.samplesPerBuffer());
+                numSamples);
     } else if (pLpfInput == pInput) {
         // Both disabled
         if (pOutput != pInput) {
             // We need to copy pInput pOutput
-            SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+            SampleUtil::copy(pOutput, pInput, numSamples);
         }
     }
 
@@ -45,10 +45,26 @@ class FilterEffect : public EffectProcessorImpl<FilterGroupState> {
             const GroupFeatureState& groupFeatures) override;
 
   private:
+    // Length of the segments for sweeping the corner frequencies when the
+    // parameters change during a callback. Each segment requires redesigning
+    // the filters, so this trades accuracy against CPU load.
+    static constexpr SINT kRampSegmentFrames = 64;
+
     QString debugString() const {
         return getId();
     }
 
+    void processSegment(
+            FilterGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT numSamples,
+            double lpf,
+            double q,
+            double hpf,
+            double minCornerNormalized,
+            double maxCornerNormalized);
+
     EngineEffectParameterPointer m_pLPF;
     EngineEffectParameterPointer m_pQ;
     EngineEffectParameterPointer m_pHPF;
@@ -26,6 +26,7 @@ EffectManifestPointer LinkwitzRiley8EQEffect::getManifest() {
                         "dB/octave).") +
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setIsMixingEQ(true);
+    pManifest->setTailLengthSeconds(0.5);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
     return pManifest;
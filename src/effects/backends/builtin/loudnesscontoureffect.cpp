@@ -31,6 +31,7 @@ EffectManifestPointer LoudnessContourEffect::getManifest() {
             "Amplifies low and high frequencies at low volumes to compensate "
             "for reduced sensitivity of the human ear."));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.5);
     pManifest->setMetaknobDefault(1.0);
 
     EffectManifestParameterPointer loudness = pManifest->addParameter();
@@ -22,6 +22,7 @@ EffectManifestPointer MoogLadder4FilterEffect::getManifest() {
             QObject::tr("A 4-pole Moog ladder filter, based on Antti "
                         "Houvilainen's non linear digital implementation"));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.5);
     pManifest->setMetaknobDefault(0.5);
 
     EffectManifestParameterPointer lpf = pManifest->addParameter();
@@ -100,31 +101,71 @@ void MoogLadder4FilterEffect::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
-    double resonance = m_pResonance->value();
-    double hpf;
-    double lpf;
     if (enableState == EffectEnableState::Disabling) {
         // Ramp to dry, when disabling, this will ramp from dry when enabling as well
-        hpf = kMinCorner;
-        lpf = kMaxCorner;
-    } else {
-        hpf = m_pHPF->value();
-        lpf = m_pLPF->value();
+        processSegment(pState,
+                pInput,
+                pOutput,
+                engineParameters.samplesPerBuffer(),
+                engineParameters.sampleRate(),
+                kMaxCorner,
+                m_pResonance->value(),
+                kMinCorner);
+        return;
+    }
+
+    if (!m_pLPF->isRamping() && !m_pResonance->isRamping() && !m_pHPF->isRamping()) {
+        processSegment(pState,
+                pInput,
+                pOutput,
+                engineParameters.samplesPerBuffer(),
+                engineParameters.sampleRate(),
+                m_pLPF->value(),
+                m_pResonance->value(),
+                m_pHPF->value());
+        return;
     }
 
+    // The knobs have been moved since the last callback. Sweep the corners
+    // in short segments through the buffer like FilterEffect.
+    const SINT framesPerBuffer = engineParameters.framesPerBuffer();
+    for (SINT frame = 0; frame < framesPerBuffer; frame += kRampSegmentFrames) {
+        const SINT segmentFrames = math_min(kRampSegmentFrames, framesPerBuffer - frame);
+        const SINT segmentEnd = frame + segmentFrames;
+        const SINT sampleOffset = frame * engineParameters.channelCount();
+        processSegment(pState,
+                pInput + sampleOffset,
+                pOutput + sampleOffset,
+                segmentFrames * engineParameters.channelCount(),
+                engineParameters.sampleRate(),
+                m_pLPF->valueAt(segmentEnd, framesPerBuffer),
+                m_pResonance->valueAt(segmentEnd, framesPerBuffer),
+                m_pHPF->valueAt(segmentEnd, framesPerBuffer));
+    }
+}
+
+void MoogLadder4FilterEffect::processSegment(
+        MoogLadder4FilterGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        double lpf,
+        double resonance,
+        double hpf) {
     if (pState->m_loFreq != lpf ||
             pState->m_resonance != resonance ||
-            pState->m_samplerate != engineParameters.sampleRate()) {
-        pState->m_pLowFilter->setParameter(engineParameters.sampleRate(),
-                static_cast<float>(lpf * engineParameters.sampleRate()),
+            pState->m_samplerate != sampleRate) {
+        pState->m_pLowFilter->setParameter(sampleRate,
+                static_cast<float>(lpf * sampleRate),
                 static_cast<float>(resonance));
     }
 
     if (pState->m_hiFreq != hpf ||
             pState->m_resonance != resonance ||
-            pState->m_samplerate != engineParameters.sampleRate()) {
-        pState->m_pHighFilter->setParameter(engineParameters.sampleRate(),
-                static_cast<float>(hpf * engineParameters.sampleRate()),
+            pState->m_samplerate != sampleRate) {
+        pState->m_pHighFilter->setParameter(sampleRate,
+                static_cast<float>(hpf * sampleRate),
                 static_cast<float>(resonance));
     }
 
@@ -138,12 +179,12 @@ void MoogLadder4FilterEffect::processChannel(
 
     if (hpf > kMinCorner) {
         // hpf enabled, fade-in is handled in the filter when starting from pause
-        pState->m_pHighFilter->process(pInput, pHpfOutput, engineParameters.samplesPerBuffer());
+        pState->m_pHighFilter->process(pInput, pHpfOutput, numSamples);
     } else if (pState->m_hiFreq > kMinCorner) {
         // hpf disabling
         pState->m_pHighFilter->processAndPauseFilter(pInput,
                 pHpfOutput,
-                engineParameters.samplesPerBuffer());
+                numSamples);
     } else {
         // paused LP uses input directly
         pLpfInput = pInput;
@@ -151,22 +192,22 @@ void MoogLadder4FilterEffect::processChannel(
 
     if (lpf < kMaxCorner) {
         // lpf enabled, fade-in is handled in the filter when starting from pause
-        pState->m_pLowFilter->process(pLpfInput, pOutput, engineParameters.samplesPerBuffer());
+        pState->m_pLowFilter->process(pLpfInput, pOutput, numSamples);
     } else if (pState->m_loFreq < kMaxCorner) {
         // hpf disabling
         pState->m_pLowFilter->processAndPauseFilter(pLpfInput,
                 pOutput,
-                engineParameters.samplesPerBuffer());
+                numSamples);
     } else if (pLpfInput == pInput) {
         // Both disabled
         if (pOutput != pInput) {
             // We need to copy pInput pOutput
-            SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+            SampleUtil::copy(pOutput, pInput, numSamples);
         }
     }
 
     pState->m_loFreq = lpf;
     pState->m_resonance = resonance;
     pState->m_hiFreq = hpf;
-    pState->m_samplerate = engineParameters.sampleRate();
+    pState->m_samplerate = sampleRate;
 }
@@ -44,10 +44,24 @@ class MoogLadder4FilterEffect : public EffectProcessorImpl<MoogLadder4FilterGrou
             const GroupFeatureState& groupFeatures) override;
 
   private:
+    // Length of the segments for sweeping the corner frequencies when the
+    // parameters change during a callback, see FilterEffect.
+    static constexpr SINT kRampSegmentFrames = 64;
+
     QString debugString() const {
         return getId();
     }
 
+    void processSegment(
+            MoogLadder4FilterGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            double lpf,
+            double resonance,
+            double hpf);
+
     EngineEffectParameterPointer m_pLPF;
     EngineEffectParameterPointer m_pResonance;
     EngineEffectParameterPointer m_pHPF;
@@ -25,6 +25,7 @@ EffectManifestPointer ParametricEQEffect::getManifest() {
             "An gentle 2-band parametric equalizer based on biquad filters.\n"
             "It is designed as a complement to the steep mixing equalizers."));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.5);
     pManifest->setIsMasterEQ(true);
 
     EffectManifestParameterPointer gain1 = pManifest->addParameter();
@@ -14,6 +14,8 @@ EffectManifestPointer ReverbEffect::getManifest() {
     EffectManifestPointer pManifest(new EffectManifest());
     pManifest->setAddDryToWet(true);
     pManifest->setEffectRampsFromDry(true);
+    // The maximum decay of the plate reverb reaches -60 dB after about 4 s.
+    pManifest->setTailLengthSeconds(8.0);
 
     pManifest->setId(getId());
     pManifest->setName(QObject::tr("Reverb"));
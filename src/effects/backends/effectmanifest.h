@@ -24,13 +24,19 @@
 /// the no-argument constructor be non-explicit.
 class EffectManifest {
   public:
+    /// The tail length of effects that may produce output from a silent input
+    /// for an unbounded time, e.g. because of feedback or because they generate
+    /// sound on their own. This is the default for all effects.
+    static constexpr double kTailLengthUnknown = -1.0;
+
     EffectManifest()
             : m_backendType(EffectBackendType::Unknown),
               m_isMixingEQ(false),
               m_isMasterEQ(false),
               m_effectRampsFromDry(false),
               m_bAddDryToWet(false),
-              m_metaknobDefault(0.0) {
+              m_metaknobDefault(0.0),
+              m_tailLengthSeconds(kTailLengthUnknown) {
     }
 
     /// Hack to store unique IDs in QComboBox models
@@ -155,6 +161,21 @@ class EffectManifest {
         m_metaknobDefault = metaknobDefault;
     }
 
+    /// The time in seconds it takes for the output of the effect to decay to
+    /// silence after its input became silent, assuming the worst case of all
+    /// parameter values. The engine skips processing an effect once its input
+    /// has been silent for longer than its tail, so this must not be set for
+    /// effects that produce sound from silence.
+    double tailLengthSeconds() const {
+        return m_tailLengthSeconds;
+    }
+    void setTailLengthSeconds(double tailLengthSeconds) {
+        m_tailLengthSeconds = tailLengthSeconds;
+    }
+    bool hasKnownTailLength() const {
+        return m_tailLengthSeconds >= 0.0;
+    }
+
     bool operator==(const EffectManifest& other) const {
         return other.id() == m_id && other.backendType() == m_backendType;
     }
@@ -188,4 +209,5 @@ class EffectManifest {
     bool m_effectRampsFromDry;
     bool m_bAddDryToWet;
     double m_metaknobDefault;
+    double m_tailLengthSeconds;
 };
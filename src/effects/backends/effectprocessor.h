@@ -2,6 +2,7 @@
 
 #include <QDebug>
 #include <QHash>
+#include <QList>
 #include <QPair>
 #include <QString>
 
@@ -10,6 +11,8 @@
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
 #include "engine/engine.h"
+#include "util/duration.h"
+#include "util/sample.h"
 #include "util/types.h"
 
 /// Effects are implemented as two separate classes, an EffectState subclass and
@@ -49,6 +52,11 @@
 /// without wasting a lot of memory. (EffectStates could be (de)allocated when toggling
 /// the enable switches for EffectSlots as well, but the memory savings would be
 /// relatively small compared to the additional code complexity.)
+/// EffectProcessorImpl keeps a pool of preallocated EffectStates for all input
+/// channels that could be routed to the chain later, so routing switches never
+/// wait for an allocation. The unused states of the pool are recycled by the
+/// next processor of the same effect when the effect is unloaded, see
+/// EffectsBackendManager::recycleEffectStates().
 class EffectState {
   public:
     EffectState(const mixxx::EngineParameters& engineParameters) {
@@ -74,6 +82,17 @@ class EffectProcessor {
     virtual void loadEngineEffectParameters(
             const QMap<QString, EngineEffectParameterPointer>& parameters) = 0;
     virtual EffectState* createState(const mixxx::EngineParameters& engineParameters) = 0;
+    /// Allocates EffectStates ahead of time for the next calls of createState()
+    /// until the pool holds the states for numInputChannels input channels.
+    virtual void refillStatePool(const mixxx::EngineParameters& engineParameters,
+            int numInputChannels) = 0;
+    /// Removes and returns the unused states of the pool when the effect is
+    /// unloaded. Processors whose states depend on the processor instance
+    /// return none, because they can not be reused by another processor.
+    virtual QList<EffectState*> takeStatePool() = 0;
+    /// Adds states that have been taken from another processor of the same
+    /// effect to the pool.
+    virtual void addToStatePool(const QList<EffectState*>& states) = 0;
     virtual void deleteStatesForInputChannel(ChannelHandle inputChannel) = 0;
 
     // Called from the audio thread
@@ -98,6 +117,30 @@ class EffectProcessor {
             const mixxx::EngineParameters& engineParameters,
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) = 0;
+
+    /// Called from the audio thread after process() if the effect has been
+    /// processed in the current callback.
+    /// Effects that delay their output, e.g. because they run on a worker
+    /// thread, return the dry signal of the chain delayed by the same amount,
+    /// so that the chain mixes the dry and the wet signal aligned. The
+    /// returned buffer is valid until the next callback.
+    virtual const CSAMPLE* alignDrySignal(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const CSAMPLE* pDry,
+            const mixxx::EngineParameters& engineParameters) {
+        Q_UNUSED(inputHandle);
+        Q_UNUSED(outputHandle);
+        Q_UNUSED(engineParameters);
+        return pDry;
+    }
+
+    /// Called from the audio thread
+    /// Returns the time spent processing this effect outside of the audio
+    /// thread since the last call, for effects that offload their processing
+    /// to a worker thread. It is included in the CPU load of the effect.
+    virtual mixxx::Duration takeExternalProcessingTime() {
+        return mixxx::Duration();
+    }
 };
 
 /// EffectProcessorImpl manages a separate EffectState for every combination of
@@ -134,6 +177,8 @@ class EffectProcessorImpl : public EffectProcessor {
             inputChannelHandleNumber++;
         }
         m_channelStateMatrix.clear();
+        qDeleteAll(m_statePool);
+        m_statePool.clear();
     };
 
     /// NOTE: Subclasses for Built-In effects must implement the following static methods for
@@ -157,17 +202,15 @@ class EffectProcessorImpl : public EffectProcessor {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) final {
         EffectSpecificState* pState = m_channelStateMatrix[inputHandle][outputHandle];
+        // The states are loaded together with enabling the chain for the input
+        // channel, so a missing state is a bug. It must not be hidden by
+        // allocating a state in the audio thread. The signal is passed through
+        // unaffected instead of dropping the audio.
         VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
-            if (kEffectDebugOutput) {
-                qWarning() << "EffectProcessorImpl::process could not retrieve"
-                              "EffectState for input"
-                           << inputHandle
-                           << "and output" << outputHandle
-                           << "EffectState should have been preallocated in the"
-                              "main thread.";
+            if (pOutput != pInput) {
+                SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
             }
-            pState = createSpecificState(engineParameters);
-            m_channelStateMatrix[inputHandle][outputHandle] = pState;
+            return;
         }
         processChannel(pState, pInput, pOutput, engineParameters, enableState, groupFeatures);
     }
@@ -187,7 +230,7 @@ class EffectProcessorImpl : public EffectProcessor {
             for (const ChannelHandleAndGroup& outputChannel :
                     std::as_const(m_registeredOutputChannels)) {
                 outputChannelMap.insert(outputChannel.handle(),
-                        createSpecificState(engineParameters));
+                        takePooledState(engineParameters));
                 if (kEffectDebugOutput) {
                     qDebug() << this << "EffectProcessorImpl::initialize "
                                         "registering output"
@@ -198,8 +241,46 @@ class EffectProcessorImpl : public EffectProcessor {
         }
     };
 
+    /// Takes a state from the pool if available, so routing an input channel
+    /// to the effect does not need to wait for the allocation.
     EffectState* createState(const mixxx::EngineParameters& engineParameters) final {
-        return createSpecificState(engineParameters);
+        return takePooledState(engineParameters);
+    };
+
+    /// The pool holds fresh states for routing numInputChannels more input
+    /// channels. The states are constructed with the engine parameters,
+    /// which allocates and clears their buffers, so the audio thread does not
+    /// hit page faults when it touches their memory for the first time.
+    void refillStatePool(const mixxx::EngineParameters& engineParameters,
+            int numInputChannels) final {
+        const int poolSize = numInputChannels * m_registeredOutputChannels.size();
+        while (m_statePool.size() < poolSize) {
+            m_statePool.append(createSpecificState(engineParameters));
+        }
+        while (m_statePool.size() > poolSize) {
+            delete m_statePool.takeLast();
+        }
+    };
+
+    QList<EffectState*> takeStatePool() override {
+        QList<EffectState*> states;
+        states.reserve(m_statePool.size());
+        for (EffectSpecificState* pState : std::as_const(m_statePool)) {
+            states.append(pState);
+        }
+        m_statePool.clear();
+        return states;
+    };
+
+    void addToStatePool(const QList<EffectState*>& states) final {
+        for (EffectState* pState : states) {
+            auto* pSpecificState = dynamic_cast<EffectSpecificState*>(pState);
+            VERIFY_OR_DEBUG_ASSERT(pSpecificState) {
+                delete pState;
+                continue;
+            }
+            m_statePool.append(pSpecificState);
+        }
     };
 
     bool loadStatesForInputChannel(ChannelHandle inputChannel,
@@ -284,6 +365,13 @@ class EffectProcessorImpl : public EffectProcessor {
     };
 
   protected:
+    /// Returns the state for a combination of input and output channel
+    /// or nullptr if none has been loaded.
+    EffectSpecificState* getChannelState(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) {
+        return m_channelStateMatrix[inputHandle][outputHandle];
+    }
+
     /// Subclasses for external effects plugins may reimplement this, but
     /// subclasses for built-in effects should not.
     virtual EffectSpecificState* createSpecificState(
@@ -296,6 +384,15 @@ class EffectProcessorImpl : public EffectProcessor {
     };
 
   private:
+    EffectSpecificState* takePooledState(const mixxx::EngineParameters& engineParameters) {
+        if (!m_statePool.isEmpty()) {
+            return m_statePool.takeLast();
+        }
+        return createSpecificState(engineParameters);
+    }
+
     QSet<ChannelHandleAndGroup> m_registeredOutputChannels;
     ChannelHandleMap<ChannelHandleMap<EffectSpecificState*>> m_channelStateMatrix;
+    // Only accessed from the main thread
+    QList<EffectSpecificState*> m_statePool;
 };
@@ -8,6 +8,14 @@
 #endif
 #include "effects/presets/effectpreset.h"
 
+namespace {
+
+// Loading a different effect in a slot and switching back should not
+// allocate again, but the states of many effects would waste memory.
+constexpr int kMaxNumRecycledEffects = 4;
+
+} // anonymous namespace
+
 EffectsBackendManager::EffectsBackendManager() {
     m_pNumEffectsAvailable = std::make_unique<ControlObject>(
             ConfigKey("[Master]", "num_effectsavailable"));
@@ -19,6 +27,13 @@ EffectsBackendManager::EffectsBackendManager() {
 #endif
 }
 
+EffectsBackendManager::~EffectsBackendManager() {
+    for (const auto& recycledStates : std::as_const(m_recycledEffectStates)) {
+        qDeleteAll(recycledStates.second);
+    }
+    m_recycledEffectStates.clear();
+}
+
 void EffectsBackendManager::addBackend(EffectsBackendPointer pBackend) {
     VERIFY_OR_DEBUG_ASSERT(pBackend) {
         return;
@@ -124,3 +139,35 @@ std::unique_ptr<EffectProcessor> EffectsBackendManager::createProcessor(
     }
     return pBackend->createProcessor(pManifest);
 }
+
+void EffectsBackendManager::recycleEffectStates(
+        const EffectManifestPointer pManifest,
+        const QList<EffectState*>& states) {
+    VERIFY_OR_DEBUG_ASSERT(pManifest) {
+        qDeleteAll(states);
+        return;
+    }
+    if (states.isEmpty()) {
+        return;
+    }
+    QList<EffectState*> recycledStates = takeRecycledEffectStates(pManifest);
+    recycledStates.append(states);
+    m_recycledEffectStates.append(qMakePair(pManifest->uniqueId(), recycledStates));
+    while (m_recycledEffectStates.size() > kMaxNumRecycledEffects) {
+        qDeleteAll(m_recycledEffectStates.takeFirst().second);
+    }
+}
+
+QList<EffectState*> EffectsBackendManager::takeRecycledEffectStates(
+        const EffectManifestPointer pManifest) {
+    if (!pManifest) {
+        return {};
+    }
+    const QString uniqueId = pManifest->uniqueId();
+    for (int i = 0; i < m_recycledEffectStates.size(); ++i) {
+        if (m_recycledEffectStates.at(i).first == uniqueId) {
+            return m_recycledEffectStates.takeAt(i).second;
+        }
+    }
+    return {};
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QList>
+#include <QPair>
+
 #include "effects/backends/effectsbackend.h"
 
 class ControlObject;
@@ -9,7 +12,7 @@ class ControlObject;
 class EffectsBackendManager {
   public:
     EffectsBackendManager();
-    ~EffectsBackendManager() = default;
+    ~EffectsBackendManager();
 
     const QList<EffectManifestPointer>& getManifests() const {
         return m_manifests;
@@ -23,6 +26,16 @@ class EffectsBackendManager {
 
     std::unique_ptr<EffectProcessor> createProcessor(const EffectManifestPointer pManifest);
 
+    /// Called in main thread when an effect is unloaded to keep the unused
+    /// preallocated states of its processor for the next processor of the
+    /// same effect. Only the states of the most recently unloaded effects are
+    /// kept, the others are deleted.
+    void recycleEffectStates(const EffectManifestPointer pManifest,
+            const QList<EffectState*>& states);
+    /// Called in main thread when an effect is loaded. The caller takes
+    /// ownership of the returned states.
+    QList<EffectState*> takeRecycledEffectStates(const EffectManifestPointer pManifest);
+
   private:
     void addBackend(EffectsBackendPointer pEffectsBackend);
 
@@ -30,6 +43,10 @@ class EffectsBackendManager {
 
     QHash<EffectBackendType, EffectsBackendPointer> m_effectsBackends;
     QList<EffectManifestPointer> m_manifests;
+
+    /// Recycled states by the unique id of the effect, the most recently
+    /// unloaded effect last.
+    QList<QPair<QString, QList<EffectState*>>> m_recycledEffectStates;
 };
 
 typedef QSharedPointer<EffectsBackendManager> EffectsBackendManagerPointer;
@@ -1,12 +1,50 @@
 #include "effects/backends/lv2/lv2backend.h"
 
+#include <QMutex>
+
+#include "control/controlpushbutton.h"
 #include "effects/backends/lv2/lv2effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
+#include "effects/backends/lv2/lv2workerthread.h"
+
+namespace {
+
+// The world loaded by LV2Backend::preloadWorld() until it is
+// adopted by the backend
+QMutex s_preloadedWorldMutex;
+LilvWorld* s_pPreloadedWorld = nullptr;
+
+LilvWorld* loadWorld() {
+    LilvWorld* pWorld = lilv_world_new();
+    lilv_world_load_all(pWorld);
+    return pWorld;
+}
+
+} // anonymous namespace
+
+//static
+void LV2Backend::preloadWorld() {
+    const QMutexLocker locker(&s_preloadedWorldMutex);
+    if (!s_pPreloadedWorld) {
+        s_pPreloadedWorld = loadWorld();
+    }
+}
 
 LV2Backend::LV2Backend() {
-    m_pWorld = lilv_world_new();
+    m_pControlWorkerThread = std::make_unique<ControlPushButton>(
+            ConfigKey("[Master]", "lv2_worker_thread"), true);
+    m_pControlWorkerThread->setButtonMode(ControlPushButton::TOGGLE);
+
+    {
+        // Blocks while the world is preloaded concurrently
+        const QMutexLocker locker(&s_preloadedWorldMutex);
+        m_pWorld = s_pPreloadedWorld;
+        s_pPreloadedWorld = nullptr;
+    }
+    if (!m_pWorld) {
+        m_pWorld = loadWorld();
+    }
     initializeProperties();
-    lilv_world_load_all(m_pWorld);
     enumeratePlugins();
 }
 
@@ -87,7 +125,14 @@ std::unique_ptr<EffectProcessor> LV2Backend::createProcessor(
     VERIFY_OR_DEBUG_ASSERT(pLV2Manifest) {
         return nullptr;
     }
-    return std::make_unique<LV2EffectProcessor>(pLV2Manifest);
+    if (!m_pControlWorkerThread->toBool()) {
+        return std::make_unique<LV2EffectProcessor>(pLV2Manifest);
+    }
+    if (!m_pWorkerThread) {
+        m_pWorkerThread = std::make_shared<LV2WorkerThread>();
+        m_pWorkerThread->start(QThread::TimeCriticalPriority);
+    }
+    return std::make_unique<LV2EffectProcessor>(pLV2Manifest, m_pWorkerThread);
 }
 
 LV2EffectManifestPointer LV2Backend::getLV2Manifest(const QString& effectId) const {
@@ -2,17 +2,27 @@
 
 #include <lilv/lilv.h>
 
+#include <memory>
+
 #include "effects/backends/effectsbackend.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
 #include "preferences/usersettings.h"
 
+class ControlPushButton;
+class LV2WorkerThread;
+
 /// Refer to EffectsBackend for documentation
 class LV2Backend : public EffectsBackend {
   public:
     LV2Backend();
     virtual ~LV2Backend();
 
+    /// Discovers all installed plugins, which might take a while. May be
+    /// called from any thread before the backend is created, which then
+    /// adopts the loaded world instead of loading it again.
+    static void preloadWorld();
+
     EffectBackendType getType() const {
         return EffectBackendType::LV2;
     };
@@ -32,6 +42,12 @@ class LV2Backend : public EffectsBackend {
     LilvWorld* m_pWorld;
     QHash<QString, LilvNode*> m_properties;
     QHash<QString, LV2EffectManifestPointer> m_registeredEffects;
+    // Toggles running newly loaded LV2 effects on a worker thread
+    std::unique_ptr<ControlPushButton> m_pControlWorkerThread;
+    // Created on demand when the first effect is loaded with the worker
+    // thread enabled. Shared with the processors, so it is stopped only
+    // after the last processor using it has been deleted.
+    mutable std::shared_ptr<LV2WorkerThread> m_pWorkerThread;
 
     QString debugString() const {
         return "LV2Backend";
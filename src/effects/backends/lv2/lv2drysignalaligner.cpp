@@ -0,0 +1,76 @@
+#include "effects/backends/lv2/lv2drysignalaligner.h"
+
+#include "util/assert.h"
+#include "util/sample.h"
+
+LV2DrySignalAligner::LV2DrySignalAligner()
+        : m_outputLatency(OutputLatency::None),
+          m_delayPos(0) {
+}
+
+void LV2DrySignalAligner::allocate(SINT maxSamplesPerBuffer, SINT maxDelaySamples) {
+    // The delay line must hold the current sample in addition to the delayed
+    // ones, see process().
+    m_delayLine = mixxx::SampleBuffer(maxDelaySamples + 1);
+    m_delayLine.clear();
+    m_delayPos = 0;
+    m_alignedDry = mixxx::SampleBuffer(maxSamplesPerBuffer);
+    m_alignedDry.clear();
+}
+
+LV2DrySignalAligner::OutputLatency LV2DrySignalAligner::updateOutputLatency(
+        bool delayedOutput, EffectEnableState enableState) {
+    if (enableState == EffectEnableState::Enabling) {
+        // The delay line is left over from the last time the effect was
+        // enabled. The plugin has been activated again, so its delayed output
+        // starts with silence as well.
+        m_delayLine.clear();
+    }
+    if (!delayedOutput) {
+        m_outputLatency = OutputLatency::None;
+    } else if (m_outputLatency == OutputLatency::None ||
+            m_outputLatency == OutputLatency::FadingOut) {
+        m_outputLatency = OutputLatency::FadingIn;
+    } else if (enableState == EffectEnableState::Disabling) {
+        // EngineEffect crossfades from the delayed output to the undelayed
+        // input, which continues without latency after disabling
+        m_outputLatency = OutputLatency::FadingOut;
+    } else {
+        m_outputLatency = OutputLatency::Delayed;
+    }
+    return m_outputLatency;
+}
+
+const CSAMPLE* LV2DrySignalAligner::process(
+        const CSAMPLE* pDry, SINT numSamples, SINT delaySamples) {
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= m_alignedDry.size()) {
+        return pDry;
+    }
+    const SINT delayLineSize = m_delayLine.size();
+    VERIFY_OR_DEBUG_ASSERT(delaySamples >= 0 && delaySamples < delayLineSize) {
+        return pDry;
+    }
+
+    CSAMPLE* pAlignedDry = m_alignedDry.data();
+    SINT delaySourcePos = (m_delayPos + delayLineSize - delaySamples) % delayLineSize;
+    for (SINT i = 0; i < numSamples; ++i) {
+        m_delayLine[m_delayPos] = pDry[i];
+        m_delayPos = (m_delayPos + 1) % delayLineSize;
+        pAlignedDry[i] = m_delayLine[delaySourcePos];
+        delaySourcePos = (delaySourcePos + 1) % delayLineSize;
+    }
+
+    switch (m_outputLatency) {
+    case OutputLatency::None:
+        return pDry;
+    case OutputLatency::FadingIn:
+        SampleUtil::linearCrossfadeBuffersIn(pAlignedDry, pDry, numSamples);
+        break;
+    case OutputLatency::Delayed:
+        break;
+    case OutputLatency::FadingOut:
+        SampleUtil::linearCrossfadeBuffersOut(pAlignedDry, pDry, numSamples);
+        break;
+    }
+    return pAlignedDry;
+}
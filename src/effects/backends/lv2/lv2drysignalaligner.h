@@ -0,0 +1,54 @@
+#pragma once
+
+#include "effects/defs.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// LV2DrySignalAligner delays the dry signal of an effect chain by the
+/// latency of an LV2 effect, so the chain mixes the dry and the wet signal
+/// aligned. The latency is the buffer added by running the plugin on an
+/// LV2WorkerThread plus the latency reported by the plugin itself.
+/// Switching between the undelayed and the delayed dry signal is crossfaded
+/// within one buffer.
+class LV2DrySignalAligner {
+  public:
+    /// The latency of the effect output in the current callback
+    enum class OutputLatency {
+        None,
+        // Crossfading from the undelayed to the delayed signal
+        FadingIn,
+        Delayed,
+        // Crossfading from the delayed to the undelayed signal
+        FadingOut,
+    };
+
+    LV2DrySignalAligner();
+
+    /// Called from the main thread. Allocates the buffers for delaying up to
+    /// maxSamplesPerBuffer samples by up to maxDelaySamples.
+    void allocate(SINT maxSamplesPerBuffer, SINT maxDelaySamples);
+
+    bool isAllocated() const {
+        return m_delayLine.size() > 0;
+    }
+
+    OutputLatency outputLatency() const {
+        return m_outputLatency;
+    }
+
+    /// Called from the audio thread when the effect has been processed.
+    /// delayedOutput tells if the output of the effect is delayed in the
+    /// current callback. Returns the latency of the output in this callback.
+    OutputLatency updateOutputLatency(bool delayedOutput, EffectEnableState enableState);
+
+    /// Called from the audio thread after updateOutputLatency(). Feeds pDry
+    /// into the delay line and returns the dry signal aligned with the output
+    /// of the effect, which is valid until the next call.
+    const CSAMPLE* process(const CSAMPLE* pDry, SINT numSamples, SINT delaySamples);
+
+  private:
+    OutputLatency m_outputLatency;
+    mixxx::SampleBuffer m_delayLine;
+    SINT m_delayPos;
+    mixxx::SampleBuffer m_alignedDry;
+};
@@ -1,13 +1,83 @@
 #include "effects/backends/lv2/lv2effectprocessor.h"
 
+#include <QThread>
+#include <algorithm>
+
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 
-LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest)
+namespace {
+
+// Higher latencies are only compensated partially, which limits the size of
+// the dry signal delay line of each state.
+constexpr SINT kMaxCompensatedLatencyFrames = 16384;
+
+SINT compensatedLatencyFrames(float reportedLatency) {
+    // Also rejects NaN
+    if (!(reportedLatency > 0)) {
+        return 0;
+    }
+    return static_cast<SINT>(std::min(reportedLatency,
+            static_cast<float>(kMaxCompensatedLatencyFrames)));
+}
+
+} // anonymous namespace
+
+LV2EffectGroupState::~LV2EffectGroupState() {
+    // The worker thread might still be running this state
+    while (m_jobPending.load(std::memory_order_acquire)) {
+        QThread::yieldCurrentThread();
+    }
+    if (m_pInstance) {
+        lilv_instance_deactivate(m_pInstance);
+        lilv_instance_free(m_pInstance);
+    }
+}
+
+void LV2EffectGroupState::allocateWorkerBuffers(
+        const mixxx::EngineParameters& engineParameters,
+        int numParameters,
+        std::atomic<qint64>* pWorkerProcessingNanos) {
+    m_inputL.resize(engineParameters.framesPerBuffer());
+    m_inputR.resize(engineParameters.framesPerBuffer());
+    m_outputL.resize(engineParameters.framesPerBuffer());
+    m_outputR.resize(engineParameters.framesPerBuffer());
+    m_parameters.resize(numParameters);
+    m_delayedInput = mixxx::SampleBuffer(engineParameters.samplesPerBuffer());
+    m_delayedInput.clear();
+    m_pWorkerProcessingNanos = pWorkerProcessingNanos;
+}
+
+void LV2EffectGroupState::runJob() {
+    PerformanceTimer timer;
+    timer.start();
+
+    if (m_jobEnableState == EffectEnableState::Enabling && !m_active) {
+        lilv_instance_activate(m_pInstance);
+        m_active = true;
+    }
+
+    lilv_instance_run(m_pInstance, m_jobFrames);
+
+    if (m_jobEnableState == EffectEnableState::Disabling && m_active) {
+        lilv_instance_deactivate(m_pInstance);
+        m_active = false;
+    }
+
+    m_pWorkerProcessingNanos->fetch_add(timer.elapsed().toIntegerNanos());
+    m_jobPending.store(false, std::memory_order_release);
+}
+
+LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest,
+        std::shared_ptr<LV2WorkerThread> pWorkerThread)
         : m_pManifest(pManifest),
           m_pPlugin(pManifest->getPlugin()),
           m_audioPortIndices(pManifest->getAudioPortIndices()),
-          m_controlPortIndices(pManifest->getControlPortIndices()) {
+          m_controlPortIndices(pManifest->getControlPortIndices()),
+          m_latencyPortIndex(pManifest->getLatencyPortIndex()),
+          m_pWorkerThread(std::move(pWorkerThread)),
+          m_workerProcessingNanos(0) {
     m_inputL = new float[MAX_BUFFER_LEN];
     m_inputR = new float[MAX_BUFFER_LEN];
     m_outputL = new float[MAX_BUFFER_LEN];
@@ -38,6 +108,10 @@ LV2EffectProcessor::~LV2EffectProcessor() {
     delete[] m_LV2parameters;
 }
 
+mixxx::Duration LV2EffectProcessor::takeExternalProcessingTime() {
+    return mixxx::Duration::fromNanos(m_workerProcessingNanos.exchange(0));
+}
+
 void LV2EffectProcessor::processChannel(
         LV2EffectGroupState* channelState,
         const CSAMPLE* pInput,
@@ -47,6 +121,15 @@ void LV2EffectProcessor::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
+    if (m_pWorkerThread) {
+        processChannelOnWorkerThread(channelState,
+                pInput,
+                pOutput,
+                engineParameters,
+                enableState);
+        return;
+    }
+
     for (int i = 0; i < m_engineEffectParameters.size(); i++) {
         m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
     }
@@ -66,6 +149,15 @@ void LV2EffectProcessor::processChannel(
 
     lilv_instance_run(instance, framesPerBuffer);
 
+    if (m_latencyPortIndex >= 0) {
+        // The output of the plugin is delayed by its reported latency
+        // since it has been activated.
+        channelState->m_latencyFrames =
+                compensatedLatencyFrames(channelState->m_reportedLatency);
+        channelState->m_drySignalAligner.updateOutputLatency(
+                channelState->m_latencyFrames > 0, enableState);
+    }
+
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < framesPerBuffer; ++i) {
         pOutput[i * 2] = m_outputL[i];
@@ -77,6 +169,99 @@ void LV2EffectProcessor::processChannel(
     }
 }
 
+void LV2EffectProcessor::processChannelOnWorkerThread(
+        LV2EffectGroupState* channelState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState) {
+    const SINT framesPerBuffer = engineParameters.framesPerBuffer();
+    const SINT numSamples = engineParameters.samplesPerBuffer();
+
+    bool submitJob = true;
+    bool delayedOutput = true;
+    const bool jobPending = channelState->m_jobPending.load(std::memory_order_acquire);
+    if (!jobPending) {
+        // The latency reported by the plugin during the last job
+        channelState->m_latencyFrames =
+                compensatedLatencyFrames(channelState->m_reportedLatency);
+    }
+    if (jobPending) {
+        // The worker missed its deadline. Never wait for it in the audio
+        // thread. Instead drop this buffer and output the dry signal with
+        // the same latency as the wet signal.
+        SampleUtil::copy(pOutput, channelState->m_delayedInput.data(), numSamples);
+        submitJob = false;
+    } else if (enableState == EffectEnableState::Enabling) {
+        // The output of the worker, if any, is left over from the last time
+        // the effect was enabled. The output switches to the delayed signal
+        // with the next buffer, see below.
+        SampleUtil::copy(pOutput, pInput, numSamples);
+        delayedOutput = false;
+    } else if (channelState->m_hasJobOutput) {
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < framesPerBuffer; ++i) {
+            pOutput[i * 2] = channelState->m_outputL[i];
+            pOutput[i * 2 + 1] = channelState->m_outputR[i];
+        }
+    } else {
+        SampleUtil::copy(pOutput, channelState->m_delayedInput.data(), numSamples);
+    }
+
+    if (channelState->m_drySignalAligner.updateOutputLatency(delayedOutput, enableState) ==
+            LV2DrySignalAligner::OutputLatency::FadingIn) {
+        // Crossfade from the undelayed signal of the previous buffer to
+        // the delayed signal instead of repeating a buffer
+        SampleUtil::linearCrossfadeBuffersIn(pOutput, pInput, numSamples);
+    }
+
+    if (!submitJob) {
+        SampleUtil::copy(channelState->m_delayedInput.data(), pInput, numSamples);
+        channelState->m_hasJobOutput = false;
+        return;
+    }
+
+    // Prepare the job for the next callback
+    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+        channelState->m_parameters[i] =
+                static_cast<float>(m_engineEffectParameters[i]->value());
+    }
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < framesPerBuffer; ++i) {
+        channelState->m_inputL[i] = pInput[i * 2];
+        channelState->m_inputR[i] = pInput[i * 2 + 1];
+    }
+    SampleUtil::copy(channelState->m_delayedInput.data(), pInput, numSamples);
+    channelState->m_jobFrames = framesPerBuffer;
+    channelState->m_jobEnableState = enableState;
+
+    channelState->m_jobPending.store(true, std::memory_order_release);
+    channelState->m_hasJobOutput = m_pWorkerThread->submit(channelState);
+    if (!channelState->m_hasJobOutput) {
+        channelState->m_jobPending.store(false, std::memory_order_release);
+    }
+}
+
+const CSAMPLE* LV2EffectProcessor::alignDrySignal(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const CSAMPLE* pDry,
+        const mixxx::EngineParameters& engineParameters) {
+    if (!m_pWorkerThread && m_latencyPortIndex < 0) {
+        return pDry;
+    }
+    LV2EffectGroupState* pState = getChannelState(inputHandle, outputHandle);
+    VERIFY_OR_DEBUG_ASSERT(pState && pState->m_drySignalAligner.isAllocated()) {
+        return pDry;
+    }
+    const SINT numSamples = engineParameters.samplesPerBuffer();
+    SINT delaySamples = pState->m_latencyFrames * mixxx::kEngineChannelCount;
+    if (m_pWorkerThread) {
+        delaySamples += numSamples;
+    }
+    return pState->m_drySignalAligner.process(pDry, numSamples, delaySamples);
+}
+
 LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         const mixxx::EngineParameters& engineParameters) {
     LV2EffectGroupState* pState = new LV2EffectGroupState(engineParameters);
@@ -89,6 +274,39 @@ LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         qDebug() << this << "LV2EffectProcessor creating LV2EffectGroupState" << pState;
     }
 
+    SINT maxDrySignalDelaySamples = 0;
+    if (m_pWorkerThread) {
+        maxDrySignalDelaySamples += engineParameters.samplesPerBuffer();
+    }
+    if (m_latencyPortIndex >= 0) {
+        maxDrySignalDelaySamples += kMaxCompensatedLatencyFrames * mixxx::kEngineChannelCount;
+        lilv_instance_connect_port(pInstance,
+                m_latencyPortIndex,
+                &pState->m_reportedLatency);
+    }
+    if (maxDrySignalDelaySamples > 0) {
+        pState->m_drySignalAligner.allocate(
+                engineParameters.samplesPerBuffer(), maxDrySignalDelaySamples);
+    }
+
+    if (m_pWorkerThread) {
+        pState->allocateWorkerBuffers(engineParameters,
+                m_engineEffectParameters.size(),
+                &m_workerProcessingNanos);
+        for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+            pState->m_parameters[i] =
+                    static_cast<float>(m_engineEffectParameters[i]->value());
+            lilv_instance_connect_port(pInstance,
+                    m_controlPortIndices[i],
+                    &pState->m_parameters[i]);
+        }
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], pState->m_inputL.data());
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], pState->m_inputR.data());
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], pState->m_outputL.data());
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], pState->m_outputR.data());
+        return pState;
+    }
+
     if (pInstance) {
         for (int i = 0; i < m_engineEffectParameters.size(); i++) {
             m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
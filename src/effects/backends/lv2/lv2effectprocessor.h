@@ -2,25 +2,35 @@
 
 #include <lilv/lilv.h>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "effects/backends/effectprocessor.h"
+#include "effects/backends/lv2/lv2drysignalaligner.h"
 #include "effects/backends/lv2/lv2manifest.h"
+#include "effects/backends/lv2/lv2workerthread.h"
 #include "effects/defs.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/engine.h"
+#include "util/samplebuffer.h"
 
 // Refer to EffectProcessor for documentation
-class LV2EffectGroupState final : public EffectState {
+class LV2EffectGroupState final : public EffectState, public LV2WorkerJob {
   public:
     LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
             : EffectState(engineParameters),
-              m_pInstance(nullptr) {
-    }
-    ~LV2EffectGroupState() {
-        if (m_pInstance) {
-            lilv_instance_deactivate(m_pInstance);
-            lilv_instance_free(m_pInstance);
-        }
+              m_pInstance(nullptr),
+              m_jobPending(false),
+              m_jobFrames(0),
+              m_jobEnableState(EffectEnableState::Disabled),
+              m_hasJobOutput(false),
+              m_active(false),
+              m_reportedLatency(0),
+              m_latencyFrames(0),
+              m_pWorkerProcessingNanos(nullptr) {
     }
+    ~LV2EffectGroupState();
 
     LilvInstance* lilvInstance(const LilvPlugin* pPlugin,
             const mixxx::EngineParameters& engineParameters) {
@@ -31,13 +41,55 @@ class LV2EffectGroupState final : public EffectState {
         return m_pInstance;
     }
 
+    /// Called from the main thread when the state is created for a processor
+    /// that runs the plugin on an LV2WorkerThread. Allocates the port buffers
+    /// owned by this state, because the audio thread fills the buffers of
+    /// the next job while the worker may still be running other states.
+    void allocateWorkerBuffers(const mixxx::EngineParameters& engineParameters,
+            int numParameters,
+            std::atomic<qint64>* pWorkerProcessingNanos);
+
+    void runJob() override;
+
   private:
+    friend class LV2EffectProcessor;
+
     LilvInstance* m_pInstance;
+
+    // Only used when running on an LV2WorkerThread. The audio thread owns
+    // all members while m_jobPending is false and the worker owns the port
+    // buffers while it is true.
+    std::atomic<bool> m_jobPending;
+    SINT m_jobFrames;
+    EffectEnableState m_jobEnableState;
+    bool m_hasJobOutput;
+    bool m_active;
+    std::vector<float> m_inputL;
+    std::vector<float> m_inputR;
+    std::vector<float> m_outputL;
+    std::vector<float> m_outputR;
+    std::vector<float> m_parameters;
+    // The input of the previous callback, which is aligned with the output
+    // of the worker and used in place of it when no output is available.
+    mixxx::SampleBuffer m_delayedInput;
+    // Connected to the latency port of plugins that report their latency.
+    // Written by the plugin, so it must only be read while the audio thread
+    // owns the state.
+    float m_reportedLatency;
+    // The compensated latency of the plugin in the current callback
+    SINT m_latencyFrames;
+    LV2DrySignalAligner m_drySignalAligner;
+    std::atomic<qint64>* m_pWorkerProcessingNanos;
 };
 
 class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState> {
   public:
-    LV2EffectProcessor(LV2EffectManifestPointer pManifest);
+    /// If pWorkerThread is set the plugin is run on that thread with one
+    /// buffer of added latency instead of in the audio callback thread.
+    /// The dry signal of the chain is delayed accordingly, together with the
+    /// latency reported by the plugin, see alignDrySignal().
+    LV2EffectProcessor(LV2EffectManifestPointer pManifest,
+            std::shared_ptr<LV2WorkerThread> pWorkerThread = nullptr);
     ~LV2EffectProcessor();
 
     void loadEngineEffectParameters(
@@ -51,10 +103,30 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    const CSAMPLE* alignDrySignal(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const CSAMPLE* pDry,
+            const mixxx::EngineParameters& engineParameters) override;
+
+    mixxx::Duration takeExternalProcessingTime() override;
+
+    /// The states are connected to the ports and counters of this processor,
+    /// so they are never recycled by another processor.
+    QList<EffectState*> takeStatePool() override {
+        return {};
+    }
+
   private:
     LV2EffectGroupState* createSpecificState(
             const mixxx::EngineParameters& engineParameters) override;
 
+    void processChannelOnWorkerThread(
+            LV2EffectGroupState* channelState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState);
+
     LV2EffectManifestPointer m_pManifest;
     QList<EngineEffectParameterPointer> m_engineEffectParameters;
     float* m_inputL;
@@ -65,4 +137,8 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
     const LilvPlugin* m_pPlugin;
     const QList<int> m_audioPortIndices;
     const QList<int> m_controlPortIndices;
+    const int m_latencyPortIndex;
+    std::shared_ptr<LV2WorkerThread> m_pWorkerThread;
+    // Time spent by the worker thread running the states of this processor
+    std::atomic<qint64> m_workerProcessingNanos;
 };
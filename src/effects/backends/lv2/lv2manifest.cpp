@@ -9,6 +9,7 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
           m_minimum(lilv_plugin_get_num_ports(plug)),
           m_maximum(lilv_plugin_get_num_ports(plug)),
           m_default(lilv_plugin_get_num_ports(plug)),
+          m_latencyPortIndex(-1),
           m_status(AVAILABLE) {
     m_pLV2plugin = plug;
 
@@ -30,11 +31,21 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
     lilv_plugin_get_port_ranges_float(
             m_pLV2plugin, m_minimum.data(), m_maximum.data(), m_default.data());
 
+    // The latency port is read by the effect processor to delay the dry
+    // signal accordingly, it is not a parameter.
+    if (lilv_plugin_has_latency(m_pLV2plugin)) {
+        m_latencyPortIndex = static_cast<int>(
+                lilv_plugin_get_latency_port_index(m_pLV2plugin));
+    }
+
     // Counters to determine the type of the plug in
     int inputPorts = 0;
     int outputPorts = 0;
 
     for (int i = 0; i < numPorts; i++) {
+        if (i == m_latencyPortIndex) {
+            continue;
+        }
         const LilvPort* port = lilv_plugin_get_port_by_index(plug, i);
 
         if (lilv_port_is_a(m_pLV2plugin, port, properties["audio_port"])) {
@@ -162,6 +173,10 @@ QList<int> LV2Manifest::getControlPortIndices() {
     return controlPortIndices;
 }
 
+int LV2Manifest::getLatencyPortIndex() const {
+    return m_latencyPortIndex;
+}
+
 const LilvPlugin* LV2Manifest::getPlugin() {
     return m_pLV2plugin;
 }
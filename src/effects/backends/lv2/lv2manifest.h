@@ -21,6 +21,9 @@ class LV2Manifest : public EffectManifest {
 
     QList<int> getAudioPortIndices();
     QList<int> getControlPortIndices();
+    /// Returns the index of the control output port the plugin reports its
+    /// latency with, or -1 if the plugin has no latency.
+    int getLatencyPortIndex() const;
     const LilvPlugin* getPlugin();
     bool isValid();
     Status getStatus();
@@ -38,6 +41,7 @@ class LV2Manifest : public EffectManifest {
     QList<int> audioPortIndices;
     // This list contains the control port indices
     QList<int> controlPortIndices;
+    int m_latencyPortIndex;
 
     // Arrays used for storing minimum, maximum and default parameter values
     std::vector<float> m_minimum;
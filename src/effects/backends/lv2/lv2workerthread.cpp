@@ -0,0 +1,48 @@
+#include "effects/backends/lv2/lv2workerthread.h"
+
+namespace {
+
+// Each submitted job is one input/output channel combination of one effect
+// for one callback, so this is plenty for all chains of all decks.
+constexpr size_t kMaxPendingJobs = 1024;
+
+} // anonymous namespace
+
+LV2WorkerThread::LV2WorkerThread()
+        : m_jobs(kMaxPendingJobs),
+          m_stop(false) {
+    setObjectName("LV2WorkerThread");
+}
+
+LV2WorkerThread::~LV2WorkerThread() {
+    stop();
+}
+
+bool LV2WorkerThread::submit(LV2WorkerJob* pJob) {
+    if (!m_jobs.try_push(pJob)) {
+        return false;
+    }
+    m_semaRun.release();
+    return true;
+}
+
+void LV2WorkerThread::stop() {
+    m_stop = true;
+    m_semaRun.release();
+    wait();
+    runPendingJobs();
+}
+
+void LV2WorkerThread::run() {
+    while (!m_stop.load()) {
+        m_semaRun.acquire();
+        runPendingJobs();
+    }
+}
+
+void LV2WorkerThread::runPendingJobs() {
+    while (LV2WorkerJob** ppJob = m_jobs.front()) {
+        (*ppJob)->runJob();
+        m_jobs.pop();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+
+#include "rigtorp/SPSCQueue.h"
+
+/// One buffer of work submitted to an LV2WorkerThread
+class LV2WorkerJob {
+  public:
+    virtual ~LV2WorkerJob() = default;
+
+    /// Called from the LV2WorkerThread
+    virtual void runJob() = 0;
+};
+
+/// LV2WorkerThread runs LV2 plugins outside of the audio callback thread, so
+/// an expensive plugin does not use up the processing budget of the whole
+/// engine. LV2EffectProcessor submits the buffer of an LV2EffectGroupState
+/// during one callback and picks up the result in the next one, which adds
+/// one buffer of latency to the effect.
+class LV2WorkerThread : public QThread {
+  public:
+    LV2WorkerThread();
+    ~LV2WorkerThread() override;
+
+    /// Called from the audio thread. Returns false if the job could not be
+    /// queued, in which case the state must not be marked as pending.
+    bool submit(LV2WorkerJob* pJob);
+
+    /// Called from the main thread. Stops the thread and runs all remaining
+    /// jobs, so no LV2EffectGroupState is left waiting for its result.
+    void stop();
+
+  protected:
+    void run() override;
+
+  private:
+    void runPendingJobs();
+
+    rigtorp::SPSCQueue<LV2WorkerJob*> m_jobs;
+    QSemaphore m_semaRun;
+    std::atomic<bool> m_stop;
+};
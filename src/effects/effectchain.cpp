@@ -301,6 +301,8 @@ void EffectChain::registerInputChannel(const ChannelHandleAndGroup& handleGroup,
             &ControlObject::valueChanged,
             this,
             [this, handleGroup](double value) { slotChannelStatusChanged(value, handleGroup); });
+
+    refillStatePools();
 }
 
 EffectSlotPointer EffectChain::getEffectSlot(unsigned int slotNumber) {
@@ -418,6 +420,7 @@ void EffectChain::enableForInputChannel(const ChannelHandleAndGroup& handleGroup
     m_pMessenger->writeRequest(request);
 
     m_enabledInputChannels.insert(handleGroup);
+    refillStatePools();
 }
 
 void EffectChain::disableForInputChannel(const ChannelHandleAndGroup& handleGroup) {
@@ -430,6 +433,15 @@ void EffectChain::disableForInputChannel(const ChannelHandleAndGroup& handleGrou
     request->pTargetChain = m_pEngineEffectChain;
     request->DisableInputChannelForChain.channelHandle = handleGroup.handle();
     m_pMessenger->writeRequest(request);
+
+    refillStatePools();
+}
+
+void EffectChain::refillStatePools() {
+    const int numInputChannels = numInactiveInputChannels();
+    for (const auto& pEffectSlot : std::as_const(m_effectSlots)) {
+        pEffectSlot->refillStatePool(numInputChannels);
+    }
 }
 
 int EffectChain::presetIndex() const {
@@ -55,6 +55,11 @@ class EffectChain : public QObject {
     const QSet<ChannelHandleAndGroup>& getActiveChannels() const {
         return m_enabledInputChannels;
     }
+    /// The number of registered input channels that are not routed to the
+    /// chain. The effects keep EffectStates preallocated for all of them.
+    int numInactiveInputChannels() const {
+        return m_channelEnableButtons.size() - m_enabledInputChannels.size();
+    }
 
     double getSuperParameter() const;
     void setSuperParameter(double value, bool force = false);
@@ -96,6 +101,9 @@ class EffectChain : public QObject {
     // Activates EffectChain processing for the provided channel.
     void enableForInputChannel(const ChannelHandleAndGroup& handleGroup);
     void disableForInputChannel(const ChannelHandleAndGroup& handleGroup);
+    /// Replaces the preallocated EffectStates after a routing switch has been
+    /// sent to the engine, so the next switch does not wait for an allocation.
+    void refillStatePools();
 
     // Protected so QuickEffectChain can use the separate QuickEffect
     // chain preset list.
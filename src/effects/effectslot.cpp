@@ -18,6 +18,8 @@
 // The maximum number of effect parameters we're going to support.
 constexpr unsigned int kDefaultMaxParameters = 16;
 
+constexpr int kCpuLoadUpdateIntervalMillis = 250;
+
 EffectSlot::EffectSlot(const QString& group,
         EffectsManager* pEffectsManager,
         EffectsMessengerPointer pEffectsMessenger,
@@ -41,6 +43,17 @@ EffectSlot::EffectSlot(const QString& group,
     m_pControlLoaded = std::make_unique<ControlObject>(ConfigKey(m_group, "loaded"));
     m_pControlLoaded->setReadOnly();
 
+    // Fraction of the audio buffer duration spent processing the loaded
+    // effect. EngineEffect measures it in the audio thread, it is polled
+    // here to avoid touching controls from the audio thread.
+    m_pControlCpuLoad = std::make_unique<ControlObject>(ConfigKey(m_group, "cpu_load"));
+    m_pControlCpuLoad->setReadOnly();
+    m_cpuLoadTimer.setInterval(kCpuLoadUpdateIntervalMillis);
+    connect(&m_cpuLoadTimer,
+            &QTimer::timeout,
+            this,
+            &EffectSlot::slotUpdateCpuLoad);
+
     m_pControlNumParameters.insert(EffectParameterType::Knob,
             QSharedPointer<ControlObject>(
                     new ControlObject(ConfigKey(m_group, "num_parameters"))));
@@ -150,6 +163,9 @@ void EffectSlot::addToEngine() {
             m_pChain->getActiveChannels(),
             m_pEffectsManager->registeredInputChannels(),
             m_pEffectsManager->registeredOutputChannels());
+    // Preallocate the states for all input channels that may be routed to
+    // the chain while the effect is loaded.
+    refillStatePool(m_pChain->numInactiveInputChannels());
 
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
@@ -157,6 +173,8 @@ void EffectSlot::addToEngine() {
     request->AddEffectToChain.pEffect = m_pEngineEffect;
     request->AddEffectToChain.iIndex = m_iEffectNumber;
     m_pMessenger->writeRequest(request);
+
+    m_cpuLoadTimer.start();
 }
 
 void EffectSlot::removeFromEngine() {
@@ -171,7 +189,18 @@ void EffectSlot::removeFromEngine() {
     request->RemoveEffectFromChain.iIndex = m_iEffectNumber;
     m_pMessenger->writeRequest(request);
 
+    // The EngineEffect is deleted in the main thread after the engine has
+    // acknowledged the request, so it must not be polled anymore from now on.
+    m_cpuLoadTimer.stop();
     m_pEngineEffect = nullptr;
+    m_pControlCpuLoad->forceSet(0.0);
+}
+
+void EffectSlot::slotUpdateCpuLoad() {
+    if (!m_pEngineEffect) {
+        return;
+    }
+    m_pControlCpuLoad->forceSet(m_pEngineEffect->cpuLoad());
 }
 
 void EffectSlot::updateEngineState() {
@@ -214,6 +243,17 @@ void EffectSlot::fillEffectStatesMap(EffectStatesMap* pStatesMap) const {
     }
 };
 
+void EffectSlot::refillStatePool(int numInputChannels) {
+    if (!isLoaded()) {
+        return;
+    }
+    //TODO: get actual configuration of engine
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(96000),
+            MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+    m_pEngineEffect->refillStatePool(engineParameters, numInputChannels);
+}
+
 EffectManifestPointer EffectSlot::getManifest() const {
     return m_pManifest;
 }
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <QTimer>
 
 #include "control/controlencoder.h"
 #include "control/controlobject.h"
@@ -124,6 +125,9 @@ class EffectSlot : public QObject {
     }
 
     void fillEffectStatesMap(EffectStatesMap* pStatesMap) const;
+    /// Preallocates the EffectStates for routing numInputChannels more input
+    /// channels to the loaded effect.
+    void refillStatePool(int numInputChannels);
 
     EffectManifestPointer getManifest() const;
 
@@ -147,6 +151,7 @@ class EffectSlot : public QObject {
 
   private slots:
     void updateEngineState();
+    void slotUpdateCpuLoad();
     void visibleEffectsListChanged();
 
   private:
@@ -184,6 +189,8 @@ class EffectSlot : public QObject {
     QMap<EffectParameterType, QList<EffectParameterSlotBasePointer>> m_parameterSlots;
 
     std::unique_ptr<ControlObject> m_pControlLoaded;
+    std::unique_ptr<ControlObject> m_pControlCpuLoad;
+    QTimer m_cpuLoadTimer;
     // Apparently QHash doesn't work with std::unique_ptr
     QHash<EffectParameterType, QSharedPointer<ControlObject>> m_pControlNumParameters;
     QHash<EffectParameterType, QSharedPointer<ControlObject>> m_pControlNumParameterSlots;
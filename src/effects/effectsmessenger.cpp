@@ -72,6 +72,11 @@ void EffectsMessenger::processEffectsResponses() {
             // EngineEffectsMessenger and functions it calls to handle requests.
 
             collectGarbage(pRequest);
+            if (!response.success &&
+                    pRequest->type == EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL) {
+                // The EffectStates have not been taken over by the engine
+                deleteUnusedEffectStates(pRequest);
+            }
 
             delete pRequest;
             it = m_activeRequests.erase(it);
@@ -100,3 +105,17 @@ void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
                 pRequest->DisableInputChannelForChain.channelHandle);
     }
 }
+
+void EffectsMessenger::deleteUnusedEffectStates(const EffectsRequest* pRequest) {
+    EffectStatesMapArray* pStatesMapArray =
+            pRequest->EnableInputChannelForChain.pEffectStatesMapArray;
+    VERIFY_OR_DEBUG_ASSERT(pStatesMapArray) {
+        return;
+    }
+    for (auto&& statesMap : *pStatesMapArray) {
+        for (EffectState* pState : statesMap) {
+            delete pState;
+        }
+        statesMap.clear();
+    }
+}
@@ -25,6 +25,7 @@ class EffectsMessenger {
 
   private:
     void collectGarbage(const EffectsRequest* pRequest);
+    void deleteUnusedEffectStates(const EffectsRequest* pRequest);
 
     QString debugString() const {
         return "EffectsMessenger";
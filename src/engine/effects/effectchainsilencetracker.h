@@ -0,0 +1,52 @@
+#pragma once
+
+#include <limits>
+
+#include "effects/defs.h"
+#include "util/types.h"
+
+/// Tracks how long the input of an effect chain has been digitally silent
+/// for a single input/output channel combination.
+///
+/// Once the input has been silent for longer than the tail of all effects
+/// in the chain, their output is known to be silent as well and processing
+/// them can be skipped. The intermediate enabling/disabling states are never
+/// skipped, so the effects always receive these signals.
+class EffectChainSilenceTracker {
+  public:
+    EffectChainSilenceTracker()
+            : m_silentFrames(0) {
+    }
+
+    /// Returns the enable state for processing the effects of the chain
+    /// with the current buffer. A negative tail length never skips.
+    EffectEnableState process(
+            EffectEnableState enableState,
+            bool inputSilent,
+            SINT numFrames,
+            double tailLengthSeconds,
+            unsigned int sampleRate) {
+        if (!inputSilent) {
+            m_silentFrames = 0;
+            return enableState;
+        }
+        const SINT previousSilentFrames = m_silentFrames;
+        // Saturate instead of overflowing when silent for a very long time
+        if (previousSilentFrames <= std::numeric_limits<SINT>::max() - numFrames) {
+            m_silentFrames += numFrames;
+        }
+        if (enableState == EffectEnableState::Enabled &&
+                tailLengthSeconds >= 0.0 &&
+                previousSilentFrames >= tailLengthSeconds * sampleRate) {
+            return EffectEnableState::Disabled;
+        }
+        return enableState;
+    }
+
+    SINT silentFrames() const {
+        return m_silentFrames;
+    }
+
+  private:
+    SINT m_silentFrames;
+};
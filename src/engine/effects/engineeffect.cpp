@@ -2,16 +2,26 @@
 
 #include "engine/engine.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 
+namespace {
+
+// Weight of the latest callback for smoothing the published CPU load
+constexpr double kCpuLoadSmoothing = 0.1;
+
+} // anonymous namespace
+
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         EffectsBackendManagerPointer pBackendManager,
         const QSet<ChannelHandleAndGroup>& activeInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_pManifest(pManifest),
+          m_pBackendManager(pBackendManager),
           m_pProcessor(pBackendManager->createProcessor(pManifest)),
-          m_parameters(pManifest->parameters().size()) {
+          m_parameters(pManifest->parameters().size()),
+          m_cpuLoad(0.0) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
         EffectManifestParameterPointer param = parameters.at(i);
@@ -29,6 +39,7 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
     }
 
     m_pProcessor->loadEngineEffectParameters(m_parametersById);
+    m_pProcessor->addToStatePool(m_pBackendManager->takeRecycledEffectStates(m_pManifest));
 
     //TODO: get actual configuration of engine
     const mixxx::EngineParameters engineParameters(
@@ -42,6 +53,9 @@ EngineEffect::~EngineEffect() {
     if (kEffectDebugOutput) {
         qDebug() << debugString() << "destroyed";
     }
+    if (m_pProcessor) {
+        m_pBackendManager->recycleEffectStates(m_pManifest, m_pProcessor->takeStatePool());
+    }
     m_parametersById.clear();
     m_parameters.clear();
 }
@@ -53,6 +67,14 @@ EffectState* EngineEffect::createState(const mixxx::EngineParameters& enginePara
     return m_pProcessor->createState(engineParameters);
 }
 
+void EngineEffect::refillStatePool(const mixxx::EngineParameters& engineParameters,
+        int numInputChannels) {
+    VERIFY_OR_DEBUG_ASSERT(m_pProcessor) {
+        return;
+    }
+    m_pProcessor->refillStatePool(engineParameters, numInputChannels);
+}
+
 void EngineEffect::loadStatesForInputChannel(ChannelHandle inputChannel,
         EffectStatesMap* pStatesMap) {
     if (kEffectDebugOutput) {
@@ -66,6 +88,23 @@ void EngineEffect::deleteStatesForInputChannel(ChannelHandle inputChannel) {
     m_pProcessor->deleteStatesForInputChannel(inputChannel);
 }
 
+void EngineEffect::onCallbackStart() {
+    for (const auto& pParameter : std::as_const(m_parameters)) {
+        pParameter->onCallbackStart();
+    }
+
+    m_processingTime += m_pProcessor->takeExternalProcessingTime();
+    if (m_bufferDuration > mixxx::Duration()) {
+        const double load = m_processingTime.toDoubleNanos() /
+                m_bufferDuration.toDoubleNanos();
+        const double previousLoad = m_cpuLoad.load(std::memory_order_relaxed);
+        m_cpuLoad.store(previousLoad + kCpuLoadSmoothing * (load - previousLoad),
+                std::memory_order_relaxed);
+    }
+    m_processingTime = mixxx::Duration();
+    m_bufferDuration = mixxx::Duration();
+}
+
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                                          EffectsResponsePipe* pResponsePipe) {
     EngineEffectParameterPointer pParameter;
@@ -182,6 +221,9 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                 mixxx::audio::SampleRate(sampleRate),
                 numSamples / mixxx::kEngineChannelCount);
 
+        PerformanceTimer timer;
+        timer.start();
+
         m_pProcessor->process(inputHandle,
                 outputHandle,
                 pInput,
@@ -210,6 +252,13 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                         numSamples);
             }
         }
+
+        m_processingTime += timer.elapsed();
+        // All channels are processed within the same callback, so the
+        // buffer duration is the same for all of them.
+        m_bufferDuration = mixxx::Duration::fromSeconds(
+                static_cast<double>(engineParameters.framesPerBuffer()) /
+                engineParameters.sampleRate());
     }
 
     // Now that the EffectProcessor has been sent the intermediate enabling/disabling
@@ -223,3 +272,14 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
 
     return processingOccured;
 }
+
+const CSAMPLE* EngineEffect::alignDrySignal(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const CSAMPLE* pDry,
+        const unsigned int numSamples,
+        const unsigned int sampleRate) {
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(sampleRate),
+            numSamples / mixxx::kEngineChannelCount);
+    return m_pProcessor->alignDrySignal(inputHandle, outputHandle, pDry, engineParameters);
+}
@@ -6,6 +6,7 @@
 #include <QString>
 #include <QVector>
 #include <QtDebug>
+#include <atomic>
 
 #include "effects/backends/effectmanifest.h"
 #include "effects/backends/effectprocessor.h"
@@ -14,6 +15,7 @@
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
+#include "util/duration.h"
 #include "util/memory.h"
 
 /// EngineEffect is a generic wrapper around an EffectProcessor which intermediates
@@ -28,11 +30,18 @@ class EngineEffect final : public EffectsRequestHandler {
             const QSet<ChannelHandleAndGroup>& activeInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredOutputChannels);
-    /// Called in main thread by EffectSlot
+    /// Called in main thread by EffectSlot. The unused preallocated states are
+    /// handed back to the EffectsBackendManager for the next EngineEffect of
+    /// the same effect.
     ~EngineEffect();
 
     /// Called in main thread to allocate an EffectState
     EffectState* createState(const mixxx::EngineParameters& engineParameters);
+    /// Called in main thread to preallocate the EffectStates for routing
+    /// numInputChannels more input channels, including the ones that
+    /// createState() has taken from the pool
+    void refillStatePool(const mixxx::EngineParameters& engineParameters,
+            int numInputChannels);
 
     /// Called in audio thread to load EffectStates received from the main thread
     void loadStatesForInputChannel(ChannelHandle inputChannel,
@@ -40,6 +49,16 @@ class EngineEffect final : public EffectsRequestHandler {
     /// Called from the main thread for garbage collection after an input channel is disabled
     void deleteStatesForInputChannel(ChannelHandle inputChannel);
 
+    /// Called in audio thread before the pending EffectsRequests are processed.
+    /// Updates the CPU load from the processing time of the previous callback.
+    void onCallbackStart();
+
+    /// Called in main thread by EffectSlot to publish the CPU load, i.e. the
+    /// fraction of the audio buffer duration spent processing this effect.
+    double cpuLoad() const {
+        return m_cpuLoad.load(std::memory_order_relaxed);
+    }
+
     /// Called in audio thread
     bool processEffectsRequest(
             EffectsRequest& message,
@@ -55,6 +74,15 @@ class EngineEffect final : public EffectsRequestHandler {
             const EffectEnableState chainEnableState,
             const GroupFeatureState& groupFeatures);
 
+    /// Called in audio thread after process() returned true. Returns the dry
+    /// signal pDry aligned with the output of the effect, see
+    /// EffectProcessor::alignDrySignal().
+    const CSAMPLE* alignDrySignal(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const CSAMPLE* pDry,
+            const unsigned int numSamples,
+            const unsigned int sampleRate);
+
     const EffectManifestPointer getManifest() const {
         return m_pManifest;
     }
@@ -69,6 +97,7 @@ class EngineEffect final : public EffectsRequestHandler {
     }
 
     EffectManifestPointer m_pManifest;
+    EffectsBackendManagerPointer m_pBackendManager;
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
     bool m_effectRampsFromDry;
@@ -76,5 +105,12 @@ class EngineEffect final : public EffectsRequestHandler {
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
 
+    // Time spent processing all channels during the current callback and the
+    // duration of audio that has been processed in that time. The smoothed
+    // ratio is published as the "cpu_load" control by the EffectSlot.
+    mixxx::Duration m_processingTime;
+    mixxx::Duration m_bufferDuration;
+    std::atomic<double> m_cpuLoad;
+
     DISALLOW_COPY_AND_ASSIGN(EngineEffect);
 };
@@ -1,6 +1,7 @@
 #include "engine/effects/engineeffectchain.h"
 
 #include "engine/effects/engineeffect.h"
+#include "engine/engine.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
@@ -11,6 +12,7 @@ EngineEffectChain::EngineEffectChain(const QString& group,
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
+          m_tailLengthSeconds(0.0),
           m_buffer1(MAX_BUFFER_LEN),
           m_buffer2(MAX_BUFFER_LEN) {
     // Try to prevent memory allocation.
@@ -49,6 +51,7 @@ bool EngineEffectChain::addEffect(EngineEffect* pEffect, int iIndex) {
         m_effects.append(nullptr);
     }
     m_effects.replace(iIndex, pEffect);
+    updateTailLength();
     return true;
 }
 
@@ -70,9 +73,25 @@ bool EngineEffectChain::removeEffect(EngineEffect* pEffect, int iIndex) {
     }
 
     m_effects.replace(iIndex, nullptr);
+    updateTailLength();
     return true;
 }
 
+void EngineEffectChain::updateTailLength() {
+    m_tailLengthSeconds = 0.0;
+    for (EngineEffect* pEffect : qAsConst(m_effects)) {
+        if (pEffect == nullptr) {
+            continue;
+        }
+        const EffectManifestPointer pManifest = pEffect->getManifest();
+        if (!pManifest->hasKnownTailLength()) {
+            m_tailLengthSeconds = EffectManifest::kTailLengthUnknown;
+            return;
+        }
+        m_tailLengthSeconds += pManifest->tailLengthSeconds();
+    }
+}
+
 // this is called from the engine thread onCallbackStart()
 bool EngineEffectChain::updateParameters(const EffectsRequest& message) {
     // TODO(rryan): Parameter interpolation.
@@ -155,11 +174,8 @@ bool EngineEffectChain::enableForInputChannel(ChannelHandle inputHandle,
     for (auto&& outputChannelStatus : outputMap) {
         VERIFY_OR_DEBUG_ASSERT(outputChannelStatus.enableState !=
                 EffectEnableState::Enabled) {
-            for (auto&& pStatesMap : *statesForEffectsInChain) {
-                for (auto&& pState : pStatesMap) {
-                    delete pState;
-                }
-            }
+            // The unused EffectStates are deleted by EffectsMessenger in
+            // the main thread after receiving the failed EffectsResponse.
             return false;
         }
         outputChannelStatus.enableState = EffectEnableState::Enabling;
@@ -257,6 +273,16 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     CSAMPLE currentMixKnob = m_dMix;
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
 
+    // The effects keep processing with the mix knob fully dry, otherwise
+    // echo and reverb tails would be cut off when turning the knob up again.
+    const SINT numFrames = static_cast<SINT>(numSamples / mixxx::kEngineChannelCount);
+    effectiveChainEnableState = channelStatus.silenceTracker.process(
+            effectiveChainEnableState,
+            SampleUtil::isSilent(pIn, numSamples),
+            numFrames,
+            m_tailLengthSeconds,
+            sampleRate);
+
     bool processingOccured = false;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
         // Ramping code inside the effects need to access the original samples
@@ -265,6 +291,9 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         // requires that the input buffer does not get modified.
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
+        // The dry signal that is mixed with the output of the last effect.
+        // Effects with latency delay it to keep it aligned with the wet signal.
+        const CSAMPLE* pDry = pIn;
         bool firstAddDryToWetEffectProcessed = false;
 
         for (EngineEffect* pEffect : qAsConst(m_effects)) {
@@ -307,6 +336,11 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                         firstAddDryToWetEffectProcessed = true;
                     }
 
+                    pDry = pEffect->alignDrySignal(inputHandle,
+                            outputHandle,
+                            pDry,
+                            numSamples,
+                            sampleRate);
                     processingOccured = true;
                     // Output of this effect becomes the input of the next effect
                     pIntermediateInput = pIntermediateOutput;
@@ -321,7 +355,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                 // Dry/Wet mode: output = (input * (1-mix knob)) + (wet * mix knob)
                 SampleUtil::copy2WithRampingGain(
                         pOut,
-                        pIn,
+                        pDry,
                         1.0f - lastCallbackMixKnob,
                         1.0f - currentMixKnob,
                         pIntermediateInput,
@@ -332,7 +366,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                 // Dry+Wet mode: output = input + (wet * mix knob)
                 SampleUtil::copy2WithRampingGain(
                         pOut,
-                        pIn,
+                        pDry,
                         1.0f,
                         1.0f,
                         pIntermediateInput,
@@ -4,6 +4,7 @@
 #include <QString>
 
 #include "engine/channelhandle.h"
+#include "engine/effects/effectchainsilencetracker.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
 #include "util/class.h"
@@ -55,6 +56,7 @@ class EngineEffectChain final : public EffectsRequestHandler {
         }
         CSAMPLE oldMixKnob;
         EffectEnableState enableState;
+        EffectChainSilenceTracker silenceTracker;
     };
 
     QString debugString() const {
@@ -64,6 +66,7 @@ class EngineEffectChain final : public EffectsRequestHandler {
     bool updateParameters(const EffectsRequest& message);
     bool addEffect(EngineEffect* pEffect, int iIndex);
     bool removeEffect(EngineEffect* pEffect, int iIndex);
+    void updateTailLength();
     bool enableForInputChannel(ChannelHandle inputHandle,
             EffectStatesMapArray* statesForEffectsInChain);
     bool disableForInputChannel(ChannelHandle inputHandle);
@@ -78,6 +81,9 @@ class EngineEffectChain final : public EffectsRequestHandler {
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
+    // The sum of the tail lengths of all effects in the chain, which are
+    // processed in series, or EffectManifest::kTailLengthUnknown.
+    double m_tailLengthSeconds;
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
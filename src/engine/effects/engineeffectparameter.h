@@ -5,12 +5,18 @@
 
 #include "effects/backends/effectmanifestparameter.h"
 #include "util/class.h"
+#include "util/types.h"
 
+/// EngineEffectParameter is the audio thread counterpart of EffectParameter.
+/// Besides the current value it remembers the value from the start of the
+/// current engine callback, so EffectProcessors can interpolate parameter
+/// changes across the buffer instead of stepping once per callback.
 class EngineEffectParameter {
   public:
     EngineEffectParameter(EffectManifestParameterPointer pParameterManifest)
             : m_pParameterManifest(pParameterManifest) {
         m_value = m_pParameterManifest->getDefault();
+        m_previousValue = m_value;
     }
     virtual ~EngineEffectParameter() {
     }
@@ -22,6 +28,29 @@ class EngineEffectParameter {
     inline double value() const {
         return m_value;
     }
+    /// The value before any changes received during the current callback
+    inline double previousValue() const {
+        return m_previousValue;
+    }
+    /// True if the value changed during the current callback and should be
+    /// ramped from previousValue() to value() across the buffer.
+    inline bool isRamping() const {
+        return m_previousValue != m_value;
+    }
+    /// Linearly interpolates between previousValue() at frame 0 and value()
+    /// at frame numFrames.
+    inline double valueAt(SINT frame, SINT numFrames) const {
+        if (numFrames <= 0 || frame >= numFrames) {
+            return m_value;
+        }
+        return m_previousValue +
+                (m_value - m_previousValue) * frame / numFrames;
+    }
+    /// Called from the audio thread at the start of each callback before
+    /// the pending parameter changes are applied.
+    inline void onCallbackStart() {
+        m_previousValue = m_value;
+    }
     inline void setValue(const double value) {
         // Values should be clamped by EffectParameter before sending to the engine.
         VERIFY_OR_DEBUG_ASSERT(
@@ -41,6 +70,7 @@ class EngineEffectParameter {
   private:
     EffectManifestParameterPointer m_pParameterManifest;
     double m_value;
+    double m_previousValue;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectParameter);
 };
@@ -11,12 +11,22 @@ EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe* pResponsePipe)
           m_buffer2(MAX_BUFFER_LEN) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
+    // Insert the lists for all stages here, so adding the first chain of a
+    // stage does not allocate a hash node in the audio thread.
+    m_chainsByStage[SignalProcessingStage::Prefader].reserve(32);
+    m_chainsByStage[SignalProcessingStage::Postfader].reserve(32);
 }
 
 EngineEffectsManager::~EngineEffectsManager() {
 }
 
 void EngineEffectsManager::onCallbackStart() {
+    // Parameter changes received below are ramped from the values of the
+    // previous callback within this callback's buffer.
+    for (EngineEffect* pEffect : std::as_const(m_effects)) {
+        pEffect->onCallbackStart();
+    }
+
     EffectsRequest* request = nullptr;
     while (m_pResponsePipe->readMessage(&request)) {
         EffectsResponse response(*request);
@@ -235,8 +245,8 @@ bool EngineEffectsManager::addEffectChain(EngineEffectChain* pChain,
     VERIFY_OR_DEBUG_ASSERT(!chains.contains(pChain)) {
         return false;
     }
-    // This might allocate in the audio thread, but it is only used when Mixxx
-    // is starting up so there is no issue.
+    // This only allocates in the audio thread when more chains are added than
+    // reserved in the constructor.
     chains.append(pChain);
     return true;
 }
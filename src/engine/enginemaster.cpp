@@ -24,6 +24,7 @@
 #include "moc_enginemaster.cpp"
 #include "preferences/usersettings.h"
 #include "util/defs.h"
+#include "util/realtimeguard.h"
 #include "util/sample.h"
 #include "util/timer.h"
 #include "util/trace.h"
@@ -391,6 +392,7 @@ void EngineMaster::process(const int iBufferSize) {
         haveSetName = true;
     }
     //Trace t("EngineMaster::process");
+    mixxx::ScopedRealtimeSection realtimeSection;
 
     bool masterEnabled = m_pMasterEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -0,0 +1,323 @@
+#include "library/autodj/autodjcratetracks.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "util/assert.h"
+
+namespace {
+
+// After batches with more tracks all active tracks are sorted
+// again instead of inserting or erasing them one by one
+constexpr int kMaxIncrementalBatchSize = 64;
+
+// Tracks that have never been played sort first, like NULL in SQLite
+constexpr qint64 kNeverPlayed = std::numeric_limits<qint64>::min();
+
+qint64 lastPlayedSortKey(const QDateTime& lastPlayed) {
+    if (!lastPlayed.isValid()) {
+        return kNeverPlayed;
+    }
+    return lastPlayed.toMSecsSinceEpoch();
+}
+
+} // anonymous namespace
+
+AutoDJCrateTracks::AutoDJCrateTracks()
+        : m_unplayedActiveTrackCount(0),
+          m_activeTracksInvalid(false),
+          m_orderByLastPlayed(false) {
+}
+
+void AutoDJCrateTracks::clear() {
+    m_tracks.clear();
+    m_crateTrackIds.clear();
+    m_activeTracks.clear();
+    m_unplayedActiveTrackCount = 0;
+    m_activeTracksInvalid = false;
+}
+
+bool AutoDJCrateTracks::lessThan(const ActiveTrack& lhs, const ActiveTrack& rhs) const {
+    if (!m_orderByLastPlayed && lhs.timesPlayed != rhs.timesPlayed) {
+        return lhs.timesPlayed < rhs.timesPlayed;
+    }
+    if (lhs.lastPlayed != rhs.lastPlayed) {
+        return lhs.lastPlayed < rhs.lastPlayed;
+    }
+    // Ties are broken by id for a deterministic order
+    return lhs.id < rhs.id;
+}
+
+void AutoDJCrateTracks::setOrderByLastPlayed(bool orderByLastPlayed) {
+    if (m_orderByLastPlayed == orderByLastPlayed) {
+        return;
+    }
+    m_orderByLastPlayed = orderByLastPlayed;
+    if (!m_activeTracksInvalid) {
+        sortActiveTracks();
+    }
+}
+
+void AutoDJCrateTracks::insertActiveTrack(const ActiveTrack& activeTrack) {
+    if (m_activeTracksInvalid) {
+        return;
+    }
+    const auto it = std::upper_bound(
+            m_activeTracks.begin(),
+            m_activeTracks.end(),
+            activeTrack,
+            [this](const ActiveTrack& lhs, const ActiveTrack& rhs) {
+                return lessThan(lhs, rhs);
+            });
+    m_activeTracks.insert(it, activeTrack);
+    if (activeTrack.timesPlayed == 0) {
+        ++m_unplayedActiveTrackCount;
+    }
+}
+
+void AutoDJCrateTracks::eraseActiveTrack(const ActiveTrack& activeTrack) {
+    if (m_activeTracksInvalid) {
+        return;
+    }
+    const auto it = std::lower_bound(
+            m_activeTracks.begin(),
+            m_activeTracks.end(),
+            activeTrack,
+            [this](const ActiveTrack& lhs, const ActiveTrack& rhs) {
+                return lessThan(lhs, rhs);
+            });
+    VERIFY_OR_DEBUG_ASSERT(it != m_activeTracks.end() && it->id == activeTrack.id) {
+        return;
+    }
+    m_activeTracks.erase(it);
+    if (activeTrack.timesPlayed == 0) {
+        --m_unplayedActiveTrackCount;
+    }
+}
+
+void AutoDJCrateTracks::sortActiveTracks() const {
+    std::sort(
+            m_activeTracks.begin(),
+            m_activeTracks.end(),
+            [this](const ActiveTrack& lhs, const ActiveTrack& rhs) {
+                return lessThan(lhs, rhs);
+            });
+}
+
+void AutoDJCrateTracks::invalidateActiveTracks() {
+    m_activeTracksInvalid = true;
+    m_activeTracks.clear();
+    m_unplayedActiveTrackCount = 0;
+}
+
+void AutoDJCrateTracks::updateActiveTracks() const {
+    if (!m_activeTracksInvalid) {
+        return;
+    }
+    m_activeTracksInvalid = false;
+    m_activeTracks.reserve(m_tracks.size());
+    m_unplayedActiveTrackCount = 0;
+    for (auto it = m_tracks.constBegin(); it != m_tracks.constEnd(); ++it) {
+        if (it->autoDjRefs > 0) {
+            continue;
+        }
+        m_activeTracks.push_back(activeTrack(it.key(), it.value()));
+        if (it->timesPlayed == 0) {
+            ++m_unplayedActiveTrackCount;
+        }
+    }
+    sortActiveTracks();
+}
+
+template<typename Modify>
+void AutoDJCrateTracks::modifyActiveTrack(TrackId trackId, Track* pTrack, Modify modify) {
+    if (pTrack->autoDjRefs > 0) {
+        modify(pTrack);
+        return;
+    }
+    eraseActiveTrack(activeTrack(trackId, *pTrack));
+    modify(pTrack);
+    insertActiveTrack(activeTrack(trackId, *pTrack));
+}
+
+void AutoDJCrateTracks::addCrateTracks(CrateId crateId, const QVector<TrackInfo>& tracks) {
+    auto& crateTrackIds = m_crateTrackIds[crateId];
+    QVector<TrackId> insertedTrackIds;
+    for (const auto& trackInfo : tracks) {
+        if (crateTrackIds.contains(trackInfo.id)) {
+            continue;
+        }
+        crateTrackIds.insert(trackInfo.id);
+        auto it = m_tracks.find(trackInfo.id);
+        if (it != m_tracks.end()) {
+            // Does not affect the sort order
+            ++it->crateRefs;
+            continue;
+        }
+        m_tracks.insert(trackInfo.id,
+                Track{1,
+                        trackInfo.timesPlayed,
+                        lastPlayedSortKey(trackInfo.lastPlayed),
+                        qMax(trackInfo.autoDjRefs, 0)});
+        insertedTrackIds.append(trackInfo.id);
+    }
+    if (insertedTrackIds.size() > kMaxIncrementalBatchSize) {
+        invalidateActiveTracks();
+        return;
+    }
+    for (const auto& trackId : std::as_const(insertedTrackIds)) {
+        const Track& track = m_tracks[trackId];
+        if (track.autoDjRefs == 0) {
+            insertActiveTrack(activeTrack(trackId, track));
+        }
+    }
+}
+
+void AutoDJCrateTracks::removeCrateTracks(CrateId crateId, const QList<TrackId>& trackIds) {
+    const auto crateIt = m_crateTrackIds.find(crateId);
+    if (crateIt == m_crateTrackIds.end()) {
+        return;
+    }
+    if (trackIds.size() > kMaxIncrementalBatchSize) {
+        invalidateActiveTracks();
+    }
+    for (const auto& trackId : trackIds) {
+        if (!crateIt->remove(trackId)) {
+            continue;
+        }
+        const auto it = m_tracks.find(trackId);
+        VERIFY_OR_DEBUG_ASSERT(it != m_tracks.end()) {
+            continue;
+        }
+        if (--it->crateRefs > 0) {
+            continue;
+        }
+        if (it->autoDjRefs == 0) {
+            eraseActiveTrack(activeTrack(trackId, it.value()));
+        }
+        m_tracks.erase(it);
+    }
+}
+
+void AutoDJCrateTracks::removeCrate(CrateId crateId) {
+    const auto crateIt = m_crateTrackIds.find(crateId);
+    if (crateIt == m_crateTrackIds.end()) {
+        return;
+    }
+    const QList<TrackId> trackIds = crateIt->values();
+    removeCrateTracks(crateId, trackIds);
+    m_crateTrackIds.remove(crateId);
+}
+
+void AutoDJCrateTracks::setTimesPlayed(TrackId trackId, int timesPlayed) {
+    const auto it = m_tracks.find(trackId);
+    if (it == m_tracks.end() || it->timesPlayed == timesPlayed) {
+        return;
+    }
+    modifyActiveTrack(trackId, &it.value(), [timesPlayed](Track* pTrack) {
+        pTrack->timesPlayed = timesPlayed;
+    });
+}
+
+void AutoDJCrateTracks::setLastPlayed(TrackId trackId, const QDateTime& lastPlayed) {
+    const auto it = m_tracks.find(trackId);
+    const qint64 sortKey = lastPlayedSortKey(lastPlayed);
+    if (it == m_tracks.end() || it->lastPlayed == sortKey) {
+        return;
+    }
+    modifyActiveTrack(trackId, &it.value(), [sortKey](Track* pTrack) {
+        pTrack->lastPlayed = sortKey;
+    });
+}
+
+void AutoDJCrateTracks::setLastPlayed(const QHash<TrackId, QDateTime>& lastPlayed) {
+    if (lastPlayed.size() <= kMaxIncrementalBatchSize) {
+        for (auto it = lastPlayed.constBegin(); it != lastPlayed.constEnd(); ++it) {
+            setLastPlayed(it.key(), it.value());
+        }
+        return;
+    }
+    invalidateActiveTracks();
+    for (auto it = lastPlayed.constBegin(); it != lastPlayed.constEnd(); ++it) {
+        const auto trackIt = m_tracks.find(it.key());
+        if (trackIt != m_tracks.end()) {
+            trackIt->lastPlayed = lastPlayedSortKey(it.value());
+        }
+    }
+}
+
+void AutoDJCrateTracks::addAutoDjReference(TrackId trackId) {
+    const auto it = m_tracks.find(trackId);
+    if (it == m_tracks.end()) {
+        return;
+    }
+    if (it->autoDjRefs++ == 0) {
+        eraseActiveTrack(activeTrack(trackId, it.value()));
+    }
+}
+
+void AutoDJCrateTracks::removeAutoDjReference(TrackId trackId) {
+    const auto it = m_tracks.find(trackId);
+    if (it == m_tracks.end() || it->autoDjRefs == 0) {
+        return;
+    }
+    if (--it->autoDjRefs == 0) {
+        insertActiveTrack(activeTrack(trackId, it.value()));
+    }
+}
+
+int AutoDJCrateTracks::autoDjReferences(TrackId trackId) const {
+    const auto it = m_tracks.constFind(trackId);
+    if (it == m_tracks.constEnd()) {
+        return 0;
+    }
+    return it->autoDjRefs;
+}
+
+int AutoDJCrateTracks::activeTrackCount() const {
+    updateActiveTracks();
+    return static_cast<int>(m_activeTracks.size());
+}
+
+int AutoDJCrateTracks::unplayedActiveTrackCount() const {
+    updateActiveTracks();
+    return m_unplayedActiveTrackCount;
+}
+
+int AutoDJCrateTracks::activeTrackCountLastPlayedBefore(const QDateTime& lastPlayed) const {
+    updateActiveTracks();
+    const qint64 sortKey = lastPlayedSortKey(lastPlayed);
+    if (!m_orderByLastPlayed) {
+        return static_cast<int>(std::count_if(
+                m_activeTracks.begin(),
+                m_activeTracks.end(),
+                [sortKey](const ActiveTrack& activeTrack) {
+                    return activeTrack.lastPlayed != kNeverPlayed &&
+                            activeTrack.lastPlayed < sortKey;
+                }));
+    }
+    // Tracks that have never been played are not counted, like
+    // comparisons with NULL in SQLite
+    const auto compareLastPlayed = [](const ActiveTrack& activeTrack, qint64 key) {
+        return activeTrack.lastPlayed < key;
+    };
+    const auto begin = std::lower_bound(
+            m_activeTracks.begin(),
+            m_activeTracks.end(),
+            kNeverPlayed + 1,
+            compareLastPlayed);
+    const auto end = std::lower_bound(
+            begin,
+            m_activeTracks.end(),
+            sortKey,
+            compareLastPlayed);
+    return static_cast<int>(end - begin);
+}
+
+TrackId AutoDJCrateTracks::activeTrackAt(int index) const {
+    updateActiveTracks();
+    VERIFY_OR_DEBUG_ASSERT(index >= 0 && index < activeTrackCount()) {
+        return TrackId();
+    }
+    return m_activeTracks[index].id;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVector>
+#include <vector>
+
+#include "library/trackset/crate/crateid.h"
+#include "track/trackid.h"
+
+/// The candidate tracks for Auto DJ crates, i.e. all tracks that are
+/// contained in at least one crate that is an Auto DJ source.
+///
+/// Tracks that are neither queued in the Auto DJ playlist nor loaded
+/// into a deck are active. Active tracks are kept sorted by the number
+/// of times they have been played and the last time they have been
+/// played, least and longest ago played tracks first. Selecting the
+/// n-th active track takes constant time, counting tracks takes at
+/// most logarithmic time.
+///
+/// The structure is updated incrementally when crates, play counts or
+/// the Auto DJ queue change. After large batches of changes the active
+/// tracks are sorted again when they are accessed next instead of
+/// inserting them one by one.
+class AutoDJCrateTracks final {
+  public:
+    struct TrackInfo {
+        TrackId id;
+        int timesPlayed = 0;
+        /// Invalid if the track has never been played.
+        QDateTime lastPlayed;
+        /// The number of references in the Auto DJ playlist
+        /// plus the number of decks the track is loaded into.
+        int autoDjRefs = 0;
+    };
+
+    AutoDJCrateTracks();
+
+    void clear();
+
+    /// Order the active tracks only by the last time they have been
+    /// played, i.e. ignore the number of times they have been played.
+    void setOrderByLastPlayed(bool orderByLastPlayed);
+    bool isOrderedByLastPlayed() const {
+        return m_orderByLastPlayed;
+    }
+
+    bool containsCrate(CrateId crateId) const {
+        return m_crateTrackIds.contains(crateId);
+    }
+    /// Adds the tracks to the crate and inserts the tracks that are
+    /// not contained yet. The properties of tracks that are already
+    /// contained are ignored. Adding a crate without tracks marks it
+    /// as an Auto DJ source.
+    void addCrateTracks(CrateId crateId, const QVector<TrackInfo>& tracks);
+    void removeCrateTracks(CrateId crateId, const QList<TrackId>& trackIds);
+    void removeCrate(CrateId crateId);
+
+    bool contains(TrackId trackId) const {
+        return m_tracks.contains(trackId);
+    }
+    int size() const {
+        return m_tracks.size();
+    }
+    QList<TrackId> trackIds() const {
+        return m_tracks.keys();
+    }
+
+    void setTimesPlayed(TrackId trackId, int timesPlayed);
+    void setLastPlayed(TrackId trackId, const QDateTime& lastPlayed);
+    void setLastPlayed(const QHash<TrackId, QDateTime>& lastPlayed);
+
+    void addAutoDjReference(TrackId trackId);
+    void removeAutoDjReference(TrackId trackId);
+    int autoDjReferences(TrackId trackId) const;
+
+    int activeTrackCount() const;
+    int unplayedActiveTrackCount() const;
+    /// The number of active tracks that have been played before the
+    /// given time. Takes logarithmic time if ordered by last played
+    /// and linear time otherwise.
+    int activeTrackCountLastPlayedBefore(const QDateTime& lastPlayed) const;
+    /// The active track at the given index in sort order.
+    TrackId activeTrackAt(int index) const;
+
+    /// The number of tracks that are queued in the Auto DJ
+    /// playlist or loaded into a deck.
+    int queuedTrackCount() const {
+        return size() - activeTrackCount();
+    }
+
+  private:
+    struct Track {
+        int crateRefs;
+        int timesPlayed;
+        qint64 lastPlayed;
+        int autoDjRefs;
+    };
+
+    struct ActiveTrack {
+        int timesPlayed;
+        qint64 lastPlayed;
+        TrackId id;
+    };
+
+    static ActiveTrack activeTrack(TrackId trackId, const Track& track) {
+        return ActiveTrack{track.timesPlayed, track.lastPlayed, trackId};
+    }
+
+    bool lessThan(const ActiveTrack& lhs, const ActiveTrack& rhs) const;
+
+    void insertActiveTrack(const ActiveTrack& activeTrack);
+    void eraseActiveTrack(const ActiveTrack& activeTrack);
+    void sortActiveTracks() const;
+    void invalidateActiveTracks();
+    void updateActiveTracks() const;
+
+    // Modifies the sort key of the track while keeping
+    // the active tracks sorted
+    template<typename Modify>
+    void modifyActiveTrack(TrackId trackId, Track* pTrack, Modify modify);
+
+    QHash<TrackId, Track> m_tracks;
+    QHash<CrateId, QSet<TrackId>> m_crateTrackIds;
+
+    // Rebuilt lazily after large batches of changes
+    mutable std::vector<ActiveTrack> m_activeTracks;
+    mutable int m_unplayedActiveTrackCount;
+    mutable bool m_activeTracksInvalid;
+
+    bool m_orderByLastPlayed;
+};
@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "library/dao/trackschema.h"
+#include "library/libraryquerythread.h"
 #include "library/queryutil.h"
 #include "library/starrating.h"
 #include "library/trackcollection.h"
@@ -20,6 +21,7 @@
 #include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/platform.h"
+#include "util/timer.h"
 
 namespace {
 
@@ -31,6 +33,9 @@ const bool sDebug = false;
 constexpr int kIdColumn = 0;
 constexpr int kMaxSortColumns = 3;
 
+// The number of rows that are fetched at once from a windowed track source
+constexpr int kFetchPageSize = 256;
+
 // Constant for getModelSetting(name)
 const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
@@ -45,10 +50,16 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bInitialized(false),
+          m_bSelectAsync(false),
+          m_bSelectPending(false),
+          m_lastFetchedPage(0) {
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    if (m_bSelectPending) {
+        m_pTrackCollectionManager->queryThread()->cancel(this);
+    }
 }
 
 void BaseSqlTableModel::initHeaderProperties() {
@@ -160,6 +171,9 @@ void BaseSqlTableModel::initSortColumnMapping() {
 void BaseSqlTableModel::clearRows() {
     DEBUG_ASSERT(m_rowInfo.empty() == m_trackIdToRows.empty());
     DEBUG_ASSERT(m_rowInfo.size() >= m_trackIdToRows.size());
+    m_lastFetchedPage = 0;
+    m_scheduledFetchPages.clear();
+    m_missingTrackIds.clear();
     if (!m_rowInfo.isEmpty()) {
         beginRemoveRows(QModelIndex(), 0, m_rowInfo.size() - 1);
         m_rowInfo.clear();
@@ -211,12 +225,29 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
+    if (m_bSelectAsync && submitSelect()) {
+        return;
+    }
+    selectSync();
+}
+
+void BaseSqlTableModel::selectSync() {
+    if (!m_bInitialized) {
+        return;
+    }
+    if (m_bSelectPending) {
+        // The rows of a background select() would replace the
+        // result of this select()
+        m_pTrackCollectionManager->queryThread()->cancel(this);
+        m_bSelectPending = false;
+    }
+
+    ScopedTimer t("BaseSqlTableModel::selectSync");
     PerformanceTimer time;
     time.start();
 
     // Prepare query for id and all columns not in m_trackSource
-    QString queryString = QString("SELECT %1 FROM %2 %3")
-                                  .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    const QString queryString = tableQuery();
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -235,11 +266,6 @@ void BaseSqlTableModel::select() {
         return;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See Bug #1090888.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
@@ -288,7 +314,116 @@ void BaseSqlTableModel::select() {
                 m_sortColumns,
                 m_tableColumns.size() - 1, // exclude the 1st column with the id
                 &m_trackSortOrder);
+    }
+
+    replaceSelectedRows(std::move(rowInfos));
+
+    qDebug() << this << "select() took" << time.elapsed().debugMillisWithUnit()
+             << m_rowInfo.size();
+}
+
+QString BaseSqlTableModel::tableQuery() const {
+    return QString("SELECT %1 FROM %2 %3")
+            .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+}
+
+LibraryQueryTemporaryViews BaseSqlTableModel::temporaryViews() const {
+    QStringList viewNames;
+    viewNames << m_tableName;
+    if (m_trackSource) {
+        viewNames << m_trackSource->tableName();
+    }
+    return LibraryQueryThread::temporaryViews(m_database, viewNames);
+}
 
+bool BaseSqlTableModel::submitSelect() {
+    LibraryQueryThread* const pQueryThread = m_pTrackCollectionManager->queryThread();
+    if (!pQueryThread->isRunning()) {
+        return false;
+    }
+
+    ScopedTimer t("BaseSqlTableModel::submitSelect");
+    LibraryQueryRequest request;
+    request.temporaryViews = temporaryViews();
+    request.tableQuery = tableQuery();
+    if (m_trackSource) {
+        // The ids of the tracks are only known after the table query
+        // has been executed
+        request.trackSourceQuery = m_trackSource->filterAndSortQuery(
+                QString("SELECT %1 FROM %2").arg(m_idColumn, m_tableName),
+                m_currentSearch,
+                m_currentSearchFilter,
+                m_trackSourceOrderBy);
+    }
+
+    if (sDebug) {
+        qDebug() << this << "select() submitting:" << request.tableQuery
+                 << request.trackSourceQuery;
+    }
+
+    m_bSelectPending = true;
+    pQueryThread->submit(this,
+            std::move(request),
+            [this](LibraryQueryResult result) {
+                applySelectResult(std::move(result));
+            });
+    return true;
+}
+
+void BaseSqlTableModel::applySelectResult(LibraryQueryResult result) {
+    DEBUG_ASSERT(m_bSelectPending);
+    m_bSelectPending = false;
+    if (!result.succeeded) {
+        qWarning() << this << "Selecting in background failed";
+        selectSync();
+        emit selectFinished();
+        return;
+    }
+
+    ScopedTimer t("BaseSqlTableModel::applySelectResult");
+    PerformanceTimer time;
+    time.start();
+
+    QVector<RowInfo> rowInfos;
+    rowInfos.reserve(result.tableRows.size());
+    QSet<TrackId> trackIds;
+    trackIds.reserve(result.tableRows.size());
+    for (auto& row : result.tableRows) {
+        VERIFY_OR_DEBUG_ASSERT(row.size() == m_tableColumns.size()) {
+            continue;
+        }
+        TrackId trackId(row.at(kIdColumn));
+        trackIds.insert(trackId);
+
+        RowInfo rowInfo;
+        rowInfo.trackId = trackId;
+        // current position defines the ordering
+        rowInfo.order = rowInfos.size();
+        rowInfo.metadata = std::move(row);
+        rowInfos.push_back(std::move(rowInfo));
+    }
+
+    if (m_trackSource) {
+        m_trackSource->applyFilterAndSortResult(trackIds,
+                result.trackSourceOrder,
+                m_currentSearch,
+                m_sortColumns,
+                m_tableColumns.size() - 1, // exclude the 1st column with the id
+                &m_trackSortOrder);
+    }
+
+    replaceSelectedRows(std::move(rowInfos));
+
+    // Only the time spent in the GUI thread, the queries have been
+    // executed in the background
+    qDebug() << this << "select() blocked the GUI thread for"
+             << time.elapsed().debugMillisWithUnit()
+             << m_rowInfo.size();
+    emit selectFinished();
+}
+
+void BaseSqlTableModel::replaceSelectedRows(QVector<RowInfo>&& rowInfos) {
+    if (m_trackSource) {
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
         for (auto& rowInfo : rowInfos) {
@@ -328,15 +463,17 @@ void BaseSqlTableModel::select() {
     // number of total rows returned by the query
     DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
 
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See Bug #1090888.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
+
     // We're done! Issue the update signals and replace the master maps.
     replaceRows(
             std::move(rowInfos),
             std::move(trackIdToRows));
     // Both rowInfo and trackIdToRows (might) have been moved and
     // must not be used afterwards!
-
-    qDebug() << this << "select() took" << time.elapsed().debugMillisWithUnit()
-             << m_rowInfo.size();
 }
 
 void BaseSqlTableModel::setTable(const QString& tableName,
@@ -666,6 +803,16 @@ QVariant BaseSqlTableModel::rawValue(
     // Subtract table columns from index to get the track source column
     // number and add 1 to skip over the id column.
     int trackSourceColumn = column - m_tableColumns.size() + 1;
+    if (!m_trackSource->isCached(trackId) && m_trackSource->isWindowed()) {
+        // Only the tracks of recently visible rows are cached. The row
+        // is updated when its page has been fetched. Fetching a track that
+        // is missing from the track source again would only repaint the
+        // row and request it again, endlessly.
+        if (!m_missingTrackIds.contains(trackId)) {
+            scheduleFetchPage(row);
+        }
+        return QVariant();
+    }
     if (!m_trackSource->isCached(trackId)) {
         // Ideally Mixxx would have notified us of this via a signal, but in
         // the case that a track is not in the cache, we attempt to load it
@@ -679,6 +826,84 @@ QVariant BaseSqlTableModel::rawValue(
     return m_trackSource->data(trackId, trackSourceColumn);
 }
 
+void BaseSqlTableModel::fetchPage(int row) const {
+    const int page = row / kFetchPageSize;
+    const int numPages = (m_rowInfo.size() + kFetchPageSize - 1) / kFetchPageSize;
+    // Read ahead in scroll direction
+    const int readAheadPage = page >= m_lastFetchedPage ? page + 1 : page - 1;
+    m_lastFetchedPage = page;
+
+    QSet<TrackId> trackIds;
+    for (const int pageToFetch : {page, readAheadPage}) {
+        if (pageToFetch < 0 || pageToFetch >= numPages) {
+            continue;
+        }
+        const int endRow = std::min(
+                (pageToFetch + 1) * kFetchPageSize, static_cast<int>(m_rowInfo.size()));
+        for (int i = pageToFetch * kFetchPageSize; i < endRow; ++i) {
+            const TrackId trackId = m_rowInfo[i].trackId;
+            if (!m_missingTrackIds.contains(trackId)) {
+                trackIds.insert(trackId);
+            }
+        }
+    }
+    m_missingTrackIds.unite(m_trackSource->fetch(trackIds));
+}
+
+void BaseSqlTableModel::scheduleFetchPage(int row) const {
+    const bool fetchScheduled = !m_scheduledFetchPages.isEmpty();
+    m_scheduledFetchPages.insert(row / kFetchPageSize);
+    if (fetchScheduled) {
+        return;
+    }
+    // Only the members used for fetching are mutable
+    auto* pModel = const_cast<BaseSqlTableModel*>(this);
+    QMetaObject::invokeMethod(
+            pModel,
+            [pModel]() {
+                pModel->fetchScheduledPages();
+            },
+            Qt::QueuedConnection);
+}
+
+void BaseSqlTableModel::fetchScheduledPages() {
+    const QSet<int> pages = std::move(m_scheduledFetchPages);
+    m_scheduledFetchPages.clear();
+    if (!m_trackSource) {
+        return;
+    }
+    for (const int page : pages) {
+        const int firstRow = page * kFetchPageSize;
+        // The rows might have been replaced in the meantime
+        if (firstRow >= m_rowInfo.size()) {
+            continue;
+        }
+        fetchPage(firstRow);
+        const int lastRow = std::min(
+                firstRow + kFetchPageSize, static_cast<int>(m_rowInfo.size())) - 1;
+        emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1));
+    }
+}
+
+void BaseSqlTableModel::prefetchRows(const QModelIndexList& indices) {
+    if (!m_trackSource || !m_trackSource->isWindowed()) {
+        return;
+    }
+    QSet<int> pages;
+    for (const auto& index : indices) {
+        const int row = index.row();
+        if (row < 0 || row >= m_rowInfo.size()) {
+            continue;
+        }
+        if (!m_trackSource->isCached(m_rowInfo[row].trackId)) {
+            pages.insert(row / kFetchPageSize);
+        }
+    }
+    for (const int page : qAsConst(pages)) {
+        fetchPage(page * kFetchPageSize);
+    }
+}
+
 bool BaseSqlTableModel::setTrackValueForColumn(
         const TrackPointer& pTrack,
         int column,
@@ -830,6 +1055,8 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
     if (sDebug) {
         qDebug() << this << "trackChanged" << trackIds.size();
     }
+    // Tracks that were missing might have been added to the track source
+    m_missingTrackIds.subtract(trackIds);
 
     const int numColumns = columnCount();
     for (const auto& trackId : trackIds) {
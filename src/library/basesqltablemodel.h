@@ -7,6 +7,7 @@
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
+#include "library/libraryquerythread.h"
 #include "util/class.h"
 
 class TrackCollectionManager;
@@ -29,6 +30,17 @@ class BaseSqlTableModel : public BaseTrackTableModel {
         return m_bInitialized;
     }
 
+    /// Execute the queries of select() in the background by LibraryQueryThread
+    /// and replace the rows when they have finished. Only suitable for models
+    /// that are displayed, other users expect the rows to be available when
+    /// select() returns.
+    void setSelectAsync(bool selectAsync) {
+        m_bSelectAsync = selectAsync;
+    }
+    bool isSelectPending() const {
+        return m_bSelectPending;
+    }
+
     void setSearch(const QString& searchText, const QString& extraFilter = QString());
     void setSort(int column, Qt::SortOrder order);
 
@@ -65,7 +77,14 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     void hideTracks(const QModelIndexList& indices) override;
 
+    /// Fetches the tracks of the visible rows if the track source is
+    /// windowed.
+    void prefetchRows(const QModelIndexList& indices) override;
+
     void select() override;
+    /// Selects the rows before returning, even if the queries of select()
+    /// are executed in the background otherwise.
+    void selectSync();
 
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
@@ -106,6 +125,11 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int m_columnIndexBySortColumnId[static_cast<int>(TrackModel::SortColumnId::IdMax)];
     QMap<int, TrackModel::SortColumnId> m_sortColumnIdByColumnIndex;
 
+  signals:
+    /// Emitted after the rows have been replaced by a select() that
+    /// has been executed in the background.
+    void selectFinished();
+
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
 
@@ -118,6 +142,14 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     // called.
     QString orderByClause() const;
 
+    QString tableQuery() const;
+    // The temporary views of our connection that are required
+    // to execute the queries on a different connection
+    LibraryQueryTemporaryViews temporaryViews() const;
+    // Returns false if the queries cannot be executed in the background
+    bool submitSelect();
+    void applySelectResult(LibraryQueryResult result);
+
     struct RowInfo {
         TrackId trackId;
         int order;
@@ -136,6 +168,16 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
 
+    // Fetches the tracks of the page that contains the row and reads
+    // ahead one page in scroll direction if the track source is windowed
+    void fetchPage(int row) const;
+    // Defers fetching the page of a row that is requested by data() to the
+    // event loop, so that painting is not blocked by database queries
+    void scheduleFetchPage(int row) const;
+    void fetchScheduledPages();
+
+    // Sorts the rows by the order of the track source before replacing them
+    void replaceSelectedRows(QVector<RowInfo>&& rowInfos);
     void clearRows();
     void replaceRows(
             QVector<RowInfo>&& rows,
@@ -148,12 +190,19 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QStringList m_tableColumns;
     QList<SortColumn> m_sortColumns;
     bool m_bInitialized;
+    bool m_bSelectAsync;
+    bool m_bSelectPending;
     QHash<TrackId, int> m_trackSortOrder;
     TrackId2Rows m_trackIdToRows;
     QString m_currentSearch;
     QString m_currentSearchFilter;
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
+    mutable int m_lastFetchedPage;
+    mutable QSet<int> m_scheduledFetchPages;
+    // Tracks that have been fetched but are not contained in the track
+    // source, e.g. because they have been deleted in the meantime
+    mutable QSet<TrackId> m_missingTrackIds;
 
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
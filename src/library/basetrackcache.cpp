@@ -1,5 +1,7 @@
 #include "library/basetrackcache.h"
 
+#include <algorithm>
+
 #include "library/queryutil.h"
 #include "library/searchqueryparser.h"
 #include "library/trackcollection.h"
@@ -19,16 +21,21 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
         const QString& tableName,
         const QString& idColumn,
         const QStringList& columns,
-        bool isCaching)
+        bool isCaching,
+        bool sortKeysEnabled)
         : m_tableName(tableName),
           m_idColumn(idColumn),
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
-          m_columnCache(columns),
+          m_columnCache(columns, sortKeysEnabled),
           m_pQueryParser(new SearchQueryParser(pTrackCollection)),
+          m_pSortKeyGenerator(sortKeysEnabled
+                          ? std::make_unique<mixxx::CollationSortKeyGenerator>()
+                          : nullptr),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
-          m_database(pTrackCollection->database()) {
+          m_database(pTrackCollection->database()),
+          m_windowSize(0) {
     m_searchColumns << "artist"
                     << "album"
                     << "album_artist"
@@ -52,6 +59,11 @@ BaseTrackCache::~BaseTrackCache() {
     // in header file
 }
 
+void BaseTrackCache::setWindowSize(int windowSize) {
+    DEBUG_ASSERT(!m_bIndexBuilt);
+    m_windowSize = std::max(windowSize, 0);
+}
+
 int BaseTrackCache::columnCount() const {
     return m_columnCount;
 }
@@ -92,6 +104,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     }
     for (const auto& trackId : qAsConst(trackIds)) {
         m_trackInfo.remove(trackId);
+        removeTrackFromWindow(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -124,6 +137,22 @@ void BaseTrackCache::ensureCached(const QSet<TrackId>& trackIds) {
     updateTracksInIndex(trackIds);
 }
 
+QSet<TrackId> BaseTrackCache::fetch(const QSet<TrackId>& trackIds) {
+    QSet<TrackId> missingTrackIds;
+    for (const auto& trackId : trackIds) {
+        if (!m_trackInfo.contains(trackId)) {
+            missingTrackIds.insert(trackId);
+        }
+    }
+    if (missingTrackIds.isEmpty()) {
+        return missingTrackIds;
+    }
+    if (!updateIndexWithQuery(selectTracksQuery(missingTrackIds), &missingTrackIds)) {
+        qDebug() << "fetch failed!";
+    }
+    return missingTrackIds;
+}
+
 void BaseTrackCache::setSearchColumns(const QStringList& columns) {
     m_searchColumns = columns;
 }
@@ -218,14 +247,13 @@ bool BaseTrackCache::updateTrackInIndex(
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
+        QVector<QVariant>& record = trackInfoForUpdate(trackId);
         // preallocate memory for all columns at once
         record.resize(numColumns);
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        evictTracksOutsideWindow();
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), std::move(pTrack));
         }
@@ -237,7 +265,8 @@ bool BaseTrackCache::updateTrackInIndex(
     return true;
 }
 
-bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
+bool BaseTrackCache::updateIndexWithQuery(
+        const QString& queryString, QSet<TrackId>* pTrackIds) {
     PerformanceTimer timer;
     timer.start();
 
@@ -265,10 +294,11 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
 
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
+        if (pTrackIds) {
+            pTrackIds->remove(trackId);
+        }
 
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
+        QVector<QVariant>& record = trackInfoForUpdate(trackId);
         record.resize(numColumns);
 
         for (int i = 0; i < numColumns; ++i) {
@@ -283,10 +313,60 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
         }
     }
 
+    evictTracksOutsideWindow();
+
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
     return true;
 }
 
+QVector<QVariant>& BaseTrackCache::trackInfoForUpdate(TrackId trackId) {
+    if (m_windowSize > 0) {
+        auto it = m_windowedTrackIdPositions.constFind(trackId);
+        if (it == m_windowedTrackIdPositions.constEnd()) {
+            m_windowedTrackIdPositions.insert(trackId,
+                    m_windowedTrackIds.insert(m_windowedTrackIds.end(), trackId));
+        } else {
+            touchTrackInWindow(trackId);
+        }
+    }
+    // m_trackInfo[id] will insert a QVector<QVariant> into the
+    // m_trackInfo HashTable with the key "id"
+    return m_trackInfo[trackId];
+}
+
+void BaseTrackCache::touchTrackInWindow(TrackId trackId) const {
+    if (m_windowSize <= 0) {
+        return;
+    }
+    const auto it = m_windowedTrackIdPositions.constFind(trackId);
+    if (it == m_windowedTrackIdPositions.constEnd()) {
+        return;
+    }
+    // Moving the node keeps all positions valid
+    m_windowedTrackIds.splice(m_windowedTrackIds.end(), m_windowedTrackIds, it.value());
+}
+
+void BaseTrackCache::removeTrackFromWindow(TrackId trackId) {
+    const auto it = m_windowedTrackIdPositions.find(trackId);
+    if (it == m_windowedTrackIdPositions.end()) {
+        return;
+    }
+    m_windowedTrackIds.erase(it.value());
+    m_windowedTrackIdPositions.erase(it);
+}
+
+void BaseTrackCache::evictTracksOutsideWindow() {
+    if (m_windowSize <= 0) {
+        return;
+    }
+    while (m_trackInfo.size() > m_windowSize && !m_windowedTrackIds.empty()) {
+        const TrackId trackId = m_windowedTrackIds.front();
+        m_windowedTrackIds.pop_front();
+        m_windowedTrackIdPositions.remove(trackId);
+        m_trackInfo.remove(trackId);
+    }
+}
+
 void BaseTrackCache::buildIndex() {
     if (sDebug) {
         qDebug() << this << "buildIndex()";
@@ -303,6 +383,14 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_windowedTrackIds.clear();
+    m_windowedTrackIdPositions.clear();
+
+    if (m_windowSize > 0) {
+        // Tracks are fetched on demand
+        m_bIndexBuilt = true;
+        return;
+    }
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -322,13 +410,7 @@ void BaseTrackCache::updateTracksInIndex(const QSet<TrackId>& trackIds) {
         return;
     }
 
-    QStringList idStrings;
-    for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 WHERE %3 in (%4)")
-            .arg(m_columnsJoined, m_tableName, m_idColumn, idStrings.join(","));
+    QString queryString = selectTracksQuery(trackIds);
 
     if (sDebug) {
         qDebug() << this << "updateTracksInIndex update query:" << queryString;
@@ -341,6 +423,16 @@ void BaseTrackCache::updateTracksInIndex(const QSet<TrackId>& trackIds) {
     emit tracksChanged(trackIds);
 }
 
+QString BaseTrackCache::selectTracksQuery(const QSet<TrackId>& trackIds) const {
+    QStringList idStrings;
+    idStrings.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idStrings << trackId.toString();
+    }
+    return QString("SELECT %1 FROM %2 WHERE %3 in (%4)")
+            .arg(m_columnsJoined, m_tableName, m_idColumn, idStrings.join(","));
+}
+
 void BaseTrackCache::getTrackValueForColumn(TrackPointer pTrack,
                                             int column,
                                             QVariant& trackValue) const {
@@ -449,6 +541,7 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
         if (it != m_trackInfo.constEnd()) {
             const QVector<QVariant>& fields = it.value();
             result = fields.value(column, result);
+            touchTrackInWindow(trackId);
         }
     }
     return result;
@@ -466,43 +559,17 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         return;
     }
 
-    if (!m_bIndexBuilt) {
-        buildIndex();
-    }
-
     QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
-    QSet<TrackId> dirtyTracks;
+    idStrings.reserve(trackIds.size());
     for (const auto& trackId: trackIds) {
         idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
-        }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    m_searchColumns,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    const QString queryString = filterAndSortQuery(
+            idStrings.join(","),
+            searchQuery,
+            extraFilter,
+            orderByClause);
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -525,17 +592,65 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         qDebug() << "Rows returned:" << rows;
     }
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
+    QVector<TrackId> trackOrder;
     if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
+        trackOrder.reserve(rows);
     }
-
     while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+        trackOrder.append(TrackId(query.value(idColumn)));
+    }
+
+    applyFilterAndSortResult(trackIds,
+            trackOrder,
+            searchQuery,
+            sortColumns,
+            columnOffset,
+            trackToIndex);
+}
+
+QString BaseTrackCache::filterAndSortQuery(const QString& trackIdsSql,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause) const {
+    QStringList queryFragments;
+    if (!extraFilter.isNull() && extraFilter != "") {
+        queryFragments << QString("(%1)").arg(extraFilter);
+    }
+    if (!trackIdsSql.isEmpty()) {
+        queryFragments << QString("%1 in (%2)")
+                .arg(m_idColumn, trackIdsSql);
+    }
+
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(
+                    searchQuery,
+                    m_searchColumns,
+                    queryFragments.join(" AND "));
+
+    QString filter = pQuery->toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    return QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+}
+
+void BaseTrackCache::applyFilterAndSortResult(const QSet<TrackId>& trackIds,
+        const QVector<TrackId>& trackOrder,
+        const QString& searchQuery,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QHash<TrackId, int>* trackToIndex) {
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+
+    m_trackOrder = trackOrder;
+    trackToIndex->clear();
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -547,10 +662,30 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     // membership of tracks in either set, we must then insertion-sort the
     // missing tracks into the resulting index list.
 
-    if (!m_bIsCaching || dirtyTracks.isEmpty()) {
+    if (!m_bIsCaching) {
+        return;
+    }
+
+    // TODO(rryan) consider making this the data passed in and a separate
+    // QVector for output
+    QSet<TrackId> dirtyTracks;
+    for (const auto& trackId: trackIds) {
+        if (m_dirtyTracks.contains(trackId)) {
+            dirtyTracks.insert(trackId);
+        }
+    }
+    if (dirtyTracks.isEmpty()) {
         return;
     }
 
+    // The id and extra filters are SQL expressions that match every
+    // track and can be omitted here
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(
+                    searchQuery,
+                    m_searchColumns,
+                    QString());
+
     for (TrackId trackId: qAsConst(dirtyTracks)) {
         // Only get the track if it is in the cache. Tracks that
         // are not cached in memory cannot be dirty.
@@ -616,7 +751,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
-        const QVector<TrackId>& trackIds) const {
+        const QVector<TrackId>& trackIds) {
     QList<QVariant> trackValues;
     if (sortColumns.isEmpty()) {
         return 0;
@@ -641,11 +776,16 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         int mid = min + (max - min) / 2;
         TrackId otherTrackId(trackIds[mid]);
 
-        // This should not happen, but it's a recoverable error so we should
-        // only log it.
         if (!m_trackInfo.contains(otherTrackId)) {
-            qDebug() << "WARNING: track" << otherTrackId << "was not in index";
-            //updateTrackInIndex(otherTrackId);
+            if (m_windowSize > 0) {
+                // Only a few tracks are fetched during the binary search
+                fetch(QSet<TrackId>{otherTrackId});
+            } else {
+                // This should not happen, but it's a recoverable error so we should
+                // only log it.
+                qDebug() << "WARNING: track" << otherTrackId << "was not in index";
+                //updateTrackInIndex(otherTrackId);
+            }
         }
 
         int compare = 0;
@@ -720,6 +860,8 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
         } else if (key1 == key2) {
             result = 0;
         }
+    } else if (m_pSortKeyGenerator && m_columnCache.isSortedBySortKey(sortColumn)) {
+        result = m_pSortKeyGenerator->compare(val1.toString(), val2.toString());
     } else {
         result = m_collator.compare(val1.toString(), val2.toString());
     }
@@ -8,12 +8,14 @@
 #include <QString>
 #include <QStringList>
 #include <QVector>
+#include <list>
 #include <memory>
 
 #include "library/columncache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
+#include "util/collationsortkey.h"
 #include "util/string.h"
 
 class SearchQueryParser;
@@ -35,6 +37,10 @@ class SortColumn {
 // waste of memory because all the table-models were caching the same data
 // (track properties). Furthermore, the base SQL tables of these table-models
 // involve complicated joins, which are very slow.
+//
+// For large tables the cache can be restricted to a window of recently
+// used tracks, see setWindowSize(). Table models then fetch the tracks
+// of visible rows page by page.
 class BaseTrackCache : public QObject {
     Q_OBJECT
   public:
@@ -42,13 +48,28 @@ class BaseTrackCache : public QObject {
     ///
     /// The order of the `columns` list parameter defines the initial/default
     /// order of columns in the library view.
+    ///
+    /// If `sortKeysEnabled` is true text columns are sorted by the collation
+    /// sort key columns of the library table, see ColumnCache.
     BaseTrackCache(TrackCollection* pTrackCollection,
                    const QString& tableName,
                    const QString& idColumn,
                    const QStringList& columns,
-                   bool isCaching);
+                   bool isCaching,
+                   bool sortKeysEnabled = false);
     ~BaseTrackCache() override;
 
+    /// Restrict the number of tracks that are kept in memory. The least
+    /// recently used tracks are evicted first. The window must be large
+    /// enough for the visible rows of all models that share the track
+    /// source. The index is not built in advance and tracks must be
+    /// fetched on demand, see fetch().
+    /// 0 keeps all tracks in memory. Must be called before buildIndex().
+    void setWindowSize(int windowSize);
+    bool isWindowed() const {
+        return m_windowSize > 0;
+    }
+
     // Rebuild the BaseTrackCache index from the SQL table. This can be
     // expensive on large tables.
     virtual void buildIndex();
@@ -70,9 +91,35 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+    /// Returns the query that selects the ordered ids of the tracks for
+    /// filterAndSort(). The tracks are restricted by `trackIdsSql`, either
+    /// a comma-separated list of ids or a subselect.
+    QString filterAndSortQuery(const QString& trackIdsSql,
+            const QString& query,
+            const QString& extraFilter,
+            const QString& orderByClause) const;
+    /// Completes filterAndSort() with the result of filterAndSortQuery()
+    /// that has been executed separately, e.g. by LibraryQueryThread.
+    void applyFilterAndSortResult(const QSet<TrackId>& trackIds,
+            const QVector<TrackId>& trackOrder,
+            const QString& query,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QHash<TrackId, int>* trackToIndex);
+    const QString& tableName() const {
+        return m_tableName;
+    }
+    const QString& idColumn() const {
+        return m_idColumn;
+    }
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
+    /// Fetches tracks that are not cached without notifying other
+    /// models, e.g. the tracks of visible rows in windowed mode.
+    /// Returns the ids of the tracks that could not be read, because
+    /// they are not contained in the table or the query failed.
+    QSet<TrackId> fetch(const QSet<TrackId>& trackIds);
     virtual void setSearchColumns(const QStringList& columns);
 
   signals:
@@ -92,7 +139,13 @@ class BaseTrackCache : public QObject {
     void replaceRecentTrack(TrackId trackId, TrackPointer pTrack) const;
     void resetRecentTrack() const;
 
-    bool updateIndexWithQuery(const QString& query);
+    /// Removes the ids of all tracks that have been read from pTrackIds
+    bool updateIndexWithQuery(const QString& query, QSet<TrackId>* pTrackIds = nullptr);
+    QString selectTracksQuery(const QSet<TrackId>& trackIds) const;
+    QVector<QVariant>& trackInfoForUpdate(TrackId trackId);
+    void touchTrackInWindow(TrackId trackId) const;
+    void removeTrackFromWindow(TrackId trackId);
+    void evictTracksOutsideWindow();
     void updateTrackInIndex(TrackId trackId);
     bool updateTrackInIndex(const TrackPointer& pTrack);
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
@@ -102,7 +155,7 @@ class BaseTrackCache : public QObject {
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
-                               const QVector<TrackId>& trackIds) const;
+                               const QVector<TrackId>& trackIds);
     int compareColumnValues(int sortColumn,
             Qt::SortOrder sortOrder,
             const QVariant& val1,
@@ -125,6 +178,9 @@ class BaseTrackCache : public QObject {
     const std::unique_ptr<SearchQueryParser> m_pQueryParser;
 
     const mixxx::StringCollator m_collator;
+    // Only if text columns are sorted by their collation sort keys. Dirty
+    // tracks are sorted in memory and must be compared in the same order.
+    const std::unique_ptr<mixxx::CollationSortKeyGenerator> m_pSortKeyGenerator;
 
     QStringList m_searchColumns;
     QVector<int> m_searchColumnIndices;
@@ -150,5 +206,12 @@ class BaseTrackCache : public QObject {
     QHash<TrackId, QVector<QVariant>> m_trackInfo;
     QSqlDatabase m_database;
 
+    int m_windowSize;
+    // The tracks in m_trackInfo from the least to the most recently used
+    // one, and the position of each track in this list. Updated when the
+    // values of cached tracks are read, see data().
+    mutable std::list<TrackId> m_windowedTrackIds;
+    QHash<TrackId, std::list<TrackId>::iterator> m_windowedTrackIdPositions;
+
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
 };
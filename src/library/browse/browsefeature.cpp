@@ -31,7 +31,10 @@ BrowseFeature::BrowseFeature(
         RecordingManager* pRecordingManager)
         : LibraryFeature(pLibrary, pConfig, QString("computer")),
           m_pTrackCollection(pLibrary->trackCollectionManager()->internalCollection()),
-          m_browseModel(this, pLibrary->trackCollectionManager(), pRecordingManager),
+          m_browseModel(this,
+                  pLibrary->trackCollectionManager(),
+                  pLibrary->dbConnectionPool(),
+                  pRecordingManager),
           m_proxyModel(&m_browseModel),
           m_pSidebarModel(new FolderTreeModel(this)),
           m_pLastRightClickedItem(nullptr) {
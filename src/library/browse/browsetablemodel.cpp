@@ -45,6 +45,7 @@ void listAppendOrReplaceAt(QList<T>* pList, int index, const T& value) {
 
 BrowseTableModel::BrowseTableModel(QObject* parent,
         TrackCollectionManager* pTrackCollectionManager,
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
         RecordingManager* pRecordingManager)
         : TrackModel(pTrackCollectionManager->internalCollection()->database(),
                   "mixxx.db.model.browse"),
@@ -163,7 +164,7 @@ BrowseTableModel::BrowseTableModel(QObject* parent,
             "QList< QList<QStandardItem*>>");
     qRegisterMetaType<BrowseTableModel*>("BrowseTableModel*");
 
-    m_pBrowseThread = BrowseThread::getInstanceRef();
+    m_pBrowseThread = BrowseThread::getInstanceRef(std::move(pDbConnectionPool));
     connect(m_pBrowseThread.data(),
             &BrowseThread::clearModel,
             this,
@@ -176,6 +177,12 @@ BrowseTableModel::BrowseTableModel(QObject* parent,
             &BrowseTableModel::slotInsert,
             Qt::QueuedConnection);
 
+    connect(m_pBrowseThread.data(),
+            &BrowseThread::rowsUpdated,
+            this,
+            &BrowseTableModel::slotUpdate,
+            Qt::QueuedConnection);
+
     connect(&PlayerInfo::instance(),
             &PlayerInfo::trackChanged,
             this,
@@ -350,6 +357,8 @@ QMimeData* BrowseTableModel::mimeData(const QModelIndexList& indexes) const {
 
 void BrowseTableModel::slotClear(BrowseTableModel* caller_object) {
     if (caller_object == this) {
+        m_pendingRows.clear();
+        m_prioritizedLocations.clear();
         removeRows(0, rowCount());
     }
 }
@@ -362,12 +371,62 @@ void BrowseTableModel::slotInsert(const QList<QList<QStandardItem*>>& rows,
     if (caller_object == this) {
         //qDebug() << "BrowseTableModel::slotInsert";
         for (int i = 0; i < rows.size(); ++i) {
+            QStandardItem* pLocationItem = rows.at(i).at(COLUMN_NATIVELOCATION);
             appendRow(rows.at(i));
+            if (pLocationItem->data(ROLE_METADATA_PENDING).toBool()) {
+                m_pendingRows.insert(pLocationItem->data(Qt::UserRole).toString(),
+                        QPersistentModelIndex(indexFromItem(pLocationItem)));
+            }
         }
         emit restoreModelState();
     }
 }
 
+void BrowseTableModel::slotUpdate(const QList<QList<QStandardItem*>>& rows,
+        BrowseTableModel* caller_object) {
+    if (caller_object != this) {
+        return;
+    }
+    for (const auto& rowItems : rows) {
+        const QString location =
+                rowItems.at(COLUMN_NATIVELOCATION)->data(Qt::UserRole).toString();
+        m_prioritizedLocations.remove(location);
+        const QPersistentModelIndex index = m_pendingRows.take(location);
+        if (!index.isValid()) {
+            // The row has been edited or removed in the meantime
+            qDeleteAll(rowItems);
+            continue;
+        }
+        for (int column = 0; column < rowItems.size(); ++column) {
+            if (column == COLUMN_PREVIEW) {
+                // Keep the preview state
+                delete rowItems.at(column);
+                continue;
+            }
+            setItem(index.row(), column, rowItems.at(column));
+        }
+    }
+}
+
+void BrowseTableModel::prefetchRows(const QModelIndexList& indices) {
+    if (m_pendingRows.isEmpty()) {
+        return;
+    }
+    // Read the metadata of the visible rows first
+    QStringList locations;
+    for (const auto& index : indices) {
+        const QString location = getTrackLocation(index);
+        if (m_pendingRows.contains(location) &&
+                !m_prioritizedLocations.contains(location)) {
+            m_prioritizedLocations.insert(location);
+            locations.append(location);
+        }
+    }
+    if (!locations.isEmpty()) {
+        m_pBrowseThread->prioritizeMetadata(locations);
+    }
+}
+
 TrackModel::Capabilities BrowseTableModel::getCapabilities() const {
     return Capability::AddToTrackSet |
             Capability::AddToAutoDJ |
@@ -428,6 +487,10 @@ bool BrowseTableModel::setData(
         return false;
     }
 
+    // The edited metadata must not be overwritten by the metadata that
+    // is still being read from the file
+    m_pendingRows.remove(getTrackLocation(index));
+
     // check if one the item were edited
     int col = index.column();
     switch (col) {
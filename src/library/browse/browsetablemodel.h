@@ -1,11 +1,15 @@
 #pragma once
 
-#include <QStandardItemModel>
+#include <QHash>
 #include <QMimeData>
+#include <QPersistentModelIndex>
+#include <QSet>
+#include <QStandardItemModel>
 
 #include "library/trackmodel.h"
 #include "recording/recordingmanager.h"
 #include "library/browse/browsethread.h"
+#include "util/db/dbconnectionpool.h"
 
 //constants
 constexpr int COLUMN_PREVIEW = 0;
@@ -30,6 +34,10 @@ constexpr int COLUMN_FILE_MODIFIED_TIME = 18;
 constexpr int COLUMN_FILE_CREATION_TIME = 19;
 constexpr int COLUMN_REPLAYGAIN = 20;
 
+// Set on the item of COLUMN_NATIVELOCATION while the metadata of the
+// file has not been read yet
+constexpr int ROLE_METADATA_PENDING = Qt::UserRole + 1;
+
 class TrackCollectionManager;
 
 namespace mixxx {
@@ -49,7 +57,10 @@ class BrowseTableModel final : public QStandardItemModel, public virtual TrackMo
     Q_OBJECT
 
   public:
-    BrowseTableModel(QObject* parent, TrackCollectionManager* pTrackCollectionManager, RecordingManager* pRec);
+    BrowseTableModel(QObject* parent,
+            TrackCollectionManager* pTrackCollectionManager,
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            RecordingManager* pRec);
     virtual ~BrowseTableModel();
 
     // initiate table population, store path
@@ -70,6 +81,7 @@ class BrowseTableModel final : public QStandardItemModel, public virtual TrackMo
     const QString currentSearch() const override;
     bool isColumnInternal(int) override;
     void moveTrack(const QModelIndex&, const QModelIndex&) override;
+    void prefetchRows(const QModelIndexList& indices) override;
     bool isLocked() override { return false; }
     bool isColumnHiddenByDefault(int column) override;
     const QList<int>& searchColumns() const override;
@@ -96,6 +108,7 @@ class BrowseTableModel final : public QStandardItemModel, public virtual TrackMo
   public slots:
     void slotClear(BrowseTableModel*);
     void slotInsert(const QList<QList<QStandardItem*>>&, BrowseTableModel*);
+    void slotUpdate(const QList<QList<QStandardItem*>>&, BrowseTableModel*);
     void trackChanged(const QString& group, TrackPointer pNewTrack, TrackPointer pOldTrack);
 
   private:
@@ -111,4 +124,8 @@ class BrowseTableModel final : public QStandardItemModel, public virtual TrackMo
     int m_columnIndexBySortColumnId[static_cast<int>(TrackModel::SortColumnId::IdMax)];
     QMap<int, TrackModel::SortColumnId> m_sortColumnIdByColumnIndex;
 
+    // The rows whose metadata is still being read by the BrowseThread
+    QHash<QString, QPersistentModelIndex> m_pendingRows;
+    QSet<QString> m_prioritizedLocations;
+
 };
@@ -1,20 +1,36 @@
 #include "library/browse/browsethread.h"
 
-#include <QDateTime>
 #include <QDirIterator>
+#include <QSet>
 #include <QStringList>
+#include <QtConcurrentRun>
 #include <QtDebug>
 
 #include "library/browse/browsetablemodel.h"
+#include "library/queryutil.h"
 #include "moc_browsethread.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/datetime.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/trace.h"
 
 QWeakPointer<BrowseThread> BrowseThread::m_weakInstanceRef;
 static QMutex s_Mutex;
 
+namespace {
+
+constexpr int kMinMetadataReaders = 4;
+constexpr int kMaxMetadataReaders = 8;
+
+// Read metadata is sent to the GUI in batches of this size or after
+// this timeout, whichever comes first.
+constexpr int kMetadataBatchSize = 50;
+constexpr unsigned long kMetadataBatchTimeoutMillis = 100;
+
+} // namespace
+
 /*
  * This class is a singleton and represents a thread
  * that is used to read ID3 metadata
@@ -26,10 +42,19 @@ static QMutex s_Mutex;
  * signals to BrowseModel objects. It does not
  * make sense to use this class in non-GUI threads
  */
-BrowseThread::BrowseThread(QObject *parent)
-        : QThread(parent) {
+BrowseThread::BrowseThread(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_metadataGeneration(0),
+          m_activeMetadataReaders(0) {
     m_bStopThread = false;
     m_model_observer = nullptr;
+    // Reading metadata is mostly waiting for I/O, especially on network
+    // shares, so use a few threads even on machines with few cores, but
+    // not too many to avoid thrashing local disks.
+    m_metadataReaderPool.setMaxThreadCount(
+            qBound(kMinMetadataReaders,
+                    QThread::idealThreadCount(),
+                    kMaxMetadataReaders));
     //start Thread
     start(QThread::LowPriority);
 
@@ -38,22 +63,25 @@ BrowseThread::BrowseThread(QObject *parent)
 BrowseThread::~BrowseThread() {
     qDebug() << "Wait to finish browser background thread";
     m_bStopThread = true;
+    cancelPendingMetadata();
     //wake up thread since it might wait for user input
     m_locationUpdated.wakeAll();
     //Wait until thread terminated
     //terminate();
     wait();
+    m_metadataReaderPool.waitForDone();
     qDebug() << "Browser background thread terminated!";
 }
 
 // static
-BrowseThreadPointer BrowseThread::getInstanceRef() {
+BrowseThreadPointer BrowseThread::getInstanceRef(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool) {
     BrowseThreadPointer strong = m_weakInstanceRef.toStrongRef();
     if (!strong) {
         s_Mutex.lock();
         strong = m_weakInstanceRef.toStrongRef();
         if (!strong) {
-            strong = BrowseThreadPointer(new BrowseThread());
+            strong = BrowseThreadPointer(new BrowseThread(std::move(pDbConnectionPool)));
             m_weakInstanceRef = strong.toWeakRef();
         }
         s_Mutex.unlock();
@@ -71,6 +99,10 @@ void BrowseThread::executePopulation(mixxx::FileAccess path, BrowseTableModel* c
 
 void BrowseThread::run() {
     QThread::currentThread()->setObjectName("BrowseThread");
+    // The pooler limits the lifetime of the thread-local database
+    // connection to the lifetime of this thread.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    m_browseMetadataDao.initialize(mixxx::DbConnectionPooled(m_pDbConnectionPool));
     m_mutex.lock();
 
     while (!m_bStopThread) {
@@ -108,14 +140,206 @@ public:
   }
 };
 
+QStandardItem* createTextItem(const QString& text) {
+    QStandardItem* item = new QStandardItem(text);
+    item->setToolTip(text);
+    item->setData(text, Qt::UserRole);
+    return item;
+}
+
+/// Creates the items of a row. If the metadata has not been read yet,
+/// only the items that depend on the file system are populated and the
+/// row is marked as pending.
+QList<QStandardItem*> createRowItems(
+        const mixxx::FileAccess& fileAccess,
+        const mixxx::TrackMetadata* pTrackMetadata) {
+    QList<QStandardItem*> row_data;
+
+    QStandardItem* item = new QStandardItem("0");
+    item->setData("0", Qt::UserRole);
+    row_data.insert(COLUMN_PREVIEW, item);
+
+    row_data.insert(COLUMN_FILENAME, createTextItem(fileAccess.info().fileName()));
+
+    if (pTrackMetadata) {
+        const mixxx::TrackMetadata& trackMetadata = *pTrackMetadata;
+
+        row_data.insert(COLUMN_ARTIST,
+                createTextItem(trackMetadata.getTrackInfo().getArtist()));
+        row_data.insert(COLUMN_TITLE,
+                createTextItem(trackMetadata.getTrackInfo().getTitle()));
+        row_data.insert(COLUMN_ALBUM,
+                createTextItem(trackMetadata.getAlbumInfo().getTitle()));
+
+        item = new QStandardItem(trackMetadata.getTrackInfo().getTrackNumber());
+        item->setToolTip(item->text());
+        item->setData(item->text().toInt(), Qt::UserRole);
+        row_data.insert(COLUMN_TRACK_NUMBER, item);
+
+        const QString year(trackMetadata.getTrackInfo().getYear());
+        item = new YearItem(year);
+        item->setToolTip(year);
+        // The year column is sorted according to the numeric calendar year
+        item->setData(mixxx::TrackMetadata::parseCalendarYear(year), Qt::UserRole);
+        row_data.insert(COLUMN_YEAR, item);
+
+        row_data.insert(COLUMN_GENRE,
+                createTextItem(trackMetadata.getTrackInfo().getGenre()));
+        row_data.insert(COLUMN_COMPOSER,
+                createTextItem(trackMetadata.getTrackInfo().getComposer()));
+        row_data.insert(COLUMN_COMMENT,
+                createTextItem(trackMetadata.getTrackInfo().getComment()));
+
+        QString duration = trackMetadata.getDurationText(
+                mixxx::Duration::Precision::SECONDS);
+        item = new QStandardItem(duration);
+        item->setToolTip(item->text());
+        item->setData(trackMetadata.getStreamInfo()
+                              .getDuration()
+                              .toDoubleSeconds(),
+                Qt::UserRole);
+        row_data.insert(COLUMN_DURATION, item);
+
+        item = new QStandardItem(trackMetadata.getTrackInfo().getBpmText());
+        item->setToolTip(item->text());
+        const mixxx::Bpm bpm = trackMetadata.getTrackInfo().getBpm();
+        item->setData(bpm.isValid() ? bpm.value() : mixxx::Bpm::kValueUndefined, Qt::UserRole);
+        row_data.insert(COLUMN_BPM, item);
+
+        row_data.insert(COLUMN_KEY,
+                createTextItem(trackMetadata.getTrackInfo().getKey()));
+    } else {
+        for (int column = COLUMN_ARTIST; column <= COLUMN_KEY; ++column) {
+            row_data.insert(column, new QStandardItem());
+        }
+    }
+
+    row_data.insert(COLUMN_TYPE, createTextItem(fileAccess.info().suffix()));
+
+    if (pTrackMetadata) {
+        item = new QStandardItem(pTrackMetadata->getBitrateText());
+        item->setToolTip(item->text());
+        item->setData(
+                static_cast<qlonglong>(
+                        pTrackMetadata->getStreamInfo().getBitrate().value()),
+                Qt::UserRole);
+        row_data.insert(COLUMN_BITRATE, item);
+    } else {
+        row_data.insert(COLUMN_BITRATE, new QStandardItem());
+    }
+
+    QString location = fileAccess.info().location();
+    QString nativeLocation = QDir::toNativeSeparators(location);
+    item = new QStandardItem(nativeLocation);
+    item->setToolTip(nativeLocation);
+    item->setData(location, Qt::UserRole);
+    item->setData(pTrackMetadata == nullptr, ROLE_METADATA_PENDING);
+    row_data.insert(COLUMN_NATIVELOCATION, item);
+
+    if (pTrackMetadata) {
+        row_data.insert(COLUMN_ALBUMARTIST,
+                createTextItem(pTrackMetadata->getAlbumInfo().getArtist()));
+        row_data.insert(COLUMN_GROUPING,
+                createTextItem(pTrackMetadata->getTrackInfo().getGrouping()));
+    } else {
+        row_data.insert(COLUMN_ALBUMARTIST, new QStandardItem());
+        row_data.insert(COLUMN_GROUPING, new QStandardItem());
+    }
+
+    const auto fileLastModified =
+            fileAccess.info().lastModified();
+    item = new QStandardItem(
+            mixxx::displayLocalDateTime(fileLastModified));
+    item->setToolTip(item->text());
+    item->setData(fileLastModified, Qt::UserRole);
+    row_data.insert(COLUMN_FILE_MODIFIED_TIME, item);
+
+    const auto fileCreated =
+            fileAccess.info().birthTime();
+    item = new QStandardItem(
+            mixxx::displayLocalDateTime(fileCreated));
+    item->setToolTip(item->text());
+    item->setData(fileCreated, Qt::UserRole);
+    row_data.insert(COLUMN_FILE_CREATION_TIME, item);
+
+    if (pTrackMetadata) {
+        const mixxx::ReplayGain replayGain(pTrackMetadata->getTrackInfo().getReplayGain());
+        row_data.insert(COLUMN_REPLAYGAIN,
+                createTextItem(mixxx::ReplayGain::ratioToString(replayGain.getRatio())));
+    } else {
+        row_data.insert(COLUMN_REPLAYGAIN, new QStandardItem());
+    }
+
+    return row_data;
+}
+
 } // namespace
 
+void BrowseThread::prioritizeMetadata(const QStringList& locations) {
+    const QSet<QString> prioritizedLocations(locations.begin(), locations.end());
+    QMutexLocker locker(&m_metadataMutex);
+    QList<mixxx::FileAccess> prioritizedFiles;
+    for (auto it = m_pendingFiles.begin(); it != m_pendingFiles.end();) {
+        if (prioritizedLocations.contains(it->info().location())) {
+            prioritizedFiles.append(*it);
+            it = m_pendingFiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_pendingFiles = prioritizedFiles + m_pendingFiles;
+}
+
+void BrowseThread::cancelPendingMetadata() {
+    QMutexLocker locker(&m_metadataMutex);
+    ++m_metadataGeneration;
+    m_pendingFiles.clear();
+    m_readResults.clear();
+}
+
+void BrowseThread::saveMetadata(const QList<MetadataReadResult>& readResults) {
+    if (readResults.isEmpty() || !m_browseMetadataDao.database().isOpen()) {
+        return;
+    }
+    ScopedTransaction transaction(m_browseMetadataDao.database());
+    for (const auto& readResult : readResults) {
+        m_browseMetadataDao.saveMetadata(readResult.fileAccess.info(), readResult.trackMetadata);
+    }
+    transaction.commit();
+}
+
+void BrowseThread::readPendingMetadata(int generation) {
+    QMutexLocker locker(&m_metadataMutex);
+    while (generation == m_metadataGeneration && !m_pendingFiles.isEmpty()) {
+        const mixxx::FileAccess fileAccess = m_pendingFiles.takeFirst();
+        locker.unlock();
+
+        mixxx::TrackMetadata trackMetadata;
+        SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
+                fileAccess,
+                &trackMetadata,
+                nullptr);
+
+        locker.relock();
+        if (generation == m_metadataGeneration) {
+            m_readResults.append(MetadataReadResult{fileAccess, trackMetadata});
+            if (m_readResults.size() >= kMetadataBatchSize) {
+                m_metadataRead.wakeAll();
+            }
+        }
+    }
+    --m_activeMetadataReaders;
+    m_metadataRead.wakeAll();
+}
+
 void BrowseThread::populateModel() {
     m_path_mutex.lock();
     auto thisPath = m_path;
     BrowseTableModel* thisModelObserver = m_model_observer;
     m_path_mutex.unlock();
 
+    cancelPendingMetadata();
+
     if (!thisPath.info().hasLocation()) {
         // Abort if the location is inaccessible or does not exist
         qWarning() << "Skipping" << thisPath.info();
@@ -134,10 +358,17 @@ void BrowseThread::populateModel() {
     // see signal/slot connection in BrowseTableModel
     emit clearModel(thisModelObserver);
 
+    // Metadata of tracks in the library and of files that have been
+    // browsed before does not need to be read again. The entries are
+    // validated against the file infos of the listing below, which
+    // avoids accessing each file once more.
+    const QHash<QString, BrowseMetadataDAO::Entry> cachedMetadata =
+            m_browseMetadataDao.loadDirectory(thisPath.info().location());
+
     QList<QList<QStandardItem*>> rows;
+    QList<mixxx::FileAccess> pendingFiles;
 
-    int row = 0;
-    // Iterate over the files
+    // First pass: List the files without opening them
     while (fileIt.hasNext()) {
         // If a user quickly jumps through the folders
         // the current task becomes "dirty"
@@ -147,162 +378,80 @@ void BrowseThread::populateModel() {
 
         if (thisPath.info() != newPath.info()) {
             qDebug() << "Abort populateModel()";
+            for (const auto& row : qAsConst(rows)) {
+                qDeleteAll(row);
+            }
             populateModel();
             return;
         }
 
-        QList<QStandardItem*> row_data;
-
-        QStandardItem* item = new QStandardItem("0");
-        item->setData("0", Qt::UserRole);
-        row_data.insert(COLUMN_PREVIEW, item);
-
+        fileIt.next();
         const auto fileAccess = mixxx::FileAccess(
-                mixxx::FileInfo(fileIt.next()),
+                mixxx::FileInfo(fileIt.fileInfo()),
                 thisPath.token());
-        {
-            mixxx::TrackMetadata trackMetadata;
-            SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
-                    fileAccess,
-                    &trackMetadata,
-                    nullptr);
-
-            item = new QStandardItem(fileAccess.info().fileName());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_FILENAME, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getArtist());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_ARTIST, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getTitle());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_TITLE, item);
-
-            item = new QStandardItem(trackMetadata.getAlbumInfo().getTitle());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_ALBUM, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getTrackNumber());
-            item->setToolTip(item->text());
-            item->setData(item->text().toInt(), Qt::UserRole);
-            row_data.insert(COLUMN_TRACK_NUMBER, item);
-
-            const QString year(trackMetadata.getTrackInfo().getYear());
-            item = new YearItem(year);
-            item->setToolTip(year);
-            // The year column is sorted according to the numeric calendar year
-            item->setData(mixxx::TrackMetadata::parseCalendarYear(year), Qt::UserRole);
-            row_data.insert(COLUMN_YEAR, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getGenre());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_GENRE, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getComposer());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_COMPOSER, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getComment());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_COMMENT, item);
-
-            QString duration = trackMetadata.getDurationText(
-                    mixxx::Duration::Precision::SECONDS);
-            item = new QStandardItem(duration);
-            item->setToolTip(item->text());
-            item->setData(trackMetadata.getStreamInfo()
-                                  .getDuration()
-                                  .toDoubleSeconds(),
-                    Qt::UserRole);
-            row_data.insert(COLUMN_DURATION, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getBpmText());
-            item->setToolTip(item->text());
-            const mixxx::Bpm bpm = trackMetadata.getTrackInfo().getBpm();
-            item->setData(bpm.isValid() ? bpm.value() : mixxx::Bpm::kValueUndefined, Qt::UserRole);
-            row_data.insert(COLUMN_BPM, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getKey());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_KEY, item);
-
-            item = new QStandardItem(fileAccess.info().suffix());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_TYPE, item);
-
-            item = new QStandardItem(trackMetadata.getBitrateText());
-            item->setToolTip(item->text());
-            item->setData(
-                    static_cast<qlonglong>(
-                            trackMetadata.getStreamInfo().getBitrate().value()),
-                    Qt::UserRole);
-            row_data.insert(COLUMN_BITRATE, item);
-
-            QString location = fileAccess.info().location();
-            QString nativeLocation = QDir::toNativeSeparators(location);
-            item = new QStandardItem(nativeLocation);
-            item->setToolTip(nativeLocation);
-            item->setData(location, Qt::UserRole);
-            row_data.insert(COLUMN_NATIVELOCATION, item);
-
-            item = new QStandardItem(trackMetadata.getAlbumInfo().getArtist());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_ALBUMARTIST, item);
-
-            item = new QStandardItem(trackMetadata.getTrackInfo().getGrouping());
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_GROUPING, item);
-
-            const auto fileLastModified =
-                    fileAccess.info().lastModified();
-            item = new QStandardItem(
-                    mixxx::displayLocalDateTime(fileLastModified));
-            item->setToolTip(item->text());
-            item->setData(fileLastModified, Qt::UserRole);
-            row_data.insert(COLUMN_FILE_MODIFIED_TIME, item);
-
-            const auto fileCreated =
-                    fileAccess.info().birthTime();
-            item = new QStandardItem(
-                    mixxx::displayLocalDateTime(fileCreated));
-            item->setToolTip(item->text());
-            item->setData(fileCreated, Qt::UserRole);
-            row_data.insert(COLUMN_FILE_CREATION_TIME, item);
-
-            const mixxx::ReplayGain replayGain(trackMetadata.getTrackInfo().getReplayGain());
-            item = new QStandardItem(
-                    mixxx::ReplayGain::ratioToString(replayGain.getRatio()));
-            item->setToolTip(item->text());
-            item->setData(item->text(), Qt::UserRole);
-            row_data.insert(COLUMN_REPLAYGAIN, item);
+        const auto cachedIt = cachedMetadata.constFind(fileAccess.info().location());
+        if (cachedIt != cachedMetadata.constEnd() &&
+                cachedIt.value().isValid(fileAccess.info())) {
+            rows.append(createRowItems(fileAccess, &cachedIt.value().trackMetadata));
+        } else {
+            rows.append(createRowItems(fileAccess, nullptr));
+            pendingFiles.append(fileAccess);
+        }
+    }
+    // this is a blocking operation
+    emit rowsAppended(rows, thisModelObserver);
+    qDebug() << "Append" << rows.count() << "tracks from"
+             << thisPath.info().locationPath() << "," << pendingFiles.count()
+             << "without metadata";
+    rows.clear();
+
+    if (pendingFiles.isEmpty()) {
+        return;
+    }
+
+    // Second pass: Read the missing metadata in parallel
+    QMutexLocker locker(&m_metadataMutex);
+    const int generation = m_metadataGeneration;
+    m_pendingFiles = std::move(pendingFiles);
+    const int numReaders = qMin(
+            m_metadataReaderPool.maxThreadCount(), m_pendingFiles.size());
+    for (int i = 0; i < numReaders; ++i) {
+        ++m_activeMetadataReaders;
+        QtConcurrent::run(&m_metadataReaderPool, [this, generation] {
+            readPendingMetadata(generation);
+        });
+    }
+
+    while (m_activeMetadataReaders > 0 || !m_readResults.isEmpty()) {
+        if (m_readResults.size() < kMetadataBatchSize && m_activeMetadataReaders > 0) {
+            m_metadataRead.wait(&m_metadataMutex, kMetadataBatchTimeoutMillis);
+        }
+        const QList<MetadataReadResult> readResults = std::move(m_readResults);
+        m_readResults.clear();
+        locker.unlock();
+
+        saveMetadata(readResults);
+
+        m_path_mutex.lock();
+        auto newPath = m_path;
+        m_path_mutex.unlock();
+        if (m_bStopThread || thisPath.info() != newPath.info()) {
+            // The remaining readers will finish in the background
+            // after the file they are currently reading
+            qDebug() << "Abort populateModel()";
+            if (!m_bStopThread) {
+                populateModel();
+            }
+            return;
         }
 
-        rows.append(row_data);
-        ++row;
-        // If 10 tracks have been analyzed, send it to GUI
-        // Will limit GUI freezing
-        if (row % 10 == 0) {
-            // this is a blocking operation
-            emit rowsAppended(rows, thisModelObserver);
-            qDebug() << "Append" << rows.count() << "tracks from "
-                     << thisPath.info().locationPath();
+        for (const auto& readResult : readResults) {
+            rows.append(createRowItems(readResult.fileAccess, &readResult.trackMetadata));
+        }
+        if (!rows.isEmpty()) {
+            emit rowsUpdated(rows, thisModelObserver);
             rows.clear();
         }
-        // Sleep additionally for 20ms which prevents us from GUI freezes
-        msleep(20);
+        locker.relock();
     }
-    emit rowsAppended(rows, thisModelObserver);
-    qDebug() << "Append last" << rows.count() << "tracks from" << thisPath.info().locationPath();
 }
@@ -4,20 +4,32 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QMutex>
 #include <QSharedPointer>
 #include <QStandardItem>
 #include <QThread>
+#include <QThreadPool>
 #include <QWaitCondition>
 #include <QWeakPointer>
 
+#include "library/dao/browsemetadatadao.h"
+#include "track/trackmetadata.h"
+#include "util/db/dbconnectionpool.h"
 #include "util/fileaccess.h"
 
 // This class is a singleton and represents a thread
 // that is used to read ID3 metadata
 // from a particular folder.
 //
+// The files of a folder are listed first, which is fast even for large
+// folders on network shares. The metadata is then read by a pool of
+// reader threads and streamed into the rows of the model, starting with
+// the rows that are currently visible. Metadata of tracks in the library
+// that is still synchronized with the file and metadata that has been
+// read before is reused without opening the file, see BrowseMetadataDAO.
+//
 // The BrowseTableModel uses this class.
 // Note: Don't call getInstance() from places
 // other than the GUI thread.
@@ -32,16 +44,37 @@ class BrowseThread : public QThread {
     virtual ~BrowseThread();
     void executePopulation(mixxx::FileAccess path, BrowseTableModel* client);
     void run();
-    static BrowseThreadPointer getInstanceRef();
+    static BrowseThreadPointer getInstanceRef(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool);
+
+    /// Reads the metadata of the given files before all other pending files
+    /// of the current folder, e.g. because they have become visible.
+    void prioritizeMetadata(const QStringList& locations);
 
   signals:
     void rowsAppended(const QList<QList<QStandardItem*>>&, BrowseTableModel*);
+    void rowsUpdated(const QList<QList<QStandardItem*>>&, BrowseTableModel*);
     void clearModel(BrowseTableModel*);
 
   private:
-    BrowseThread(QObject *parent = 0);
+    struct MetadataReadResult {
+        mixxx::FileAccess fileAccess;
+        mixxx::TrackMetadata trackMetadata;
+    };
+
+    explicit BrowseThread(mixxx::DbConnectionPoolPtr pDbConnectionPool);
 
     void populateModel();
+    void saveMetadata(const QList<MetadataReadResult>& readResults);
+
+    // Executed by the threads of m_metadataReaderPool
+    void readPendingMetadata(int generation);
+    // Stops all readers from picking up further files
+    void cancelPendingMetadata();
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    // Only accessed by this thread
+    BrowseMetadataDAO m_browseMetadataDao;
 
     QMutex m_mutex;
     QWaitCondition m_locationUpdated;
@@ -52,5 +85,16 @@ class BrowseThread : public QThread {
     mixxx::FileAccess m_path;
     BrowseTableModel* m_model_observer;
 
+    // You must hold m_metadataMutex to touch the following members
+    QMutex m_metadataMutex;
+    QWaitCondition m_metadataRead;
+    // Incremented for every folder, results of previous folders are discarded
+    int m_metadataGeneration;
+    QList<mixxx::FileAccess> m_pendingFiles;
+    QList<MetadataReadResult> m_readResults;
+    int m_activeMetadataReaders;
+
+    QThreadPool m_metadataReaderPool;
+
     static QWeakPointer<BrowseThread> m_weakInstanceRef;
 };
@@ -12,10 +12,13 @@ const QString kSortInt = QStringLiteral("cast(%1 as integer)");
 const QString kSortNoCase = QStringLiteral("lower(%1)");
 const QString kSortNoCaseLex = mixxx::DbConnection::collateLexicographically(
         QStringLiteral("lower(%1)"));
+// Binary sort keys are compared byte-wise without a collation function
+const QString kSortKey = QStringLiteral("%1_sortkey");
 
 } // namespace
 
-ColumnCache::ColumnCache(const QStringList& columns) {
+ColumnCache::ColumnCache(const QStringList& columns, bool sortKeysEnabled)
+        : m_sortKeysEnabled(sortKeysEnabled) {
     m_pKeyNotationCP = new ControlProxy(mixxx::library::prefs::kKeyNotationConfigKey, this);
     m_pKeyNotationCP->connectValueChanged(this, &ColumnCache::slotSetKeySortOrder);
 
@@ -104,17 +107,18 @@ void ColumnCache::setColumns(const QStringList& columns) {
 
     m_columnSortByIndex.clear();
     // Add the columns that requires a special sort
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_ARTIST, kSortNoCaseLex);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_TITLE, kSortNoCaseLex);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_ALBUM, kSortNoCaseLex);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_ALBUMARTIST, kSortNoCaseLex);
+    const QString& sortLex = m_sortKeysEnabled ? kSortKey : kSortNoCaseLex;
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_ARTIST, sortLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_TITLE, sortLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_ALBUM, sortLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_ALBUMARTIST, sortLex);
     insertColumnSortByEnum(COLUMN_LIBRARYTABLE_YEAR, kSortNoCase);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_GENRE, kSortNoCaseLex);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_COMPOSER, kSortNoCaseLex);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_GROUPING, kSortNoCaseLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_GENRE, sortLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_COMPOSER, sortLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_GROUPING, sortLex);
     insertColumnSortByEnum(COLUMN_LIBRARYTABLE_TRACKNUMBER, kSortInt);
     insertColumnSortByEnum(COLUMN_LIBRARYTABLE_FILETYPE, kSortNoCase);
-    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_COMMENT, kSortNoCaseLex);
+    insertColumnSortByEnum(COLUMN_LIBRARYTABLE_COMMENT, sortLex);
     insertColumnSortByEnum(COLUMN_LIBRARYTABLE_BITRATE, kSortInt);
     insertColumnSortByEnum(COLUMN_LIBRARYTABLE_SAMPLERATE, kSortInt);
     insertColumnSortByEnum(COLUMN_LIBRARYTABLE_TIMESPLAYED, kSortInt);
@@ -124,6 +128,10 @@ void ColumnCache::setColumns(const QStringList& columns) {
     slotSetKeySortOrder(m_pKeyNotationCP->get());
 }
 
+bool ColumnCache::isSortedBySortKey(int index) const {
+    return m_sortKeysEnabled && m_columnSortByIndex.value(index) == kSortKey;
+}
+
 void ColumnCache::slotSetKeySortOrder(double notationValue) {
     const int keyColumnIndex = m_columnIndexByEnum[COLUMN_LIBRARYTABLE_KEY];
     if (keyColumnIndex < 0) {
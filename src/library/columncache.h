@@ -70,7 +70,13 @@ class ColumnCache : public QObject {
         NUM_COLUMNS
     };
 
-    explicit ColumnCache(const QStringList& columns = QStringList());
+    /// If `sortKeysEnabled` is true the text columns of the library
+    /// table are sorted by their collation sort key columns, i.e.
+    /// "artist" by "artist_sortkey". The sort key columns must be
+    /// available in the table or view of the track source.
+    explicit ColumnCache(
+            const QStringList& columns = QStringList(),
+            bool sortKeysEnabled = false);
 
     void setColumns(const QStringList& columns);
 
@@ -96,6 +102,10 @@ class ColumnCache : public QObject {
         return m_columnsByIndex.at(index);
     }
 
+    /// Returns true if the column is sorted by its collation sort key
+    /// column instead of the collation function.
+    bool isSortedBySortKey(int index) const;
+
     inline QString columnSortForFieldIndex(int index) const {
         // Check if there is a special sort clause
         QString format = m_columnSortByIndex.value(index, "%1");
@@ -136,6 +146,7 @@ class ColumnCache : public QObject {
     QMap<Column, QString> m_columnNameByEnum;
     // A mapping from column enum to logical index.
     int m_columnIndexByEnum[NUM_COLUMNS];
+    const bool m_sortKeysEnabled;
 
     ControlProxy* m_pKeyNotationCP;
 };
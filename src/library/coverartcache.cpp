@@ -1,28 +1,28 @@
 #include "library/coverartcache.h"
 
-#include <QFutureWatcher>
-#include <QPixmapCache>
-#include <QtConcurrentRun>
+#include <QRunnable>
 #include <QtDebug>
+#include <functional>
 
+#include "library/coverartdiskcache.h"
 #include "library/coverartutils.h"
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
+#include "util/counter.h"
 #include "util/logger.h"
 #include "util/thread_affinity.h"
+#include "util/time.h"
+#include "util/timer.h"
 
 namespace {
 
 mixxx::Logger kLogger("CoverArtCache");
 
-// The initial QPixmapCache limit is 10MB.
-// But it is not used just by the coverArt stuff,
-// it is also used by Qt to handle other things behind the scenes.
-// Consequently coverArt cache will always have less than those
-// 10MB available to store the pixmaps.
-// So, we must increase this size a bit more,
-// in order to allow CoverCache handle more covers (performance gain).
-constexpr int kPixmapCacheLimit = 20480;
+// The memory budget for resized covers. Unlike the shared QPixmapCache
+// that is also used by Qt behind the scenes this budget is reserved
+// for covers. A 100x100 thumbnail with 32 bits per pixel consumes
+// ~40KB, i.e. the budget is sufficient for ~800 thumbnails.
+constexpr int kPixmapCacheLimitBytes = 32 * 1024 * 1024;
 
 QString pixmapCacheKey(mixxx::cache_key_t hash, int width) {
     return QString("CoverArtCache_%1_%2")
@@ -37,10 +37,48 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
     return image.scaledToWidth(width, kTransformationMode);
 }
 
+int pixmapCost(const QPixmap& pixmap) {
+    return math_max(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8);
+}
+
+class LoadCoverTask : public QRunnable {
+  public:
+    explicit LoadCoverTask(std::function<void()> task)
+            : m_task(std::move(task)) {
+    }
+
+    void run() override {
+        m_task();
+    }
+
+  private:
+    const std::function<void()> m_task;
+};
+
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
-    QPixmapCache::setCacheLimit(kPixmapCacheLimit);
+CoverArtCache::CoverArtCache()
+        : m_pixmapCache(kPixmapCacheLimitBytes),
+          m_nextRequestPriority(0),
+          m_firstCoverLoaded(false) {
+    m_threadPool.setObjectName("CoverArtCache");
+}
+
+CoverArtCache::~CoverArtCache() {
+    // Results of pending requests must not be delivered to
+    // a destroyed object
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
+
+void CoverArtCache::enableDiskCache(const QString& directory, qint64 maxSizeInBytes) {
+    kLogger.info()
+            << "Storing thumbnails in"
+            << directory
+            << "with up to"
+            << maxSizeInBytes
+            << "bytes";
+    m_pDiskCache = std::make_shared<CoverArtDiskCache>(directory, maxSizeInBytes);
 }
 
 //static
@@ -113,8 +151,10 @@ QPixmap CoverArtCache::tryLoadCover(
     // performance issues).
     QString cacheKey = pixmapCacheKey(requestedCacheKey, desiredWidth);
 
-    QPixmap pixmap;
-    if (QPixmapCache::find(cacheKey, &pixmap)) {
+    const QPixmap* pCachedPixmap = m_pixmapCache.object(cacheKey);
+    if (pCachedPixmap) {
+        Counter("CoverArtCache memory hit")++;
+        const QPixmap pixmap = *pCachedPixmap;
         if (kLogger.traceEnabled()) {
             kLogger.trace()
                     << "requestCover cache hit"
@@ -139,21 +179,28 @@ QPixmap CoverArtCache::tryLoadCover(
                 << "requestCover starting future for"
                 << coverInfo;
     }
+    Counter("CoverArtCache memory miss")++;
     m_runningRequests.insert(requestId);
-    // The watcher will be deleted in coverLoaded()
-    QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
-    QFuture<FutureResult> future = QtConcurrent::run(
-            &CoverArtCache::loadCover,
-            pRequestor,
-            pTrack,
-            coverInfo,
-            desiredWidth,
-            loading == Loading::Default);
-    connect(watcher,
-            &QFutureWatcher<FutureResult>::finished,
-            this,
-            &CoverArtCache::coverLoaded);
-    watcher->setFuture(future);
+    const bool signalWhenDone = loading == Loading::Default;
+    auto pDiskCache = m_pDiskCache;
+    m_threadPool.start(
+            new LoadCoverTask(
+                    [this, pRequestor, pTrack, coverInfo, desiredWidth, signalWhenDone, pDiskCache] {
+                        FutureResult res = loadCover(
+                                pRequestor,
+                                pTrack,
+                                coverInfo,
+                                desiredWidth,
+                                signalWhenDone,
+                                pDiskCache);
+                        QMetaObject::invokeMethod(
+                                this,
+                                [this, res = std::move(res)]() mutable {
+                                    coverLoaded(std::move(res));
+                                },
+                                Qt::QueuedConnection);
+                    }),
+            m_nextRequestPriority++);
     return QPixmap();
 }
 
@@ -163,7 +210,9 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
         int desiredWidth,
-        bool signalWhenDone) {
+        bool signalWhenDone,
+        std::shared_ptr<CoverArtDiskCache> pDiskCache) {
+    ScopedTimer t("CoverArtCache::loadCover");
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -180,6 +229,28 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             signalWhenDone);
     DEBUG_ASSERT(!res.coverInfoUpdated);
 
+    // Only covers with an image digest are persisted, the
+    // legacy hash is too short to identify them reliably
+    const bool useDiskCache = pDiskCache &&
+            desiredWidth > 0 &&
+            !coverInfo.imageDigest().isEmpty();
+    if (useDiskCache) {
+        const auto cacheKey = coverInfo.cacheKey();
+        QImage thumbnail = pDiskCache->load(cacheKey, desiredWidth);
+        if (!thumbnail.isNull()) {
+            Counter("CoverArtCache disk hit")++;
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.image = std::move(thumbnail);
+            loadedImage.location = pDiskCache->filePath(cacheKey, desiredWidth);
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+        Counter("CoverArtCache disk miss")++;
+    }
+
     auto loadedImage = coverInfo.loadImage(
             pTrack ? pTrack->getFileAccess().token() : SecurityTokenPointer());
     if (!loadedImage.image.isNull()) {
@@ -197,6 +268,10 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             // Adjust the cover size according to the request
             // or downsize the image for efficiency.
             loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            // The digest might have been missing or outdated
+            if (pDiskCache && !coverInfo.imageDigest().isEmpty()) {
+                pDiskCache->store(coverInfo.cacheKey(), desiredWidth, loadedImage.image);
+            }
         }
     }
 
@@ -207,19 +282,7 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     return res;
 }
 
-// watcher
-void CoverArtCache::coverLoaded() {
-    FutureResult res;
-    {
-        QFutureWatcher<FutureResult>* pFutureWatcher =
-                static_cast<QFutureWatcher<FutureResult>*>(sender());
-        VERIFY_OR_DEBUG_ASSERT(pFutureWatcher) {
-            return;
-        }
-        res = pFutureWatcher->result();
-        pFutureWatcher->deleteLater();
-    }
-
+void CoverArtCache::coverLoaded(FutureResult res) {
     if (kLogger.traceEnabled()) {
         kLogger.trace() << "coverLoaded" << res.coverArt;
     }
@@ -261,7 +324,14 @@ void CoverArtCache::coverLoaded() {
             // be displayed when loaded from the cache.
             QString cacheKey = pixmapCacheKey(
                     res.coverArt.cacheKey(), res.coverArt.resizedToWidth);
-            QPixmapCache::insert(cacheKey, pixmap);
+            m_pixmapCache.insert(cacheKey, new QPixmap(pixmap), pixmapCost(pixmap));
+        }
+        if (!m_firstCoverLoaded) {
+            m_firstCoverLoaded = true;
+            kLogger.info()
+                    << "First cover loaded"
+                    << mixxx::Time::elapsed().formatMillisWithUnit()
+                    << "after startup";
         }
     }
 
@@ -1,15 +1,20 @@
 #pragma once
 
+#include <QCache>
 #include <QObject>
 #include <QPair>
 #include <QPixmap>
 #include <QSet>
+#include <QThreadPool>
 #include <QtDebug>
+#include <memory>
 
 #include "library/coverart.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
+class CoverArtDiskCache;
+
 class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     Q_OBJECT
   public:
@@ -32,7 +37,7 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
      *      covers from the given 'coverLocation' and it will also NOT run the
      *      search algorithm.
      *      In this way, the method will just look into CoverCache and return
-     *      a Pixmap if it is already loaded in the QPixmapCache.
+     *      a Pixmap if it is already loaded in the memory cache.
      */
     enum class Loading {
         CachedOnly,
@@ -84,11 +89,12 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             TrackPointer pTrack,
             CoverInfo coverInfo,
             int desiredWidth,
-            bool emitSignals);
+            bool emitSignals,
+            std::shared_ptr<CoverArtDiskCache> pDiskCache = nullptr);
 
-  private slots:
-    // Called when loadCover is complete in the main thread.
-    void coverLoaded();
+    /// Persist resized covers as thumbnails in the given directory
+    /// to avoid extracting and scaling them again after a restart.
+    void enableDiskCache(const QString& directory, qint64 maxSizeInBytes);
 
   signals:
     void coverFound(
@@ -100,7 +106,7 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
 
   protected:
     CoverArtCache();
-    ~CoverArtCache() override = default;
+    ~CoverArtCache() override;
     friend class Singleton<CoverArtCache>;
 
   private:
@@ -116,7 +122,22 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             int desiredWidth,
             Loading loading);
 
+    // Called when loadCover is complete in the main thread.
+    void coverLoaded(FutureResult res);
+
     QSet<QPair<const QObject*, mixxx::cache_key_t>> m_runningRequests;
+
+    // The cost of each pixmap is its size in bytes
+    QCache<QString, QPixmap> m_pixmapCache;
+
+    std::shared_ptr<CoverArtDiskCache> m_pDiskCache;
+
+    QThreadPool m_threadPool;
+    // Requests are prioritized in reverse order. When scrolling through
+    // the library the most recent requests are for the rows that are
+    // currently visible.
+    int m_nextRequestPriority;
+    bool m_firstCoverLoaded;
 };
 
 inline
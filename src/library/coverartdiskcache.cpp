@@ -0,0 +1,186 @@
+#include "library/coverartdiskcache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <algorithm>
+
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtDiskCache");
+
+// Lossy compression is fine for small thumbnails
+constexpr int kImageQuality = 85;
+
+// Thumbnails are evicted until the total size falls below this
+// fraction of the limit to avoid evicting after every store
+constexpr qint64 kEvictionTargetPercent = 90;
+
+QByteArray imageFormat() {
+    // WebP is only available with the Qt image formats plugin
+    if (QImageWriter::supportedImageFormats().contains("webp") &&
+            QImageReader::supportedImageFormats().contains("webp")) {
+        return QByteArrayLiteral("webp");
+    }
+    return QByteArrayLiteral("jpg");
+}
+
+} // anonymous namespace
+
+CoverArtDiskCache::CoverArtDiskCache(const QString& directory, qint64 maxSizeInBytes)
+        : m_directory(directory),
+          m_maxSizeInBytes(maxSizeInBytes),
+          m_format(imageFormat()),
+          m_scanned(false),
+          m_totalSizeInBytes(0) {
+    if (!m_directory.exists() && !m_directory.mkpath(QStringLiteral("."))) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << m_directory.absolutePath();
+    }
+}
+
+QString CoverArtDiskCache::fileName(mixxx::cache_key_t cacheKey, int width) const {
+    return QStringLiteral("%1_%2.%3")
+            .arg(QString::number(cacheKey, 16),
+                    QString::number(width),
+                    QString::fromLatin1(m_format));
+}
+
+void CoverArtDiskCache::scanDirectoryLocked() {
+    if (m_scanned) {
+        return;
+    }
+    m_scanned = true;
+    // Thumbnails in a different format are ignored, e.g. if
+    // the WebP plugin is no longer available
+    const QFileInfoList fileInfos = m_directory.entryInfoList(
+            QStringList{QStringLiteral("*.") + QString::fromLatin1(m_format)},
+            QDir::Files | QDir::Readable);
+    m_entries.reserve(fileInfos.size());
+    for (const auto& fileInfo : fileInfos) {
+        // The last access is not available on all file systems
+        const Entry entry{fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch()};
+        m_entries.insert(fileInfo.fileName(), entry);
+        m_totalSizeInBytes += entry.sizeInBytes;
+    }
+    kLogger.debug()
+            << "Found"
+            << m_entries.size()
+            << "thumbnails with"
+            << m_totalSizeInBytes
+            << "bytes";
+    evictLocked();
+}
+
+QImage CoverArtDiskCache::load(mixxx::cache_key_t cacheKey, int width) {
+    const QString name = fileName(cacheKey, width);
+    {
+        const QMutexLocker locker(&m_mutex);
+        scanDirectoryLocked();
+        const auto it = m_entries.find(name);
+        if (it == m_entries.end()) {
+            return QImage();
+        }
+        it->lastAccessed = QDateTime::currentMSecsSinceEpoch();
+    }
+    QImage image(m_directory.filePath(name), m_format.constData());
+    if (image.isNull()) {
+        kLogger.warning()
+                << "Removing unreadable thumbnail"
+                << name;
+        const QMutexLocker locker(&m_mutex);
+        removeLocked(name);
+    }
+    return image;
+}
+
+void CoverArtDiskCache::store(mixxx::cache_key_t cacheKey, int width, const QImage& image) {
+    if (image.isNull()) {
+        return;
+    }
+    const QString name = fileName(cacheKey, width);
+    const QString filePath = m_directory.filePath(name);
+    // Concurrent readers must never see a partially written
+    // thumbnail. QSaveFile writes into a temporary file that
+    // atomically replaces the thumbnail when committed.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << filePath
+                << file.errorString();
+        return;
+    }
+    QImageWriter writer(&file, m_format);
+    writer.setQuality(kImageQuality);
+    if (!writer.write(image)) {
+        kLogger.warning()
+                << "Failed to write thumbnail"
+                << filePath
+                << writer.errorString();
+        file.cancelWriting();
+        return;
+    }
+    const qint64 sizeInBytes = file.size();
+    if (!file.commit()) {
+        kLogger.warning()
+                << "Failed to save thumbnail"
+                << filePath
+                << file.errorString();
+        return;
+    }
+
+    const QMutexLocker locker(&m_mutex);
+    scanDirectoryLocked();
+    // The thumbnail might have been stored by another
+    // thread in the meantime and must not be counted twice
+    const auto it = m_entries.find(name);
+    if (it != m_entries.end()) {
+        m_totalSizeInBytes -= it->sizeInBytes;
+    }
+    const Entry entry{sizeInBytes, QDateTime::currentMSecsSinceEpoch()};
+    m_entries.insert(name, entry);
+    m_totalSizeInBytes += entry.sizeInBytes;
+    evictLocked();
+}
+
+void CoverArtDiskCache::removeLocked(const QString& name) {
+    const auto it = m_entries.find(name);
+    if (it == m_entries.end()) {
+        return;
+    }
+    m_totalSizeInBytes -= it->sizeInBytes;
+    m_entries.erase(it);
+    QFile::remove(m_directory.filePath(name));
+}
+
+void CoverArtDiskCache::evictLocked() {
+    if (m_totalSizeInBytes <= m_maxSizeInBytes) {
+        return;
+    }
+    QVector<QPair<qint64, QString>> entriesByLastAccess;
+    entriesByLastAccess.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        entriesByLastAccess.append(qMakePair(it->lastAccessed, it.key()));
+    }
+    std::sort(entriesByLastAccess.begin(), entriesByLastAccess.end());
+
+    const qint64 targetSizeInBytes = m_maxSizeInBytes * kEvictionTargetPercent / 100;
+    int evictedCount = 0;
+    for (const auto& entry : std::as_const(entriesByLastAccess)) {
+        if (m_totalSizeInBytes <= targetSizeInBytes) {
+            break;
+        }
+        removeLocked(entry.second);
+        ++evictedCount;
+    }
+    kLogger.debug()
+            << "Evicted"
+            << evictedCount
+            << "thumbnails";
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+#include "util/cache.h"
+#include "util/class.h"
+
+/// A persistent, size-bounded store of cover art thumbnails, i.e. covers
+/// that have been scaled to the width of the cover art column. Thumbnails
+/// are identified by the cache key of the original image and their width.
+///
+/// Reading a small compressed thumbnail is much faster than extracting the
+/// embedded cover from an audio file and scaling it down again. The least
+/// recently used thumbnails are deleted when the total size exceeds the
+/// limit.
+///
+/// All functions are thread-safe, thumbnails are loaded and stored by the
+/// worker threads of CoverArtCache.
+class CoverArtDiskCache final {
+  public:
+    CoverArtDiskCache(const QString& directory, qint64 maxSizeInBytes);
+
+    /// Returns a null image if the thumbnail is not available.
+    QImage load(mixxx::cache_key_t cacheKey, int width);
+
+    void store(mixxx::cache_key_t cacheKey, int width, const QImage& image);
+
+    /// The location of the thumbnail, even if it is not available.
+    QString filePath(mixxx::cache_key_t cacheKey, int width) const {
+        return m_directory.filePath(fileName(cacheKey, width));
+    }
+
+  private:
+    struct Entry {
+        qint64 sizeInBytes;
+        // Milliseconds since epoch
+        qint64 lastAccessed;
+    };
+
+    QString fileName(mixxx::cache_key_t cacheKey, int width) const;
+
+    // Must be called with m_mutex locked
+    void scanDirectoryLocked();
+    void removeLocked(const QString& fileName);
+    void evictLocked();
+
+    const QDir m_directory;
+    const qint64 m_maxSizeInBytes;
+    const QByteArray m_format;
+
+    QMutex m_mutex;
+    bool m_scanned;
+    QHash<QString, Entry> m_entries;
+    qint64 m_totalSizeInBytes;
+
+    DISALLOW_COPY_AND_ASSIGN(CoverArtDiskCache);
+};
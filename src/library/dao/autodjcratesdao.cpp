@@ -3,6 +3,7 @@
 #include <QRandomGenerator>
 #include <QtDebug>
 #include <QtSql>
+#include <algorithm>
 
 #include "library/dao/settingsdao.h"
 #include "library/dao/trackdao.h"
@@ -15,31 +16,14 @@
 #include "mixer/playermanager.h"
 #include "moc_autodjcratesdao.cpp"
 #include "track/track.h"
+#include "util/db/sqlite.h"
+#include "util/performancetimer.h"
 
 #if !defined(VERBOSE_DEBUG_LOG)
 // set to true for verbose debug logs
 #define VERBOSE_DEBUG_LOG false
 #endif
 
-#define AUTODJCRATESTABLE_TRACKID "track_id"
-#define AUTODJCRATESTABLE_CRATEREFS "craterefs"
-#define AUTODJCRATESTABLE_TIMESPLAYED "timesplayed"
-#define AUTODJCRATESTABLE_AUTODJREFS "autodjrefs"
-#define AUTODJCRATESTABLE_LASTPLAYED "lastplayed"
-
-#define AUTODJCRATES_TABLE "temp_autodj_crates"
-// A table of all tracks that are assigned to the AutoDJ via a crate
-// Columns:
-// INTEGER AUTODJCRATESTABLE_TRACKID -> Tracks that are member of crate assigned to AutoDj
-// INTEGER AUTODJCRATESTABLE_CRATEREFS -> counts the occurrences of track in auto dj crates
-// INTEGER AUTODJCRATESTABLE_TIMESPLAYED -> library played counter
-// INTEGER AUTODJCRATESTABLE_AUTODJREFS -> counts the occurrences of the track in the AutoDj queue
-// DATETIME AUTODJCRATESTABLE_LASTPLAYED -> from the history feature
-
-#define AUTODJACTIVETRACKS_TABLE "temp_autodj_activetracks"
-// The same table like above, but of all tracks that not already queued into Auto DJ
-// ordered by TimesPlayed.
-
 namespace {
 // Percentage of most and least played tracks to ignore [0,50)
 constexpr int kLeastPreferredPercent = 15;
@@ -54,6 +38,39 @@ int bounded_rand(int highest) {
     return QRandomGenerator::global()->bounded(highest);
 }
 
+QString joinTrackIdList(const QList<TrackId>& trackIds) {
+    QStringList trackIdList;
+    trackIdList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        trackIdList.append(trackId.toString());
+    }
+    return trackIdList.join(QChar(','));
+}
+
+// Tracks that are loaded into a deck count as auto-DJ references.
+// The same track might be loaded into multiple decks.
+QHash<TrackId, int> countLoadedDeckTracks() {
+    QHash<TrackId, int> loadedDeckTracks;
+    const int iDecks = static_cast<int>(PlayerManager::numDecks());
+    for (int i = 0; i < iDecks; ++i) {
+        const TrackPointer pTrack = PlayerInfo::instance().getTrackInfo(
+                PlayerManager::groupForDeck(i));
+        if (pTrack) {
+            ++loadedDeckTracks[pTrack->getId()];
+        }
+    }
+    return loadedDeckTracks;
+}
+
+// The condition that selects the tracks of all auto-DJ crates
+const QString kAutoDjCrateTracksCondition =
+        QStringLiteral(CRATE_TRACKS_TABLE ".%1 IN (SELECT %2 FROM " CRATE_TABLE
+                       " WHERE %3=1)")
+                .arg(CRATETRACKSTABLE_CRATEID,   // %1
+                        CRATETABLE_ID,           // %2
+                        CRATETABLE_AUTODJ_SOURCE // %3
+                );
+
 } // anonymous namespace
 
 AutoDJCratesDAO::AutoDJCratesDAO(
@@ -64,8 +81,8 @@ AutoDJCratesDAO::AutoDJCratesDAO(
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
           m_pConfig(pConfig),
-          // The database has not been created yet.
-          m_bAutoDjCratesDbCreated(false),
+          // The tracks have not been loaded yet.
+          m_bAutoDjCrateTracksLoaded(false),
           // By default, active tracks are not tracks that haven't been played in
           // a while.
           m_bUseIgnoreTime(false) {
@@ -74,124 +91,47 @@ AutoDJCratesDAO::AutoDJCratesDAO(
 AutoDJCratesDAO::~AutoDJCratesDAO() {
 }
 
-// Create the temporary auto-DJ-crates table.
+// Load the tracks of all auto-DJ crates into memory.
 // Done the first time it's used, since the user might not even make
 // use of this feature.
-void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
+void AutoDJCratesDAO::loadAndConnectAutoDjCrateTracks() {
     // If the use of tracks that haven't been played in a while has changed,
-    // then the active-tracks view must be recreated.
-    bool bUseIgnoreTime = m_pConfig->getValue(
+    // then the active tracks must be reordered.
+    m_bUseIgnoreTime = m_pConfig->getValue(
             ConfigKey("[Auto DJ]", "UseIgnoreTime"), false);
-    if (m_bAutoDjCratesDbCreated) {
-        if (m_bUseIgnoreTime != bUseIgnoreTime) {
-            // Do all this in a single transaction.
-            ScopedTransaction oTransaction(m_database);
-
-            // Get rid of the old active-tracks view.
-            QSqlQuery oQuery(m_database);
-            oQuery.exec ("DROP VIEW IF EXISTS " AUTODJACTIVETRACKS_TABLE);
-            if (!oQuery.exec()) {
-                LOG_FAILED_QUERY(oQuery);
-                return;
-            }
-
-            // Create the new active-tracks view.
-            if (!createActiveTracksView(bUseIgnoreTime)) {
-                return;
-            }
+    m_crateTracks.setOrderByLastPlayed(m_bUseIgnoreTime);
 
-            // Remember the new setting.
-            m_bUseIgnoreTime = bUseIgnoreTime;
-
-            // Commit these changes.
-            oTransaction.commit();
-        }
-    } else {
-        m_bUseIgnoreTime = bUseIgnoreTime;
-    }
-
-    // If this database has already been created, skip this.
-    if (m_bAutoDjCratesDbCreated) {
+    // If the tracks have already been loaded, skip this.
+    if (m_bAutoDjCrateTracksLoaded) {
         return;
     }
 
-    // Do all of this in a single transaction.
-    ScopedTransaction oTransaction(m_database);
-
-    // The auto-DJ-crates table contains the track ID, the number of references
-    // to that track ID in all of the auto-DJ crates, the number of times that
-    // track has been played, and the number of references to the track in the
-    // auto-DJ playlist (or in loaded decks).  It filters out tracks that have
-    // been deleted from the database (i.e. "hidden" tracks).
+    PerformanceTimer timer;
+    timer.start();
 
-    // Create an empty table.
-    QSqlQuery oQuery(m_database);
-    // CREATE TEMP TABLE temp_autodj_crates (track_id INTEGER UNIQUE, craterefs INTEGER, timesplayed INTEGER, autodjrefs INTEGER, lastplayed DATETIME);
-    //oQuery.exec ("DROP TABLE IF EXISTS " AUTODJCRATES_TABLE);
-    QString strQuery("CREATE TEMP TABLE " AUTODJCRATES_TABLE
-        " (" AUTODJCRATESTABLE_TRACKID " INTEGER UNIQUE, "
-        AUTODJCRATESTABLE_CRATEREFS " INTEGER, "
-        AUTODJCRATESTABLE_TIMESPLAYED " INTEGER, "
-        AUTODJCRATESTABLE_AUTODJREFS " INTEGER, "
-        AUTODJCRATESTABLE_LASTPLAYED " DATETIME)");
-    oQuery.prepare(strQuery);
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
+    // The tracks of all auto-DJ crates with the number of times they have
+    // been played and the number of references to them in the auto-DJ
+    // playlist (or in loaded decks). Tracks that have been deleted from
+    // the database (i.e. "hidden" tracks) are filtered out.
+    QHash<CrateId, QVector<AutoDJCrateTracks::TrackInfo>> crateTracks;
+    if (!queryCrateTracks(kAutoDjCrateTracksCondition, &crateTracks)) {
         return;
     }
-
-    strQuery = QStringLiteral(
-            "INSERT INTO " AUTODJCRATES_TABLE "(" AUTODJCRATESTABLE_TRACKID
-            "," AUTODJCRATESTABLE_CRATEREFS "," AUTODJCRATESTABLE_TIMESPLAYED
-            "," AUTODJCRATESTABLE_LASTPLAYED "," AUTODJCRATESTABLE_AUTODJREFS
-            ") SELECT " CRATE_TRACKS_TABLE
-            ".%5,"               // TRACKID
-            "COUNT(*),"          // CRATEREFS
-            LIBRARY_TABLE ".%2," // TIMESPLAYED
-            LIBRARY_TABLE
-            ".%3," // LASTPLAYED
-            "0"    // AUTODJREFS = default
-            " FROM " CRATE_TRACKS_TABLE
-            " INNER JOIN " LIBRARY_TABLE " ON " LIBRARY_TABLE ".%1=" CRATE_TRACKS_TABLE
-            ".%5"
-            " WHERE " LIBRARY_TABLE
-            ".%4=0"
-            " AND " CRATE_TRACKS_TABLE ".%6 IN (SELECT %7 FROM " CRATE_TABLE
-            " WHERE %8=1)"
-            " GROUP BY " CRATE_TRACKS_TABLE ".%5")
-                       .arg(LIBRARYTABLE_ID,                // %1
-                               LIBRARYTABLE_TIMESPLAYED,    // %2
-                               LIBRARYTABLE_LAST_PLAYED_AT, // %3
-                               LIBRARYTABLE_MIXXXDELETED,   // %4
-                               CRATETRACKSTABLE_TRACKID,    // %5
-                               CRATETRACKSTABLE_CRATEID,    // %6
-                               CRATETABLE_ID,               // %7
-                               CRATETABLE_AUTODJ_SOURCE);   // %8
-#if !defined(VERBOSE_DEBUG_LOG)
-    qDebug().noquote()
-            << "Populating " AUTODJCRATES_TABLE " using the following SQL query:"
-            << strQuery;
-#endif
-    oQuery.prepare(strQuery);
+    // Crates without tracks are auto-DJ crates, too.
+    QSqlQuery oQuery(m_database);
+    oQuery.prepare(QStringLiteral("SELECT %1 FROM " CRATE_TABLE " WHERE %2=1")
+                           .arg(CRATETABLE_ID,              // %1
+                                   CRATETABLE_AUTODJ_SOURCE // %2
+                                   ));
     if (!oQuery.exec()) {
         LOG_FAILED_QUERY(oQuery);
         return;
     }
-
-    // Fill out the number of auto-DJ-playlist references.
-    if (!updateAutoDjPlaylistReferences()) {
-        return;
-    }
-
-    // Fill out the last-played date/time.
-    if (!updateLastPlayedDateTime()) {
-        return;
-    }
-
-    // Create the active-tracks view.
-    //oQuery.exec ("DROP VIEW IF EXISTS " AUTODJACTIVETRACKS_TABLE);
-    if (!createActiveTracksView (m_bUseIgnoreTime)) {
-        return;
+    while (oQuery.next()) {
+        const CrateId crateId(oQuery.value(0));
+        if (!crateTracks.contains(crateId)) {
+            crateTracks.insert(crateId, {});
+        }
     }
 
     // Make a list of the IDs of every set-log playlist.
@@ -209,10 +149,18 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
         return;
     }
 
-    // Now the auto-DJ crates database is initialized.
-    // Externally-driven updates to the database from now on are driven by
-    // signals.
-    oTransaction.commit();
+    m_crateTracks.clear();
+    for (auto it = crateTracks.constBegin(); it != crateTracks.constEnd(); ++it) {
+        m_crateTracks.addCrateTracks(it.key(), it.value());
+    }
+    qDebug() << "Loaded"
+             << m_crateTracks.size()
+             << "tracks of"
+             << crateTracks.size()
+             << "auto-DJ crates in"
+             << timer.elapsed().debugMillisWithUnit();
+
+    // Externally-driven updates from now on are driven by signals.
 
     // Be notified when a track is modified.
     // We only care when the number of times it's been played changes.
@@ -269,306 +217,118 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
             this,
             &AutoDJCratesDAO::slotPlayerInfoTrackChanged);
 
-    // Remember that the auto-DJ-crates database has been created.
-    m_bAutoDjCratesDbCreated = true;
+    // Remember that the tracks of the auto-DJ crates have been loaded.
+    m_bAutoDjCrateTracksLoaded = true;
 }
 
-// Create the active-tracks view.
-bool AutoDJCratesDAO::createActiveTracksView (bool a_bUseIgnoreTime) {
-    // Create the active-tracks view.  This is a list of all tracks loaded into
-    // the auto-DJ-crates database, excluding all tracks already in the auto-DJ
-    // playlist, sorted by the number of times the track has been played, and
-    // limited by either the active percentage or by the number of tracks that
-    // have never been played, whichever is larger.
-    //
-    // At one point, I hoped that I could create this table in a single SQL
-    // statement, with a "limit" clause that dynamically updated the size of the
-    // view as the state of the system changed.  Unfortunately, that limit
-    // clause is only evaluated once.  For posterity, though, here's the monster
-    // SQL query that attempted to create that version:
-    //
-    // CREATE TEMP VIEW temp_autodj_activetracks AS
-    //     SELECT * FROM temp_autodj_crates
-    //     WHERE autodjrefs = 0
-    //     ORDER BY timesplayed, lastplayed LIMIT (
-    //         SELECT MAX(count)
-    //         FROM (
-    //             SELECT COUNT(*) AS count
-    //             FROM temp_autodj_crates WHERE timesplayed = 0
-    //             UNION ALL SELECT (
-    //                 count * (
-    //                     SELECT value
-    //                     FROM settings WHERE
-    //                     name="mixxx.db.model.autodjcrates.active_percentage")
-    //                 / 100) AS count
-    //                 FROM (
-    //                     SELECT COUNT(*) AS count
-    //                     FROM temp_autodj_crates)));
-
-    // CREATE TEMP VIEW temp_autodj_activetracks AS
-    // SELECT *
-    // FROM temp_autodj_crates
-    // WHERE autodjrefs = 0
-    // ORDER BY timesplayed, lastplayed;
-    QSqlQuery oQuery(m_database);
-    QString strTimesPlayed;
-    if (!a_bUseIgnoreTime) {
-        strTimesPlayed = AUTODJCRATESTABLE_TIMESPLAYED ", ";
-    }
-    oQuery.prepare(QString("CREATE TEMP VIEW " AUTODJACTIVETRACKS_TABLE
-            " AS SELECT * FROM " AUTODJCRATES_TABLE " WHERE "
-            AUTODJCRATESTABLE_AUTODJREFS " = 0 ORDER BY %1"
-            AUTODJCRATESTABLE_LASTPLAYED)
-            .arg(strTimesPlayed)); // %1
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return false;
+bool AutoDJCratesDAO::queryCrateTracks(
+        const QString& crateTracksCondition,
+        QHash<CrateId, QVector<AutoDJCrateTracks::TrackInfo>>* pCrateTracks) {
+    // SELECT crate_tracks.crate_id, crate_tracks.track_id, library.timesplayed,
+    //     COALESCE((
+    //         SELECT MAX(PlaylistTracks.pl_datetime_added)
+    //         FROM PlaylistTracks INNER JOIN Playlists
+    //         ON PlaylistTracks.playlist_id = Playlists.id
+    //         WHERE Playlists.hidden = PLHT_SET_LOG
+    //         AND PlaylistTracks.track_id = crate_tracks.track_id),
+    //         library.last_played_at),
+    //     (SELECT COUNT(*) FROM PlaylistTracks
+    //         WHERE PlaylistTracks.playlist_id = :autodj_playlist_id
+    //         AND PlaylistTracks.track_id = crate_tracks.track_id)
+    // FROM crate_tracks INNER JOIN library ON library.id = crate_tracks.track_id
+    // WHERE library.mixxx_deleted = 0 AND <condition>;
+    const QString strQuery =
+            QStringLiteral(
+                    "SELECT " CRATE_TRACKS_TABLE ".%1," CRATE_TRACKS_TABLE
+                    ".%2," LIBRARY_TABLE
+                    ".%3,"
+                    "COALESCE((SELECT MAX(" PLAYLIST_TRACKS_TABLE
+                    ".%4) FROM " PLAYLIST_TRACKS_TABLE
+                    " INNER JOIN " PLAYLIST_TABLE " ON " PLAYLIST_TRACKS_TABLE
+                    ".%5=" PLAYLIST_TABLE ".%6 WHERE " PLAYLIST_TABLE
+                    ".%7=%8 AND " PLAYLIST_TRACKS_TABLE ".%9=" CRATE_TRACKS_TABLE
+                    ".%2)," LIBRARY_TABLE
+                    ".%10),"
+                    "(SELECT COUNT(*) FROM " PLAYLIST_TRACKS_TABLE
+                    " WHERE " PLAYLIST_TRACKS_TABLE ".%5=:autodj_playlist_id AND " PLAYLIST_TRACKS_TABLE
+                    ".%9=" CRATE_TRACKS_TABLE
+                    ".%2)"
+                    " FROM " CRATE_TRACKS_TABLE " INNER JOIN " LIBRARY_TABLE
+                    " ON " LIBRARY_TABLE ".%11=" CRATE_TRACKS_TABLE
+                    ".%2"
+                    " WHERE " LIBRARY_TABLE ".%12=0 AND (%13)")
+                    .arg(CRATETRACKSTABLE_CRATEID,                     // %1
+                            CRATETRACKSTABLE_TRACKID,                  // %2
+                            LIBRARYTABLE_TIMESPLAYED,                  // %3
+                            PLAYLISTTRACKSTABLE_DATETIMEADDED,         // %4
+                            PLAYLISTTRACKSTABLE_PLAYLISTID,            // %5
+                            PLAYLISTTABLE_ID,                          // %6
+                            PLAYLISTTABLE_HIDDEN,                      // %7
+                            QString::number(PlaylistDAO::PLHT_SET_LOG), // %8
+                            PLAYLISTTRACKSTABLE_TRACKID)               // %9
+                    .arg(LIBRARYTABLE_LAST_PLAYED_AT,                  // %10
+                            LIBRARYTABLE_ID,                           // %11
+                            LIBRARYTABLE_MIXXXDELETED,                 // %12
+                            crateTracksCondition);                     // %13
+    if (VERBOSE_DEBUG_LOG) {
+        qDebug().noquote()
+                << "Querying auto-DJ crate tracks using the following SQL query:"
+                << strQuery;
     }
-    return true;
-}
-
-// Update the number of auto-DJ-playlist references to each track in the
-// auto-DJ-crates database.
-bool AutoDJCratesDAO::updateAutoDjPlaylistReferences() {
     QSqlQuery oQuery(m_database);
-
-    // Rebuild the auto-DJ-playlist reference count.
-    // INSERT OR REPLACE INTO temp_autodj_crates (
-    //     track_id, craterefs, timesplayed, autodjrefs)
-    // SELECT *
-    // FROM (
-    //     SELECT PlaylistTracks.track_id, craterefs, timesplayed, COUNT (*) AS newautodjrefs
-    //     FROM PlaylistTracks, temp_autodj_crates
-    //     WHERE PlaylistTracks.playlist_id IN (
-    //         SELECT id FROM Playlists WHERE hidden = PLHT_AUTO_DJ)
-    //     AND PlaylistTracks.track_id = temp_autodj_crates.track_id
-    //     GROUP BY PlaylistTracks.track_id)
-    // WHERE newautodjrefs > 0;
-    QString strHidden;
-    strHidden.setNum(PlaylistDAO::PLHT_AUTO_DJ);
-    QString strQuery(QString ("INSERT OR REPLACE INTO " AUTODJCRATES_TABLE
-            " (" AUTODJCRATESTABLE_TRACKID ", " AUTODJCRATESTABLE_CRATEREFS ", "
-            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS ")"
-            " SELECT * FROM (SELECT " PLAYLIST_TRACKS_TABLE ".%1, "
-            AUTODJCRATESTABLE_CRATEREFS ", " AUTODJCRATESTABLE_TIMESPLAYED
-            ", COUNT (*) AS new" AUTODJCRATESTABLE_AUTODJREFS " FROM "
-            PLAYLIST_TRACKS_TABLE ", " AUTODJCRATES_TABLE " WHERE "
-            PLAYLIST_TRACKS_TABLE ".%2 IN (SELECT %3 FROM " PLAYLIST_TABLE
-            " WHERE %4 = %5) AND " PLAYLIST_TRACKS_TABLE ".%1 = "
-            AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_TRACKID " GROUP BY "
-            PLAYLIST_TRACKS_TABLE ".%1) WHERE new" AUTODJCRATESTABLE_AUTODJREFS
-            " > 0")
-            .arg(PLAYLISTTRACKSTABLE_TRACKID, // %1
-                 PLAYLISTTRACKSTABLE_PLAYLISTID, // %2
-                 PLAYLISTTABLE_ID, // %3
-                 PLAYLISTTABLE_HIDDEN, // %4
-                 strHidden)); // %5
+    oQuery.setForwardOnly(true);
     oQuery.prepare(strQuery);
+    oQuery.bindValue(":autodj_playlist_id", m_iAutoDjPlaylistId);
     if (!oQuery.exec()) {
         LOG_FAILED_QUERY(oQuery);
         return false;
     }
-
-    // Incorporate all tracks loaded into decks.
-    // Each track has to be done as a separate database query, in case the same
-    // track is loaded into multiple decks.
-    int iDecks = (int) PlayerManager::numDecks();
-    for (int i = 0; i < iDecks; ++i) {
-        QString group = PlayerManager::groupForDeck(i);
-        TrackPointer pTrack = PlayerInfo::instance().getTrackInfo(group);
-        if (pTrack) {
-            TrackId trackId(pTrack->getId());
-            // UPDATE temp_autodj_crates SET autodjrefs = autodjrefs + 1 WHERE track_id IN (:track_id);
-            oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-                    AUTODJCRATESTABLE_AUTODJREFS " = " AUTODJCRATESTABLE_AUTODJREFS
-                    " + 1 WHERE " AUTODJCRATESTABLE_TRACKID " IN (:track_id)");
-            oQuery.bindValue(":track_id", trackId.toVariant());
-            if (!oQuery.exec()) {
-                LOG_FAILED_QUERY(oQuery);
-                return false;
-            }
-        }
+    const QHash<TrackId, int> loadedDeckTracks = countLoadedDeckTracks();
+    while (oQuery.next()) {
+        AutoDJCrateTracks::TrackInfo trackInfo;
+        trackInfo.id = TrackId(oQuery.value(1));
+        trackInfo.timesPlayed = oQuery.value(2).toInt();
+        trackInfo.lastPlayed = mixxx::sqlite::readGeneratedTimestamp(oQuery.value(3));
+        trackInfo.autoDjRefs = oQuery.value(4).toInt() +
+                loadedDeckTracks.value(trackInfo.id);
+        (*pCrateTracks)[CrateId(oQuery.value(0))].append(trackInfo);
     }
     return true;
 }
 
-// Update the number of auto-DJ-playlist references to the given track in the
-// auto-DJ-crates database.
-bool AutoDJCratesDAO::updateAutoDjPlaylistReferencesForTrack(TrackId trackId) {
-    QSqlQuery oQuery(m_database);
-
-    // INSERT OR REPLACE INTO temp_autodj_crates (
-    //     track_id, craterefs, timesplayed, autodjrefs)
-    // SELECT *
-    // FROM (
-    //     SELECT :track_id AS new_track_id, craterefs, timesplayed, COUNT (*) AS newautodjrefs
-    //     FROM PlaylistTracks, temp_autodj_crates
-    //     WHERE PlaylistTracks.playlist_id IN (
-    //         SELECT id
-    //         FROM Playlists
-    //         WHERE hidden = 1)
-    //     AND PlaylistTracks.track_id = :track_id
-    //     AND temp_autodj_crates.track_id = :track_id
-    //     GROUP BY new_track_id)
-    // WHERE newautodjrefs > 0;
-    QString strHidden;
-    strHidden.setNum(PlaylistDAO::PLHT_AUTO_DJ);
-    oQuery.prepare(QString("INSERT OR REPLACE INTO " AUTODJCRATES_TABLE " ("
-            AUTODJCRATESTABLE_TRACKID ", " AUTODJCRATESTABLE_CRATEREFS ", "
-            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS
-            ") SELECT * FROM (SELECT :track_id_1 AS new_track_id, "
-            AUTODJCRATESTABLE_CRATEREFS ", " AUTODJCRATESTABLE_TIMESPLAYED
-            ", COUNT (*) AS new" AUTODJCRATESTABLE_AUTODJREFS " FROM "
-            PLAYLIST_TRACKS_TABLE ", " AUTODJCRATES_TABLE " WHERE "
-            PLAYLIST_TRACKS_TABLE ".%1 IN (SELECT %4 FROM " PLAYLIST_TABLE
-            " WHERE %2 = %5) AND " PLAYLIST_TRACKS_TABLE ".%3 = :track_id_2 AND "
-            AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_TRACKID
-            " = :track_id_3 GROUP BY new_track_id) WHERE new"
-            AUTODJCRATESTABLE_AUTODJREFS " > 0")
-            .arg(PLAYLISTTRACKSTABLE_PLAYLISTID, // %1
-                 PLAYLISTTABLE_HIDDEN, // %2
-                 PLAYLISTTRACKSTABLE_TRACKID, // %3
-                 PLAYLISTTABLE_ID, // %4
-                 strHidden)); // %5
-    oQuery.bindValue(":track_id_1", trackId.toVariant());
-    oQuery.bindValue(":track_id_2", trackId.toVariant());
-    oQuery.bindValue(":track_id_3", trackId.toVariant());
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return false;
-    }
-
-    // The update was successful.
-    return true;
-}
-
-// Update the last-played date/time for each track in the auto-DJ-crates
-// database.
-bool AutoDJCratesDAO::updateLastPlayedDateTime() {
-    QSqlQuery oQuery(m_database);
-
-    // Rebuild the auto-DJ-playlist last-played date/time.
-    // INSERT OR REPLACE INTO temp_autodj_crates (
-    //     track_id, craterefs, timesplayed, autodjrefs, lastplayed)
-    // SELECT *
-    // FROM (
-    //     SELECT PlaylistTracks.track_id, craterefs, timesplayed, autodjrefs, MAX(pl_datetime_added) AS newlastplayed
-    //     FROM PlaylistTracks, temp_autodj_crates
-    //     WHERE PlaylistTracks.playlist_id IN (
-    //         SELECT id FROM Playlists WHERE hidden = PLHT_SET_LOG)
-    //     AND PlaylistTracks.track_id = temp_autodj_crates.track_id
-    //     GROUP BY PlaylistTracks.track_id)
-    // WHERE newlastplayed != "";
-    QString strSetLog;
-    strSetLog.setNum(PlaylistDAO::PLHT_SET_LOG);
-    QString strQuery(QString ("INSERT OR REPLACE INTO " AUTODJCRATES_TABLE
-            " (" AUTODJCRATESTABLE_TRACKID ", " AUTODJCRATESTABLE_CRATEREFS ", "
-            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS ", "
-            AUTODJCRATESTABLE_LASTPLAYED ")"
-            " SELECT * FROM (SELECT " PLAYLIST_TRACKS_TABLE ".%1, "
-            AUTODJCRATESTABLE_CRATEREFS ", " AUTODJCRATESTABLE_TIMESPLAYED ", "
-            AUTODJCRATESTABLE_AUTODJREFS ", MAX(%3) AS new"
-            AUTODJCRATESTABLE_LASTPLAYED " FROM " PLAYLIST_TRACKS_TABLE ", "
-            AUTODJCRATES_TABLE " WHERE " PLAYLIST_TRACKS_TABLE
-            ".%2 IN (SELECT %4 FROM " PLAYLIST_TABLE " WHERE %5 = %6) AND "
-            PLAYLIST_TRACKS_TABLE ".%1 = " AUTODJCRATES_TABLE "."
-            AUTODJCRATESTABLE_TRACKID " GROUP BY " PLAYLIST_TRACKS_TABLE
-            ".%1) WHERE new" AUTODJCRATESTABLE_LASTPLAYED " != \"\"")
-            .arg(PLAYLISTTRACKSTABLE_TRACKID, // %1
-                 PLAYLISTTRACKSTABLE_PLAYLISTID, // %2
-                 PLAYLISTTRACKSTABLE_DATETIMEADDED, // %3
-                 PLAYLISTTABLE_ID, // %4
-                 PLAYLISTTABLE_HIDDEN, // %5
-                 strSetLog)); // %6
-    oQuery.prepare(strQuery);
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
+// Update the last-played date/time of the given tracks or of all tracks
+// if the list is empty.
+bool AutoDJCratesDAO::updateLastPlayedDateTime(const QList<TrackId>& trackIds) {
+    QString condition = kAutoDjCrateTracksCondition;
+    if (!trackIds.isEmpty()) {
+        condition += QStringLiteral(" AND " CRATE_TRACKS_TABLE ".%1 IN (%2)")
+                             .arg(CRATETRACKSTABLE_TRACKID,
+                                     joinTrackIdList(trackIds));
+    }
+    QHash<CrateId, QVector<AutoDJCrateTracks::TrackInfo>> crateTracks;
+    if (!queryCrateTracks(condition, &crateTracks)) {
         return false;
     }
-
-    return true;
-}
-
-// Update the last-played date/time for the given track in the auto-DJ-crates
-// database.
-bool AutoDJCratesDAO::updateLastPlayedDateTimeForTrack(TrackId trackId) {
-    QSqlQuery oQuery(m_database);
-
-    // Update the last-played date/time for this track.
-    // INSERT OR REPLACE INTO temp_autodj_crates (
-    //     track_id, craterefs, timesplayed, autodjrefs, lastplayed)
-    // SELECT *
-    // FROM (
-    //     SELECT PlaylistTracks.track_id, craterefs, timesplayed, autodjrefs, MAX(pl_datetime_added) AS newlastplayed
-    //     FROM PlaylistTracks, temp_autodj_crates
-    //     WHERE PlaylistTracks.playlist_id IN (
-    //         SELECT id FROM Playlists WHERE hidden = PLHT_SET_LOG)
-    //     AND PlaylistTracks.track_id = :track_id
-    //     AND PlaylistTracks.track_id = temp_autodj_crates.track_id
-    //     GROUP BY PlaylistTracks.track_id)
-    // WHERE newlastplayed != "";
-    QString strSetLog;
-    strSetLog.setNum(PlaylistDAO::PLHT_SET_LOG);
-    oQuery.prepare(QString ("INSERT OR REPLACE INTO " AUTODJCRATES_TABLE
-            " (" AUTODJCRATESTABLE_TRACKID ", " AUTODJCRATESTABLE_CRATEREFS ", "
-            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS ", "
-            AUTODJCRATESTABLE_LASTPLAYED ")"
-            " SELECT * FROM (SELECT " PLAYLIST_TRACKS_TABLE ".%1, "
-            AUTODJCRATESTABLE_CRATEREFS ", " AUTODJCRATESTABLE_TIMESPLAYED ", "
-            AUTODJCRATESTABLE_AUTODJREFS ", MAX(%3) AS new"
-            AUTODJCRATESTABLE_LASTPLAYED " FROM " PLAYLIST_TRACKS_TABLE ", "
-            AUTODJCRATES_TABLE " WHERE " PLAYLIST_TRACKS_TABLE
-            ".%2 IN (SELECT %4 FROM " PLAYLIST_TABLE " WHERE %5 = %6) AND "
-            PLAYLIST_TRACKS_TABLE ".%1 = :track_id AND " PLAYLIST_TRACKS_TABLE
-            ".%1 = " AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_TRACKID
-            " GROUP BY " PLAYLIST_TRACKS_TABLE ".%1) WHERE new"
-            AUTODJCRATESTABLE_LASTPLAYED " != \"\"")
-            .arg(PLAYLISTTRACKSTABLE_TRACKID, // %1
-                 PLAYLISTTRACKSTABLE_PLAYLISTID, // %2
-                 PLAYLISTTRACKSTABLE_DATETIMEADDED, // %3
-                 PLAYLISTTABLE_ID, // %4
-                 PLAYLISTTABLE_HIDDEN, // %5
-                 strSetLog)); // %6
-    oQuery.bindValue(":track_id", trackId.toVariant());
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return false;
+    QHash<TrackId, QDateTime> lastPlayed;
+    for (const auto& tracks : std::as_const(crateTracks)) {
+        for (const auto& trackInfo : tracks) {
+            lastPlayed.insert(trackInfo.id, trackInfo.lastPlayed);
+        }
     }
-
-    // The update was successful.
+    m_crateTracks.setLastPlayed(lastPlayed);
     return true;
 }
 
 // Get the ID, i.e. one that references library.id, of a random track.
 // Returns an invalid track id if there was an error.
 TrackId AutoDJCratesDAO::getRandomTrackId() {
-    // If necessary, create the temporary auto-DJ-crates database.
-    createAndConnectAutoDjCratesDatabase();
+    // If necessary, load the tracks of the auto-DJ crates.
+    loadAndConnectAutoDjCrateTracks();
 
     // Calculate the number of active-tracks that have never been played, and
     // the total number of active-tracks.
-    QSqlQuery oQuery(m_database);
-    // SELECT COUNT(*) AS count
-    // FROM temp_autodj_activetracks
-    // WHERE timesplayed = 0
-    // UNION ALL SELECT COUNT(*) AS count
-    // FROM temp_autodj_activetracks;
-    oQuery.prepare("SELECT COUNT(*) AS count FROM " AUTODJACTIVETRACKS_TABLE
-        " WHERE " AUTODJCRATESTABLE_TIMESPLAYED
-        " = 0 UNION ALL SELECT COUNT(*) AS count FROM "
-        AUTODJACTIVETRACKS_TABLE);
-    VERIFY_OR_DEBUG_ASSERT(oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return TrackId();
-    }
-    int iUnplayedTracks = 0;
-    int iTotalTracks = 0;
-    if (oQuery.next()) {
-        iUnplayedTracks = oQuery.value(0).toInt();
-        if (oQuery.next()) {
-            iTotalTracks = oQuery.value(0).toInt();
-        }
-    }
+    const int iUnplayedTracks = m_crateTracks.unplayedActiveTrackCount();
+    const int iTotalTracks = m_crateTracks.activeTrackCount();
 
     // Get the active percentage (default 20%).
     int minimumAvailablePercentage = m_pConfig->getValue(
@@ -603,24 +363,9 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
         timeCurrent = timeCurrent.addSecs(-(timIgnoreTime.hour() * 3600
             + timIgnoreTime.minute() * 60));
 
-        // Convert the time to sqlite's format, which is similar to ISO date,
-        // but not quite.
-        QString strDateTime = timeCurrent.toString("yyyy-MM-dd hh:mm:ss");
-
         // Count the number of tracks that haven't been played since this time.
-        // SELECT COUNT(*) FROM temp_autodj_activetracks WHERE lastplayed < :lastplayed;
-        int iIgnoreTimeTracks = 0;
-        oQuery.prepare("SELECT COUNT(*) FROM " AUTODJACTIVETRACKS_TABLE
-            " WHERE " AUTODJCRATESTABLE_LASTPLAYED " < :lastplayed");
-        oQuery.bindValue (":lastplayed", strDateTime);
-        if (oQuery.exec()) {
-            if (oQuery.next()) {
-                iIgnoreTimeTracks = oQuery.value(0).toInt();
-            }
-        } else {
-            LOG_FAILED_QUERY(oQuery);
-            return TrackId();
-        }
+        const int iIgnoreTimeTracks =
+                m_crateTracks.activeTrackCountLastPlayedBefore(timeCurrent);
 
         // Allow that to be a new maximum.
         iActiveTracks = qMax(iActiveTracks, iIgnoreTimeTracks);
@@ -633,25 +378,10 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
         qDebug() << "No random track available for Auto DJ";
         return TrackId();
     }
+    DEBUG_ASSERT(iActiveTracks <= iTotalTracks);
 
     // Pick a random track.
-    // SELECT track_id
-    // FROM temp_autodj_activetracks LIMIT 1 OFFSET ABS (RANDOM() % :active);
-    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TRACKID " FROM "
-        AUTODJACTIVETRACKS_TABLE " LIMIT 1 OFFSET ABS (RANDOM() % :active)");
-    oQuery.bindValue (":active", iActiveTracks);
-    VERIFY_OR_DEBUG_ASSERT(oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return TrackId();
-    }
-    if (oQuery.next()) {
-        // Give our caller the randomly-selected track.
-        return TrackId(oQuery.value(0));
-    } else {
-        DEBUG_ASSERT(false); // We should have exit earlier
-        qDebug() << "No random track available for Auto DJ";
-        return TrackId();
-    }
+    return m_crateTracks.activeTrackAt(bounded_rand(qMin(iActiveTracks, iTotalTracks)));
 }
 
 TrackId AutoDJCratesDAO::getRandomTrackIdFromAutoDj(int percentActive) {
@@ -664,20 +394,7 @@ TrackId AutoDJCratesDAO::getRandomTrackIdFromAutoDj(int percentActive) {
 
     // Calculate the number of tracks in the AutoDJ playlist
     // that are already queued up from the crates
-    QSqlQuery oQuery(m_database);
-    // SELECT COUNT(*) AS count
-    // FROM temp_autodj_crates
-    // WHERE autodjrefs > 0;
-    oQuery.prepare("SELECT COUNT(*) AS count FROM " AUTODJCRATES_TABLE
-        " WHERE " AUTODJCRATESTABLE_AUTODJREFS " > 0" );
-    VERIFY_OR_DEBUG_ASSERT(oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return TrackId();
-    }
-    VERIFY_OR_DEBUG_ASSERT(oQuery.next()) {
-        return TrackId();
-    }
-    int queuedTracks = oQuery.value(0).toInt();
+    const int queuedTracks = m_crateTracks.queuedTrackCount();
 
     // If there are no tracks, let our caller know.
     if (queuedTracks == 0) {
@@ -688,72 +405,61 @@ TrackId AutoDJCratesDAO::getRandomTrackIdFromAutoDj(int percentActive) {
     // Use the top percentage of the AutoDJ to re-add
     int iActiveTracks = qMax((queuedTracks * percentActive / 100), 1);
 
-    // Pick a random track.
-    // SELECT DISTINCT track_id
-    // FROM temp_autodj_crates INNER JOIN Playlists
-    // ON temp_autodj_crates.track_id = PlaylistsTracks.track_id
-    // AND PlaylistsTracks.playlist_id = m_iAutoDjPlaylistId
-    // ORDER BY temp_autodj_crates.autodjrefs, PlaylistsTracks.position
-    // LIMIT 1 OFFSET ABS (RANDOM() % :active);
-    oQuery.prepare(QString("SELECT DISTINCT " AUTODJCRATES_TABLE "."
-            AUTODJCRATESTABLE_TRACKID " FROM "
-            AUTODJCRATES_TABLE " INNER JOIN " PLAYLIST_TRACKS_TABLE
-            " ON " AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_TRACKID
-            " = " PLAYLIST_TRACKS_TABLE ".%1"
-            " AND " PLAYLIST_TRACKS_TABLE ".%2 = %3"
-            " ORDER BY " AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_AUTODJREFS ", "
-            PLAYLIST_TRACKS_TABLE ".%4"
-            " LIMIT 1 OFFSET ABS (RANDOM() % :active)")
-            .arg(PLAYLISTTRACKSTABLE_TRACKID, // %1
-                 PLAYLISTTRACKSTABLE_PLAYLISTID, // %2
-                 QString::number(m_iAutoDjPlaylistId), // %3
-                 PLAYLISTTABLE_POSITION)); // %4
-    oQuery.bindValue (":active", iActiveTracks);
+    // The crate tracks in the AutoDJ playlist ordered by the number of
+    // auto-DJ references and their position in the playlist.
+    // SELECT track_id FROM PlaylistTracks
+    // WHERE playlist_id = m_iAutoDjPlaylistId
+    // ORDER BY position;
+    QSqlQuery oQuery(m_database);
+    oQuery.setForwardOnly(true);
+    oQuery.prepare(QString("SELECT %1 FROM " PLAYLIST_TRACKS_TABLE
+                           " WHERE %2 = :id ORDER BY %3")
+                           .arg(PLAYLISTTRACKSTABLE_TRACKID, // %1
+                                   PLAYLISTTRACKSTABLE_PLAYLISTID, // %2
+                                   PLAYLISTTRACKSTABLE_POSITION)); // %3
+    oQuery.bindValue(":id", m_iAutoDjPlaylistId);
     VERIFY_OR_DEBUG_ASSERT(oQuery.exec()) {
         LOG_FAILED_QUERY(oQuery);
         return TrackId();
     }
-    if (oQuery.next()) {
-        // Give our caller the randomly-selected track.
-        return TrackId(oQuery.value(0));
-    } else {
-        DEBUG_ASSERT(false); // We should have exit earlier
+    QVector<TrackId> queuedTrackIds;
+    QSet<TrackId> distinctTrackIds;
+    while (oQuery.next()) {
+        const TrackId trackId(oQuery.value(0));
+        if (m_crateTracks.contains(trackId) && !distinctTrackIds.contains(trackId)) {
+            distinctTrackIds.insert(trackId);
+            queuedTrackIds.append(trackId);
+        }
+    }
+    std::stable_sort(queuedTrackIds.begin(),
+            queuedTrackIds.end(),
+            [this](TrackId lhs, TrackId rhs) {
+                return m_crateTracks.autoDjReferences(lhs) <
+                        m_crateTracks.autoDjReferences(rhs);
+            });
+    if (queuedTrackIds.isEmpty()) {
+        // Only loaded into decks
         qDebug() << "No random track available for Auto DJ";
         return TrackId();
     }
-}
-
 
+    // Pick a random track.
+    return queuedTrackIds.at(bounded_rand(qMin(iActiveTracks, queuedTrackIds.size())));
+}
 
 // Signaled by the track DAO when a track's information is updated.
 void AutoDJCratesDAO::slotTrackDirty(TrackId trackId) {
+    // Only the tracks of auto-DJ crates are of interest.
+    if (!m_crateTracks.contains(trackId)) {
+        return;
+    }
     // Update our record of the number of times played, if that changed.
     TrackPointer pTrack = m_pTrackCollectionManager->getTrackById(trackId);
     if (!pTrack) {
         return;
     }
     const PlayCounter playCounter(pTrack->getPlayCounter());
-    if (playCounter.getTimesPlayed() == 0) {
-        return;
-    }
-
-    // Update our record of how many times this track has been played.
-    // UPDATE temp_autodj_crates
-    // SET timesplayed = :newplayed
-    // WHERE track_id = :track_id
-    // AND timesplayed = :oldplayed;
-    QSqlQuery oQuery(m_database);
-    oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_TIMESPLAYED " = :newplayed WHERE "
-            AUTODJCRATESTABLE_TRACKID " = :track_id AND "
-            AUTODJCRATESTABLE_TIMESPLAYED " = :oldplayed");
-    oQuery.bindValue(":track_id", trackId.toVariant());
-    oQuery.bindValue(":oldplayed", playCounter.getTimesPlayed() - 1);
-    oQuery.bindValue(":newplayed", playCounter.getTimesPlayed());
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return;
-    }
+    m_crateTracks.setTimesPlayed(trackId, playCounter.getTimesPlayed());
 }
 
 void AutoDJCratesDAO::slotCrateInserted(CrateId crateId) {
@@ -784,224 +490,48 @@ void AutoDJCratesDAO::slotCrateDeleted(CrateId crateId) {
 }
 
 void AutoDJCratesDAO::updateAutoDjCrate(CrateId crateId) {
-    // Handle a crate that's entered the auto-DJ queue differently than one that
-    // is leaving it.  (Obviously.)
-    ScopedTransaction oTransaction(m_database);
-
-    // Add a crate-reference to every track in this crate, if that track is
-    // already in the auto-DJ-crates table.
-    QSqlQuery oQuery(m_database);
-    // UPDATE temp_autodj_crates SET craterefs = craterefs + 1
-    // WHERE track_id IN (
-    //     SELECT temp_autodj_crates.track_id
-    //     FROM crate_tracks, temp_autodj_crates
-    //     WHERE crate_tracks.crate_id = :crate_id
-    //     AND crate_tracks.track_id = temp_autodj_crates.track_id);
-    oQuery.prepare(QString ("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_CRATEREFS " = " AUTODJCRATESTABLE_CRATEREFS
-            " + 1 WHERE " AUTODJCRATESTABLE_TRACKID " IN (SELECT "
-            AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_TRACKID " FROM "
-            CRATE_TRACKS_TABLE ", " AUTODJCRATES_TABLE " WHERE "
-            CRATE_TRACKS_TABLE ".%2 = :crate_id AND " CRATE_TRACKS_TABLE
-            ".%1 = " AUTODJCRATES_TABLE "." AUTODJCRATESTABLE_TRACKID ")")
-            .arg(CRATETRACKSTABLE_TRACKID, // %1
-                 CRATETRACKSTABLE_CRATEID)); // %2
-    oQuery.bindValue(":crate_id", crateId.toVariant());
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
+    // Other changes of a crate, e.g. renaming, do not affect its tracks.
+    if (m_crateTracks.containsCrate(crateId)) {
         return;
     }
-
-    // Create an entry for all tracks that weren't in the auto-DJ-crates
-    // table already.
-    // The number of crate references is known to be 1 for such tracks.
-    // The number of references to each track in the auto-DJ playlist isn't
-    // set yet; it defaults to zero.
-    // If no records were modified by this query, then there's no reason to
-    // update the number of auto-DJ-playlist references to each track.
-
-    // INSERT INTO temp_autodj_crates (
-    //     track_id, craterefs, timesplayed, autodjrefs)
-    // SELECT crate_tracks.track_id, 1, library.timesplayed, 0
-    // FROM crate_tracks, library
-    // WHERE crate_tracks.crate_id = :crate_id
-    // AND crate_tracks.track_id NOT IN (
-    //     SELECT track_id FROM temp_autodj_crates)
-    // AND crate_tracks.track_id = library.id
-    // AND library.mixxx_deleted = 0;
-    oQuery.prepare(QString("INSERT INTO " AUTODJCRATES_TABLE " ("
-            AUTODJCRATESTABLE_TRACKID ", " AUTODJCRATESTABLE_CRATEREFS ", "
-            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS
-            ") SELECT " CRATE_TRACKS_TABLE ".%1, 1, " LIBRARY_TABLE
-            ".timesplayed, 0 FROM " CRATE_TRACKS_TABLE ", " LIBRARY_TABLE
-            " WHERE " CRATE_TRACKS_TABLE ".%2 = :crate_id AND "
-            CRATE_TRACKS_TABLE ".%1 NOT IN (SELECT " AUTODJCRATESTABLE_TRACKID
-            " FROM " AUTODJCRATES_TABLE" ) AND " CRATE_TRACKS_TABLE ".%1 = "
-            LIBRARY_TABLE ".%3 AND " LIBRARY_TABLE ".%4 = 0")
-            .arg(CRATETRACKSTABLE_TRACKID, // %1
-                 CRATETRACKSTABLE_CRATEID, // %2
-                 LIBRARYTABLE_ID, // %3
-                 LIBRARYTABLE_MIXXXDELETED)); // %4
-    oQuery.bindValue(":crate_id", crateId.toVariant());
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return;
-    }
-    if (oQuery.numRowsAffected() == 0) {
-        oTransaction.commit();
-        return;
-    }
-
-    // Update the number of auto-DJ-playlist references to each track.
-    // There's no way to avoid updating the number of references to tracks
-    // that were already in the database, but the auto-DJ-playlist is likely
-    // to be small compared to the number of tracks in auto-DJ crates, so
-    // this isn't so bad.
-    if (!updateAutoDjPlaylistReferences()) {
-        return;
-    }
-
-    // Update the last-played date/time for each track.
-    // Similarly, there's no way to avoid updating the last-played date/time
-    // of tracks that were already in the database.
-    if (!updateLastPlayedDateTime()) {
+    QHash<CrateId, QVector<AutoDJCrateTracks::TrackInfo>> crateTracks;
+    if (!queryCrateTracks(
+                QStringLiteral(CRATE_TRACKS_TABLE ".%1=%2")
+                        .arg(CRATETRACKSTABLE_CRATEID, crateId.toString()),
+                &crateTracks)) {
         return;
     }
-
-    // The transaction was successful.
-    oTransaction.commit();
+    m_crateTracks.addCrateTracks(crateId, crateTracks.value(crateId));
 }
 
 void AutoDJCratesDAO::deleteAutoDjCrate(CrateId crateId) {
-    // Handle a crate that's entered the auto-DJ queue differently than one that
-    // is leaving it.  (Obviously.)
-    ScopedTransaction oTransaction(m_database);
-
-    // Remove a crate-reference from every track in this crate.
-    QSqlQuery oQuery(m_database);
-    // UPDATE temp_autodj_crates SET craterefs = craterefs - 1
-    // WHERE track_id IN (
-    //     SELECT track_id
-    //     FROM crate_tracks
-    //     WHERE crate_tracks.crate_id = :crate_id);
-    oQuery.prepare(QString("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_CRATEREFS " = " AUTODJCRATESTABLE_CRATEREFS
-            " - 1 WHERE " AUTODJCRATESTABLE_TRACKID " IN (SELECT %1 FROM "
-            CRATE_TRACKS_TABLE " WHERE " CRATE_TRACKS_TABLE ".%2 = :crate_id)")
-            .arg(CRATETRACKSTABLE_TRACKID, // %1
-                 CRATETRACKSTABLE_CRATEID)); // %2
-    oQuery.bindValue(":crate_id", crateId.toVariant());
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return;
-    }
-
-    // Remove all tracks that no longer have crate references.
-    //DELETE FROM temp_autodj_crates WHERE craterefs = 0;
-    oQuery.prepare("DELETE FROM " AUTODJCRATES_TABLE " WHERE "
-        AUTODJCRATESTABLE_CRATEREFS " = 0");
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return;
-    }
-
-    // The transaction was successful.
-    oTransaction.commit();
+    // The tracks of the crate are still known, even if the
+    // crate has already been deleted from the database.
+    m_crateTracks.removeCrate(crateId);
 }
 
 void AutoDJCratesDAO::slotCrateTracksChanged(
         CrateId crateId, const QList<TrackId>& addedTrackIds,
         const QList<TrackId>& removedTrackIds) {
     // Skip this if it's not an auto-DJ crate.
-    Crate crate;
-    if (!m_pTrackCollectionManager->internalCollection()
-                    ->crates()
-                    .readCrateById(crateId, &crate) ||
-            !crate.isAutoDjSource()) {
+    if (!m_crateTracks.containsCrate(crateId)) {
         return;
     }
 
-    ScopedTransaction oTransaction(m_database);
-    QSqlQuery oQuery(m_database);
-    for (const auto& trackId: addedTrackIds) {
-        // Add a crate-reference to this track, if it's already in the
-        // auto-DJ-crates table (in which case, we're done).
-        // UPDATE temp_autodj_crates SET craterefs = craterefs + 1 WHERE track_id = :track_id;
-        QString strHidden;
-        strHidden.setNum(PlaylistDAO::PLHT_AUTO_DJ);
-        oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_CRATEREFS " = " AUTODJCRATESTABLE_CRATEREFS
-            " + 1 WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id");
-        oQuery.bindValue(":track_id", trackId.toVariant());
-        if (!oQuery.exec()) {
-            LOG_FAILED_QUERY(oQuery);
-            return;
-        }
-        if (oQuery.numRowsAffected() == 1) {
-            continue;
-        }
-
-        // Create an entry for the track.
-        // The number of crate references is known to be 1 for such tracks.
-        // The number of references to each track in the auto-DJ playlist isn't
-        // set yet; it defaults to zero.
-        // If no records were modified by this query (i.e. because the track's
-        // mixxx_deleted flag is set), then there's no reason to update the number
-        // of auto-DJ-playlist references to each track.
-        // INSERT INTO temp_autodj_crates (track_id, craterefs, timesplayed, autodjrefs) SELECT :track_id, 1, library.timesplayed, 0 FROM library WHERE :track_id = library.id AND library.mixxx_deleted = 0;
-        oQuery.prepare(QString("INSERT INTO " AUTODJCRATES_TABLE " ("
-                AUTODJCRATESTABLE_TRACKID ", " AUTODJCRATESTABLE_CRATEREFS ", "
-                AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS
-                ") SELECT :track_id_1, 1, " LIBRARY_TABLE ".%1, 0 FROM " LIBRARY_TABLE
-                " WHERE :track_id_2 = " LIBRARY_TABLE ".%2 AND " LIBRARY_TABLE
-                ".%3 = 0")
-                .arg(LIBRARYTABLE_TIMESPLAYED, // %1
-                     LIBRARYTABLE_ID, // %2
-                     LIBRARYTABLE_MIXXXDELETED)); // %3
-        oQuery.bindValue(":track_id_1", trackId.toVariant());
-        oQuery.bindValue(":track_id_2", trackId.toVariant());
-        if (!oQuery.exec()) {
-            LOG_FAILED_QUERY(oQuery);
-            return;
-        }
-        if (oQuery.numRowsAffected() == 0) {
-            continue;
-        }
-
-        // Update the number of auto-DJ-playlist references to this track.
-        if (!updateAutoDjPlaylistReferencesForTrack(trackId)) {
-            return; // failure
-        }
-
-        // Update the last-played date/time for this track.
-        if (!updateLastPlayedDateTimeForTrack(trackId)) {
-            return; // failure
-        }
-    }
-    for (const auto& trackId: removedTrackIds) {
-        // UPDATE temp_autodj_crates SET craterefs = craterefs - 1 WHERE track_id = :track_id;
-        oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_CRATEREFS " = " AUTODJCRATESTABLE_CRATEREFS
-            " - 1 WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id");
-        oQuery.bindValue(":track_id", trackId.toVariant());
-        if (!oQuery.exec()) {
-            LOG_FAILED_QUERY(oQuery);
-            return;
-        }
-
-        // Remove the track if it no longer has a crate reference.
-        //DELETE FROM temp_autodj_crates WHERE track_id = :track_id AND craterefs = 0;
-        oQuery.prepare("DELETE FROM " AUTODJCRATES_TABLE " WHERE "
-            AUTODJCRATESTABLE_TRACKID " = :track_id AND "
-            AUTODJCRATESTABLE_CRATEREFS " = 0");
-        oQuery.bindValue(":track_id", trackId.toVariant());
-        if (!oQuery.exec()) {
-            LOG_FAILED_QUERY(oQuery);
+    if (!addedTrackIds.isEmpty()) {
+        QHash<CrateId, QVector<AutoDJCrateTracks::TrackInfo>> crateTracks;
+        if (!queryCrateTracks(
+                    QStringLiteral(CRATE_TRACKS_TABLE ".%1=%2 AND " CRATE_TRACKS_TABLE ".%3 IN (%4)")
+                            .arg(CRATETRACKSTABLE_CRATEID,
+                                    crateId.toString(),
+                                    CRATETRACKSTABLE_TRACKID,
+                                    joinTrackIdList(addedTrackIds)),
+                    &crateTracks)) {
             return;
         }
+        m_crateTracks.addCrateTracks(crateId, crateTracks.value(crateId));
     }
-    // The transaction was successful.
-    oTransaction.commit();
+    m_crateTracks.removeCrateTracks(crateId, removedTrackIds);
 }
 
 // Signaled by the playlistDAO when a playlist is added.
@@ -1010,8 +540,9 @@ void AutoDJCratesDAO::slotPlaylistAdded(int playlistId) {
     if (m_pTrackCollectionManager->internalCollection()
                     ->getPlaylistDAO()
                     .getHiddenType(playlistId) == PlaylistDAO::PLHT_SET_LOG) {
+        // A new set-log playlist is empty, i.e. the last-played
+        // date/time of the tracks is not affected.
         m_lstSetLogPlaylistIds.append(playlistId);
-        updateLastPlayedDateTime();
     }
 }
 
@@ -1030,23 +561,11 @@ void AutoDJCratesDAO::slotPlaylistTrackAdded(int playlistId, TrackId trackId,
                                              int /* a_iPosition */) {
     // Deal with changes to the auto-DJ playlist.
     if (playlistId == m_iAutoDjPlaylistId) {
-        QSqlQuery oQuery(m_database);
-        // UPDATE temp_autodj_crates SET autodjrefs = autodjrefs + 1
-        // WHERE track_id = :track_id;
-        oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_AUTODJREFS " = " AUTODJCRATESTABLE_AUTODJREFS
-            " + 1 WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id");
-        oQuery.bindValue(":track_id", trackId.toVariant());
-        if (!oQuery.exec()) {
-            LOG_FAILED_QUERY(oQuery);
-            return;
-        }
-    } else if (m_lstSetLogPlaylistIds.contains(playlistId)) {
+        m_crateTracks.addAutoDjReference(trackId);
+    } else if (m_lstSetLogPlaylistIds.contains(playlistId) &&
+            m_crateTracks.contains(trackId)) {
         // Deal with changes to set-log playlists.
-        // If this query doesn't succeed, it'll log a message.
-        // Do nothing special otherwise -- any change it makes can be part of
-        // any current transaction.
-        updateLastPlayedDateTimeForTrack(trackId);
+        updateLastPlayedDateTime({trackId});
     }
 }
 
@@ -1056,22 +575,11 @@ void AutoDJCratesDAO::slotPlaylistTrackRemoved(int playlistId,
                                                int /* a_iPosition */) {
     // Deal with changes to the auto-DJ playlist.
     if (playlistId == m_iAutoDjPlaylistId) {
-        QSqlQuery oQuery(m_database);
-        // UPDATE temp_autodj_crates SET autodjrefs = autodjrefs - 1 WHERE track_id = :track_id;
-        oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-            AUTODJCRATESTABLE_AUTODJREFS " = " AUTODJCRATESTABLE_AUTODJREFS
-            " - 1 WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id");
-        oQuery.bindValue(":track_id", trackId.toVariant());
-        if (!oQuery.exec()) {
-            LOG_FAILED_QUERY(oQuery);
-            return;
-        }
-    } else if (m_lstSetLogPlaylistIds.contains(playlistId)) {
+        m_crateTracks.removeAutoDjReference(trackId);
+    } else if (m_lstSetLogPlaylistIds.contains(playlistId) &&
+            m_crateTracks.contains(trackId)) {
         // Deal with changes to set-log playlists.
-        // If this query doesn't succeed, it'll log a message.
-        // Do nothing special otherwise -- any change it makes can be part of
-        // any current transaction.
-        updateLastPlayedDateTimeForTrack(trackId);
+        updateLastPlayedDateTime({trackId});
     }
 }
 
@@ -1097,17 +605,7 @@ void AutoDJCratesDAO::playerInfoTrackLoaded(const QString& group,
     for (unsigned int i = 0; i < numDecks; ++i) {
         if (group == PlayerManager::groupForDeck(i)) {
             // Update the number of auto-DJ-playlist references to this track.
-            QSqlQuery oQuery(m_database);
-            // UPDATE temp_autodj_crates SET autodjrefs = autodjrefs + 1
-            // WHERE track_id = :track_id;
-            oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-                AUTODJCRATESTABLE_AUTODJREFS " = " AUTODJCRATESTABLE_AUTODJREFS
-                " + 1 WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id");
-            oQuery.bindValue(":track_id", trackId.toVariant());
-            if (!oQuery.exec()) {
-                LOG_FAILED_QUERY(oQuery);
-                return;
-            }
+            m_crateTracks.addAutoDjReference(trackId);
             return;
         }
     }
@@ -1125,17 +623,7 @@ void AutoDJCratesDAO::playerInfoTrackUnloaded(const QString& group,
     for (unsigned int i = 0; i < numDecks; ++i) {
         if (group == PlayerManager::groupForDeck(i)) {
             // Get rid of the ID of the track in this deck.
-            QSqlQuery oQuery(m_database);
-            // UPDATE temp_autodj_crates SET autodjrefs = autodjrefs - 1
-            // WHERE track_id = :track_id;
-            oQuery.prepare("UPDATE " AUTODJCRATES_TABLE " SET "
-                AUTODJCRATESTABLE_AUTODJREFS " = " AUTODJCRATESTABLE_AUTODJREFS
-                " - 1 WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id");
-            oQuery.bindValue(":track_id", trackId.toVariant());
-            if (!oQuery.exec()) {
-                LOG_FAILED_QUERY(oQuery);
-                return;
-            }
+            m_crateTracks.removeAutoDjReference(trackId);
             return;
         }
     }
@@ -1160,7 +648,8 @@ TrackId AutoDJCratesDAO::getRandomTrackIdFromLibrary(int iPlaylistId) {
     DEBUG_ASSERT(kLeastPreferredPercent >= kLeastPreferredPercentMin);
     DEBUG_ASSERT(kLeastPreferredPercent <= kLeastPreferredPercentMax);
 
-    // getRandomTrackId() would have already created the temporary auto-DJ-crates database.
+    // Tracks are selected from the whole library, i.e. independent of the
+    // tracks of the auto-DJ crates.
     QSqlQuery oQuery(m_database);
     oQuery.prepare(" SELECT COUNT(*)"
                    " FROM library"
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QSqlDatabase>
 
+#include "library/autodj/autodjcratetracks.h"
 #include "library/trackset/crate/crateid.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -31,29 +32,20 @@ class AutoDJCratesDAO : public QObject {
     // (Isn't that normal for QObject subclasses?)
     DISALLOW_COPY_AND_ASSIGN(AutoDJCratesDAO);
 
-    // Create the temporary auto-DJ-crates database.
+    // Load the tracks of all auto-DJ crates into memory.
     // Done the first time it's used, since the user might not even make
     // use of this feature.
-    void createAndConnectAutoDjCratesDatabase();
+    void loadAndConnectAutoDjCrateTracks();
 
-    // Create the active-tracks view.
-    bool createActiveTracksView(bool a_bUseIgnoreTime);
+    // Query the tracks of the crates that match the condition, grouped
+    // by crate. Returns false if the query failed.
+    bool queryCrateTracks(
+            const QString& crateTracksCondition,
+            QHash<CrateId, QVector<AutoDJCrateTracks::TrackInfo>>* pCrateTracks);
 
-    // Update the number of auto-DJ-playlist references to each track in the
-    // auto-DJ-crates database.  Returns true if successful.
-    bool updateAutoDjPlaylistReferences();
-
-    // Update the number of auto-DJ-playlist references to the given track
-    // in the auto-DJ-crates database.  Returns true if successful.
-    bool updateAutoDjPlaylistReferencesForTrack(TrackId trackId);
-
-    // Update the last-played date/time for each track in the
-    // auto-DJ-crates database.  Returns true if successful.
-    bool updateLastPlayedDateTime();
-
-    // Update the last-played date/time for the given track in the
-    // auto-DJ-crates database.  Returns true if successful.
-    bool updateLastPlayedDateTimeForTrack(TrackId trackId);
+    // Update the last-played date/time of the given tracks or of all
+    // tracks if the list is empty.  Returns true if successful.
+    bool updateLastPlayedDateTime(const QList<TrackId>& trackIds = {});
 
     // Calculates a random Track from AutoDJ,
     // This is used when all active tracks are already queued up.
@@ -110,8 +102,11 @@ class AutoDJCratesDAO : public QObject {
     // The source of our configuration.
     UserSettingsPointer m_pConfig;
 
-    // True if the auto-DJ-crates database has been created.
-    bool m_bAutoDjCratesDbCreated;
+    // The tracks of all auto-DJ crates.
+    AutoDJCrateTracks m_crateTracks;
+
+    // True if the tracks of the auto-DJ crates have been loaded.
+    bool m_bAutoDjCrateTracksLoaded;
 
     // True if active tracks can be tracks that haven't been played in
     // a while.
@@ -0,0 +1,198 @@
+#include "library/dao/browsemetadatadao.h"
+
+#include <QSqlQuery>
+
+#include "library/queryutil.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("BrowseMetadataDAO");
+
+// The columns with the metadata, in the same order for both the library
+// and the cache
+const QString kMetadataColumns = QStringLiteral(
+        "artist,title,album,album_artist,year,genre,composer,grouping,"
+        "tracknumber,comment,duration,bpm,key,bitrate,replaygain");
+
+constexpr int kFirstMetadataColumn = 3;
+
+mixxx::TrackMetadata readTrackMetadata(const QSqlQuery& query) {
+    int column = kFirstMetadataColumn;
+    mixxx::TrackMetadata trackMetadata;
+    mixxx::TrackInfo& trackInfo = trackMetadata.refTrackInfo();
+    trackInfo.setArtist(query.value(column++).toString());
+    trackInfo.setTitle(query.value(column++).toString());
+    trackMetadata.refAlbumInfo().setTitle(query.value(column++).toString());
+    trackMetadata.refAlbumInfo().setArtist(query.value(column++).toString());
+    trackInfo.setYear(query.value(column++).toString());
+    trackInfo.setGenre(query.value(column++).toString());
+    trackInfo.setComposer(query.value(column++).toString());
+    trackInfo.setGrouping(query.value(column++).toString());
+    trackInfo.setTrackNumber(query.value(column++).toString());
+    trackInfo.setComment(query.value(column++).toString());
+    trackMetadata.refStreamInfo().setDuration(
+            mixxx::Duration::fromSeconds(query.value(column++).toDouble()));
+    trackInfo.setBpm(mixxx::Bpm(query.value(column++).toDouble()));
+    trackInfo.setKey(query.value(column++).toString());
+    trackMetadata.refStreamInfo().setBitrate(
+            mixxx::audio::Bitrate(query.value(column++).toInt()));
+    mixxx::ReplayGain replayGain;
+    replayGain.setRatio(query.value(column++).toDouble());
+    trackInfo.setReplayGain(replayGain);
+    return trackMetadata;
+}
+
+QDateTime fileModifiedAt(const mixxx::FileInfo& fileInfo) {
+    const QDateTime lastModifiedUtc = fileInfo.lastModified().toUTC();
+    // Ignore bogus values like 1970-01-01T00:00:00.000 UTC, like
+    // MetadataSource::getFileSynchronizedAt()
+    if (lastModifiedUtc.isValid() && lastModifiedUtc.toMSecsSinceEpoch() == 0) {
+        return QDateTime();
+    }
+    return lastModifiedUtc;
+}
+
+} // anonymous namespace
+
+bool BrowseMetadataDAO::Entry::isValid(const mixxx::FileInfo& fileInfo) const {
+    if (fileInfo.sizeInBytes() != sizeInBytes) {
+        return false;
+    }
+    const QDateTime modifiedAt = fileModifiedAt(fileInfo);
+    if (fromLibrary) {
+        // Only metadata that has been imported from the current
+        // version of the file is reused
+        return !(modifiedAt > synchronizedAt);
+    }
+    return modifiedAt == synchronizedAt;
+}
+
+QHash<QString, BrowseMetadataDAO::Entry> BrowseMetadataDAO::loadDirectory(
+        const QString& directory) const {
+    QHash<QString, Entry> entries;
+    loadCachedDirectory(directory, &entries);
+    // Overwrites the cached entries
+    loadLibraryDirectory(directory, &entries);
+    return entries;
+}
+
+void BrowseMetadataDAO::loadLibraryDirectory(
+        const QString& directory, QHash<QString, Entry>* pEntries) const {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral(
+            "SELECT track_locations.location,track_locations.filesize,"
+            "library.source_synchronized_ms,%1 "
+            "FROM library INNER JOIN track_locations "
+            "ON library.location=track_locations.id "
+            "WHERE track_locations.directory=:directory "
+            "AND library.source_synchronized_ms IS NOT NULL")
+                          .arg(kMetadataColumns));
+    query.bindValue(":directory", directory);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    while (query.next()) {
+        Entry entry;
+        entry.sizeInBytes = query.value(1).toLongLong();
+        entry.synchronizedAt = QDateTime::fromMSecsSinceEpoch(
+                query.value(2).toLongLong(), Qt::UTC);
+        entry.fromLibrary = true;
+        entry.trackMetadata = readTrackMetadata(query);
+        pEntries->insert(query.value(0).toString(), entry);
+    }
+}
+
+void BrowseMetadataDAO::loadCachedDirectory(
+        const QString& directory, QHash<QString, Entry>* pEntries) const {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral(
+            "SELECT location,filesize,file_modified_ms,%1 "
+            "FROM browse_metadata WHERE directory=:directory")
+                          .arg(kMetadataColumns));
+    query.bindValue(":directory", directory);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    while (query.next()) {
+        Entry entry;
+        entry.sizeInBytes = query.value(1).toLongLong();
+        if (!query.value(2).isNull()) {
+            entry.synchronizedAt = QDateTime::fromMSecsSinceEpoch(
+                    query.value(2).toLongLong(), Qt::UTC);
+        }
+        entry.trackMetadata = readTrackMetadata(query);
+        pEntries->insert(query.value(0).toString(), entry);
+    }
+}
+
+bool BrowseMetadataDAO::saveMetadata(const mixxx::FileInfo& fileInfo,
+        const mixxx::TrackMetadata& trackMetadata) {
+    QSqlQuery query(m_database);
+    // Replacing the row assigns a new row id, so the entries that have
+    // been read from the files the longest time ago are removed first by
+    // cleanUp()
+    query.prepare(QStringLiteral(
+            "INSERT OR REPLACE INTO browse_metadata "
+            "(location,directory,filesize,file_modified_ms,%1) VALUES "
+            "(:location,:directory,:filesize,:file_modified_ms,"
+            ":artist,:title,:album,:album_artist,:year,:genre,:composer,"
+            ":grouping,:tracknumber,:comment,:duration,:bpm,:key,:bitrate,"
+            ":replaygain)")
+                          .arg(kMetadataColumns));
+    const mixxx::TrackInfo& trackInfo = trackMetadata.getTrackInfo();
+    const QDateTime modifiedAt = fileModifiedAt(fileInfo);
+    query.bindValue(":location", fileInfo.location());
+    query.bindValue(":directory", fileInfo.locationPath());
+    query.bindValue(":filesize", fileInfo.sizeInBytes());
+    query.bindValue(":file_modified_ms",
+            modifiedAt.isValid() ? QVariant(modifiedAt.toMSecsSinceEpoch()) : QVariant());
+    query.bindValue(":artist", trackInfo.getArtist());
+    query.bindValue(":title", trackInfo.getTitle());
+    query.bindValue(":album", trackMetadata.getAlbumInfo().getTitle());
+    query.bindValue(":album_artist", trackMetadata.getAlbumInfo().getArtist());
+    query.bindValue(":year", trackInfo.getYear());
+    query.bindValue(":genre", trackInfo.getGenre());
+    query.bindValue(":composer", trackInfo.getComposer());
+    query.bindValue(":grouping", trackInfo.getGrouping());
+    query.bindValue(":tracknumber", trackInfo.getTrackNumber());
+    query.bindValue(":comment", trackInfo.getComment());
+    query.bindValue(":duration",
+            trackMetadata.getStreamInfo().getDuration().toDoubleSeconds());
+    const mixxx::Bpm bpm = trackInfo.getBpm();
+    query.bindValue(":bpm", bpm.isValid() ? bpm.value() : mixxx::Bpm::kValueUndefined);
+    query.bindValue(":key", trackInfo.getKey());
+    query.bindValue(":bitrate",
+            static_cast<int>(trackMetadata.getStreamInfo().getBitrate().value()));
+    query.bindValue(":replaygain", trackInfo.getReplayGain().getRatio());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+void BrowseMetadataDAO::cleanUp(int maxEntries) {
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral(
+                "DELETE FROM browse_metadata WHERE location IN "
+                "(SELECT location FROM track_locations WHERE fs_deleted=0)"))) {
+        LOG_FAILED_QUERY(query);
+    }
+    const int numLibraryTracks = query.numRowsAffected();
+    query.prepare(QStringLiteral(
+            "DELETE FROM browse_metadata WHERE rowid NOT IN "
+            "(SELECT rowid FROM browse_metadata ORDER BY rowid DESC "
+            "LIMIT :max_entries)"));
+    query.bindValue(":max_entries", maxEntries);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    kLogger.debug()
+            << "Removed" << numLibraryTracks << "library tracks and"
+            << query.numRowsAffected() << "old entries";
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "library/dao/dao.h"
+#include "track/trackmetadata.h"
+#include "util/fileinfo.h"
+
+/// Persistently caches the metadata of files that have been shown in the
+/// Browse view, but that are not in the library.
+///
+/// The metadata of tracks in the library is read from the library tables,
+/// which are kept up to date by the LibraryScanner. The LibraryScanner also
+/// removes the cached metadata of files once they have been added to the
+/// library and limits the number of cached files.
+///
+/// The entries are loaded per directory without accessing the files. The
+/// caller must validate them against the files with isValid().
+class BrowseMetadataDAO : public DAO {
+  public:
+    struct Entry {
+        qint64 sizeInBytes = 0;
+        /// Browse cache: The modification time of the file when the
+        /// metadata was read.
+        /// Library: The time when the metadata was synchronized with the
+        /// file, which might be later than the modification time.
+        QDateTime synchronizedAt;
+        bool fromLibrary = false;
+        mixxx::TrackMetadata trackMetadata;
+
+        /// Checks that the file has not been modified since the metadata
+        /// was read. Uses the size and modification time of fileInfo, i.e.
+        /// it needs to be refreshed by the caller.
+        bool isValid(const mixxx::FileInfo& fileInfo) const;
+    };
+
+    ~BrowseMetadataDAO() override = default;
+
+    /// Loads the metadata of all files in the directory, both from the
+    /// library and from the cache. Library entries take precedence.
+    QHash<QString, Entry> loadDirectory(const QString& directory) const;
+
+    /// Stores the metadata of files. Wrap the calls in a transaction.
+    bool saveMetadata(const mixxx::FileInfo& fileInfo,
+            const mixxx::TrackMetadata& trackMetadata);
+
+    /// Removes the metadata of files that are in the library now, and the
+    /// oldest entries if more than maxEntries files are cached.
+    void cleanUp(int maxEntries);
+
+  private:
+    void loadLibraryDirectory(const QString& directory, QHash<QString, Entry>* pEntries) const;
+    void loadCachedDirectory(const QString& directory, QHash<QString, Entry>* pEntries) const;
+};
@@ -9,6 +9,7 @@
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/color/rgbcolor.h"
+#include "util/db/dbconnection.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
 #include "util/performancetimer.h"
@@ -61,47 +62,90 @@ CuePointer cueFromRow(const QSqlRecord& row) {
     return pCue;
 }
 
+/// Appends a cue that has been loaded from the database and drops
+/// a previously loaded hot cue with the same number.
+void appendCue(QList<CuePointer>* pCues, CuePointer pCue) {
+    const int hotCueNumber = pCue->getHotCue();
+    if (hotCueNumber != Cue::kNoHotCue) {
+        for (auto it = pCues->begin(); it != pCues->end(); ++it) {
+            if ((*it)->getHotCue() == hotCueNumber) {
+                kLogger.warning()
+                        << "Dropping hot cue"
+                        << (*it)->getId()
+                        << "with duplicate number"
+                        << hotCueNumber;
+                pCues->erase(it);
+                break;
+            }
+        }
+    }
+    pCues->append(std::move(pCue));
+}
+
 } // namespace
 
 QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
     //qDebug() << "CueDAO::getCuesForTrack" << QThread::currentThread() << m_database.connectionName();
     QList<CuePointer> cues;
 
-    FwdSqlQuery query(
+    // This query is executed for every track that is loaded
+    auto query = mixxx::DbConnection::cachedQuery(
             m_database,
             QStringLiteral("SELECT * FROM " CUE_TABLE " WHERE track_id=:id"));
     DEBUG_ASSERT(
-            query.isPrepared() &&
-            !query.hasError());
-    query.bindValue(":id", trackId.toVariant());
-    VERIFY_OR_DEBUG_ASSERT(query.execPrepared()) {
+            query->isPrepared() &&
+            !query->hasError());
+    query->bindValue(":id", trackId.toVariant());
+    VERIFY_OR_DEBUG_ASSERT(query->execPrepared()) {
         kLogger.warning()
                 << "Failed to load cues of track"
                 << trackId;
         return cues;
     }
-    QMap<int, CuePointer> hotCuesByNumber;
+    while (query->next()) {
+        CuePointer pCue = cueFromRow(query->record());
+        VERIFY_OR_DEBUG_ASSERT(pCue) {
+            continue;
+        }
+        appendCue(&cues, std::move(pCue));
+    }
+    return cues;
+}
+
+QHash<TrackId, QList<CuePointer>> CueDAO::getCuesForTracks(
+        const QList<TrackId>& trackIds) const {
+    QHash<TrackId, QList<CuePointer>> cuesByTrackId;
+    if (trackIds.isEmpty()) {
+        return cuesByTrackId;
+    }
+
+    QStringList idList;
+    idList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
+
+    FwdSqlQuery query(
+            m_database,
+            QStringLiteral("SELECT * FROM " CUE_TABLE " WHERE track_id IN (%1)")
+                    .arg(idList.join(QChar(','))));
+    VERIFY_OR_DEBUG_ASSERT(query.execPrepared()) {
+        kLogger.warning()
+                << "Failed to load cues of"
+                << trackIds.size()
+                << "tracks";
+        return cuesByTrackId;
+    }
+    const DbFieldIndex trackIdIndex = query.fieldIndex(QStringLiteral("track_id"));
     while (query.next()) {
         CuePointer pCue = cueFromRow(query.record());
         VERIFY_OR_DEBUG_ASSERT(pCue) {
             continue;
         }
-        int hotCueNumber = pCue->getHotCue();
-        if (hotCueNumber != Cue::kNoHotCue) {
-            const auto pDuplicateCue = hotCuesByNumber.take(hotCueNumber);
-            if (pDuplicateCue) {
-                kLogger.warning()
-                        << "Dropping hot cue"
-                        << pDuplicateCue->getId()
-                        << "with duplicate number"
-                        << hotCueNumber;
-                cues.removeOne(pDuplicateCue);
-            }
-            hotCuesByNumber.insert(hotCueNumber, pCue);
-        }
-        cues.push_back(pCue);
+        const TrackId trackId(query.fieldValue(trackIdIndex));
+        appendCue(&cuesByTrackId[trackId], std::move(pCue));
     }
-    return cues;
+    return cuesByTrackId;
 }
 
 bool CueDAO::deleteCuesForTrack(TrackId trackId) const {
@@ -0,0 +1,204 @@
+#include "library/dao/fingerprintdao.h"
+
+#include <QSqlQuery>
+#include <QStringList>
+#include <algorithm>
+
+#include "library/queryutil.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("FingerprintDAO");
+
+// Keys that are shared by too many tracks do not help to find duplicates
+constexpr int kMaxTracksPerKey = 1000;
+
+// The number of keys that a candidate must share with the sketch
+constexpr int kMinSharedKeys = 2;
+
+// The number of candidates that are verified, those with the most shared
+// keys first
+constexpr int kMaxCandidates = 100;
+
+// Re-encoded audio usually has a similarity above 0.9, unrelated audio
+// has a similarity of about 0.5
+constexpr double kMinSimilarity = 0.8;
+
+} // anonymous namespace
+
+bool FingerprintDAO::hasFingerprint(TrackId trackId) const {
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT 1 FROM track_fingerprints WHERE track_id=:track_id"));
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return query.next();
+}
+
+mixxx::AudioFingerprint FingerprintDAO::getFingerprint(TrackId trackId) const {
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT fingerprint FROM track_fingerprints WHERE track_id=:track_id"));
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return mixxx::AudioFingerprint();
+    }
+    if (!query.next()) {
+        return mixxx::AudioFingerprint();
+    }
+    return mixxx::AudioFingerprint(
+            mixxx::AudioFingerprint::deserialize(query.value(0).toByteArray()));
+}
+
+bool FingerprintDAO::saveFingerprint(
+        TrackId trackId, const mixxx::AudioFingerprint& fingerprint) {
+    // Replacing the row assigns a new row id, so that the sketch is
+    // indexed again by updateIndex()
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "INSERT OR REPLACE INTO track_fingerprints "
+            "(track_id, fingerprint, sketch) "
+            "VALUES (:track_id, :fingerprint, :sketch)"));
+    query.bindValue(":track_id", trackId.toVariant());
+    query.bindValue(":fingerprint",
+            mixxx::AudioFingerprint::serialize(fingerprint.items()));
+    query.bindValue(":sketch",
+            mixxx::AudioFingerprint::serialize(fingerprint.sketch()));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+void FingerprintDAO::deleteFingerprints(const QList<TrackId>& trackIds) {
+    QStringList idList;
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral("DELETE FROM track_fingerprints "
+                                 "WHERE track_id in (%1)")
+                          .arg(idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't delete fingerprints";
+        return;
+    }
+    for (const auto& trackId : trackIds) {
+        removeFromIndex(trackId);
+    }
+}
+
+void FingerprintDAO::removeFromIndex(TrackId trackId) {
+    const QVector<uint32_t> sketch = m_indexedSketches.take(trackId);
+    for (const auto key : sketch) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            continue;
+        }
+        it.value().removeAll(trackId);
+        if (it.value().isEmpty()) {
+            m_index.erase(it);
+        }
+    }
+}
+
+void FingerprintDAO::updateIndex() {
+    PerformanceTimer timer;
+    timer.start();
+
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral(
+            "SELECT id, track_id, sketch FROM track_fingerprints "
+            "WHERE id>:last_id ORDER BY id"));
+    query.bindValue(":last_id", m_lastIndexedRowId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    int numIndexed = 0;
+    while (query.next()) {
+        m_lastIndexedRowId = query.value(0).toLongLong();
+        const TrackId trackId(query.value(1));
+        const QVector<uint32_t> sketch =
+                mixxx::AudioFingerprint::deserialize(query.value(2).toByteArray());
+        // The fingerprint of the track has been replaced
+        removeFromIndex(trackId);
+        for (const auto key : sketch) {
+            m_index[key].append(trackId);
+        }
+        m_indexedSketches.insert(trackId, sketch);
+        ++numIndexed;
+    }
+    if (numIndexed > 0) {
+        kLogger.debug()
+                << "Indexed" << numIndexed << "fingerprints in"
+                << timer.elapsed().debugMillisWithUnit();
+    }
+}
+
+QList<TrackId> FingerprintDAO::findDuplicates(TrackId trackId) {
+    const mixxx::AudioFingerprint fingerprint = getFingerprint(trackId);
+    if (fingerprint.isEmpty()) {
+        return QList<TrackId>();
+    }
+    updateIndex();
+
+    QHash<TrackId, int> sharedKeysByTrackId;
+    for (const auto key : fingerprint.sketch()) {
+        const auto it = m_index.constFind(key);
+        if (it == m_index.constEnd() || it.value().size() > kMaxTracksPerKey) {
+            continue;
+        }
+        for (const auto& candidateId : it.value()) {
+            if (candidateId != trackId) {
+                ++sharedKeysByTrackId[candidateId];
+            }
+        }
+    }
+
+    QVector<QPair<int, TrackId>> candidates;
+    for (auto it = sharedKeysByTrackId.constBegin();
+            it != sharedKeysByTrackId.constEnd();
+            ++it) {
+        if (it.value() >= kMinSharedKeys) {
+            candidates.append(qMakePair(it.value(), it.key()));
+        }
+    }
+    std::sort(candidates.begin(),
+            candidates.end(),
+            [](const QPair<int, TrackId>& lhs, const QPair<int, TrackId>& rhs) {
+                return lhs.first > rhs.first;
+            });
+    if (candidates.size() > kMaxCandidates) {
+        candidates.resize(kMaxCandidates);
+    }
+
+    QVector<QPair<double, TrackId>> duplicates;
+    for (const auto& candidate : qAsConst(candidates)) {
+        const double similarity =
+                fingerprint.similarity(getFingerprint(candidate.second));
+        if (similarity >= kMinSimilarity) {
+            duplicates.append(qMakePair(similarity, candidate.second));
+        }
+    }
+    std::sort(duplicates.begin(),
+            duplicates.end(),
+            [](const QPair<double, TrackId>& lhs, const QPair<double, TrackId>& rhs) {
+                return lhs.first > rhs.first;
+            });
+
+    QList<TrackId> trackIds;
+    trackIds.reserve(duplicates.size());
+    for (const auto& duplicate : qAsConst(duplicates)) {
+        trackIds.append(duplicate.second);
+    }
+    return trackIds;
+}
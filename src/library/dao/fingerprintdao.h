@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+#include "library/dao/dao.h"
+#include "track/audiofingerprint.h"
+#include "track/trackid.h"
+
+/// Stores the audio fingerprints of tracks, see AnalyzerFingerprint.
+///
+/// Duplicates are found by looking up the sketch of a fingerprint in an
+/// index that is kept in memory and only contains the sketches. The few
+/// candidates are then verified by comparing the full fingerprints.
+class FingerprintDAO : public DAO {
+  public:
+    ~FingerprintDAO() override = default;
+
+    bool hasFingerprint(TrackId trackId) const;
+    mixxx::AudioFingerprint getFingerprint(TrackId trackId) const;
+    bool saveFingerprint(TrackId trackId, const mixxx::AudioFingerprint& fingerprint);
+    void deleteFingerprints(const QList<TrackId>& trackIds);
+
+    /// Returns the tracks that contain the same recording as the given
+    /// track, the most similar first.
+    QList<TrackId> findDuplicates(TrackId trackId);
+
+  private:
+    /// Adds the sketches of all fingerprints to the index that have been
+    /// stored since the last update, including those that have been stored
+    /// by the analyzers with other database connections. The keys of a
+    /// replaced fingerprint are removed from the index.
+    void updateIndex();
+
+    void removeFromIndex(TrackId trackId);
+
+    QHash<uint32_t, QVector<TrackId>> m_index;
+    // The keys of each track in m_index
+    QHash<TrackId, QVector<uint32_t>> m_indexedSketches;
+    qint64 m_lastIndexedRowId = 0;
+};
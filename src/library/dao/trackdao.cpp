@@ -18,9 +18,12 @@
 #include "library/dao/cuedao.h"
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
+#include "library/dao/settingsdao.h"
 #include "library/dao/trackschema.h"
+#include "library/dao/tracksnapshot.h"
 #include "library/library_prefs.h"
 #include "library/queryutil.h"
+#include "library/tracksavequeue.h"
 #include "library/trackset/crate/cratestorage.h"
 #include "moc_trackdao.cpp"
 #include "sources/soundsourceproxy.h"
@@ -32,6 +35,7 @@
 #include "track/tracknumbers.h"
 #include "util/assert.h"
 #include "util/datetime.h"
+#include "util/db/dbconnection.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/db/sqlite.h"
 #include "util/db/sqlstringformatter.h"
@@ -39,6 +43,7 @@
 #include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/performancetimer.h"
 #include "util/qt.h"
 #include "util/timer.h"
 
@@ -48,6 +53,9 @@ mixxx::Logger kLogger("TrackDAO");
 
 enum { UndefinedRecordIndex = -2 };
 
+const QString kSortKeysVersionSettingName =
+        QStringLiteral("mixxx.db.library.sortkeys_version");
+
 void markTrackLocationsAsDeleted(const QSqlDatabase& database, const QString& directory) {
     //qDebug() << "TrackDAO::markTrackLocationsAsDeleted" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(database);
@@ -92,7 +100,8 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
           m_pConfig(pConfig),
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
-          m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex) {
+          m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex),
+          m_pTrackSaveQueue(nullptr) {
     connect(&m_playlistDao,
             &PlaylistDAO::tracksRemovedFromPlayedHistory,
             this,
@@ -354,6 +363,13 @@ void TrackDAO::slotDatabaseTracksRelocated(const QList<RelocatedTrack>& relocate
     }
 }
 
+void TrackDAO::slotDatabaseTracksSaved(const QList<TrackId>& savedTrackIds) {
+    // Evicted tracks have been saved asynchronously
+    for (const auto& trackId : savedTrackIds) {
+        emit trackClean(trackId);
+    }
+}
+
 void TrackDAO::addTracksPrepare() {
     if (m_pQueryLibraryInsert || m_pQueryTrackLocationInsert ||
             m_pQueryLibrarySelect || m_pQueryTrackLocationSelect ||
@@ -430,6 +446,14 @@ void TrackDAO::addTracksPrepare() {
             "coverart_color,"
             "coverart_digest,"
             "coverart_hash,"
+            "artist_sortkey,"
+            "title_sortkey,"
+            "album_sortkey,"
+            "album_artist_sortkey,"
+            "genre_sortkey,"
+            "composer_sortkey,"
+            "grouping_sortkey,"
+            "comment_sortkey,"
             "datetime_added"
             ") VALUES ("
             ":artist,"
@@ -478,6 +502,14 @@ void TrackDAO::addTracksPrepare() {
             ":coverart_color,"
             ":coverart_digest,"
             ":coverart_hash,"
+            ":artist_sortkey,"
+            ":title_sortkey,"
+            ":album_sortkey,"
+            ":album_artist_sortkey,"
+            ":genre_sortkey,"
+            ":composer_sortkey,"
+            ":grouping_sortkey,"
+            ":comment_sortkey,"
             ":datetime_added"
             ")");
 
@@ -528,11 +560,34 @@ bool insertTrackLocation(
     }
 }
 
+// Bind the collation sort keys of the text columns
+void bindTrackLibrarySortKeys(
+        QSqlQuery* pTrackLibraryQuery,
+        const mixxx::CollationSortKeyGenerator& sortKeyGenerator,
+        const QString& artist,
+        const QString& title,
+        const QString& album,
+        const QString& albumArtist,
+        const QString& genre,
+        const QString& composer,
+        const QString& grouping,
+        const QString& comment) {
+    pTrackLibraryQuery->bindValue(":artist_sortkey", sortKeyGenerator.sortKey(artist));
+    pTrackLibraryQuery->bindValue(":title_sortkey", sortKeyGenerator.sortKey(title));
+    pTrackLibraryQuery->bindValue(":album_sortkey", sortKeyGenerator.sortKey(album));
+    pTrackLibraryQuery->bindValue(":album_artist_sortkey", sortKeyGenerator.sortKey(albumArtist));
+    pTrackLibraryQuery->bindValue(":genre_sortkey", sortKeyGenerator.sortKey(genre));
+    pTrackLibraryQuery->bindValue(":composer_sortkey", sortKeyGenerator.sortKey(composer));
+    pTrackLibraryQuery->bindValue(":grouping_sortkey", sortKeyGenerator.sortKey(grouping));
+    pTrackLibraryQuery->bindValue(":comment_sortkey", sortKeyGenerator.sortKey(comment));
+}
+
 // Bind common values for insert/update
 void bindTrackLibraryValues(
         QSqlQuery* pTrackLibraryQuery,
         const mixxx::TrackRecord& track,
-        const mixxx::BeatsPointer& pBeats) {
+        const mixxx::BeatsPointer& pBeats,
+        const mixxx::CollationSortKeyGenerator& sortKeyGenerator) {
     const mixxx::TrackMetadata& trackMetadata = track.getMetadata();
     const mixxx::TrackInfo& trackInfo = trackMetadata.getTrackInfo();
     const mixxx::AlbumInfo& albumInfo = trackMetadata.getAlbumInfo();
@@ -557,6 +612,17 @@ void bindTrackLibraryValues(
     pTrackLibraryQuery->bindValue(":bpm_lock", track.getBpmLocked() ? 1 : 0);
     pTrackLibraryQuery->bindValue(":replaygain", trackInfo.getReplayGain().getRatio());
     pTrackLibraryQuery->bindValue(":replaygain_peak", trackInfo.getReplayGain().getPeak());
+    bindTrackLibrarySortKeys(
+            pTrackLibraryQuery,
+            sortKeyGenerator,
+            trackInfo.getArtist(),
+            trackInfo.getTitle(),
+            albumInfo.getTitle(),
+            albumInfo.getArtist(),
+            trackInfo.getGenre(),
+            trackInfo.getComposer(),
+            trackInfo.getGrouping(),
+            trackInfo.getComment());
 
     pTrackLibraryQuery->bindValue(":channels",
             static_cast<uint>(trackMetadata.getStreamInfo().getSignalInfo().getChannelCount()));
@@ -638,10 +704,11 @@ bool insertTrackLibrary(
         QSqlQuery* pTrackLibraryInsert,
         const mixxx::TrackRecord& trackRecord,
         const mixxx::BeatsPointer& pBeats,
+        const mixxx::CollationSortKeyGenerator& sortKeyGenerator,
         DbId trackLocationId,
         const mixxx::FileInfo& fileInfo,
         const QDateTime& trackDateAdded) {
-    bindTrackLibraryValues(pTrackLibraryInsert, trackRecord, pBeats);
+    bindTrackLibraryValues(pTrackLibraryInsert, trackRecord, pBeats, sortKeyGenerator);
 
     if (!trackRecord.getDateAdded().isNull()) {
         qDebug() << "insertTrackLibrary: Track"
@@ -788,6 +855,7 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
                     m_pQueryLibraryInsert.get(),
                     trackRecord,
                     pTrack->getBeats(),
+                    m_sortKeyGenerator,
                     trackLocationId,
                     fileAccess.info(),
                     trackDateAdded)) {
@@ -1323,6 +1391,86 @@ struct ColumnPopulator {
     TrackPopulatorFn populator;
 };
 
+constexpr ColumnPopulator kTrackColumns[] = {
+        // Location must be first and is populated manually!
+        {"track_locations.location", nullptr},
+        {"artist", setTrackArtist},
+        {"title", setTrackTitle},
+        {"album", setTrackAlbum},
+        {"album_artist", setTrackAlbumArtist},
+        {"year", setTrackYear},
+        {"genre", setTrackGenre},
+        {"composer", setTrackComposer},
+        {"grouping", setTrackGrouping},
+        {"tracknumber", setTrackNumber},
+        {"tracktotal", setTrackTotal},
+        {"filetype", setTrackFiletype},
+        {"rating", setTrackRating},
+        {"color", setTrackColor},
+        {"comment", setTrackComment},
+        {"url", setTrackUrl},
+        {"cuepoint", setTrackCuePoint},
+        {"replaygain", setTrackReplayGainRatio},
+        {"replaygain_peak", setTrackReplayGainPeak},
+        {"timesplayed", setTrackTimesPlayed},
+        {"last_played_at", setTrackLastPlayedAt},
+        {"played", setTrackPlayed},
+        {"datetime_added", setTrackDateAdded},
+        {"header_parsed", setTrackHeaderParsed},
+        {"source_synchronized_ms", setTrackSourceSynchronizedAt},
+
+        // Audio properties are set together at once. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"channels", setTrackAudioProperties},
+        {"samplerate", nullptr},
+        {"bitrate", nullptr},
+        {"duration", nullptr},
+
+        // Beat detection columns are handled by setTrackBeats. Do not change
+        // the ordering of these columns or put other columns in between them!
+        {"bpm", setTrackBeats},
+        {"beats_version", nullptr},
+        {"beats_sub_version", nullptr},
+        {"beats", nullptr},
+        {"bpm_lock", nullptr},
+
+        // Beat detection columns are handled by setTrackKey. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"key", setTrackKey},
+        {"keys_version", nullptr},
+        {"keys_sub_version", nullptr},
+        {"keys", nullptr},
+
+        // Cover art columns are handled by setTrackCoverInfo. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"coverart_source", setTrackCoverInfo},
+        {"coverart_type", nullptr},
+        {"coverart_location", nullptr},
+        {"coverart_color", nullptr},
+        {"coverart_digest", nullptr},
+        {"coverart_hash", nullptr},
+
+        // The id is only needed for mapping the results of batched queries
+        // and must be last.
+        {"library.id", nullptr},
+};
+constexpr int kTrackColumnsCount = std::size(kTrackColumns);
+
+// The number of tracks that are loaded by a single batched query
+constexpr int kMaxTrackIdsPerQuery = 500;
+
+const QString& trackColumnsString() {
+    static const QString columnsStr = [] {
+        QStringList columnNames;
+        columnNames.reserve(kTrackColumnsCount);
+        for (const auto& column : kTrackColumns) {
+            columnNames.append(QString::fromLatin1(column.name));
+        }
+        return columnNames.join(QChar(','));
+    }();
+    return columnsStr;
+}
+
 }  // namespace
 
 TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
@@ -1336,66 +1484,16 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return pTrack;
     }
 
-    constexpr ColumnPopulator columns[] = {
-            // Location must be first and is populated manually!
-            {"track_locations.location", nullptr},
-            {"artist", setTrackArtist},
-            {"title", setTrackTitle},
-            {"album", setTrackAlbum},
-            {"album_artist", setTrackAlbumArtist},
-            {"year", setTrackYear},
-            {"genre", setTrackGenre},
-            {"composer", setTrackComposer},
-            {"grouping", setTrackGrouping},
-            {"tracknumber", setTrackNumber},
-            {"tracktotal", setTrackTotal},
-            {"filetype", setTrackFiletype},
-            {"rating", setTrackRating},
-            {"color", setTrackColor},
-            {"comment", setTrackComment},
-            {"url", setTrackUrl},
-            {"cuepoint", setTrackCuePoint},
-            {"replaygain", setTrackReplayGainRatio},
-            {"replaygain_peak", setTrackReplayGainPeak},
-            {"timesplayed", setTrackTimesPlayed},
-            {"last_played_at", setTrackLastPlayedAt},
-            {"played", setTrackPlayed},
-            {"datetime_added", setTrackDateAdded},
-            {"header_parsed", setTrackHeaderParsed},
-            {"source_synchronized_ms", setTrackSourceSynchronizedAt},
-
-            // Audio properties are set together at once. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"channels", setTrackAudioProperties},
-            {"samplerate", nullptr},
-            {"bitrate", nullptr},
-            {"duration", nullptr},
-
-            // Beat detection columns are handled by setTrackBeats. Do not change
-            // the ordering of these columns or put other columns in between them!
-            {"bpm", setTrackBeats},
-            {"beats_version", nullptr},
-            {"beats_sub_version", nullptr},
-            {"beats", nullptr},
-            {"bpm_lock", nullptr},
-
-            // Beat detection columns are handled by setTrackKey. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"key", setTrackKey},
-            {"keys_version", nullptr},
-            {"keys_sub_version", nullptr},
-            {"keys", nullptr},
-
-            // Cover art columns are handled by setTrackCoverInfo. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"coverart_source", setTrackCoverInfo},
-            {"coverart_type", nullptr},
-            {"coverart_location", nullptr},
-            {"coverart_color", nullptr},
-            {"coverart_digest", nullptr},
-            {"coverart_hash", nullptr},
-    };
-    constexpr int columnsCount = std::size(columns);
+    if (m_pTrackSaveQueue) {
+        // The modifications of a recently evicted track might not have
+        // been saved yet and must be saved before loading it again.
+        auto pendingSnapshot = m_pTrackSaveQueue->takePendingSnapshot(trackId);
+        if (pendingSnapshot &&
+                !updateTracks({std::move(*pendingSnapshot)}).isEmpty()) {
+            emit mixxx::thisAsNonConst(this)->trackClean(trackId);
+        }
+    }
+
 
     // Accessing the database is a time consuming operation that should not
     // be executed with a lock on the GlobalTrackCache. The GlobalTrackCache
@@ -1405,40 +1503,139 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
 
     QSqlRecord queryRecord;
     {
-        QString columnsStr;
-        int columnsSize = 0;
-        for (int i = 0; i < columnsCount; ++i) {
-            columnsSize += qstrlen(columns[i].name) + 1;
-        }
-        columnsStr.reserve(columnsSize);
-        for (int i = 0; i < columnsCount; ++i) {
-            if (i > 0) {
-                columnsStr.append(QChar(','));
-            }
-            columnsStr.append(columns[i].name);
-        }
-
-        QSqlQuery query(m_database);
-        query.prepare(QString(
-                "SELECT %1 FROM Library "
-                "INNER JOIN track_locations ON library.location = track_locations.id "
-                "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
-        VERIFY_OR_DEBUG_ASSERT(query.exec()) {
-            LOG_FAILED_QUERY(query)
-                    << QString("getTrack(%1)").arg(trackId.toString());
+        // This query is executed for every track that is loaded
+        auto query = mixxx::DbConnection::cachedQuery(m_database,
+                QStringLiteral(
+                        "SELECT %1 FROM Library "
+                        "INNER JOIN track_locations ON library.location = track_locations.id "
+                        "WHERE library.id=:id")
+                        .arg(trackColumnsString()));
+        query->bindValue(":id", trackId.toVariant());
+        VERIFY_OR_DEBUG_ASSERT(query->execPrepared()) {
+            kLogger.warning()
+                    << "Failed to load track"
+                    << trackId;
             return nullptr;
         }
 
-        if (!query.next()) {
+        if (!query->next()) {
             qDebug() << "Track with id =" << trackId << "not found";
             return nullptr;
         }
-        queryRecord = query.record();
+        queryRecord = query->record();
         // Only a single record is expected
-        DEBUG_ASSERT(!query.next());
+        DEBUG_ASSERT(!query->next());
+    }
+
+    return loadTrackFromRecord(trackId,
+            queryRecord,
+            [this, trackId] {
+                return m_cueDao.getCuesForTrack(trackId);
+            });
+}
+
+QList<TrackPointer> TrackDAO::getTracksByIds(const QList<TrackId>& trackIds) const {
+    QHash<TrackId, TrackPointer> tracksById;
+    QList<TrackId> uncachedTrackIds;
+    {
+        // The GlobalTrackCache is only locked while looking up the
+        // cached tracks.
+        GlobalTrackCacheLocker cacheLocker;
+        QSet<TrackId> uncachedTrackIdSet;
+        for (const auto& trackId : trackIds) {
+            if (!trackId.isValid() ||
+                    tracksById.contains(trackId) ||
+                    uncachedTrackIdSet.contains(trackId)) {
+                continue;
+            }
+            TrackPointer pTrack = cacheLocker.lookupTrackById(trackId);
+            if (pTrack) {
+                tracksById.insert(trackId, std::move(pTrack));
+            } else {
+                uncachedTrackIdSet.insert(trackId);
+                uncachedTrackIds.append(trackId);
+            }
+        }
+    }
+
+    if (m_pTrackSaveQueue && !uncachedTrackIds.isEmpty()) {
+        // The modifications of recently evicted tracks might not have
+        // been saved yet and must be saved before loading them again.
+        QList<TrackSnapshot> pendingSnapshots;
+        for (const auto& trackId : qAsConst(uncachedTrackIds)) {
+            auto pendingSnapshot = m_pTrackSaveQueue->takePendingSnapshot(trackId);
+            if (pendingSnapshot) {
+                pendingSnapshots.append(std::move(*pendingSnapshot));
+            }
+        }
+        if (!pendingSnapshots.isEmpty()) {
+            const auto savedTrackIds = updateTracks(pendingSnapshots);
+            for (const auto& trackId : savedTrackIds) {
+                emit mixxx::thisAsNonConst(this)->trackClean(trackId);
+            }
+        }
+    }
+
+    ScopedTimer t("TrackDAO::getTracksByIds");
+
+    for (int offset = 0; offset < uncachedTrackIds.size(); offset += kMaxTrackIdsPerQuery) {
+        const QList<TrackId> batchTrackIds = uncachedTrackIds.mid(offset, kMaxTrackIdsPerQuery);
+        QStringList idList;
+        idList.reserve(batchTrackIds.size());
+        for (const auto& trackId : batchTrackIds) {
+            idList.append(trackId.toString());
+        }
+
+        // Records are collected before populating the tracks, which
+        // might access the database and the files.
+        QList<QSqlRecord> queryRecords;
+        queryRecords.reserve(batchTrackIds.size());
+        {
+            FwdSqlQuery query(m_database,
+                    QStringLiteral(
+                            "SELECT %1 FROM Library "
+                            "INNER JOIN track_locations ON library.location = track_locations.id "
+                            "WHERE library.id IN (%2)")
+                            .arg(trackColumnsString(), idList.join(QChar(','))));
+            VERIFY_OR_DEBUG_ASSERT(query.execPrepared()) {
+                kLogger.warning()
+                        << "Failed to load"
+                        << batchTrackIds.size()
+                        << "tracks";
+                continue;
+            }
+            while (query.next()) {
+                queryRecords.append(query.record());
+            }
+        }
+        const auto cuesByTrackId = m_cueDao.getCuesForTracks(batchTrackIds);
+
+        for (const auto& queryRecord : qAsConst(queryRecords)) {
+            const TrackId trackId(queryRecord.value(kTrackColumnsCount - 1));
+            TrackPointer pTrack = loadTrackFromRecord(trackId,
+                    queryRecord,
+                    [&cuesByTrackId, trackId] {
+                        return cuesByTrackId.value(trackId);
+                    });
+            if (pTrack) {
+                tracksById.insert(trackId, std::move(pTrack));
+            }
+        }
+    }
+
+    QList<TrackPointer> tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        tracks.append(tracksById.value(trackId));
     }
+    return tracks;
+}
 
+TrackPointer TrackDAO::loadTrackFromRecord(
+        TrackId trackId,
+        const QSqlRecord& queryRecord,
+        const std::function<QList<CuePointer>()>& loadCues) const {
+    TrackPointer pTrack;
     {
         // Location is the first column.
         DEBUG_ASSERT(queryRecord.count() > 0);
@@ -1501,11 +1698,11 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     bool shouldDirty = false;
     {
         int recordCount = queryRecord.count();
-        VERIFY_OR_DEBUG_ASSERT(recordCount == columnsCount) {
-            recordCount = math_min(recordCount, columnsCount);
+        VERIFY_OR_DEBUG_ASSERT(recordCount == kTrackColumnsCount) {
+            recordCount = math_min(recordCount, kTrackColumnsCount);
         }
         for (int i = 0; i < recordCount; ++i) {
-            TrackPopulatorFn populator = columns[i].populator;
+            TrackPopulatorFn populator = kTrackColumns[i].populator;
             if (populator && (*populator)(queryRecord, i, pTrack.get())) {
                 // If any populator says the track should be dirty then we dirty it.
                 shouldDirty = true;
@@ -1514,7 +1711,7 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     }
 
     // Populate track cues from the cues table.
-    pTrack->setCuePoints(m_cueDao.getCuesForTrack(trackId));
+    pTrack->setCuePoints(loadCues());
 
     // Normally we will set the track as clean but sometimes when loading from
     // the database we need to perform upkeep that ought to be written back to
@@ -1639,17 +1836,118 @@ TrackPointer TrackDAO::getTrackByRef(
     return getTrackById(trackId);
 }
 
+bool TrackDAO::updateSortKeys() const {
+    const SettingsDAO settings(m_database);
+    // The version is empty if sort keys are not supported
+    const QString sortKeysVersion = m_sortKeyGenerator.version();
+    if (settings.getValue(kSortKeysVersionSettingName) == sortKeysVersion) {
+        return true;
+    }
+
+    // Sort keys of different locales or versions of the collation
+    // rules must not be mixed
+    kLogger.info()
+            << "Regenerating collation sort keys for"
+            << (sortKeysVersion.isEmpty() ? QStringLiteral("<none>") : sortKeysVersion);
+    PerformanceTimer timer;
+    timer.start();
+
+    SqlTransaction transaction(m_database);
+    QSqlQuery selectQuery(m_database);
+    selectQuery.setForwardOnly(true);
+    selectQuery.prepare(
+            "SELECT id,artist,title,album,album_artist,genre,composer,grouping,comment "
+            "FROM library");
+    if (!selectQuery.exec()) {
+        LOG_FAILED_QUERY(selectQuery);
+        return false;
+    }
+    QSqlQuery updateQuery(m_database);
+    updateQuery.prepare(
+            "UPDATE library SET "
+            "artist_sortkey=:artist_sortkey,"
+            "title_sortkey=:title_sortkey,"
+            "album_sortkey=:album_sortkey,"
+            "album_artist_sortkey=:album_artist_sortkey,"
+            "genre_sortkey=:genre_sortkey,"
+            "composer_sortkey=:composer_sortkey,"
+            "grouping_sortkey=:grouping_sortkey,"
+            "comment_sortkey=:comment_sortkey "
+            "WHERE id=:id");
+    int numTracks = 0;
+    while (selectQuery.next()) {
+        updateQuery.bindValue(":id", selectQuery.value(0));
+        bindTrackLibrarySortKeys(
+                &updateQuery,
+                m_sortKeyGenerator,
+                selectQuery.value(1).toString(),
+                selectQuery.value(2).toString(),
+                selectQuery.value(3).toString(),
+                selectQuery.value(4).toString(),
+                selectQuery.value(5).toString(),
+                selectQuery.value(6).toString(),
+                selectQuery.value(7).toString(),
+                selectQuery.value(8).toString());
+        if (!updateQuery.exec()) {
+            LOG_FAILED_QUERY(updateQuery);
+            return false;
+        }
+        ++numTracks;
+    }
+    if (!settings.setValue(kSortKeysVersionSettingName, sortKeysVersion)) {
+        return false;
+    }
+    if (!transaction.commit()) {
+        return false;
+    }
+    kLogger.info()
+            << "Regenerating collation sort keys of"
+            << numTracks
+            << "tracks took"
+            << timer.elapsed().formatMillisWithUnit();
+    return true;
+}
+
 // Saves a track's info back to the database
 bool TrackDAO::updateTrack(const Track& track) const {
-    const TrackId trackId = track.getId();
+    SqlTransaction transaction(m_database);
+    if (!updateTrackWithinTransaction(TrackSnapshot::fromTrack(track))) {
+        return false;
+    }
+    transaction.commit();
+    return true;
+}
+
+QList<TrackId> TrackDAO::updateTracks(
+        const QList<TrackSnapshot>& trackSnapshots) const {
+    QList<TrackId> updatedTrackIds;
+    updatedTrackIds.reserve(trackSnapshots.size());
+    SqlTransaction transaction(m_database);
+    for (const auto& trackSnapshot : trackSnapshots) {
+        if (updateTrackWithinTransaction(trackSnapshot)) {
+            updatedTrackIds.append(trackSnapshot.getId());
+        }
+    }
+    if (!transaction.commit()) {
+        kLogger.warning()
+                << "Failed to save"
+                << trackSnapshots.size()
+                << "track(s) in database";
+        return {};
+    }
+    return updatedTrackIds;
+}
+
+bool TrackDAO::updateTrackWithinTransaction(
+        const TrackSnapshot& trackSnapshot) const {
+    const TrackId trackId = trackSnapshot.getId();
     DEBUG_ASSERT(trackId.isValid());
 
     qDebug() << "TrackDAO:"
              << "Updating track in database"
              << trackId
-             << track.getFileInfo();
+             << trackSnapshot.location;
 
-    SqlTransaction transaction(m_database);
     // PerformanceTimer time;
     // time.start();
 
@@ -1701,16 +1999,24 @@ bool TrackDAO::updateTrack(const Track& track) const {
             "coverart_location=:coverart_location,"
             "coverart_color=:coverart_color,"
             "coverart_digest=:coverart_digest,"
-            "coverart_hash=:coverart_hash "
+            "coverart_hash=:coverart_hash,"
+            "artist_sortkey=:artist_sortkey,"
+            "title_sortkey=:title_sortkey,"
+            "album_sortkey=:album_sortkey,"
+            "album_artist_sortkey=:album_artist_sortkey,"
+            "genre_sortkey=:genre_sortkey,"
+            "composer_sortkey=:composer_sortkey,"
+            "grouping_sortkey=:grouping_sortkey,"
+            "comment_sortkey=:comment_sortkey "
             "WHERE id=:track_id");
 
     query.bindValue(":track_id", trackId.toVariant());
 
-    const auto trackRecord = track.getRecord();
     bindTrackLibraryValues(
             &query,
-            trackRecord,
-            track.getBeats());
+            trackSnapshot.record,
+            trackSnapshot.pBeats,
+            m_sortKeyGenerator);
 
     VERIFY_OR_DEBUG_ASSERT(query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -1726,11 +2032,10 @@ bool TrackDAO::updateTrack(const Track& track) const {
     //time.start();
     m_analysisDao.saveTrackAnalyses(
             trackId,
-            track.getWaveform(),
-            track.getWaveformSummary());
+            trackSnapshot.pWaveform,
+            trackSnapshot.pWaveformSummary);
     m_cueDao.saveTrackCues(
-            trackId, track.getCuePoints());
-    transaction.commit();
+            trackId, trackSnapshot.cuePoints);
 
     //qDebug() << "Update track in database took: " << time.elapsed().formatMillisWithUnit();
     //time.start();
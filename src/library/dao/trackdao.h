@@ -6,20 +6,26 @@
 #include <QSet>
 #include <QSqlDatabase>
 #include <QString>
+#include <functional>
 
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
+#include "util/collationsortkey.h"
 #include "util/memory.h"
 
+class CuePointer;
 class FwdSqlQuery;
+class QSqlRecord;
 class SqlTransaction;
 class PlaylistDAO;
 class AnalysisDao;
 class CueDAO;
 class LibraryHashDAO;
+class TrackSaveQueue;
+struct TrackSnapshot;
 
 namespace mixxx {
 
@@ -76,6 +82,21 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
 
+    /// Returns true if the collation sort key columns of the library
+    /// table are maintained and can be used for sorting instead of
+    /// the custom collation function.
+    bool hasSortKeys() const {
+        return m_sortKeyGenerator.isValid();
+    }
+
+    /// Regenerates all collation sort keys if the locale or the version
+    /// of the collation rules have changed since they were generated.
+    /// This takes a while for large libraries and is done by the
+    /// LibraryScanner thread on startup.
+    ///
+    /// Only used by friend class LibraryScanner, but public for testing!
+    bool updateSortKeys() const;
+
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
     bool updatePlayCounterFromPlayedHistory(
@@ -97,6 +118,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     /// access as a friend.
     static bool getTrackHeaderParsedInternal(const mixxx::TrackRecord& trackRecord);
 
+    /// Modifications of evicted tracks that are still pending in the
+    /// queue are saved before loading these tracks again.
+    void setTrackSaveQueue(TrackSaveQueue* pTrackSaveQueue) {
+        m_pTrackSaveQueue = pTrackSaveQueue;
+    }
+
     /// Lookup and load a track by URL.
     ///
     /// Only local file URLs are supported.
@@ -127,16 +154,24 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             const QSet<TrackId>& changedTrackIds);
     void slotDatabaseTracksRelocated(
             const QList<RelocatedTrack>& relocatedTracks);
+    void slotDatabaseTracksSaved(
+            const QList<TrackId>& savedTrackIds);
 
   private:
     friend class LibraryScanner;
     friend class TrackCollection;
     friend class TrackAnalysisScheduler;
+    friend class TrackSaveQueue;
 
     TrackId getTrackIdByLocation(
             const QString& location) const;
     TrackPointer getTrackById(
             TrackId trackId) const;
+    /// Loads multiple tracks with a few batched queries instead of
+    /// separate queries for each track. The returned list contains
+    /// a nullptr for each track that could not be loaded.
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
 
     // Loads a track from the database (by id if available, otherwise by location)
     // or adds it if not found in case the location is known. The (optional) out
@@ -164,6 +199,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
+    /// Saves the snapshots in a single transaction and returns
+    /// the ids of all tracks that have been saved.
+    QList<TrackId> updateTracks(
+            const QList<TrackSnapshot>& trackSnapshots) const;
+    // Must be invoked within a transaction
+    bool updateTrackWithinTransaction(
+            const TrackSnapshot& trackSnapshot) const;
 
     void hideAllTracks(const QDir& rootDir) const;
 
@@ -200,6 +242,15 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             TrackId trackId,
             mixxx::FileAccess fileAccess) override;
 
+    /// Populates a new track object from a record of the library query
+    /// or returns the track object that has been cached in the meantime.
+    /// Only a helper of getTrackById() and getTracksByIds(), not intended
+    /// to be used by the friend classes.
+    TrackPointer loadTrackFromRecord(
+            TrackId trackId,
+            const QSqlRecord& queryRecord,
+            const std::function<QList<CuePointer>()>& loadCues) const;
+
     CueDAO& m_cueDao;
     PlaylistDAO& m_playlistDao;
     AnalysisDao& m_analysisDao;
@@ -207,6 +258,8 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     const UserSettingsPointer m_pConfig;
 
+    const mixxx::CollationSortKeyGenerator m_sortKeyGenerator;
+
     std::unique_ptr<QSqlQuery> m_pQueryTrackLocationInsert;
     std::unique_ptr<QSqlQuery> m_pQueryTrackLocationSelect;
     std::unique_ptr<QSqlQuery> m_pQueryLibraryInsert;
@@ -219,6 +272,8 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     QSet<TrackId> m_tracksAddedSet;
 
+    TrackSaveQueue* m_pTrackSaveQueue;
+
     DISALLOW_COPY_AND_ASSIGN(TrackDAO);
 };
 
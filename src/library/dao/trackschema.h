@@ -47,6 +47,16 @@ const QString LIBRARYTABLE_COVERART_COLOR = QStringLiteral("coverart_color");
 const QString LIBRARYTABLE_COVERART_DIGEST = QStringLiteral("coverart_digest");
 const QString LIBRARYTABLE_COVERART_HASH = QStringLiteral("coverart_hash");
 
+// Binary collation sort keys of the corresponding text columns
+const QString LIBRARYTABLE_ARTIST_SORTKEY = QStringLiteral("artist_sortkey");
+const QString LIBRARYTABLE_TITLE_SORTKEY = QStringLiteral("title_sortkey");
+const QString LIBRARYTABLE_ALBUM_SORTKEY = QStringLiteral("album_sortkey");
+const QString LIBRARYTABLE_ALBUMARTIST_SORTKEY = QStringLiteral("album_artist_sortkey");
+const QString LIBRARYTABLE_GENRE_SORTKEY = QStringLiteral("genre_sortkey");
+const QString LIBRARYTABLE_COMPOSER_SORTKEY = QStringLiteral("composer_sortkey");
+const QString LIBRARYTABLE_GROUPING_SORTKEY = QStringLiteral("grouping_sortkey");
+const QString LIBRARYTABLE_COMMENT_SORTKEY = QStringLiteral("comment_sortkey");
+
 const QString TRACKLOCATIONSTABLE_ID = QStringLiteral("id");
 const QString TRACKLOCATIONSTABLE_LOCATION = QStringLiteral("location");
 const QString TRACKLOCATIONSTABLE_FILENAME = QStringLiteral("filename");
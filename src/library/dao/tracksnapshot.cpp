@@ -0,0 +1,15 @@
+#include "library/dao/tracksnapshot.h"
+
+#include "track/track.h"
+
+//static
+TrackSnapshot TrackSnapshot::fromTrack(const Track& track) {
+    TrackSnapshot trackSnapshot;
+    trackSnapshot.record = track.getRecord();
+    trackSnapshot.pBeats = track.getBeats();
+    trackSnapshot.pWaveform = track.getWaveform();
+    trackSnapshot.pWaveformSummary = track.getWaveformSummary();
+    trackSnapshot.cuePoints = track.getCuePoints();
+    trackSnapshot.location = track.getLocation();
+    return trackSnapshot;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include "track/beats.h"
+#include "track/cue.h"
+#include "track/trackrecord.h"
+#include "waveform/waveform.h"
+
+class Track;
+
+/// The properties of a track that are stored in the database,
+/// captured from a Track object for saving them later.
+///
+/// Beats and waveforms are immutable and cue objects are only
+/// modified by saving them. Snapshots must only be taken from
+/// tracks that are not accessed anymore, i.e. from tracks that
+/// have been evicted from the GlobalTrackCache.
+struct TrackSnapshot {
+    static TrackSnapshot fromTrack(const Track& track);
+
+    TrackId getId() const {
+        return record.getId();
+    }
+
+    mixxx::TrackRecord record;
+    mixxx::BeatsPointer pBeats;
+    ConstWaveformPointer pWaveform;
+    ConstWaveformPointer pWaveformSummary;
+    QList<CuePointer> cuePoints;
+    // Only used for logging
+    QString location;
+};
@@ -75,6 +75,7 @@ std::optional<djinterop::musical_key> toDjinteropKey(
 }
 
 QString exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
+        ExportFileCopier* pFileCopier,
         TrackPointer pTrack) {
     if (!pRequest->engineLibraryDbDir.exists()) {
         const auto msg = QStringLiteral(
@@ -96,10 +97,12 @@ QString exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
     const auto trackId = pTrack->getId().value();
     QString dstFilename = QString::number(trackId) + " - " + srcFileInfo.fileName();
     QString dstPath = pRequest->musicFilesDir.filePath(dstFilename);
+    // The file is copied in the background while the metadata is exported.
+    // An existing file is only rewritten if its content differs.
     if (!QFile::exists(dstPath) ||
             srcFileInfo.lastModified() > QFileInfo{dstPath}.lastModified()) {
         const auto srcPath = srcFileInfo.location();
-        QFile::copy(srcPath, dstPath);
+        pFileCopier->copyFile(srcPath, dstPath);
     }
 
     return pRequest->engineLibraryDbDir.relativeFilePath(dstPath);
@@ -338,6 +341,7 @@ void exportMetadata(djinterop::database* pDatabase,
 
 void exportTrack(
         const QSharedPointer<EnginePrimeExportRequest> pRequest,
+        ExportFileCopier* pFileCopier,
         djinterop::database* pDatabase,
         QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
         const TrackPointer pTrack,
@@ -351,7 +355,7 @@ void exportTrack(
     }
 
     // Copy the file, if required.
-    const auto musicFileRelativePath = exportFile(pRequest, pTrack);
+    const auto musicFileRelativePath = exportFile(pRequest, pFileCopier, pTrack);
 
     // Export meta-data.
     exportMetadata(pDatabase,
@@ -361,6 +365,21 @@ void exportTrack(
             musicFileRelativePath);
 }
 
+void logCopyResult(const ExportFileCopier::Result& result) {
+    switch (result.status) {
+    case ExportFileCopier::Status::Copied:
+    case ExportFileCopier::Status::Canceled:
+        break;
+    case ExportFileCopier::Status::Identical:
+        qDebug() << "Music file" << result.destPath << "is up to date";
+        break;
+    case ExportFileCopier::Status::Failed:
+        qWarning() << "Failed to copy music file" << result.sourcePath
+                   << "to" << result.destPath << ":" << result.errorString;
+        break;
+    }
+}
+
 void exportCrate(
         djinterop::crate* pExtRootCrate,
         const QHash<TrackId, int64_t>& mixxxToEnginePrimeTrackIdMap,
@@ -539,6 +558,8 @@ void EnginePrimeExportJob::run() {
     // We will build up a map from Mixxx track id to EL track id during export.
     QHash<TrackId, int64_t> mixxxToEnginePrimeTrackIdMap;
 
+    int numTracksDone = 0;
+
     for (const auto& trackRef : qAsConst(m_trackRefs)) {
         // Load each track.
         // Note that loading must happen on the same thread as the track collection
@@ -560,6 +581,7 @@ void EnginePrimeExportJob::run() {
                 << "at" << m_pLastLoadedTrack->getFileInfo().location() << "...";
         try {
             exportTrack(m_pRequest,
+                    &m_fileCopier,
                     pDb.get(),
                     &mixxxToEnginePrimeTrackIdMap,
                     m_pLastLoadedTrack,
@@ -575,10 +597,35 @@ void EnginePrimeExportJob::run() {
 
         m_pLastLoadedTrack.reset();
 
+        while (const auto result = m_fileCopier.takeResult()) {
+            logCopyResult(*result);
+        }
+
+        ++numTracksDone;
+        // Only outdated music files are copied, so the tracks that remain
+        // are assumed to need as many bytes copied as the previous ones
+        // on average.
+        const qint64 queuedBytes = m_fileCopier.queuedBytes();
+        const qint64 bytesPerTrack =
+                (m_fileCopier.processedBytes() + queuedBytes) / numTracksDone;
+        emitTransferRate(queuedBytes +
+                bytesPerTrack * (m_trackRefs.size() - numTracksDone));
+
         ++currProgress;
         emit jobProgress(currProgress);
     }
 
+    // Wait until all music files have been written to the target device.
+    while (const auto result = m_fileCopier.waitForResult()) {
+        logCopyResult(*result);
+        emitTransferRate(m_fileCopier.queuedBytes());
+    }
+    if (m_cancellationRequested.loadAcquire() != 0) {
+        qInfo() << "Cancelling export";
+        return;
+    }
+    m_fileCopier.syncToDisk();
+
     // We will ensure that there is a special top-level crate representing the
     // root of all Mixxx-exported items.  Mixxx tracks and crates will exist
     // underneath this crate.
@@ -658,8 +705,17 @@ void EnginePrimeExportJob::run() {
     emit completed(m_trackRefs.size(), m_crateIds.size());
 }
 
+void EnginePrimeExportJob::emitTransferRate(qint64 remainingBytes) {
+    const double bytesPerSecond = m_fileCopier.bytesPerSecond();
+    if (bytesPerSecond > 0) {
+        emit jobTransferRate(bytesPerSecond,
+                qMax(qint64(0), remainingBytes) / bytesPerSecond);
+    }
+}
+
 void EnginePrimeExportJob::slotCancel() {
     m_cancellationRequested = 1;
+    m_fileCopier.cancel();
 }
 
 } // namespace mixxx
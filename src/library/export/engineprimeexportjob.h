@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "library/export/engineprimeexportrequest.h"
+#include "library/export/exportfilecopier.h"
 #include "library/trackcollectionmanager.h"
 #include "library/trackset/crate/crate.h"
 #include "library/trackset/crate/crateid.h"
@@ -41,6 +42,10 @@ class EnginePrimeExportJob : public QThread {
     /// Informs of progress through the job, up to the pre-signalled maximum.
     void jobProgress(int progress);
 
+    /// Informs of the rate at which music files are copied and the
+    /// estimated time until all tracks have been exported.
+    void jobTransferRate(double bytesPerSecond, double remainingSeconds);
+
     /// Inform of a completed export job.
     void completed(int numTracksExported, int numCratesExported);
 
@@ -60,6 +65,9 @@ class EnginePrimeExportJob : public QThread {
     void loadCrate(const CrateId& crateId);
 
   private:
+    // Estimates the remaining time from the current transfer rate
+    void emitTransferRate(qint64 remainingBytes);
+
     QList<TrackRef> m_trackRefs;
     QList<CrateId> m_crateIds;
     TrackPointer m_pLastLoadedTrack;
@@ -69,6 +77,8 @@ class EnginePrimeExportJob : public QThread {
 
     QAtomicInteger<int> m_cancellationRequested;
 
+    ExportFileCopier m_fileCopier;
+
     TrackCollectionManager* m_pTrackCollectionManager;
     QSharedPointer<EnginePrimeExportRequest> m_pRequest;
 
@@ -0,0 +1,399 @@
+#include "library/export/exportfilecopier.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QStorageInfo>
+#include <QtConcurrentRun>
+#include <cstring>
+
+#if defined(__LINUX__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#elif !defined(__WINDOWS__)
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("ExportFileCopier");
+
+// Flash drives perform best with large sequential writes
+constexpr qint64 kCopyBufferSize = 4 * 1024 * 1024;
+
+// The written data is flushed to the target device after this many
+// bytes. Otherwise the page cache fills up with dirty pages that are
+// only written when the device is unmounted, which makes both the
+// progress and the remaining time meaningless.
+constexpr qint64 kSyncBatchSize = 256 * 1024 * 1024;
+
+bool haveEqualContent(QFile* pSourceFile, QFile* pDestFile) {
+    QByteArray sourceBuffer(kCopyBufferSize, Qt::Uninitialized);
+    QByteArray destBuffer(kCopyBufferSize, Qt::Uninitialized);
+    while (true) {
+        const qint64 sourceBytes = pSourceFile->read(sourceBuffer.data(), sourceBuffer.size());
+        const qint64 destBytes = pDestFile->read(destBuffer.data(), destBuffer.size());
+        if (sourceBytes < 0 || sourceBytes != destBytes) {
+            return false;
+        }
+        if (sourceBytes == 0) {
+            return true;
+        }
+        if (std::memcmp(sourceBuffer.constData(), destBuffer.constData(), sourceBytes) != 0) {
+            return false;
+        }
+    }
+}
+
+bool copyFileContent(QFile* pSourceFile, QFile* pDestFile, const QAtomicInt& canceled) {
+    QByteArray buffer(kCopyBufferSize, Qt::Uninitialized);
+    while (!canceled.loadAcquire()) {
+        const qint64 readBytes = pSourceFile->read(buffer.data(), buffer.size());
+        if (readBytes <= 0) {
+            return readBytes == 0;
+        }
+        if (pDestFile->write(buffer.constData(), readBytes) != readBytes) {
+            return false;
+        }
+    }
+    return false;
+}
+
+#if defined(__LINUX__)
+enum class KernelCopyResult {
+    Copied,
+    Unsupported,
+    Failed,
+};
+
+// Copies the file without transferring the data through user space
+// if both files are stored on the same filesystem. Copy-on-write
+// filesystems like Btrfs or XFS may even share the data blocks.
+KernelCopyResult copyFileInKernel(
+        int sourceFd,
+        int destFd,
+        qint64 sizeInBytes,
+        const QAtomicInt& canceled,
+        QString* pErrorString) {
+    struct stat sourceStat;
+    struct stat destStat;
+    if (fstat(sourceFd, &sourceStat) != 0 ||
+            fstat(destFd, &destStat) != 0 ||
+            sourceStat.st_dev != destStat.st_dev) {
+        return KernelCopyResult::Unsupported;
+    }
+#ifdef FICLONE
+    if (ioctl(destFd, FICLONE, sourceFd) == 0) {
+        return KernelCopyResult::Copied;
+    }
+#endif
+    qint64 copiedBytes = 0;
+    while (copiedBytes < sizeInBytes) {
+        if (canceled.loadAcquire()) {
+            return KernelCopyResult::Failed;
+        }
+        const ssize_t chunkBytes = copy_file_range(sourceFd,
+                nullptr,
+                destFd,
+                nullptr,
+                static_cast<size_t>(qMin(sizeInBytes - copiedBytes, kCopyBufferSize)),
+                0);
+        if (chunkBytes < 0) {
+            const int error = errno;
+            if (copiedBytes == 0 &&
+                    (error == ENOSYS || error == EXDEV ||
+                            error == EINVAL || error == EOPNOTSUPP)) {
+                return KernelCopyResult::Unsupported;
+            }
+            *pErrorString = qt_error_string(error);
+            return KernelCopyResult::Failed;
+        }
+        if (chunkBytes == 0) {
+            // The source file has been truncated concurrently
+            break;
+        }
+        copiedBytes += chunkBytes;
+    }
+    return KernelCopyResult::Copied;
+}
+#endif
+
+void syncFiles(const QStringList& filePaths) {
+    if (filePaths.isEmpty()) {
+        return;
+    }
+    PerformanceTimer timer;
+    timer.start();
+#if defined(__LINUX__)
+    // Flushing each filesystem once is much cheaper than flushing each
+    // file individually. The files might be stored on multiple devices.
+    QHash<QString, QString> filePathByRootPath;
+    for (const auto& filePath : filePaths) {
+        filePathByRootPath.insert(
+                QStorageInfo(QFileInfo(filePath).absolutePath()).rootPath(),
+                filePath);
+    }
+    for (auto it = filePathByRootPath.constBegin(); it != filePathByRootPath.constEnd(); ++it) {
+        QFile file(it.value());
+        if (!file.open(QIODevice::ReadOnly)) {
+            kLogger.warning()
+                    << "Failed to open" << it.value()
+                    << "for flushing" << it.key() << ':' << file.errorString();
+            continue;
+        }
+        if (syncfs(file.handle()) != 0) {
+            kLogger.warning()
+                    << "Failed to flush" << it.key() << ':' << qt_error_string(errno);
+        }
+    }
+#elif !defined(__WINDOWS__)
+    for (const auto& filePath : filePaths) {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            kLogger.warning()
+                    << "Failed to open" << filePath
+                    << "for flushing:" << file.errorString();
+            continue;
+        }
+        if (fsync(file.handle()) != 0) {
+            kLogger.warning()
+                    << "Failed to flush" << filePath << ':' << qt_error_string(errno);
+        }
+    }
+#else
+    // Windows disables the write cache of removable drives by default
+#endif
+    kLogger.debug()
+            << "Flushing"
+            << filePaths.size()
+            << "file(s) took"
+            << timer.elapsed().debugMillisWithUnit();
+}
+
+} // anonymous namespace
+
+ExportFileCopier::ExportFileCopier(int maxConcurrentCopies)
+        : m_pendingCount(0),
+          m_processedBytes(0),
+          m_queuedBytes(0),
+          m_unsyncedBytes(0) {
+    m_threadPool.setMaxThreadCount(maxConcurrentCopies);
+}
+
+ExportFileCopier::~ExportFileCopier() {
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+void ExportFileCopier::copyFile(const QString& sourcePath, const QString& destPath) {
+    const qint64 queuedBytes = QFileInfo(sourcePath).size();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_timer.isValid()) {
+            m_timer.start();
+        }
+        ++m_pendingCount;
+        m_queuedBytes += queuedBytes;
+    }
+    QtConcurrent::run(&m_threadPool,
+            [this, sourcePath, destPath, queuedBytes] {
+                Result result = copyFileNow(sourcePath, destPath);
+                QMutexLocker locker(&m_mutex);
+                m_queuedBytes -= queuedBytes;
+                if (result.status != Status::Canceled) {
+                    m_processedBytes += result.sizeInBytes;
+                }
+                m_results.enqueue(std::move(result));
+                m_resultAvailable.wakeAll();
+            });
+}
+
+int ExportFileCopier::pendingCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_pendingCount;
+}
+
+std::optional<ExportFileCopier::Result> ExportFileCopier::takeResult() {
+    QMutexLocker locker(&m_mutex);
+    if (m_results.isEmpty()) {
+        return std::nullopt;
+    }
+    --m_pendingCount;
+    return m_results.dequeue();
+}
+
+std::optional<ExportFileCopier::Result> ExportFileCopier::waitForResult() {
+    QMutexLocker locker(&m_mutex);
+    while (m_results.isEmpty()) {
+        if (m_pendingCount == 0) {
+            return std::nullopt;
+        }
+        m_resultAvailable.wait(&m_mutex);
+    }
+    --m_pendingCount;
+    return m_results.dequeue();
+}
+
+void ExportFileCopier::cancel() {
+    m_canceled = 1;
+}
+
+void ExportFileCopier::syncToDisk() {
+    QStringList filePaths;
+    {
+        QMutexLocker locker(&m_mutex);
+        filePaths.swap(m_unsyncedFilePaths);
+        m_unsyncedBytes = 0;
+    }
+    syncFiles(filePaths);
+}
+
+double ExportFileCopier::bytesPerSecond() const {
+    QMutexLocker locker(&m_mutex);
+    const qint64 elapsedMillis = m_timer.isValid() ? m_timer.elapsed() : 0;
+    if (elapsedMillis <= 0) {
+        return 0.0;
+    }
+    return m_processedBytes * 1000.0 / elapsedMillis;
+}
+
+qint64 ExportFileCopier::processedBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_processedBytes;
+}
+
+qint64 ExportFileCopier::queuedBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_queuedBytes;
+}
+
+ExportFileCopier::Result ExportFileCopier::copyFileNow(
+        const QString& sourcePath,
+        const QString& destPath) {
+    Result result{sourcePath, destPath, Status::Failed, 0, QString()};
+    if (m_canceled.loadAcquire()) {
+        result.status = Status::Canceled;
+        return result;
+    }
+
+    QFile sourceFile(sourcePath);
+    if (!sourceFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        result.errorString = sourceFile.errorString();
+        return result;
+    }
+    result.sizeInBytes = sourceFile.size();
+
+    QFile destFile(destPath);
+    if (destFile.exists() && destFile.size() == result.sizeInBytes &&
+            destFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        // Reading the destination file is much faster than writing it
+        if (haveEqualContent(&sourceFile, &destFile)) {
+            kLogger.debug() << "Skipping identical file" << destPath;
+            result.status = Status::Identical;
+            return result;
+        }
+        destFile.close();
+        // Restart reading from the beginning
+        sourceFile.close();
+        if (!sourceFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            result.errorString = sourceFile.errorString();
+            return result;
+        }
+    }
+
+    // Concurrent writes of multiple files would fragment both the files
+    // and the write stream of the target device, which slows down flash
+    // drives considerably.
+    const auto pWriteMutex = deviceWriteMutex(destPath);
+    const QMutexLocker writeLocker(pWriteMutex.get());
+    if (m_canceled.loadAcquire()) {
+        // Canceled while waiting for the other files on this device
+        result.status = Status::Canceled;
+        return result;
+    }
+    if (!destFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        result.errorString = destFile.errorString();
+        return result;
+    }
+    bool copied = false;
+    bool copyInUserSpace = true;
+#if defined(__LINUX__)
+    switch (copyFileInKernel(sourceFile.handle(),
+            destFile.handle(),
+            result.sizeInBytes,
+            m_canceled,
+            &result.errorString)) {
+    case KernelCopyResult::Copied:
+        copied = true;
+        copyInUserSpace = false;
+        break;
+    case KernelCopyResult::Failed:
+        copyInUserSpace = false;
+        break;
+    case KernelCopyResult::Unsupported:
+        break;
+    }
+#endif
+    if (copyInUserSpace) {
+        copied = copyFileContent(&sourceFile, &destFile, m_canceled);
+        if (!copied && result.errorString.isEmpty()) {
+            result.errorString = destFile.error() != QFileDevice::NoError
+                    ? destFile.errorString()
+                    : sourceFile.errorString();
+        }
+    }
+    if (!copied) {
+        // Don't leave a partially written file behind
+        destFile.remove();
+        if (m_canceled.loadAcquire()) {
+            result.status = Status::Canceled;
+            result.errorString.clear();
+        }
+        return result;
+    }
+    destFile.setPermissions(sourceFile.permissions());
+    destFile.close();
+
+    result.status = Status::Copied;
+    addUnsyncedFile(destPath, result.sizeInBytes);
+    return result;
+}
+
+std::shared_ptr<QMutex> ExportFileCopier::deviceWriteMutex(const QString& destPath) {
+    const QString rootPath =
+            QStorageInfo(QFileInfo(destPath).absolutePath()).rootPath();
+    QMutexLocker locker(&m_mutex);
+    auto& pWriteMutex = m_deviceWriteMutexes[rootPath];
+    if (!pWriteMutex) {
+        pWriteMutex = std::make_shared<QMutex>();
+    }
+    return pWriteMutex;
+}
+
+void ExportFileCopier::addUnsyncedFile(const QString& destPath, qint64 sizeInBytes) {
+    QStringList filePaths;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_unsyncedFilePaths.append(destPath);
+        m_unsyncedBytes += sizeInBytes;
+        if (m_unsyncedBytes < kSyncBatchSize) {
+            return;
+        }
+        filePaths.swap(m_unsyncedFilePaths);
+        m_unsyncedBytes = 0;
+    }
+    syncFiles(filePaths);
+}
+
+} // namespace mixxx
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <memory>
+#include <optional>
+
+namespace mixxx {
+
+/// Copies music files into an export destination, e.g. a USB stick,
+/// on a bounded number of background threads.
+///
+/// Source files are read and compared with existing destination files
+/// concurrently, but only a single file is written per target device at
+/// a time. Reading the next source files while the previous file is still
+/// being written keeps both the source and the target device busy without
+/// interleaving the writes of multiple files on the target device.
+/// Files are copied with large sequential writes and the written data
+/// is flushed to the target device in batches instead of once per file.
+/// Within the same filesystem the data is shared or copied by the kernel
+/// if possible.
+///
+/// An existing destination file is only overwritten if it differs from
+/// the source file by size or content.
+///
+/// All functions are thread-safe.
+class ExportFileCopier {
+  public:
+    enum class Status {
+        Copied,
+        // The destination file is identical and has not been written
+        Identical,
+        Canceled,
+        Failed,
+    };
+
+    struct Result {
+        QString sourcePath;
+        QString destPath;
+        Status status;
+        qint64 sizeInBytes;
+        QString errorString;
+    };
+
+    explicit ExportFileCopier(int maxConcurrentCopies = kDefaultMaxConcurrentCopies);
+    /// Cancels all pending copies and waits until the running
+    /// copies have been aborted.
+    ~ExportFileCopier();
+
+    /// Copies the file in the background. The result is available
+    /// from waitForResult() or takeResult() afterwards.
+    void copyFile(const QString& sourcePath, const QString& destPath);
+
+    /// The number of copies whose results have not been taken yet.
+    int pendingCount() const;
+
+    /// Returns the result of a finished copy or std::nullopt if none
+    /// of the pending copies has finished yet.
+    std::optional<Result> takeResult();
+
+    /// Blocks until the next copy has finished. Returns std::nullopt
+    /// if no copies are pending.
+    std::optional<Result> waitForResult();
+
+    /// Aborts all running and pending copies. Partially written files
+    /// are removed and copies that have not been started yet finish
+    /// with Status::Canceled. May be called from any thread.
+    void cancel();
+
+    /// Flushes all data that has been written so far to the target
+    /// device. Blocks until the device has confirmed the writes.
+    void syncToDisk();
+
+    /// The source bytes processed per second since the first copy
+    /// has been started, including identical files.
+    double bytesPerSecond() const;
+
+    /// The size of the source files whose copies have finished,
+    /// including identical files.
+    qint64 processedBytes() const;
+
+    /// The size of the source files whose copies have not finished yet.
+    qint64 queuedBytes() const;
+
+    /// The number of files that are processed concurrently. Only one
+    /// of them is written to each target device at a time.
+    static constexpr int kDefaultMaxConcurrentCopies = 3;
+
+  private:
+    Result copyFileNow(const QString& sourcePath, const QString& destPath);
+    void addUnsyncedFile(const QString& destPath, qint64 sizeInBytes);
+    std::shared_ptr<QMutex> deviceWriteMutex(const QString& destPath);
+
+    QThreadPool m_threadPool;
+    QAtomicInt m_canceled;
+
+    // You must hold m_mutex to touch the following members
+    mutable QMutex m_mutex;
+    QWaitCondition m_resultAvailable;
+    QQueue<Result> m_results;
+    int m_pendingCount;
+    QElapsedTimer m_timer;
+    qint64 m_processedBytes;
+    qint64 m_queuedBytes;
+    QStringList m_unsyncedFilePaths;
+    qint64 m_unsyncedBytes;
+    // Serializes the writes per target device, keyed by the root path
+    // of the mounted volume
+    QHash<QString, std::shared_ptr<QMutex>> m_deviceWriteMutexes;
+};
+
+} // namespace mixxx
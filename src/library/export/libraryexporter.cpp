@@ -1,9 +1,11 @@
 #include "library/export/libraryexporter.h"
 
+#include <QLocale>
 #include <QProgressDialog>
 #include <QThreadPool>
 
 #include "library/export/engineprimeexportjob.h"
+#include "util/duration.h"
 #include "util/parented_ptr.h"
 
 namespace mixxx {
@@ -80,6 +82,18 @@ void LibraryExporter::beginEnginePrimeExport(
             &EnginePrimeExportJob::jobProgress,
             pProgressDlg,
             &QProgressDialog::setValue);
+    connect(pJobThread,
+            &EnginePrimeExportJob::jobTransferRate,
+            pProgressDlg,
+            [pProgressDlg = pProgressDlg.get()](
+                    double bytesPerSecond, double remainingSeconds) {
+                pProgressDlg->setLabelText(
+                        tr("Exporting to Engine Prime...") + QChar('\n') +
+                        tr("%1/s, %2 remaining")
+                                .arg(QLocale().formattedDataSize(
+                                             static_cast<qint64>(bytesPerSecond)),
+                                        Duration::formatTime(remainingSeconds)));
+            });
     connect(pJobThread, &EnginePrimeExportJob::finished, pProgressDlg, &QObject::deleteLater);
     connect(pProgressDlg,
             &QProgressDialog::canceled,
@@ -1,10 +1,12 @@
 #include "library/export/trackexportdlg.h"
 
 #include <QFileInfo>
+#include <QLocale>
 #include <QMessageBox>
 
 #include "moc_trackexportdlg.cpp"
 #include "util/assert.h"
+#include "util/duration.h"
 
 TrackExportDlg::TrackExportDlg(QWidget *parent,
                                UserSettingsPointer pConfig,
@@ -28,6 +30,10 @@ TrackExportDlg::TrackExportDlg(QWidget *parent,
             &TrackExportWorker::progress,
             this,
             &TrackExportDlg::slotProgress);
+    connect(m_worker,
+            &TrackExportWorker::transferRate,
+            this,
+            &TrackExportDlg::slotTransferRate);
     connect(m_worker,
             &TrackExportWorker::askOverwriteMode,
             this,
@@ -54,14 +60,23 @@ void TrackExportDlg::slotProgress(const QString& filename, int progress, int cou
     if (progress == count) {
         statusLabel->setText(tr("Export finished"));
         finish();
-    } else {
+    } else if (m_transferRate.isEmpty()) {
         statusLabel->setText(tr("Exporting %1").arg(filename));
+    } else {
+        statusLabel->setText(tr("Exporting %1 (%2)").arg(filename, m_transferRate));
     }
     exportProgress->setMinimum(0);
     exportProgress->setMaximum(count);
     exportProgress->setValue(progress);
 }
 
+void TrackExportDlg::slotTransferRate(double bytesPerSecond, double remainingSeconds) {
+    m_transferRate = tr("%1/s, %2 remaining")
+                             .arg(QLocale().formattedDataSize(
+                                          static_cast<qint64>(bytesPerSecond)),
+                                     mixxx::Duration::formatTime(remainingSeconds));
+}
+
 void TrackExportDlg::slotAskOverwriteMode(
         const QString& filename,
         std::promise<TrackExportWorker::OverwriteAnswer>* promise) {
@@ -29,9 +29,12 @@ class TrackExportDlg : public QDialog, public Ui::DlgTrackExport {
 
   public slots:
     void slotProgress(const QString& filename, int progress, int count);
+    void slotTransferRate(double bytesPerSecond, double remainingSeconds);
     void slotAskOverwriteMode(
             const QString& filename,
             std::promise<TrackExportWorker::OverwriteAnswer>* promise);
+    // Stops the worker, see TrackExportWorker::stop() for what happens
+    // with the files that have not been exported yet.
     void cancelButtonClicked();
 
   protected:
@@ -48,4 +51,5 @@ class TrackExportDlg : public QDialog, public Ui::DlgTrackExport {
     UserSettingsPointer m_pConfig;
     TrackPointerList m_tracks;
     TrackExportWorker* m_worker;
+    QString m_transferRate;
 };
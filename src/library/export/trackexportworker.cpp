@@ -69,80 +69,126 @@ QMap<QString, mixxx::FileInfo> createCopylist(const TrackPointerList& tracks) {
 }  // namespace
 
 void TrackExportWorker::run() {
-    int i = 0;
-    QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
+    const QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
+    if (copy_list.isEmpty()) {
+        return;
+    }
+    m_progress = 0;
+    m_progressCount = copy_list.size();
+    m_remainingBytes = 0;
+    for (const auto& fileinfo : copy_list) {
+        m_remainingBytes += fileinfo.sizeInBytes();
+    }
+    // Guarantee that we emit a sane progress before we start.
+    emit progress(copy_list.first().fileName(), 0, m_progressCount);
+
+    QString last_filename;
     for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
-        // We emit progress twice per loop, which may seem excessive, but it
-        // guarantees that we emit a sane progress before we start and after
-        // we end.  In between, each filename will get its own visible tick
-        // on the bar, which looks really nice.
-        emit progress(it->fileName(), i, copy_list.size());
-        copyFile(*it, it.key());
         if (m_bStop.loadAcquire()) {
-            emit canceled();
-            return;
+            break;
+        }
+        // Existing files are handled in order, so the user is asked about
+        // them in the same order as before.  The copies themselves are
+        // pipelined.
+        const QString dest_path = QDir(m_destDir).filePath(it.key());
+        if (confirmCopy(*it, dest_path)) {
+            qDebug() << "Copying" << it->canonicalLocation() << "to" << dest_path;
+            m_fileCopier.copyFile(it->canonicalLocation(), dest_path);
+        } else if (!m_bStop.loadAcquire()) {
+            fileFinished(it->fileName(), it->sizeInBytes());
+        }
+        last_filename = it->fileName();
+
+        // Each filename will get its own visible tick on the bar as soon
+        // as it has been copied, which looks really nice.
+        while (const auto result = m_fileCopier.takeResult()) {
+            handleCopyResult(*result);
         }
-        ++i;
-        emit progress(it->fileName(), i, copy_list.size());
     }
+    while (const auto result = m_fileCopier.waitForResult()) {
+        handleCopyResult(*result);
+    }
+
+    if (m_bStop.loadAcquire()) {
+        emit canceled();
+        return;
+    }
+    // The export is only finished when all files have been written
+    // to the target device.
+    m_fileCopier.syncToDisk();
+    emit progress(last_filename, m_progressCount, m_progressCount);
 }
 
-void TrackExportWorker::copyFile(
+bool TrackExportWorker::confirmCopy(
         const mixxx::FileInfo& source_fileinfo,
-        const QString& dest_filename) {
-    QString sourceFilename = source_fileinfo.canonicalLocation();
-    const QString dest_path = QDir(m_destDir).filePath(dest_filename);
-    QFileInfo dest_fileinfo(dest_path);
-
-    if (dest_fileinfo.exists()) {
-        switch (m_overwriteMode) {
-        // Give the user the option to overwrite existing files in the destination.
-        case OverwriteMode::ASK:
-            switch (makeOverwriteRequest(dest_path)) {
-            case OverwriteAnswer::SKIP:
-            case OverwriteAnswer::SKIP_ALL:
-                qDebug() << "skipping" << sourceFilename;
-                return;
-            case OverwriteAnswer::OVERWRITE:
-            case OverwriteAnswer::OVERWRITE_ALL:
-                break;
-            case OverwriteAnswer::CANCEL:
-                m_errorMessage = tr("Export process was canceled");
-                stop();
-                return;
-            }
-            break;
-        case OverwriteMode::SKIP_ALL:
+        const QString& dest_path) {
+    if (!QFileInfo::exists(dest_path)) {
+        return true;
+    }
+    const QString sourceFilename = source_fileinfo.canonicalLocation();
+    switch (m_overwriteMode) {
+    // Give the user the option to overwrite existing files in the destination.
+    case OverwriteMode::ASK:
+        switch (makeOverwriteRequest(dest_path)) {
+        case OverwriteAnswer::SKIP:
+        case OverwriteAnswer::SKIP_ALL:
             qDebug() << "skipping" << sourceFilename;
-            return;
-        case OverwriteMode::OVERWRITE_ALL:;
-        }
-
-        // Remove the existing file in preparation for overwriting.
-        QFile dest_file(dest_path);
-        qDebug() << "Removing existing file" << dest_path;
-        if (!dest_file.remove()) {
-            const QString error_message = tr(
-                    "Error removing file %1: %2. Stopping.").arg(
-                    dest_path, dest_file.errorString());
-            qWarning() << error_message;
-            m_errorMessage = error_message;
+            return false;
+        case OverwriteAnswer::OVERWRITE:
+        case OverwriteAnswer::OVERWRITE_ALL:
+            return true;
+        case OverwriteAnswer::CANCEL:
+            m_errorMessage = tr("Export process was canceled");
             stop();
-            return;
+            return false;
         }
+        return false;
+    case OverwriteMode::SKIP_ALL:
+        qDebug() << "skipping" << sourceFilename;
+        return false;
+    case OverwriteMode::OVERWRITE_ALL:
+        // The existing file is only rewritten if it differs from the source.
+        return true;
     }
+    return false;
+}
 
-    qDebug() << "Copying" << sourceFilename << "to" << dest_path;
-    QFile source_file(sourceFilename);
-    if (!source_file.copy(dest_path)) {
+void TrackExportWorker::handleCopyResult(const mixxx::ExportFileCopier::Result& result) {
+    switch (result.status) {
+    case mixxx::ExportFileCopier::Status::Copied:
+        break;
+    case mixxx::ExportFileCopier::Status::Identical:
+        qDebug() << "skipping identical file" << result.destPath;
+        break;
+    case mixxx::ExportFileCopier::Status::Canceled:
+        return;
+    case mixxx::ExportFileCopier::Status::Failed: {
         const QString error_message = tr(
                 "Error exporting track %1 to %2: %3. Stopping.").arg(
-                sourceFilename, dest_path, source_file.errorString());
+                result.sourcePath, result.destPath, result.errorString);
         qWarning() << error_message;
-        m_errorMessage = error_message;
+        if (m_errorMessage.isEmpty()) {
+            m_errorMessage = error_message;
+        }
         stop();
         return;
     }
+    }
+    fileFinished(QFileInfo(result.sourcePath).fileName(), result.sizeInBytes);
+}
+
+void TrackExportWorker::fileFinished(const QString& filename, qint64 sizeInBytes) {
+    ++m_progress;
+    m_remainingBytes -= sizeInBytes;
+    const double bytesPerSecond = m_fileCopier.bytesPerSecond();
+    if (bytesPerSecond > 0) {
+        emit transferRate(bytesPerSecond,
+                qMax(qint64(0), m_remainingBytes) / bytesPerSecond);
+    }
+    // The final progress is emitted after all files have been written.
+    if (m_progress < m_progressCount) {
+        emit progress(filename, m_progress, m_progressCount);
+    }
 }
 
 TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
@@ -191,6 +237,7 @@ TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
 }
 
 void TrackExportWorker::stop() {
-    // We'll wait for the current file to finish copying, then stop.
     m_bStop = true;
+    // Partially copied files are removed and queued files are skipped.
+    m_fileCopier.cancel();
 }
@@ -6,13 +6,15 @@
 #include <QThread>
 #include <future>
 
+#include "library/export/exportfilecopier.h"
 #include "track/track_decl.h"
 #include "util/fileinfo.h"
 
 // A QThread class for copying a list of files to a single destination directory.
-// Currently does not preserve subdirectory relationships.  This class performs
-// all copies in a blocking style within its own thread.  May be canceled from
-// another thread.
+// Currently does not preserve subdirectory relationships.  This class asks
+// how to handle existing files one after another within its own thread, while
+// the files are copied in parallel by an ExportFileCopier.  May be canceled
+// from another thread.
 class TrackExportWorker : public QThread {
     Q_OBJECT
   public:
@@ -48,8 +50,11 @@ class TrackExportWorker : public QThread {
         return m_errorMessage;
     }
 
-    // Cancels the export after the current copy operation.
-    // May be called from another thread.
+    // Cancels the export and aborts the running copy operations.
+    // Files that have already been copied are kept. Files that are
+    // currently being written are deleted, and files that are only
+    // queued for copying are skipped, i.e. existing files at the
+    // destination remain unchanged. May be called from another thread.
     void stop();
 
   signals:
@@ -62,16 +67,25 @@ class TrackExportWorker : public QThread {
             const QString& filename,
             std::promise<TrackExportWorker::OverwriteAnswer>* promise);
     void progress(const QString& filename, int progress, int count);
+    // Emitted after each file with the estimated time until all files
+    // have been exported.
+    void transferRate(double bytesPerSecond, double remainingSeconds);
     void canceled();
 
   private:
-    // Copies the file at source_fileinfo to the destination directory with the
-    // name given by dest_filename (not a full path).  If the destination file
-    // exists, will emit an overwrite request signal to ask how to proceed.
+    // Decides if the file at source_fileinfo should be copied to dest_path.
+    // If the destination file exists, will emit an overwrite request signal
+    // to ask how to proceed.  Stops the export process entirely if the user
+    // cancels.
+    bool confirmCopy(const mixxx::FileInfo& source_fileinfo,
+            const QString& dest_path);
+
     // On unrecoverable error, sets the error message and stops the export
     // process entirely.
-    void copyFile(const mixxx::FileInfo& source_fileinfo,
-            const QString& dest_filename);
+    void handleCopyResult(const mixxx::ExportFileCopier::Result& result);
+
+    // Updates the progress after a file has been copied or skipped.
+    void fileFinished(const QString& filename, qint64 sizeInBytes);
 
     // Emit a signal requesting overwrite mode, and block until we get an
     // answer.  Updates m_overwriteMode appropriately.
@@ -83,4 +97,9 @@ class TrackExportWorker : public QThread {
     OverwriteMode m_overwriteMode = OverwriteMode::ASK;
     const QString m_destDir;
     const TrackPointerList m_tracks;
+
+    mixxx::ExportFileCopier m_fileCopier;
+    int m_progress = 0;
+    int m_progressCount = 0;
+    qint64 m_remainingBytes = 0;
 };
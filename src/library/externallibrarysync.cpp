@@ -0,0 +1,233 @@
+#include "library/externallibrarysync.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "library/queryutil.h"
+#include "util/assert.h"
+
+QString externalLibraryFileFingerprint(const QString& filePath) {
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists()) {
+        return QString();
+    }
+    return fileInfo.absoluteFilePath() + QChar('|') +
+            QString::number(fileInfo.size()) + QChar('|') +
+            QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+ExternalLibraryTableSync::ExternalLibraryTableSync(const QSqlDatabase& database,
+        const QString& tableName,
+        const QString& keyColumn,
+        const QStringList& valueColumns)
+        : m_database(database),
+          m_tableName(tableName),
+          m_keyColumn(keyColumn),
+          m_valueColumns(valueColumns),
+          m_insertQuery(database),
+          m_updateQuery(database) {
+}
+
+// static
+std::optional<QString> ExternalLibraryTableSync::rowValue(const QVariant& value) {
+    if (value.isNull()) {
+        return std::nullopt;
+    }
+    return value.toString();
+}
+
+bool ExternalLibraryTableSync::load() {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    QStringList columns = m_valueColumns;
+    columns.prepend(m_keyColumn);
+    if (!query.exec(QStringLiteral("SELECT %1 FROM %2")
+                            .arg(columns.join(QChar(',')), m_tableName))) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    m_existingRows.clear();
+    m_writtenKeys.clear();
+    while (query.next()) {
+        RowValues values;
+        values.reserve(m_valueColumns.size());
+        for (int i = 0; i < m_valueColumns.size(); ++i) {
+            values.append(rowValue(query.value(i + 1)));
+        }
+        m_existingRows.insert(query.value(0).toString(), values);
+    }
+
+    QStringList placeholders;
+    QStringList assignments;
+    for (const auto& column : qAsConst(m_valueColumns)) {
+        placeholders.append(QChar(':') + column);
+        assignments.append(column + QStringLiteral("=:") + column);
+    }
+    m_insertQuery.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (:%3%4)")
+                                  .arg(m_tableName,
+                                          columns.join(QChar(',')),
+                                          m_keyColumn,
+                                          placeholders.isEmpty()
+                                                  ? QString()
+                                                  : QChar(',') +
+                                                          placeholders.join(QChar(','))));
+    if (!m_valueColumns.isEmpty()) {
+        m_updateQuery.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE %3=:%3")
+                                      .arg(m_tableName,
+                                              assignments.join(QChar(',')),
+                                              m_keyColumn));
+    }
+    return true;
+}
+
+bool ExternalLibraryTableSync::write(const QVariant& key, const QVariantList& values) {
+    DEBUG_ASSERT(values.size() == m_valueColumns.size());
+    const QString keyString = key.toString();
+    if (m_writtenKeys.contains(keyString)) {
+        // Duplicate keys would violate the constraints of the table. The
+        // first row wins, like with the INSERT of a full import.
+        return false;
+    }
+    m_writtenKeys.insert(keyString);
+
+    const auto it = m_existingRows.constFind(keyString);
+    QSqlQuery* pQuery;
+    if (it == m_existingRows.constEnd()) {
+        pQuery = &m_insertQuery;
+    } else {
+        RowValues rowValues;
+        rowValues.reserve(values.size());
+        for (const auto& value : values) {
+            rowValues.append(rowValue(value));
+        }
+        if (it.value() == rowValues) {
+            ++m_stats.unchanged;
+            return true;
+        }
+        pQuery = &m_updateQuery;
+    }
+
+    pQuery->bindValue(QChar(':') + m_keyColumn, key);
+    for (int i = 0; i < m_valueColumns.size(); ++i) {
+        pQuery->bindValue(QChar(':') + m_valueColumns.at(i), values.at(i));
+    }
+    if (!pQuery->exec()) {
+        LOG_FAILED_QUERY(*pQuery);
+        return false;
+    }
+    if (pQuery == &m_insertQuery) {
+        ++m_stats.inserted;
+    } else {
+        ++m_stats.updated;
+    }
+    return true;
+}
+
+QList<QVariant> ExternalLibraryTableSync::removeUnwritten() {
+    QList<QVariant> deletedKeys;
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral("DELETE FROM %1 WHERE %2=:key")
+                          .arg(m_tableName, m_keyColumn));
+    for (auto it = m_existingRows.constBegin(); it != m_existingRows.constEnd(); ++it) {
+        if (m_writtenKeys.contains(it.key())) {
+            continue;
+        }
+        query.bindValue(QStringLiteral(":key"), it.key());
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            continue;
+        }
+        deletedKeys.append(it.key());
+        ++m_stats.deleted;
+    }
+    return deletedKeys;
+}
+
+ExternalLibraryPlaylistTracksSync::ExternalLibraryPlaylistTracksSync(
+        const QSqlDatabase& database, const QString& tableName)
+        : m_database(database),
+          m_tableName(tableName),
+          m_insertQuery(database),
+          m_deleteQuery(database),
+          m_numRewrittenPlaylists(0) {
+}
+
+bool ExternalLibraryPlaylistTracksSync::load() {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (!query.exec(QStringLiteral("SELECT playlist_id, track_id FROM %1 "
+                                   "ORDER BY playlist_id, position")
+                            .arg(m_tableName))) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    m_existingTrackIds.clear();
+    m_writtenPlaylistIds.clear();
+    while (query.next()) {
+        m_existingTrackIds[query.value(0).toInt()].append(query.value(1).toInt());
+    }
+
+    m_insertQuery.prepare(QStringLiteral("INSERT INTO %1 (playlist_id, track_id, position) "
+                                         "VALUES (:playlist_id, :track_id, :position)")
+                                  .arg(m_tableName));
+    m_deleteQuery.prepare(QStringLiteral("DELETE FROM %1 WHERE playlist_id=:playlist_id")
+                                  .arg(m_tableName));
+    return true;
+}
+
+bool ExternalLibraryPlaylistTracksSync::write(int playlistId, const QVector<int>& trackIds) {
+    m_writtenPlaylistIds.insert(playlistId);
+    const auto it = m_existingTrackIds.constFind(playlistId);
+    if (it != m_existingTrackIds.constEnd()) {
+        if (it.value() == trackIds) {
+            return true;
+        }
+        if (!remove(playlistId)) {
+            return false;
+        }
+    }
+    ++m_numRewrittenPlaylists;
+    m_insertQuery.bindValue(QStringLiteral(":playlist_id"), playlistId);
+    int position = 1;
+    for (const int trackId : trackIds) {
+        m_insertQuery.bindValue(QStringLiteral(":track_id"), trackId);
+        m_insertQuery.bindValue(QStringLiteral(":position"), position++);
+        if (!m_insertQuery.exec()) {
+            LOG_FAILED_QUERY(m_insertQuery);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ExternalLibraryPlaylistTracksSync::removeUnwritten() {
+    bool result = true;
+    for (auto it = m_existingTrackIds.constBegin(); it != m_existingTrackIds.constEnd(); ++it) {
+        if (!m_writtenPlaylistIds.contains(it.key())) {
+            result = remove(it.key()) && result;
+        }
+    }
+    return result;
+}
+
+bool ExternalLibraryPlaylistTracksSync::remove(int playlistId) {
+    m_deleteQuery.bindValue(QStringLiteral(":playlist_id"), playlistId);
+    if (!m_deleteQuery.exec()) {
+        LOG_FAILED_QUERY(m_deleteQuery);
+        return false;
+    }
+    return true;
+}
+
+int ExternalLibraryImportProgress::update() {
+    const qint64 size = m_pDevice->size();
+    if (size <= 0) {
+        return -1;
+    }
+    const int percent = static_cast<int>(m_pDevice->pos() * 100 / size);
+    if (percent == m_lastPercent) {
+        return -1;
+    }
+    m_lastPercent = percent;
+    return percent;
+}
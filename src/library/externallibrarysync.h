@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QHash>
+#include <QIODevice>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariantList>
+#include <QVector>
+#include <optional>
+
+/// Fingerprint of an external library file, which changes whenever the
+/// file is modified. Returns an empty string if the file does not exist.
+QString externalLibraryFileFingerprint(const QString& filePath);
+
+/// Incrementally applies the rows of a re-imported external library (like
+/// iTunes or Traktor) to a table that still contains the rows of the previous
+/// import. Only inserted, changed and deleted rows are written.
+///
+/// The rows are identified by a key column that must be stable across
+/// imports, e.g. the track ID of iTunes or the location of a Traktor track.
+/// Wrap all writes in a single transaction, so that the models of the
+/// feature keep showing the previous import until it is committed.
+class ExternalLibraryTableSync final {
+  public:
+    struct Stats {
+        int inserted = 0;
+        int updated = 0;
+        int deleted = 0;
+        int unchanged = 0;
+    };
+
+    ExternalLibraryTableSync(const QSqlDatabase& database,
+            const QString& tableName,
+            const QString& keyColumn,
+            const QStringList& valueColumns);
+
+    /// Loads the existing rows, must be called before any write().
+    bool load();
+
+    /// Inserts or updates a row unless it is unchanged. The values are in
+    /// the order of the value columns.
+    bool write(const QVariant& key, const QVariantList& values);
+
+    /// Deletes all existing rows that have not been written since load().
+    /// Returns the keys of the deleted rows.
+    QList<QVariant> removeUnwritten();
+
+    const Stats& stats() const {
+        return m_stats;
+    }
+
+  private:
+    const QSqlDatabase m_database;
+    const QString m_tableName;
+    const QString m_keyColumn;
+    const QStringList m_valueColumns;
+
+    // The keys and values are converted to strings, because QVariant is not
+    // hashable and the types read from the database may differ from the
+    // types that have been bound, e.g. a year as string or integer. NULL
+    // values are std::nullopt, to distinguish them from empty strings.
+    typedef QVector<std::optional<QString>> RowValues;
+    static std::optional<QString> rowValue(const QVariant& value);
+
+    QHash<QString, RowValues> m_existingRows;
+    QSet<QString> m_writtenKeys;
+
+    QSqlQuery m_insertQuery;
+    QSqlQuery m_updateQuery;
+
+    Stats m_stats;
+};
+
+/// Incrementally applies the track lists of re-imported playlists to a
+/// playlist tracks table with the columns playlist_id, track_id and
+/// position. A playlist is only rewritten if its track list has changed.
+class ExternalLibraryPlaylistTracksSync final {
+  public:
+    ExternalLibraryPlaylistTracksSync(const QSqlDatabase& database,
+            const QString& tableName);
+
+    /// Loads the existing track lists, must be called before any write().
+    bool load();
+
+    /// Replaces the track list of a playlist unless it is unchanged.
+    bool write(int playlistId, const QVector<int>& trackIds);
+
+    /// Deletes the track lists of all playlists that have not been written
+    /// since load().
+    bool removeUnwritten();
+
+    int numRewrittenPlaylists() const {
+        return m_numRewrittenPlaylists;
+    }
+
+  private:
+    bool remove(int playlistId);
+
+    const QSqlDatabase m_database;
+    const QString m_tableName;
+
+    QHash<int, QVector<int>> m_existingTrackIds;
+    QSet<int> m_writtenPlaylistIds;
+
+    QSqlQuery m_insertQuery;
+    QSqlQuery m_deleteQuery;
+
+    int m_numRewrittenPlaylists;
+};
+
+/// Tracks the progress of reading an external library file in percent.
+class ExternalLibraryImportProgress final {
+  public:
+    explicit ExternalLibraryImportProgress(const QIODevice* pDevice)
+            : m_pDevice(pDevice),
+              m_lastPercent(-1) {
+    }
+
+    /// Returns the progress if it has changed since the last call, or -1.
+    int update();
+
+  private:
+    const QIODevice* const m_pDevice;
+    int m_lastPercent;
+};
@@ -13,6 +13,7 @@
 #include "library/baseexternaltrackmodel.h"
 #include "library/basetrackcache.h"
 #include "library/dao/settingsdao.h"
+#include "library/externallibrarysync.h"
 #include "library/library.h"
 #include "library/queryutil.h"
 #include "library/trackcollectionmanager.h"
@@ -30,6 +31,25 @@
 namespace {
 
 const QString ITDB_PATH_KEY = "mixxx.itunesfeature.itdbpath";
+const QString ITDB_FINGERPRINT_KEY = "mixxx.itunesfeature.itdbfingerprint";
+
+// The value columns of itunes_library, in the order of parseTrack()
+const QStringList kTrackValueColumns = {
+        QStringLiteral("artist"),
+        QStringLiteral("title"),
+        QStringLiteral("album"),
+        QStringLiteral("album_artist"),
+        QStringLiteral("year"),
+        QStringLiteral("genre"),
+        QStringLiteral("grouping"),
+        QStringLiteral("comment"),
+        QStringLiteral("tracknumber"),
+        QStringLiteral("bpm"),
+        QStringLiteral("bitrate"),
+        QStringLiteral("duration"),
+        QStringLiteral("location"),
+        QStringLiteral("rating"),
+};
 
 const QString kDict = "dict";
 const QString kKey = "key";
@@ -166,14 +186,8 @@ void ITunesFeature::activate() {
 void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
     if (!m_isActivated || forceReload) {
-
-        //Delete all table entries of iTunes feature
-        ScopedTransaction transaction(m_database);
-        clearTable("itunes_playlist_tracks");
-        clearTable("itunes_library");
-        clearTable("itunes_playlists");
-        transaction.commit();
-
+        // The tables still contain the previous import, which stays visible
+        // until the import thread has committed the changes.
         emit showTrackModel(m_pITunesTrackModel);
 
         SettingsDAO settings(m_pTrackCollection->database());
@@ -251,7 +265,7 @@ void ITunesFeature::onRightClick(const QPoint& globalPos) {
     if (chosen == &useDefault) {
         SettingsDAO settings(m_database);
         settings.setValue(ITDB_PATH_KEY, QString());
-        activate(true); // clears tables before parsing
+        activate(true); // re-imports the library
     } else if (chosen == &chooseNew) {
         SettingsDAO settings(m_database);
         QString dbfile = QFileDialog::getOpenFileName(
@@ -269,7 +283,7 @@ void ITunesFeature::onRightClick(const QPoint& globalPos) {
         Sandbox::createSecurityToken(&dbFileInfo);
 
         settings.setValue(ITDB_PATH_KEY, dbfile);
-        activate(true); // clears tables before parsing
+        activate(true); // re-imports the library
     }
 }
 
@@ -382,6 +396,18 @@ TreeItem* ITunesFeature::importLibrary() {
 
     qDebug() << "ITunesFeature::importLibrary() ";
 
+    // Skip parsing if the file has not changed since the last import, the
+    // tables still contain its contents.
+    SettingsDAO settings(m_database);
+    const QString fingerprint = externalLibraryFileFingerprint(m_dbfile);
+    if (!fingerprint.isEmpty() &&
+            settings.getValue(ITDB_FINGERPRINT_KEY) == fingerprint) {
+        qDebug() << "iTunes music collection is unchanged since the last import";
+        return loadPlaylistsFromDatabase();
+    }
+
+    // All changes are applied in a single transaction. The models of this
+    // feature keep showing the previous import until it is committed.
     ScopedTransaction transaction(m_database);
 
     // By default set m_mixxxItunesRoot and m_dbItunesRoot to strip out
@@ -399,6 +425,20 @@ TreeItem* ITunesFeature::importLibrary() {
         return nullptr;
     }
 
+    ExternalLibraryTableSync trackSync(m_database,
+            QStringLiteral("itunes_library"),
+            QStringLiteral("id"),
+            kTrackValueColumns);
+    ExternalLibraryPlaylistTracksSync playlistTracksSync(m_database,
+            QStringLiteral("itunes_playlist_tracks"));
+    if (!trackSync.load() || !playlistTracksSync.load()) {
+        return nullptr;
+    }
+    // Playlists are few compared to tracks, so they are simply rewritten.
+    // Their ids are stable across imports.
+    clearTable("itunes_playlists");
+
+    ExternalLibraryImportProgress progress(&itunes_file);
     QXmlStreamReader xml(&itunes_file);
     TreeItem* playlist_root = nullptr;
     while (!xml.atEnd() && !m_cancelImport) {
@@ -414,11 +454,11 @@ TreeItem* ITunesFeature::importLibrary() {
                         guessMusicLibraryMountpoint(xml);
                     }
                 } else if (key == "Tracks") {
-                    parseTracks(xml);
+                    parseTracks(xml, &trackSync, &progress);
                     if (playlist_root != nullptr) {
                         delete playlist_root;
                     }
-                    playlist_root = parsePlaylists(xml);
+                    playlist_root = parsePlaylists(xml, &playlistTracksSync, &progress);
                     isTracksParsed = true;
                 }
             }
@@ -427,6 +467,24 @@ TreeItem* ITunesFeature::importLibrary() {
 
     itunes_file.close();
 
+    if (xml.hasError() || m_cancelImport) {
+        // Roll back the transaction, a half-parsed file must not replace
+        // the previous import.
+        qDebug() << "Abort processing iTunes music collection";
+        if (xml.hasError()) {
+            qDebug() << "line:" << xml.lineNumber() <<
+                    "column:" << xml.columnNumber() <<
+                    "error:" << xml.errorString();
+        }
+        if (playlist_root) {
+            delete playlist_root;
+        }
+        return nullptr;
+    }
+
+    trackSync.removeUnwritten();
+    playlistTracksSync.removeUnwritten();
+
     if (isMusicFolderLocatedAfterTracks) {
         qDebug() << "Updating iTunes real path from " << m_dbItunesRoot << " to " << m_mixxxItunesRoot;
         // In some iTunes files "Music Folder" XML node is located at the end of file. So, we need to
@@ -441,35 +499,53 @@ TreeItem* ITunesFeature::importLibrary() {
         }
     }
 
-    // Even if an error occurred, commit the transaction. The file may have been
-    // half-parsed.
+    settings.setValue(ITDB_FINGERPRINT_KEY, fingerprint);
     transaction.commit();
 
-    if (xml.hasError()) {
-        // do error handling
-        qDebug() << "Abort processing iTunes music collection";
-        qDebug() << "line:" << xml.lineNumber() <<
-                "column:" << xml.columnNumber() <<
-                "error:" << xml.errorString();
-        if (playlist_root) {
-            delete playlist_root;
-        }
-        playlist_root = nullptr;
-    }
+    const ExternalLibraryTableSync::Stats& stats = trackSync.stats();
+    qDebug() << "iTunes music collection imported:"
+             << stats.inserted << "tracks inserted,"
+             << stats.updated << "updated,"
+             << stats.deleted << "deleted,"
+             << stats.unchanged << "unchanged,"
+             << playlistTracksSync.numRewrittenPlaylists() << "playlists rewritten";
     return playlist_root;
 }
 
-void ITunesFeature::parseTracks(QXmlStreamReader& xml) {
+// This method is executed in a separate thread
+// via QtConcurrent::run
+TreeItem* ITunesFeature::loadPlaylistsFromDatabase() {
+    std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT name FROM itunes_playlists ORDER BY id")) {
+        LOG_FAILED_QUERY(query);
+        return nullptr;
+    }
+    while (query.next()) {
+        pRootItem->appendChild(query.value(0).toString());
+    }
+    return pRootItem.release();
+}
+
+void ITunesFeature::reportImportProgress(int percent) {
+    QMetaObject::invokeMethod(
+            this,
+            [this, percent] {
+                if (!m_future.isRunning()) {
+                    return;
+                }
+                m_title = tr("(loading %1%) iTunes").arg(percent);
+                emit featureIsLoading(this, false);
+            },
+            Qt::QueuedConnection);
+}
+
+void ITunesFeature::parseTracks(QXmlStreamReader& xml,
+        ExternalLibraryTableSync* pTrackSync,
+        ExternalLibraryImportProgress* pProgress) {
     bool in_container_dictionary = false;
     bool in_track_dictionary = false;
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO itunes_library (id, artist, title, album, album_artist, year, genre, grouping, comment, tracknumber,"
-                  "bpm, bitrate,"
-                  "duration, location,"
-                  "rating ) "
-                  "VALUES (:id, :artist, :title, :album, :album_artist, :year, :genre, :grouping, :comment, :tracknumber,"
-                  ":bpm, :bitrate,"
-                  ":duration, :location," ":rating )");
 
     qDebug() << "Parse iTunes music collection";
 
@@ -486,7 +562,11 @@ void ITunesFeature::parseTracks(QXmlStreamReader& xml) {
                     // We are in a <dict> tag that holds track information
                     in_track_dictionary = true;
                     // Parse track here
-                    parseTrack(xml, query);
+                    parseTrack(xml, pTrackSync);
+                    const int percent = pProgress->update();
+                    if (percent >= 0) {
+                        reportImportProgress(percent);
+                    }
                 }
             }
         }
@@ -503,7 +583,7 @@ void ITunesFeature::parseTracks(QXmlStreamReader& xml) {
     }
 }
 
-void ITunesFeature::parseTrack(QXmlStreamReader& xml, QSqlQuery& query) {
+void ITunesFeature::parseTrack(QXmlStreamReader& xml, ExternalLibraryTableSync* pTrackSync) {
     //qDebug() << "----------------TRACK-----------------";
     int id = -1;
     QString title;
@@ -625,51 +705,45 @@ void ITunesFeature::parseTrack(QXmlStreamReader& xml, QSqlQuery& query) {
     }
 
     // If we reach the end of <dict>
-    // Save parsed track to database
-    query.bindValue(":id", id);
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":album_artist", album_artist);
-    query.bindValue(":genre", genre);
-    query.bindValue(":grouping", grouping);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-
-    bool success = query.exec();
-
-    if (!success) {
-        LOG_FAILED_QUERY(query);
-        return;
-    }
+    // Save parsed track to database, unless it is unchanged
+    pTrackSync->write(id,
+            QVariantList{artist,
+                    title,
+                    album,
+                    album_artist,
+                    year,
+                    genre,
+                    grouping,
+                    comment,
+                    tracknumber,
+                    bpm,
+                    bitrate,
+                    playtime,
+                    location,
+                    rating});
 }
 
-TreeItem* ITunesFeature::parsePlaylists(QXmlStreamReader& xml) {
+TreeItem* ITunesFeature::parsePlaylists(QXmlStreamReader& xml,
+        ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync,
+        ExternalLibraryImportProgress* pProgress) {
     qDebug() << "Parse iTunes playlists";
     std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
     QSqlQuery query_insert_to_playlists(m_database);
     query_insert_to_playlists.prepare("INSERT INTO itunes_playlists (id, name) "
                                       "VALUES (:id, :name)");
 
-    QSqlQuery query_insert_to_playlist_tracks(m_database);
-    query_insert_to_playlist_tracks.prepare(
-        "INSERT INTO itunes_playlist_tracks (playlist_id, track_id, position) "
-        "VALUES (:playlist_id, :track_id, :position)");
-
     while (!xml.atEnd() && !m_cancelImport) {
         xml.readNext();
         //We process and iterate the <dict> tags holding playlist summary information here
         if (xml.isStartElement() && xml.name() == kDict) {
             parsePlaylist(xml,
                           query_insert_to_playlists,
-                          query_insert_to_playlist_tracks,
+                          pPlaylistTracksSync,
                           pRootItem.get());
+            const int percent = pProgress->update();
+            if (percent >= 0) {
+                reportImportProgress(percent);
+            }
             continue;
         }
         if (xml.isEndElement()) {
@@ -692,17 +766,20 @@ bool ITunesFeature::readNextStartElement(QXmlStreamReader& xml) {
     return false;
 }
 
-void ITunesFeature::parsePlaylist(QXmlStreamReader& xml, QSqlQuery& query_insert_to_playlists,
-                                  QSqlQuery& query_insert_to_playlist_tracks, TreeItem* root) {
+void ITunesFeature::parsePlaylist(QXmlStreamReader& xml,
+        QSqlQuery& query_insert_to_playlists,
+        ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync,
+        TreeItem* root) {
     //qDebug() << "Parse Playlist";
 
     QString playlistname;
     int playlist_id = -1;
-    int playlist_position = -1;
     int track_reference = -1;
     //indicates that we haven't found the <
     bool isSystemPlaylist = false;
     bool isPlaylistItemsStarted = false;
+    bool isPlaylistInserted = false;
+    QVector<int> trackIds;
 
     //We process and iterate the <dict> tags holding playlist summary information here
     while (!xml.atEnd() && !m_cancelImport) {
@@ -725,7 +802,6 @@ void ITunesFeature::parsePlaylist(QXmlStreamReader& xml, QSqlQuery& query_insert
                 if (key == "Playlist ID") {
                     readNextStartElement(xml);
                     playlist_id = xml.readElementText().toInt();
-                    playlist_position = 1;
                     continue;
                 }
                 //Hide playlists that are system playlists
@@ -766,6 +842,7 @@ void ITunesFeature::parsePlaylist(QXmlStreamReader& xml, QSqlQuery& query_insert
                     }
                     //append the playlist to the child model
                     root->appendChild(playlistname);
+                    isPlaylistInserted = true;
                 }
                 // When processing playlist entries, playlist name and id have
                 // already been processed and persisted
@@ -773,19 +850,7 @@ void ITunesFeature::parsePlaylist(QXmlStreamReader& xml, QSqlQuery& query_insert
 
                     readNextStartElement(xml);
                     track_reference = xml.readElementText().toInt();
-
-                    query_insert_to_playlist_tracks.bindValue(":playlist_id", playlist_id);
-                    query_insert_to_playlist_tracks.bindValue(":track_id", track_reference);
-                    query_insert_to_playlist_tracks.bindValue(":position", playlist_position++);
-
-                    //Insert tracks if we are not in a pre-build playlist
-                    if (!isSystemPlaylist && !query_insert_to_playlist_tracks.exec()) {
-                        qDebug() << "SQL Error in ITunesFeature.cpp: line" << __LINE__ << " "
-                                 << query_insert_to_playlist_tracks.lastError();
-                        qDebug() << "trackid" << track_reference;
-                        qDebug() << "playlistname; " << playlistname;
-                        qDebug() << "-----------------";
-                    }
+                    trackIds.append(track_reference);
                 }
             }
         }
@@ -800,6 +865,12 @@ void ITunesFeature::parsePlaylist(QXmlStreamReader& xml, QSqlQuery& query_insert
             }
         }
     }
+
+    //Insert tracks if we are not in a pre-build playlist
+    if (isPlaylistInserted &&
+            !pPlaylistTracksSync->write(playlist_id, trackIds)) {
+        qDebug() << "Failed to write the tracks of iTunes playlist" << playlistname;
+    }
 }
 
 void ITunesFeature::clearTable(const QString& table_name) {
@@ -15,6 +15,9 @@
 
 class BaseExternalTrackModel;
 class BaseExternalPlaylistModel;
+class ExternalLibraryImportProgress;
+class ExternalLibraryPlaylistTracksSync;
+class ExternalLibraryTableSync;
 class WLibrarySidebar;
 
 class ITunesFeature : public BaseExternalLibraryFeature {
@@ -41,13 +44,23 @@ class ITunesFeature : public BaseExternalLibraryFeature {
     static QString getiTunesMusicPath();
     // returns the invisible rootItem for the sidebar model
     TreeItem* importLibrary();
+    // builds the sidebar model from the playlists of the previous import
+    TreeItem* loadPlaylistsFromDatabase();
     void guessMusicLibraryMountpoint(QXmlStreamReader& xml);
-    void parseTracks(QXmlStreamReader& xml);
-    void parseTrack(QXmlStreamReader& xml, QSqlQuery& query);
-    TreeItem* parsePlaylists(QXmlStreamReader &xml);
-    void parsePlaylist(QXmlStreamReader& xml, QSqlQuery& query1,
-                       QSqlQuery &query2, TreeItem*);
+    void parseTracks(QXmlStreamReader& xml,
+            ExternalLibraryTableSync* pTrackSync,
+            ExternalLibraryImportProgress* pProgress);
+    void parseTrack(QXmlStreamReader& xml, ExternalLibraryTableSync* pTrackSync);
+    TreeItem* parsePlaylists(QXmlStreamReader& xml,
+            ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync,
+            ExternalLibraryImportProgress* pProgress);
+    void parsePlaylist(QXmlStreamReader& xml,
+            QSqlQuery& query_insert_to_playlists,
+            ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync,
+            TreeItem* root);
     void clearTable(const QString& table_name);
+    // called from the import thread
+    void reportImportProgress(int percent);
     bool readNextStartElement(QXmlStreamReader& xml);
 
     BaseExternalTrackModel* m_pITunesTrackModel;
@@ -64,3 +64,18 @@ const ConfigKey mixxx::library::prefs::kUseRelativePathOnExportConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("UseRelativePathOnExport")};
+
+const ConfigKey mixxx::library::prefs::kTrackCacheWindowSizeConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("TrackCacheWindowSize")};
+
+const ConfigKey mixxx::library::prefs::kCoverArtDiskCacheSizeConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("CoverArtDiskCacheSizeMB")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseWriteAheadLog")};
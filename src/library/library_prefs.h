@@ -40,6 +40,31 @@ extern const ConfigKey kSyncSeratoMetadataConfigKey;
 
 extern const ConfigKey kUseRelativePathOnExportConfigKey;
 
+/// The maximum number of tracks that are kept in memory by the track
+/// source of the internal library. The remaining tracks are fetched
+/// on demand while scrolling. 0 keeps all tracks in memory.
+extern const ConfigKey kTrackCacheWindowSizeConfigKey;
+
+const int kTrackCacheWindowSizeDefault = 0;
+
+/// Smaller windows are enlarged to hold the visible rows of all
+/// table models that share the track source.
+const int kTrackCacheWindowSizeMin = 2048;
+
+/// The maximum size of the cover art thumbnails that are stored on
+/// disk in megabytes. 0 disables the persistent thumbnail cache.
+extern const ConfigKey kCoverArtDiskCacheSizeConfigKey;
+
+const int kCoverArtDiskCacheSizeDefault = 256;
+
+/// Open the database in write-ahead log mode. Readers and the writer
+/// don't block each other in this mode. Always disabled if the settings
+/// directory is located on a detected network filesystem. Disable it
+/// manually for network filesystems that are not detected.
+extern const ConfigKey kDatabaseWriteAheadLogConfigKey;
+
+const bool kDatabaseWriteAheadLogDefault = true;
+
 } // namespace prefs
 
 } // namespace library
@@ -0,0 +1,318 @@
+#include "library/libraryquerythread.h"
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#ifdef __SQLITE3__
+#include <sqlite3.h>
+#endif // __SQLITE3__
+
+#include "library/queryutil.h"
+#include "moc_libraryquerythread.cpp"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryQueryThread");
+
+// Appends the view after the views it depends on
+void appendTemporaryView(const QString& viewName,
+        const QHash<QString, QString>& allViews,
+        QSet<QString>* pVisitedViews,
+        LibraryQueryTemporaryViews* pTemporaryViews) {
+    if (pVisitedViews->contains(viewName)) {
+        return;
+    }
+    pVisitedViews->insert(viewName);
+    const QString sql = allViews.value(viewName);
+    for (auto it = allViews.constBegin(); it != allViews.constEnd(); ++it) {
+        if (it.key() == viewName) {
+            continue;
+        }
+        // Might also match a string literal or column with the same name,
+        // which only creates an unused view
+        const QRegularExpression reference(
+                QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(it.key())),
+                QRegularExpression::CaseInsensitiveOption);
+        if (sql.contains(reference)) {
+            appendTemporaryView(it.key(), allViews, pVisitedViews, pTemporaryViews);
+        }
+    }
+    pTemporaryViews->append(qMakePair(viewName, sql));
+}
+
+} // anonymous namespace
+
+//static
+LibraryQueryTemporaryViews LibraryQueryThread::temporaryViews(
+        const QSqlDatabase& database,
+        const QStringList& viewNames) {
+    QHash<QString, QString> allViews;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.exec(QStringLiteral(
+                "SELECT name,sql FROM sqlite_temp_master WHERE type='view'"))) {
+        LOG_FAILED_QUERY(query);
+        return LibraryQueryTemporaryViews();
+    }
+    const QString kCreateView = QStringLiteral("CREATE VIEW");
+    while (query.next()) {
+        // SQLite stores the statement without the TEMPORARY keyword
+        QString sql = query.value(1).toString();
+        VERIFY_OR_DEBUG_ASSERT(sql.startsWith(kCreateView, Qt::CaseInsensitive)) {
+            continue;
+        }
+        sql.replace(0, kCreateView.size(), QStringLiteral("CREATE TEMPORARY VIEW"));
+        allViews.insert(query.value(0).toString(), sql);
+    }
+
+    LibraryQueryTemporaryViews temporaryViews;
+    QSet<QString> visitedViews;
+    for (const auto& viewName : viewNames) {
+        if (allViews.contains(viewName)) {
+            appendTemporaryView(viewName, allViews, &visitedViews, &temporaryViews);
+        }
+    }
+    return temporaryViews;
+}
+
+LibraryQueryThread::LibraryQueryThread(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_nextRequestId(1),
+          m_runningRequestId(0),
+          m_runningRequestCancelled(false),
+          m_pSqliteHandle(nullptr),
+          m_bStopThread(false) {
+    start(QThread::LowPriority);
+}
+
+LibraryQueryThread::~LibraryQueryThread() {
+    kLogger.debug() << "Wait to finish library query thread";
+    {
+        QMutexLocker locker(&m_mutex);
+        m_bStopThread = true;
+        m_pendingRequests.clear();
+        if (m_runningRequestId != 0) {
+            cancelRequestLocked(m_runningRequestId);
+        }
+        m_requestSubmitted.wakeAll();
+    }
+    wait();
+    kLogger.debug() << "Library query thread terminated";
+}
+
+void LibraryQueryThread::submit(const QObject* pRequester,
+        LibraryQueryRequest request,
+        ResultCallback resultCallback) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    cancel(pRequester);
+
+    const quint64 requestId = m_nextRequestId++;
+    m_requestIdsByRequester.insert(pRequester, requestId);
+    m_resultCallbacks.insert(requestId, std::move(resultCallback));
+
+    QMutexLocker locker(&m_mutex);
+    m_pendingRequests.enqueue(PendingRequest{requestId, std::move(request)});
+    m_requestSubmitted.wakeAll();
+}
+
+void LibraryQueryThread::cancel(const QObject* pRequester) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    const quint64 requestId = m_requestIdsByRequester.take(pRequester);
+    if (requestId == 0) {
+        return;
+    }
+    m_resultCallbacks.remove(requestId);
+
+    QMutexLocker locker(&m_mutex);
+    cancelRequestLocked(requestId);
+}
+
+void LibraryQueryThread::cancelRequestLocked(quint64 requestId) {
+    if (requestId == m_runningRequestId) {
+        m_runningRequestCancelled = true;
+#ifdef __SQLITE3__
+        // Aborts the statement that is currently executed on the
+        // connection of this thread. It is safe to call this function
+        // from a different thread while the connection is open.
+        if (m_pSqliteHandle) {
+            sqlite3_interrupt(m_pSqliteHandle);
+        }
+#endif // __SQLITE3__
+        return;
+    }
+    for (auto it = m_pendingRequests.begin(); it != m_pendingRequests.end(); ++it) {
+        if (it->id == requestId) {
+            m_pendingRequests.erase(it);
+            return;
+        }
+    }
+}
+
+bool LibraryQueryThread::isRunningRequestCancelled() {
+    QMutexLocker locker(&m_mutex);
+    return m_runningRequestCancelled;
+}
+
+void LibraryQueryThread::run() {
+    QThread::currentThread()->setObjectName("LibraryQueryThread");
+    // The pooler limits the lifetime of the thread-local database
+    // connection to the lifetime of this thread.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    VERIFY_OR_DEBUG_ASSERT(database.isOpen()) {
+        kLogger.warning() << "No database connection available";
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+#ifdef __SQLITE3__
+    const QVariant handle = database.driver()->handle();
+    if (handle.isValid() && strcmp(handle.typeName(), "sqlite3*") == 0) {
+        m_pSqliteHandle = *static_cast<sqlite3* const*>(handle.constData());
+    }
+#endif // __SQLITE3__
+    while (!m_bStopThread) {
+        if (m_pendingRequests.isEmpty()) {
+            m_requestSubmitted.wait(&m_mutex);
+            continue;
+        }
+        const PendingRequest pendingRequest = m_pendingRequests.dequeue();
+        m_runningRequestId = pendingRequest.id;
+        m_runningRequestCancelled = false;
+        locker.unlock();
+
+        PerformanceTimer time;
+        time.start();
+        LibraryQueryResult result = execute(database, pendingRequest.request);
+        if (result.succeeded) {
+            kLogger.debug()
+                    << "Executing request"
+                    << pendingRequest.id
+                    << "took"
+                    << time.elapsed().debugMillisWithUnit();
+        }
+
+        locker.relock();
+        if (!m_runningRequestCancelled) {
+            // The callback is looked up and invoked in the GUI thread,
+            // the request might have been cancelled in the meantime
+            const quint64 requestId = pendingRequest.id;
+            QMetaObject::invokeMethod(
+                    this,
+                    [this, requestId, result = std::move(result)]() mutable {
+                        deliverResult(requestId, std::move(result));
+                    },
+                    Qt::QueuedConnection);
+        }
+        m_runningRequestId = 0;
+        m_runningRequestCancelled = false;
+    }
+    m_pSqliteHandle = nullptr;
+}
+
+void LibraryQueryThread::deliverResult(quint64 requestId, LibraryQueryResult result) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    const ResultCallback resultCallback = m_resultCallbacks.take(requestId);
+    if (!resultCallback) {
+        // Superseded or cancelled
+        return;
+    }
+    for (auto it = m_requestIdsByRequester.begin(); it != m_requestIdsByRequester.end(); ++it) {
+        if (it.value() == requestId) {
+            m_requestIdsByRequester.erase(it);
+            break;
+        }
+    }
+    resultCallback(std::move(result));
+}
+
+bool LibraryQueryThread::createTemporaryViews(const QSqlDatabase& database,
+        const LibraryQueryTemporaryViews& temporaryViews) {
+    // Dependencies are created first. SQLite only resolves the views
+    // that a view depends on when it is queried.
+    for (const auto& temporaryView : temporaryViews) {
+        const QString& viewName = temporaryView.first;
+        const QString& sql = temporaryView.second;
+        if (m_createdViews.value(viewName) == sql) {
+            continue;
+        }
+        QSqlQuery query(database);
+        if (!query.exec(QStringLiteral("DROP VIEW IF EXISTS temp.\"%1\"").arg(viewName))) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        if (!query.exec(sql)) {
+            LOG_FAILED_QUERY(query);
+            m_createdViews.remove(viewName);
+            return false;
+        }
+        m_createdViews.insert(viewName, sql);
+    }
+    return true;
+}
+
+LibraryQueryResult LibraryQueryThread::execute(const QSqlDatabase& database,
+        const LibraryQueryRequest& request) {
+    LibraryQueryResult result;
+    if (!createTemporaryViews(database, request.temporaryViews)) {
+        return result;
+    }
+
+    QSqlQuery query(database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    query.setForwardOnly(true);
+    if (!query.prepare(request.tableQuery) || !query.exec()) {
+        if (!isRunningRequestCancelled()) {
+            LOG_FAILED_QUERY(query);
+        }
+        return result;
+    }
+    const int columnCount = query.record().count();
+    while (query.next()) {
+        QVector<QVariant> row;
+        row.reserve(columnCount);
+        for (int i = 0; i < columnCount; ++i) {
+            row.push_back(query.value(i));
+        }
+        result.tableRows.push_back(std::move(row));
+    }
+    if (isRunningRequestCancelled()) {
+        return result;
+    }
+    if (query.lastError().isValid()) {
+        LOG_FAILED_QUERY(query);
+        return result;
+    }
+
+    if (!request.trackSourceQuery.isEmpty()) {
+        if (!query.prepare(request.trackSourceQuery) || !query.exec()) {
+            if (!isRunningRequestCancelled()) {
+                LOG_FAILED_QUERY(query);
+            }
+            return result;
+        }
+        while (query.next()) {
+            result.trackSourceOrder.append(TrackId(query.value(0)));
+        }
+        if (isRunningRequestCancelled()) {
+            return result;
+        }
+        if (query.lastError().isValid()) {
+            LOG_FAILED_QUERY(query);
+            return result;
+        }
+    }
+
+    result.succeeded = true;
+    return result;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QQueue>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QThread>
+#include <QVariant>
+#include <QVector>
+#include <QWaitCondition>
+#include <functional>
+
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+struct sqlite3;
+
+/// The names of temporary views and the SQL that creates them, ordered
+/// such that each view follows the views it depends on.
+typedef QList<QPair<QString, QString>> LibraryQueryTemporaryViews;
+
+/// The queries of a table model that are executed by LibraryQueryThread.
+struct LibraryQueryRequest {
+    /// The temporary views of the GUI connection that are referenced
+    /// by the queries, see LibraryQueryThread::temporaryViews().
+    /// Temporary views are private to a connection and are recreated
+    /// on the connection of the thread.
+    LibraryQueryTemporaryViews temporaryViews;
+    /// Selects the rows of the table, the first column contains the id.
+    QString tableQuery;
+    /// Selects the ordered ids of the tracks in the track source. Optional.
+    QString trackSourceQuery;
+};
+
+struct LibraryQueryResult {
+    bool succeeded = false;
+    QVector<QVector<QVariant>> tableRows;
+    QVector<TrackId> trackSourceOrder;
+};
+
+/// Executes the queries of library table models on a separate database
+/// connection, so that filtering and sorting large tables does not block
+/// the GUI thread.
+///
+/// Each requester has at most one request in flight. Submitting a new
+/// request supersedes the previous one: a pending request is dropped and
+/// a running query is interrupted. Results are delivered in the thread
+/// of the LibraryQueryThread object, i.e. the GUI thread, and only if the
+/// request has neither been superseded nor cancelled.
+///
+/// The reads do not block writes on the GUI connection only if the
+/// database is in write-ahead log mode. In rollback journal mode a
+/// long-running query delays writes until it has finished or has been
+/// cancelled.
+class LibraryQueryThread : public QThread {
+    Q_OBJECT
+  public:
+    typedef std::function<void(LibraryQueryResult)> ResultCallback;
+
+    explicit LibraryQueryThread(mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~LibraryQueryThread() override;
+
+    /// Returns the temporary views of the connection with the given names,
+    /// including all temporary views they depend on, directly or
+    /// indirectly. Names that are not temporary views are ignored.
+    static LibraryQueryTemporaryViews temporaryViews(
+            const QSqlDatabase& database,
+            const QStringList& viewNames);
+
+    /// Must be called from the GUI thread.
+    void submit(const QObject* pRequester,
+            LibraryQueryRequest request,
+            ResultCallback resultCallback);
+    /// Cancels the request of the requester, e.g. before it is destroyed.
+    /// Must be called from the GUI thread.
+    void cancel(const QObject* pRequester);
+
+  protected:
+    void run() override;
+
+  private:
+    struct PendingRequest {
+        quint64 id;
+        LibraryQueryRequest request;
+    };
+
+    bool createTemporaryViews(const QSqlDatabase& database,
+            const LibraryQueryTemporaryViews& temporaryViews);
+    LibraryQueryResult execute(const QSqlDatabase& database,
+            const LibraryQueryRequest& request);
+    bool isRunningRequestCancelled();
+    // Must be called with m_mutex locked
+    void cancelRequestLocked(quint64 requestId);
+    void deliverResult(quint64 requestId, LibraryQueryResult result);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    // Only accessed from the GUI thread
+    QHash<const QObject*, quint64> m_requestIdsByRequester;
+    QHash<quint64, ResultCallback> m_resultCallbacks;
+    quint64 m_nextRequestId;
+
+    // Only accessed from this thread
+    QHash<QString, QString> m_createdViews;
+
+    // You must hold m_mutex to touch the following members
+    QMutex m_mutex;
+    QWaitCondition m_requestSubmitted;
+    QQueue<PendingRequest> m_pendingRequests;
+    quint64 m_runningRequestId;
+    bool m_runningRequestCancelled;
+    sqlite3* m_pSqliteHandle;
+    bool m_bStopThread;
+};
@@ -1,6 +1,7 @@
 #include "library/mixxxlibraryfeature.h"
 
 #include <QtDebug>
+#include <algorithm>
 #ifdef __ENGINEPRIME__
 #include <QMenu>
 #endif
@@ -11,6 +12,7 @@
 #include "library/dlgmissing.h"
 #include "library/hiddentablemodel.h"
 #include "library/library.h"
+#include "library/library_prefs.h"
 #include "library/librarytablemodel.h"
 #include "library/missingtablemodel.h"
 #include "library/parser.h"
@@ -65,6 +67,16 @@ const QStringList DEFAULT_COLUMNS = {
         LIBRARYTABLE_COVERART_DIGEST,
         LIBRARYTABLE_COVERART_HASH};
 
+const QStringList kSortKeyColumns = {
+        LIBRARYTABLE_ARTIST_SORTKEY,
+        LIBRARYTABLE_TITLE_SORTKEY,
+        LIBRARYTABLE_ALBUM_SORTKEY,
+        LIBRARYTABLE_ALBUMARTIST_SORTKEY,
+        LIBRARYTABLE_GENRE_SORTKEY,
+        LIBRARYTABLE_COMPOSER_SORTKEY,
+        LIBRARYTABLE_GROUPING_SORTKEY,
+        LIBRARYTABLE_COMMENT_SORTKEY};
+
 } // namespace
 
 MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
@@ -83,6 +95,14 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
         qualifiedTableColumns.append(mixxx::trackschema::tableForColumn(col) +
                 QLatin1Char('.') + col);
     }
+    // The sort key columns are only needed for ORDER BY and
+    // not selected by BaseTrackCache
+    const bool sortKeysEnabled = m_pTrackCollection->getTrackDAO().hasSortKeys();
+    if (sortKeysEnabled) {
+        for (const auto& col : kSortKeyColumns) {
+            qualifiedTableColumns.append(QStringLiteral("library.") + col);
+        }
+    }
 
     QSqlQuery query(m_pTrackCollection->database());
     QString tableName = "library_cache_view";
@@ -97,7 +117,14 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
     }
 
     BaseTrackCache* pBaseTrackCache = new BaseTrackCache(
-            m_pTrackCollection, tableName, LIBRARYTABLE_ID, columns, true);
+            m_pTrackCollection, tableName, LIBRARYTABLE_ID, columns, true, sortKeysEnabled);
+    const int trackCacheWindowSize = m_pConfig->getValue(
+            mixxx::library::prefs::kTrackCacheWindowSizeConfigKey,
+            mixxx::library::prefs::kTrackCacheWindowSizeDefault);
+    if (trackCacheWindowSize > 0) {
+        pBaseTrackCache->setWindowSize(std::max(trackCacheWindowSize,
+                mixxx::library::prefs::kTrackCacheWindowSizeMin));
+    }
     m_pBaseTrackCache = QSharedPointer<BaseTrackCache>(pBaseTrackCache);
     m_pTrackCollection->connectTrackSource(m_pBaseTrackCache);
 
@@ -105,6 +132,8 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
     m_pLibraryTableModel = new LibraryTableModel(this,
             pLibrary->trackCollectionManager(),
             "mixxx.db.model.library");
+    // Searching and sorting the whole library must not block the GUI
+    m_pLibraryTableModel->setSelectAsync(true);
 
     std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
     pRootItem->appendChild(kMissingTitle);
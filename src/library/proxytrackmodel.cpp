@@ -115,6 +115,18 @@ void ProxyTrackModel::moveTrack(const QModelIndex& sourceIndex,
     }
 }
 
+void ProxyTrackModel::prefetchRows(const QModelIndexList& indices) {
+    if (!m_pTrackModel) {
+        return;
+    }
+    QModelIndexList sourceIndices;
+    sourceIndices.reserve(indices.size());
+    for (const auto& index : indices) {
+        sourceIndices.append(mapToSource(index));
+    }
+    m_pTrackModel->prefetchRows(sourceIndices);
+}
+
 QAbstractItemDelegate* ProxyTrackModel::delegateForColumn(const int i, QObject* pParent) {
     return m_pTrackModel ? m_pTrackModel->delegateForColumn(i, pParent) : nullptr;
 }
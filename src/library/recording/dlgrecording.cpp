@@ -25,7 +25,10 @@ DlgRecording::DlgRecording(
                           pLibrary,
                           parent->getTrackTableBackgroundColorOpacity(),
                           true)),
-          m_browseModel(this, pLibrary->trackCollectionManager(), pRecordingManager),
+          m_browseModel(this,
+                  pLibrary->trackCollectionManager(),
+                  pLibrary->dbConnectionPool(),
+                  pRecordingManager),
           m_proxyModel(&m_browseModel),
           m_bytesRecordedStr("--"),
           m_durationRecordedStr("--:--"),
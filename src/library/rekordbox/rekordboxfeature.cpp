@@ -13,8 +13,8 @@
 #include "library/library.h"
 #include "library/queryutil.h"
 #include "library/rekordbox/rekordbox_anlz.h"
-#include "library/rekordbox/rekordbox_pdb.h"
 #include "library/rekordbox/rekordboxconstants.h"
+#include "library/rekordbox/rekordboxpdbreader.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "library/treeitem.h"
@@ -249,35 +249,18 @@ QList<TreeItem*> findRekordboxDevices() {
     return foundDevices;
 }
 
-template<typename Base, typename T>
-inline bool instanceof (const T* ptr) {
-    return dynamic_cast<const Base*>(ptr) != nullptr;
-}
-
-QString toUnicode(const std::string& toConvert) {
-    return QTextCodec::codecForName("UTF-16BE")
-            ->toUnicode(toConvert.data(), static_cast<int>(toConvert.length()));
-}
-
-// Functions getText and parseDeviceDB are roughly based on the following Java file:
+// The strings in the PDB file "have a variety of obscure representations", see
 // https://github.com/Deep-Symmetry/crate-digger/commit/f09fa9fc097a2a428c43245ddd542ac1370c1adc
-// getText is needed because the strings in the PDB file "have a variety of obscure representations".
-
-QString getText(rekordbox_pdb_t::device_sql_string_t* deviceString) {
+QString toQString(const RekordboxPdbString& pdbString) {
     QString text;
-
-    if (instanceof <rekordbox_pdb_t::device_sql_short_ascii_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_short_ascii_t* shortAsciiString =
-                static_cast<rekordbox_pdb_t::device_sql_short_ascii_t*>(deviceString->body());
-        text = QString::fromStdString(shortAsciiString->text());
-    } else if (instanceof <rekordbox_pdb_t::device_sql_long_ascii_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_long_ascii_t* longAsciiString =
-                static_cast<rekordbox_pdb_t::device_sql_long_ascii_t*>(deviceString->body());
-        text = QString::fromStdString(longAsciiString->text());
-    } else if (instanceof <rekordbox_pdb_t::device_sql_long_utf16be_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_long_utf16be_t* longUtf16beString =
-                static_cast<rekordbox_pdb_t::device_sql_long_utf16be_t*>(deviceString->body());
-        text = toUnicode(longUtf16beString->text());
+    switch (pdbString.encoding()) {
+    case RekordboxPdbString::Encoding::Ascii:
+        text = QString::fromUtf8(pdbString.data(), static_cast<int>(pdbString.size()));
+        break;
+    case RekordboxPdbString::Encoding::Utf16Be:
+        text = QTextCodec::codecForName("UTF-16BE")
+                       ->toUnicode(pdbString.data(), static_cast<int>(pdbString.size()));
+        break;
     }
 
     // Some strings read from Rekordbox *.PDB files contain random null characters
@@ -285,6 +268,19 @@ QString getText(rekordbox_pdb_t::device_sql_string_t* deviceString) {
     return text.remove(QChar('\x0'));
 }
 
+// Maps the whole file into memory, returns nullptr on failure
+const uchar* mapFile(QFile* pFile) {
+    if (!pFile->open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << pFile->fileName() << pFile->errorString();
+        return nullptr;
+    }
+    const uchar* pData = pFile->map(0, pFile->size());
+    if (!pData) {
+        qWarning() << "Failed to map" << pFile->fileName() << pFile->errorString();
+    }
+    return pData;
+}
+
 int createDevicePlaylist(QSqlDatabase& database, const QString& devicePath) {
     int playlistID = -1;
 
@@ -342,8 +338,7 @@ mixxx::RgbColor colorFromID(int colorID) {
 }
 
 void insertTrack(
-        QSqlDatabase& database,
-        rekordbox_pdb_t::track_row_t* track,
+        const RekordboxPdbTrackRow& track,
         QSqlQuery& query,
         QSqlQuery& queryInsertIntoDevicePlaylistTracks,
         QMap<uint32_t, QString>& artistsMap,
@@ -353,21 +348,21 @@ void insertTrack(
         const QString& devicePath,
         const QString& device,
         int audioFilesCount) {
-    int rbID = static_cast<int>(track->id());
-    QString title = getText(track->title());
-    QString artist = artistsMap[track->artist_id()];
-    QString album = albumsMap[track->album_id()];
-    QString year = QString::number(track->year());
-    QString genre = genresMap[track->genre_id()];
-    QString location = devicePath + getText(track->file_path());
-    float bpm = static_cast<float>(track->tempo() / 100.0);
-    int bitrate = static_cast<int>(track->bitrate());
-    QString key = keysMap[track->key_id()];
-    int playtime = static_cast<int>(track->duration());
-    int rating = static_cast<int>(track->rating());
-    QString comment = getText(track->comment());
-    QString tracknumber = QString::number(track->track_number());
-    QString anlzPath = devicePath + getText(track->analyze_path());
+    int rbID = static_cast<int>(track.id());
+    QString title = toQString(track.title());
+    QString artist = artistsMap[track.artistId()];
+    QString album = albumsMap[track.albumId()];
+    QString year = QString::number(track.year());
+    QString genre = genresMap[track.genreId()];
+    QString location = devicePath + toQString(track.filePath());
+    float bpm = static_cast<float>(track.tempo() / 100.0);
+    int bitrate = static_cast<int>(track.bitrate());
+    QString key = keysMap[track.keyId()];
+    int playtime = static_cast<int>(track.duration());
+    int rating = static_cast<int>(track.rating());
+    QString comment = toQString(track.comment());
+    QString tracknumber = QString::number(track.trackNumber());
+    QString anlzPath = devicePath + toQString(track.analyzePath());
 
     query.bindValue(":rb_id", rbID);
     query.bindValue(":artist", artist);
@@ -387,27 +382,13 @@ void insertTrack(
     query.bindValue(":device", device);
     query.bindValue(":color",
             mixxx::RgbColor::toQVariant(
-                    colorFromID(static_cast<int>(track->color_id()))));
+                    colorFromID(static_cast<int>(track.colorId()))));
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
+        return;
     }
-
-    int trackID = -1;
-    QSqlQuery finderQuery(database);
-    finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-            " where rb_id=:rb_id and device=:device");
-    finderQuery.bindValue(":rb_id", rbID);
-    finderQuery.bindValue(":device", device);
-
-    if (!finderQuery.exec()) {
-        LOG_FAILED_QUERY(finderQuery)
-                << "rbID:" << rbID;
-    }
-
-    if (finderQuery.next()) {
-        trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-    }
+    const int trackID = query.lastInsertId().toInt();
 
     // Insert into device all tracks playlist
     queryInsertIntoDevicePlaylistTracks.bindValue(":track_id", trackID);
@@ -427,9 +408,7 @@ void buildPlaylistTree(
         QMap<uint32_t, QString>& playlistNameMap,
         QMap<uint32_t, bool>& playlistIsFolderMap,
         QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
-        const QString& playlistPath,
-        const QString& device);
+        const QString& playlistPath);
 
 QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* deviceItem) {
     QString device = deviceItem->getLabel();
@@ -487,10 +466,16 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     if (!Sandbox::askForAccess(&fileInfo)) {
         return QString();
     }
-    std::ifstream ifs(dbPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
-
-    rekordbox_pdb_t reckordboxDB = rekordbox_pdb_t(&ks);
+    QFile pdbFile(dbPath);
+    const uchar* pPdbData = mapFile(&pdbFile);
+    if (!pPdbData) {
+        return QString();
+    }
+    const RekordboxPdbReader reader(pPdbData, static_cast<std::size_t>(pdbFile.size()));
+    if (!reader.isValid()) {
+        qWarning() << "Invalid Rekordbox database" << dbPath;
+        return QString();
+    }
 
     // There are other types of tables (eg. COLOR), these are the only ones we are
     // interested at the moment. Perhaps when/if
@@ -499,18 +484,10 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     // Attempt was made to also recover HISTORY
     // playlists (which are found on removable Rekordbox devices), however
     // they didn't appear to contain valid row_ref_t structures.
-    constexpr int totalTables = 8;
-
-    rekordbox_pdb_t::page_type_t tableOrder[totalTables] = {
-            rekordbox_pdb_t::PAGE_TYPE_KEYS,
-            rekordbox_pdb_t::PAGE_TYPE_GENRES,
-            rekordbox_pdb_t::PAGE_TYPE_ARTISTS,
-            rekordbox_pdb_t::PAGE_TYPE_ALBUMS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES,
-            rekordbox_pdb_t::PAGE_TYPE_TRACKS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE,
-            rekordbox_pdb_t::PAGE_TYPE_HISTORY};
-
+    //
+    // The PLAYLIST_ENTRIES table is the largest one, but only needed for
+    // the playlists that are actually opened. It is read on demand, see
+    // loadPlaylistTracks().
     QMap<uint32_t, QString> keysMap;
     QMap<uint32_t, QString> genresMap;
     QMap<uint32_t, QString> artistsMap;
@@ -518,136 +495,54 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     QMap<uint32_t, QString> playlistNameMap;
     QMap<uint32_t, bool> playlistIsFolderMap;
     QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTreeMap;
-    QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTrackMap;
 
     bool folderOrPlaylistFound = false;
 
-    for (int tableOrderIndex = 0; tableOrderIndex < totalTables; tableOrderIndex++) {
-        for (std::vector<rekordbox_pdb_t::table_t*>::iterator table =
-                        reckordboxDB.tables()->begin();
-                table != reckordboxDB.tables()->end();
-                ++table) {
-            if ((*table)->type() == tableOrder[tableOrderIndex]) {
-                uint16_t lastIndex = (*table)->last_page()->index();
-                rekordbox_pdb_t::page_ref_t* currentRef = (*table)->first_page();
-
-                while (true) {
-                    rekordbox_pdb_t::page_t* page = currentRef->body();
-
-                    if (page->is_data_page()) {
-                        for (std::vector<rekordbox_pdb_t::row_group_t*>::
-                                        iterator rowGroup =
-                                                page->row_groups()->begin();
-                                rowGroup != page->row_groups()->end();
-                                ++rowGroup) {
-                            for (std::vector<rekordbox_pdb_t::row_ref_t*>::
-                                            iterator rowRef = (*rowGroup)
-                                                                      ->rows()
-                                                                      ->begin();
-                                    rowRef != (*rowGroup)->rows()->end();
-                                    ++rowRef) {
-                                if ((*rowRef)->present()) {
-                                    switch (tableOrder[tableOrderIndex]) {
-                                    case rekordbox_pdb_t::PAGE_TYPE_KEYS: {
-                                        // Key found, update map
-                                        rekordbox_pdb_t::key_row_t* key =
-                                                static_cast<rekordbox_pdb_t::
-                                                                key_row_t*>(
-                                                        (*rowRef)->body());
-                                        keysMap[key->id()] = getText(key->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_GENRES: {
-                                        // Genre found, update map
-                                        rekordbox_pdb_t::genre_row_t* genre =
-                                                static_cast<rekordbox_pdb_t::
-                                                                genre_row_t*>(
-                                                        (*rowRef)->body());
-                                        genresMap[genre->id()] = getText(genre->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ARTISTS: {
-                                        // Artist found, update map
-                                        rekordbox_pdb_t::artist_row_t* artist =
-                                                static_cast<rekordbox_pdb_t::
-                                                                artist_row_t*>(
-                                                        (*rowRef)->body());
-                                        artistsMap[artist->id()] = getText(artist->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ALBUMS: {
-                                        // Album found, update map
-                                        rekordbox_pdb_t::album_row_t* album =
-                                                static_cast<rekordbox_pdb_t::
-                                                                album_row_t*>(
-                                                        (*rowRef)->body());
-                                        albumsMap[album->id()] = getText(album->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES: {
-                                        // Playlist to track mapping found, update map
-                                        rekordbox_pdb_t::playlist_entry_row_t*
-                                                playlistEntry = static_cast<
-                                                        rekordbox_pdb_t::
-                                                                playlist_entry_row_t*>(
-                                                        (*rowRef)->body());
-                                        playlistTrackMap
-                                                [playlistEntry->playlist_id()]
-                                                [playlistEntry->entry_index()] =
-                                                        playlistEntry
-                                                                ->track_id();
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_TRACKS: {
-                                        // Track found, insert into database
-                                        insertTrack(database,
-                                                static_cast<rekordbox_pdb_t::
-                                                                track_row_t*>(
-                                                        (*rowRef)->body()),
-                                                query,
-                                                queryInsertIntoDevicePlaylistTracks,
-                                                artistsMap,
-                                                albumsMap,
-                                                genresMap,
-                                                keysMap,
-                                                devicePath,
-                                                device,
-                                                audioFilesCount);
-
-                                        audioFilesCount++;
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE: {
-                                        // Playlist tree node found, update map
-                                        rekordbox_pdb_t::playlist_tree_row_t*
-                                                playlistTree = static_cast<
-                                                        rekordbox_pdb_t::
-                                                                playlist_tree_row_t*>(
-                                                        (*rowRef)->body());
-
-                                        playlistNameMap[playlistTree->id()] =
-                                                getText(playlistTree->name());
-                                        playlistIsFolderMap[playlistTree
-                                                                    ->id()] =
-                                                playlistTree->is_folder();
-                                        playlistTreeMap
-                                                [playlistTree->parent_id()]
-                                                [playlistTree->sort_order()] =
-                                                        playlistTree->id();
-
-                                        folderOrPlaylistFound = true;
-                                    } break;
-                                    default:
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    if (currentRef->index() == lastIndex) {
-                        break;
-                    } else {
-                        currentRef = page->next_page();
-                    }
-                }
-            }
-        }
-    }
+    reader.forEachRow(RekordboxPdbPageType::Keys, [&](const RekordboxPdbRow& row) {
+        // Key found, update map
+        const RekordboxPdbNameRow key(RekordboxPdbPageType::Keys, row);
+        keysMap[key.id()] = toQString(key.name());
+    });
+    reader.forEachRow(RekordboxPdbPageType::Genres, [&](const RekordboxPdbRow& row) {
+        // Genre found, update map
+        const RekordboxPdbNameRow genre(RekordboxPdbPageType::Genres, row);
+        genresMap[genre.id()] = toQString(genre.name());
+    });
+    reader.forEachRow(RekordboxPdbPageType::Artists, [&](const RekordboxPdbRow& row) {
+        // Artist found, update map
+        const RekordboxPdbArtistRow artist(row);
+        artistsMap[artist.id()] = toQString(artist.name());
+    });
+    reader.forEachRow(RekordboxPdbPageType::Albums, [&](const RekordboxPdbRow& row) {
+        // Album found, update map
+        const RekordboxPdbAlbumRow album(row);
+        albumsMap[album.id()] = toQString(album.name());
+    });
+    reader.forEachRow(RekordboxPdbPageType::Tracks, [&](const RekordboxPdbRow& row) {
+        // Track found, insert into database
+        insertTrack(RekordboxPdbTrackRow(row),
+                query,
+                queryInsertIntoDevicePlaylistTracks,
+                artistsMap,
+                albumsMap,
+                genresMap,
+                keysMap,
+                devicePath,
+                device,
+                audioFilesCount);
+
+        audioFilesCount++;
+    });
+    reader.forEachRow(RekordboxPdbPageType::PlaylistTree, [&](const RekordboxPdbRow& row) {
+        // Playlist tree node found, update map
+        const RekordboxPdbPlaylistTreeRow playlistTree(row);
+        playlistNameMap[playlistTree.id()] = toQString(playlistTree.name());
+        playlistIsFolderMap[playlistTree.id()] = playlistTree.isFolder();
+        playlistTreeMap[playlistTree.parentId()][playlistTree.sortOrder()] =
+                playlistTree.id();
+
+        folderOrPlaylistFound = true;
+    });
 
     if (audioFilesCount > 0 || folderOrPlaylistFound) {
         // If we have found anything, recursively build playlist/folder TreeItem children
@@ -658,9 +553,7 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
                 playlistNameMap,
                 playlistIsFolderMap,
                 playlistTreeMap,
-                playlistTrackMap,
-                devicePath,
-                device);
+                devicePath);
     }
 
     qDebug() << "Found: " << audioFilesCount << " audio files in Rekordbox device " << device;
@@ -677,9 +570,13 @@ void buildPlaylistTree(
         QMap<uint32_t, QString>& playlistNameMap,
         QMap<uint32_t, bool>& playlistIsFolderMap,
         QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
-        const QString& playlistPath,
-        const QString& device) {
+        const QString& playlistPath) {
+    QSqlQuery queryInsertIntoPlaylist(database);
+    queryInsertIntoPlaylist.prepare(
+            "INSERT INTO " + kRekordboxPlaylistsTable +
+            " (name) "
+            "VALUES (:name)");
+
     for (uint32_t childIndex = 0;
             childIndex < (uint32_t)playlistTreeMap[parentID].size();
             childIndex++) {
@@ -688,20 +585,17 @@ void buildPlaylistTree(
 
         QString currentPath = playlistPath + kPLaylistPathDelimiter + playlistItemName;
 
+        // The 3rd element holds the Rekordbox ID of a playlist until its
+        // tracks have been loaded on demand, see loadPlaylistTracks().
         QList<QString> data;
 
         data << currentPath;
         data << IS_NOT_RECORDBOX_DEVICE;
+        data << QString::number(childID);
 
         TreeItem* child = parent->appendChild(playlistItemName, QVariant(data));
 
         // Create a playlist for this child
-        QSqlQuery queryInsertIntoPlaylist(database);
-        queryInsertIntoPlaylist.prepare(
-                "INSERT INTO " + kRekordboxPlaylistsTable +
-                " (name) "
-                "VALUES (:name)");
-
         queryInsertIntoPlaylist.bindValue(":name", currentPath);
 
         if (!queryInsertIntoPlaylist.exec()) {
@@ -710,67 +604,6 @@ void buildPlaylistTree(
             return;
         }
 
-        QSqlQuery idQuery(database);
-        idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
-        idQuery.bindValue(":path", currentPath);
-
-        if (!idQuery.exec()) {
-            LOG_FAILED_QUERY(idQuery)
-                    << "currentPath" << currentPath;
-            return;
-        }
-
-        int playlistID = -1;
-        while (idQuery.next()) {
-            playlistID = idQuery.value(idQuery.record().indexOf("id")).toInt();
-        }
-
-        QSqlQuery queryInsertIntoPlaylistTracks(database);
-        queryInsertIntoPlaylistTracks.prepare(
-                "INSERT INTO " + kRekordboxPlaylistTracksTable +
-                " (playlist_id, track_id, position) "
-                "VALUES (:playlist_id, :track_id, :position)");
-
-        if (playlistTrackMap.count(childID)) {
-            // Add playlist tracks for children
-            for (uint32_t trackIndex = 1; trackIndex <=
-                    static_cast<uint32_t>(playlistTrackMap[childID].size());
-                    trackIndex++) {
-                uint32_t rbTrackID = playlistTrackMap[childID][trackIndex];
-
-                int trackID = -1;
-                QSqlQuery finderQuery(database);
-                finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-                        " where rb_id=:rb_id and device=:device");
-                finderQuery.bindValue(":rb_id", rbTrackID);
-                finderQuery.bindValue(":device", device);
-
-                if (!finderQuery.exec()) {
-                    LOG_FAILED_QUERY(finderQuery)
-                            << "rbTrackID:" << rbTrackID
-                            << "device:" << device;
-                    return;
-                }
-
-                if (finderQuery.next()) {
-                    trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-                }
-
-                queryInsertIntoPlaylistTracks.bindValue(":playlist_id", playlistID);
-                queryInsertIntoPlaylistTracks.bindValue(":track_id", trackID);
-                queryInsertIntoPlaylistTracks.bindValue(":position", static_cast<int>(trackIndex));
-
-                if (!queryInsertIntoPlaylistTracks.exec()) {
-                    LOG_FAILED_QUERY(queryInsertIntoPlaylistTracks)
-                            << "playlistID:" << playlistID
-                            << "trackID:" << trackID
-                            << "trackIndex:" << trackIndex;
-
-                    return;
-                }
-            }
-        }
-
         if (playlistIsFolderMap[childID]) {
             // If this child is a folder (playlists are only leaf nodes), build playlist tree for it
             buildPlaylistTree(database,
@@ -779,67 +612,130 @@ void buildPlaylistTree(
                     playlistNameMap,
                     playlistIsFolderMap,
                     playlistTreeMap,
-                    playlistTrackMap,
-                    currentPath,
-                    device);
+                    currentPath);
         }
     }
 }
 
-void clearDeviceTables(QSqlDatabase& database, TreeItem* child) {
-    ScopedTransaction transaction(database);
-
-    int trackID = -1;
-    int playlistID = -1;
-    QSqlQuery tracksQuery(database);
-    tracksQuery.prepare("select id from " + kRekordboxLibraryTable + " where device=:device");
-    tracksQuery.bindValue(":device", child->getLabel());
-
-    QSqlQuery deletePlaylistsQuery(database);
-    deletePlaylistsQuery.prepare("delete from " + kRekordboxPlaylistsTable + " where id=:id");
-
-    QSqlQuery deletePlaylistTracksQuery(database);
-    deletePlaylistTracksQuery.prepare("delete from " +
-            kRekordboxPlaylistTracksTable + " where playlist_id=:playlist_id");
+// Inserts the tracks of a playlist that has been created by buildPlaylistTree()
+void loadPlaylistTracks(QSqlDatabase& database,
+        const TreeItem* playlistItem,
+        const QString& playlistPath,
+        uint32_t rbPlaylistID) {
+    // The device is the top level item
+    const TreeItem* deviceItem = playlistItem;
+    while (deviceItem->hasParent() && !deviceItem->parent()->isRoot()) {
+        deviceItem = deviceItem->parent();
+    }
+    const QString device = deviceItem->getLabel();
+    const QString devicePath = deviceItem->getData().toList()[0].toString();
+    const QString dbPath = devicePath + QStringLiteral("/") + kPdbPath;
 
-    if (!tracksQuery.exec()) {
-        LOG_FAILED_QUERY(tracksQuery)
-                << "device:" << child->getLabel();
+    mixxx::FileInfo fileInfo(dbPath);
+    if (!Sandbox::askForAccess(&fileInfo)) {
+        return;
+    }
+    QFile pdbFile(dbPath);
+    const uchar* pPdbData = mapFile(&pdbFile);
+    if (!pPdbData) {
+        return;
+    }
+    const RekordboxPdbReader reader(pPdbData, static_cast<std::size_t>(pdbFile.size()));
+
+    // Rekordbox track IDs by entry index
+    QMap<uint32_t, uint32_t> playlistTracks;
+    reader.forEachRow(RekordboxPdbPageType::PlaylistEntries, [&](const RekordboxPdbRow& row) {
+        const RekordboxPdbPlaylistEntryRow playlistEntry(row);
+        if (playlistEntry.playlistId() == rbPlaylistID) {
+            playlistTracks[playlistEntry.entryIndex()] = playlistEntry.trackId();
+        }
+    });
+    if (playlistTracks.isEmpty()) {
+        return;
     }
 
-    while (tracksQuery.next()) {
-        trackID = tracksQuery.value(tracksQuery.record().indexOf("id")).toInt();
+    QSqlQuery idQuery(database);
+    idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
+    idQuery.bindValue(":path", playlistPath);
+    if (!idQuery.exec() || !idQuery.next()) {
+        LOG_FAILED_QUERY(idQuery)
+                << "playlistPath" << playlistPath;
+        return;
+    }
+    const int playlistID = idQuery.value(0).toInt();
 
-        QSqlQuery playlistTracksQuery(database);
-        playlistTracksQuery.prepare("select playlist_id from " +
-                kRekordboxPlaylistTracksTable + " where track_id=:track_id");
-        playlistTracksQuery.bindValue(":track_id", trackID);
+    QHash<uint32_t, int> trackIDs;
+    QSqlQuery finderQuery(database);
+    finderQuery.prepare("select id, rb_id from " + kRekordboxLibraryTable +
+            " where device=:device");
+    finderQuery.bindValue(":device", device);
+    if (!finderQuery.exec()) {
+        LOG_FAILED_QUERY(finderQuery)
+                << "device:" << device;
+        return;
+    }
+    while (finderQuery.next()) {
+        trackIDs.insert(finderQuery.value(1).toUInt(), finderQuery.value(0).toInt());
+    }
 
-        if (!playlistTracksQuery.exec()) {
-            LOG_FAILED_QUERY(playlistTracksQuery)
-                    << "trackID:" << trackID;
+    ScopedTransaction transaction(database);
+    QSqlQuery queryInsertIntoPlaylistTracks(database);
+    queryInsertIntoPlaylistTracks.prepare(
+            "INSERT INTO " + kRekordboxPlaylistTracksTable +
+            " (playlist_id, track_id, position) "
+            "VALUES (:playlist_id, :track_id, :position)");
+    queryInsertIntoPlaylistTracks.bindValue(":playlist_id", playlistID);
+
+    int trackIndex = 1;
+    for (const uint32_t rbTrackID : qAsConst(playlistTracks)) {
+        const int trackID = trackIDs.value(rbTrackID, -1);
+        queryInsertIntoPlaylistTracks.bindValue(":track_id", trackID);
+        queryInsertIntoPlaylistTracks.bindValue(":position", trackIndex);
+
+        if (!queryInsertIntoPlaylistTracks.exec()) {
+            LOG_FAILED_QUERY(queryInsertIntoPlaylistTracks)
+                    << "playlistID:" << playlistID
+                    << "trackID:" << trackID
+                    << "trackIndex:" << trackIndex;
+            return;
         }
+        ++trackIndex;
+    }
+    transaction.commit();
+}
 
-        while (playlistTracksQuery.next()) {
-            playlistID = playlistTracksQuery
-                                 .value(playlistTracksQuery.record().indexOf(
-                                         "playlist_id"))
-                                 .toInt();
-
-            deletePlaylistsQuery.bindValue(":id", playlistID);
+void clearDeviceTables(QSqlDatabase& database, TreeItem* child) {
+    ScopedTransaction transaction(database);
 
-            if (!deletePlaylistsQuery.exec()) {
-                LOG_FAILED_QUERY(deletePlaylistsQuery)
-                        << "playlistID:" << playlistID;
-            }
+    // The names of all playlists of a device start with the device path,
+    // including playlists without tracks and those whose tracks have not
+    // been loaded yet.
+    const QString devicePath = child->getData().toList()[0].toString();
+    const QString devicePlaylistIDs = "select id from " + kRekordboxPlaylistsTable +
+            " where name=:path or substr(name, 1, length(:prefix))=:prefix";
+    const QString devicePlaylistPrefix = devicePath + kPLaylistPathDelimiter;
 
-            deletePlaylistTracksQuery.bindValue(":playlist_id", playlistID);
+    QSqlQuery deletePlaylistTracksQuery(database);
+    deletePlaylistTracksQuery.prepare("delete from " +
+            kRekordboxPlaylistTracksTable + " where playlist_id in (" +
+            devicePlaylistIDs + ")");
+    deletePlaylistTracksQuery.bindValue(":path", devicePath);
+    deletePlaylistTracksQuery.bindValue(":prefix", devicePlaylistPrefix);
+
+    if (!deletePlaylistTracksQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistTracksQuery)
+                << "devicePath:" << devicePath;
+    }
 
-            if (!deletePlaylistTracksQuery.exec()) {
-                LOG_FAILED_QUERY(deletePlaylistTracksQuery)
-                        << "playlistID:" << playlistID;
-            }
-        }
+    QSqlQuery deletePlaylistsQuery(database);
+    deletePlaylistsQuery.prepare("delete from " + kRekordboxPlaylistsTable +
+            " where id in (" + devicePlaylistIDs + ")");
+    deletePlaylistsQuery.bindValue(":path", devicePath);
+    deletePlaylistsQuery.bindValue(":prefix", devicePlaylistPrefix);
+
+    if (!deletePlaylistsQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistsQuery)
+                << "devicePath:" << devicePath;
     }
 
     QSqlQuery deleteTracksQuery(database);
@@ -900,8 +796,14 @@ void readAnalyze(TrackPointer track,
 
     qDebug() << "Rekordbox ANLZ path:" << anlzPath << " for: " << track->getTitle();
 
-    std::ifstream ifs(anlzPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
+    QFile anlzFile(anlzPath);
+    const uchar* pAnlzData = mapFile(&anlzFile);
+    if (!pAnlzData) {
+        return;
+    }
+    RekordboxMemoryStreamBuf anlzBuffer(pAnlzData, static_cast<std::size_t>(anlzFile.size()));
+    std::istream anlzStream(&anlzBuffer);
+    kaitai::kstream ks(&anlzStream);
 
     rekordbox_anlz_t anlz = rekordbox_anlz_t(&ks);
 
@@ -1520,12 +1422,13 @@ void RekordboxFeature::activateChild(const QModelIndex& index) {
         return;
     }
 
-    // TreeItem list data holds 2 values in a QList and have different meanings.
-    // If the 2nd QList element IS_RECORDBOX_DEVICE, the 1st element is the
-    // filesystem device path, and the parseDeviceDB concurrent thread to parse
-    // the Rekcordbox database is initiated. If the 2nd element is
+    // TreeItem list data holds 2 or 3 values in a QList and have different
+    // meanings. If the 2nd QList element IS_RECORDBOX_DEVICE, the 1st element
+    // is the filesystem device path, and the parseDeviceDB concurrent thread
+    // to parse the Rekcordbox database is initiated. If the 2nd element is
     // IS_NOT_RECORDBOX_DEVICE, the 1st element is the playlist path and it is
-    // activated.
+    // activated. A 3rd element is the Rekordbox ID of a playlist whose tracks
+    // have not been loaded yet. It is removed after loading them.
     QList<QVariant> data = item->getData().toList();
     QString playlist = data[0].toString();
     bool doParseDeviceDB = data[1].toString() == IS_RECORDBOX_DEVICE;
@@ -1546,6 +1449,13 @@ void RekordboxFeature::activateChild(const QModelIndex& index) {
         item->setData(QVariant(data));
     } else {
         qDebug() << "Activate Rekordbox Playlist: " << playlist;
+        if (data.size() > 2) {
+            // The tracks of this playlist have not been loaded yet
+            QSqlDatabase database = m_pTrackCollection->database();
+            loadPlaylistTracks(database, item, playlist, data[2].toUInt());
+            data.removeLast();
+            item->setData(QVariant(data));
+        }
         m_pRekordboxPlaylistModel->setPlaylist(playlist);
         emit showTrackModel(m_pRekordboxPlaylistModel);
     }
@@ -0,0 +1,232 @@
+#include "library/rekordbox/rekordboxpdbreader.h"
+
+namespace {
+
+// The file header
+constexpr std::size_t kHeaderPageSizeOffset = 0x04;
+constexpr std::size_t kHeaderNumTablesOffset = 0x08;
+constexpr std::size_t kHeaderTablesOffset = 0x1c;
+constexpr std::size_t kTableSize = 0x10;
+
+// The page header
+constexpr std::size_t kPageTypeOffset = 0x08;
+constexpr std::size_t kPageNextPageOffset = 0x0c;
+constexpr std::size_t kPageNumRowsSmallOffset = 0x18;
+constexpr std::size_t kPageFlagsOffset = 0x1b;
+constexpr std::size_t kPageNumRowsLargeOffset = 0x22;
+constexpr std::size_t kPageHeapOffset = 0x28;
+
+constexpr uint8_t kPageFlagNoDataPage = 0x40;
+constexpr uint16_t kNumRowsLargeInvalid = 0x1fff;
+
+// The row index at the end of a page consists of groups of up to 16 row
+// offsets, each followed by a bitmask of the rows that are present.
+constexpr int kRowGroupSize = 16;
+constexpr std::size_t kRowGroupLength = 0x24;
+
+// The kinds of strings, all other values denote a short ASCII string
+constexpr uint8_t kStringKindLongAscii = 0x40;
+constexpr uint8_t kStringKindLongUtf16Be = 0x90;
+
+inline uint16_t readU16(const uint8_t* pData) {
+    return static_cast<uint16_t>(pData[0] | (pData[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t* pData) {
+    return static_cast<uint32_t>(pData[0]) |
+            (static_cast<uint32_t>(pData[1]) << 8) |
+            (static_cast<uint32_t>(pData[2]) << 16) |
+            (static_cast<uint32_t>(pData[3]) << 24);
+}
+
+} // namespace
+
+uint8_t RekordboxPdbRow::u8(std::size_t offset) const {
+    const std::size_t pos = m_rowOffset + offset;
+    if (pos + 1 > m_pageSize) {
+        return 0;
+    }
+    return m_pPage[pos];
+}
+
+uint16_t RekordboxPdbRow::u16(std::size_t offset) const {
+    const std::size_t pos = m_rowOffset + offset;
+    if (pos + 2 > m_pageSize) {
+        return 0;
+    }
+    return readU16(m_pPage + pos);
+}
+
+uint32_t RekordboxPdbRow::u32(std::size_t offset) const {
+    const std::size_t pos = m_rowOffset + offset;
+    if (pos + 4 > m_pageSize) {
+        return 0;
+    }
+    return readU32(m_pPage + pos);
+}
+
+RekordboxPdbString RekordboxPdbRow::string(std::size_t offset) const {
+    const std::size_t pos = m_rowOffset + offset;
+    if (pos + 1 > m_pageSize) {
+        return RekordboxPdbString();
+    }
+    const uint8_t lengthAndKind = m_pPage[pos];
+    RekordboxPdbString::Encoding encoding = RekordboxPdbString::Encoding::Ascii;
+    std::size_t textPos;
+    std::size_t textSize;
+    if (lengthAndKind == kStringKindLongAscii ||
+            lengthAndKind == kStringKindLongUtf16Be) {
+        if (pos + 3 > m_pageSize) {
+            return RekordboxPdbString();
+        }
+        const uint16_t length = readU16(m_pPage + pos + 1);
+        textPos = pos + 3;
+        if (lengthAndKind == kStringKindLongAscii) {
+            textSize = length;
+        } else {
+            // The length includes two trailing null characters
+            encoding = RekordboxPdbString::Encoding::Utf16Be;
+            if (length < 4) {
+                return RekordboxPdbString();
+            }
+            textSize = length - 4;
+        }
+    } else {
+        // The length of short strings is incremented, doubled and
+        // incremented again. Even values are invalid.
+        if (lengthAndKind % 2 == 0 || lengthAndKind < 3) {
+            return RekordboxPdbString();
+        }
+        textPos = pos + 1;
+        textSize = (lengthAndKind - 1) / 2 - 1;
+    }
+    if (textPos + textSize > m_pageSize) {
+        return RekordboxPdbString();
+    }
+    return RekordboxPdbString(encoding,
+            reinterpret_cast<const char*>(m_pPage + textPos),
+            textSize);
+}
+
+RekordboxPdbReader::RekordboxPdbReader(const uint8_t* pData, std::size_t size)
+        : m_pData(pData),
+          m_size(size),
+          m_pageSize(0),
+          m_numTables(0) {
+    if (size < kHeaderTablesOffset) {
+        return;
+    }
+    const std::size_t pageSize = readU32(pData + kHeaderPageSizeOffset);
+    const uint32_t numTables = readU32(pData + kHeaderNumTablesOffset);
+    if (pageSize <= kPageHeapOffset + kRowGroupLength ||
+            kHeaderTablesOffset + numTables * kTableSize > pageSize ||
+            pageSize > size) {
+        return;
+    }
+    m_pageSize = pageSize;
+    m_numTables = numTables;
+}
+
+RekordboxPdbPageType RekordboxPdbReader::tableType(uint32_t tableIndex) const {
+    return static_cast<RekordboxPdbPageType>(
+            readU32(m_pData + kHeaderTablesOffset + tableIndex * kTableSize));
+}
+
+int RekordboxPdbReader::pageNumRows(const uint8_t* pPage) const {
+    const uint8_t numRowsSmall = pPage[kPageNumRowsSmallOffset];
+    const uint16_t numRowsLarge = readU16(pPage + kPageNumRowsLargeOffset);
+    const int numRows = (numRowsLarge > numRowsSmall && numRowsLarge != kNumRowsLargeInvalid)
+            ? numRowsLarge
+            : numRowsSmall;
+    // The row index must not overlap with the page header
+    const int maxNumRows = static_cast<int>(
+            (m_pageSize - kPageHeapOffset) / kRowGroupLength * kRowGroupSize);
+    return numRows < maxNumRows ? numRows : maxNumRows;
+}
+
+std::size_t RekordboxPdbReader::pageRowOffset(const uint8_t* pPage, int rowIndex) const {
+    const std::size_t groupBase = m_pageSize - (rowIndex / kRowGroupSize) * kRowGroupLength;
+    const int indexInGroup = rowIndex % kRowGroupSize;
+    const uint16_t presentFlags = readU16(pPage + groupBase - 4);
+    if (((presentFlags >> indexInGroup) & 1) == 0) {
+        return 0;
+    }
+    const std::size_t rowOffset =
+            readU16(pPage + groupBase - (6 + 2 * indexInGroup)) + kPageHeapOffset;
+    if (rowOffset >= m_pageSize) {
+        return 0;
+    }
+    return rowOffset;
+}
+
+RekordboxPdbReader::PageIterator::PageIterator(
+        const RekordboxPdbReader& reader, uint32_t tableIndex)
+        : m_reader(reader),
+          m_type(reader.tableType(tableIndex)),
+          m_lastPageIndex(readU32(reader.m_pData + kHeaderTablesOffset +
+                  tableIndex * kTableSize + 0x0c)),
+          m_pageIndex(readU32(reader.m_pData + kHeaderTablesOffset +
+                  tableIndex * kTableSize + 0x08)),
+          m_remainingPages(reader.m_size / reader.m_pageSize) {
+}
+
+const uint8_t* RekordboxPdbReader::PageIterator::nextDataPage() {
+    while (m_remainingPages > 0) {
+        --m_remainingPages;
+        const std::size_t pageIndex = m_pageIndex;
+        if ((pageIndex + 1) * m_reader.m_pageSize > m_reader.m_size) {
+            break;
+        }
+        const uint8_t* pPage = m_reader.m_pData + pageIndex * m_reader.m_pageSize;
+        if (pageIndex == m_lastPageIndex) {
+            m_remainingPages = 0;
+        } else {
+            m_pageIndex = readU32(pPage + kPageNextPageOffset);
+        }
+        // The first page of a table usually is not a data page
+        if (static_cast<RekordboxPdbPageType>(readU32(pPage + kPageTypeOffset)) == m_type &&
+                (pPage[kPageFlagsOffset] & kPageFlagNoDataPage) == 0) {
+            return pPage;
+        }
+    }
+    return nullptr;
+}
+
+RekordboxMemoryStreamBuf::RekordboxMemoryStreamBuf(const uint8_t* pData, std::size_t size) {
+    // The buffer is never written, the const_cast is required by the API
+    char* pBegin = const_cast<char*>(reinterpret_cast<const char*>(pData));
+    setg(pBegin, pBegin, pBegin + size);
+}
+
+RekordboxMemoryStreamBuf::pos_type RekordboxMemoryStreamBuf::seekoff(
+        off_type off,
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode which) {
+    if (!(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+    }
+    off_type pos;
+    switch (dir) {
+    case std::ios_base::beg:
+        pos = off;
+        break;
+    case std::ios_base::cur:
+        pos = (gptr() - eback()) + off;
+        break;
+    case std::ios_base::end:
+        pos = (egptr() - eback()) + off;
+        break;
+    default:
+        return pos_type(off_type(-1));
+    }
+    if (pos < 0 || pos > egptr() - eback()) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+}
+
+RekordboxMemoryStreamBuf::pos_type RekordboxMemoryStreamBuf::seekpos(
+        pos_type pos, std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+
+// A lightweight reader for the DeviceSQL database (export.pdb) that is
+// written by Rekordbox to removable devices. The format is described in
+// rekordbox_pdb.ksy.
+//
+// In contrast to the Kaitai generated rekordbox_pdb_t, which copies each
+// page into a substream and allocates an object graph for every row, this
+// reader works directly on the memory of the file, usually a memory mapped
+// QFile. Only the pages of the requested tables are touched and rows are
+// decoded on demand by the accessors of the row views below. The views
+// and strings refer to the memory of the file and must not outlive it.
+
+/// The types of tables in a DeviceSQL database.
+enum class RekordboxPdbPageType : uint32_t {
+    Tracks = 0,
+    Genres = 1,
+    Artists = 2,
+    Albums = 3,
+    Labels = 4,
+    Keys = 5,
+    Colors = 6,
+    PlaylistTree = 7,
+    PlaylistEntries = 8,
+    Artwork = 13,
+    History = 19,
+};
+
+/// An undecoded string stored in a DeviceSQL database.
+class RekordboxPdbString {
+  public:
+    enum class Encoding {
+        Ascii,
+        Utf16Be,
+    };
+
+    RekordboxPdbString()
+            : RekordboxPdbString(Encoding::Ascii, nullptr, 0) {
+    }
+    RekordboxPdbString(Encoding encoding, const char* pData, std::size_t size)
+            : m_encoding(encoding),
+              m_pData(pData),
+              m_size(size) {
+    }
+
+    Encoding encoding() const {
+        return m_encoding;
+    }
+    const char* data() const {
+        return m_pData;
+    }
+    std::size_t size() const {
+        return m_size;
+    }
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+  private:
+    Encoding m_encoding;
+    const char* m_pData;
+    std::size_t m_size;
+};
+
+/// A row of a table page. All offsets are relative to the start of the
+/// row. Fields that exceed the page are read as 0 or an empty string.
+class RekordboxPdbRow {
+  public:
+    RekordboxPdbRow(const uint8_t* pPage, std::size_t pageSize, std::size_t rowOffset)
+            : m_pPage(pPage),
+              m_pageSize(pageSize),
+              m_rowOffset(rowOffset) {
+    }
+
+    uint8_t u8(std::size_t offset) const;
+    uint16_t u16(std::size_t offset) const;
+    uint32_t u32(std::size_t offset) const;
+    RekordboxPdbString string(std::size_t offset) const;
+
+  private:
+    const uint8_t* m_pPage;
+    std::size_t m_pageSize;
+    std::size_t m_rowOffset;
+};
+
+/// A row of the keys, genres or labels table.
+class RekordboxPdbNameRow {
+  public:
+    RekordboxPdbNameRow(RekordboxPdbPageType type, const RekordboxPdbRow& row)
+            : m_row(row),
+              m_nameOffset(type == RekordboxPdbPageType::Keys ? 8 : 4) {
+    }
+
+    uint32_t id() const {
+        return m_row.u32(0);
+    }
+    RekordboxPdbString name() const {
+        return m_row.string(m_nameOffset);
+    }
+
+  private:
+    RekordboxPdbRow m_row;
+    std::size_t m_nameOffset;
+};
+
+class RekordboxPdbArtistRow {
+  public:
+    explicit RekordboxPdbArtistRow(const RekordboxPdbRow& row)
+            : m_row(row) {
+    }
+
+    uint32_t id() const {
+        return m_row.u32(0x04);
+    }
+    RekordboxPdbString name() const {
+        // Subtype 0x64 indicates a name that is too far away from the
+        // start of the row for a single byte offset
+        const bool isFar = m_row.u16(0x00) == 0x64;
+        return m_row.string(isFar ? m_row.u16(0x0a) : m_row.u8(0x09));
+    }
+
+  private:
+    RekordboxPdbRow m_row;
+};
+
+class RekordboxPdbAlbumRow {
+  public:
+    explicit RekordboxPdbAlbumRow(const RekordboxPdbRow& row)
+            : m_row(row) {
+    }
+
+    uint32_t id() const {
+        return m_row.u32(0x0c);
+    }
+    RekordboxPdbString name() const {
+        return m_row.string(m_row.u8(0x15));
+    }
+
+  private:
+    RekordboxPdbRow m_row;
+};
+
+class RekordboxPdbPlaylistTreeRow {
+  public:
+    explicit RekordboxPdbPlaylistTreeRow(const RekordboxPdbRow& row)
+            : m_row(row) {
+    }
+
+    uint32_t parentId() const {
+        return m_row.u32(0x00);
+    }
+    uint32_t sortOrder() const {
+        return m_row.u32(0x08);
+    }
+    uint32_t id() const {
+        return m_row.u32(0x0c);
+    }
+    bool isFolder() const {
+        return m_row.u32(0x10) != 0;
+    }
+    RekordboxPdbString name() const {
+        return m_row.string(0x14);
+    }
+
+  private:
+    RekordboxPdbRow m_row;
+};
+
+class RekordboxPdbPlaylistEntryRow {
+  public:
+    explicit RekordboxPdbPlaylistEntryRow(const RekordboxPdbRow& row)
+            : m_row(row) {
+    }
+
+    uint32_t entryIndex() const {
+        return m_row.u32(0x00);
+    }
+    uint32_t trackId() const {
+        return m_row.u32(0x04);
+    }
+    uint32_t playlistId() const {
+        return m_row.u32(0x08);
+    }
+
+  private:
+    RekordboxPdbRow m_row;
+};
+
+class RekordboxPdbTrackRow {
+  public:
+    explicit RekordboxPdbTrackRow(const RekordboxPdbRow& row)
+            : m_row(row) {
+    }
+
+    uint32_t sampleRate() const {
+        return m_row.u32(0x08);
+    }
+    uint32_t keyId() const {
+        return m_row.u32(0x20);
+    }
+    uint32_t bitrate() const {
+        return m_row.u32(0x30);
+    }
+    uint32_t trackNumber() const {
+        return m_row.u32(0x34);
+    }
+    /// The tempo in beats per minute multiplied by 100
+    uint32_t tempo() const {
+        return m_row.u32(0x38);
+    }
+    uint32_t genreId() const {
+        return m_row.u32(0x3c);
+    }
+    uint32_t albumId() const {
+        return m_row.u32(0x40);
+    }
+    uint32_t artistId() const {
+        return m_row.u32(0x44);
+    }
+    uint32_t id() const {
+        return m_row.u32(0x48);
+    }
+    uint16_t year() const {
+        return m_row.u16(0x50);
+    }
+    uint16_t duration() const {
+        return m_row.u16(0x54);
+    }
+    uint8_t colorId() const {
+        return m_row.u8(0x58);
+    }
+    uint8_t rating() const {
+        return m_row.u8(0x59);
+    }
+    RekordboxPdbString analyzePath() const {
+        return stringAt(14);
+    }
+    RekordboxPdbString comment() const {
+        return stringAt(16);
+    }
+    RekordboxPdbString title() const {
+        return stringAt(17);
+    }
+    RekordboxPdbString filePath() const {
+        return stringAt(20);
+    }
+
+  private:
+    RekordboxPdbString stringAt(int index) const {
+        return m_row.string(m_row.u16(0x5e + 2 * index));
+    }
+
+    RekordboxPdbRow m_row;
+};
+
+class RekordboxPdbReader {
+  public:
+    /// The data must stay valid for the lifetime of the reader.
+    RekordboxPdbReader(const uint8_t* pData, std::size_t size);
+
+    /// Returns false if the header is malformed.
+    bool isValid() const {
+        return m_pageSize > 0;
+    }
+
+    /// Invokes the callback with a RekordboxPdbRow for each present row of
+    /// all tables of the given type, in the order of the pages.
+    template<typename RowCallback>
+    void forEachRow(RekordboxPdbPageType type, RowCallback rowCallback) const {
+        for (uint32_t tableIndex = 0; tableIndex < m_numTables; ++tableIndex) {
+            if (tableType(tableIndex) != type) {
+                continue;
+            }
+            PageIterator pages(*this, tableIndex);
+            while (const uint8_t* pPage = pages.nextDataPage()) {
+                const int numRows = pageNumRows(pPage);
+                for (int rowIndex = 0; rowIndex < numRows; ++rowIndex) {
+                    const std::size_t rowOffset = pageRowOffset(pPage, rowIndex);
+                    if (rowOffset > 0) {
+                        rowCallback(RekordboxPdbRow(pPage, m_pageSize, rowOffset));
+                    }
+                }
+            }
+        }
+    }
+
+  private:
+    // Follows the linked list of pages of a table
+    class PageIterator {
+      public:
+        PageIterator(const RekordboxPdbReader& reader, uint32_t tableIndex);
+
+        /// Returns nullptr after the last page.
+        const uint8_t* nextDataPage();
+
+      private:
+        const RekordboxPdbReader& m_reader;
+        const RekordboxPdbPageType m_type;
+        const uint32_t m_lastPageIndex;
+        uint32_t m_pageIndex;
+        // Guards against cyclic page links in corrupt files
+        std::size_t m_remainingPages;
+    };
+
+    RekordboxPdbPageType tableType(uint32_t tableIndex) const;
+    int pageNumRows(const uint8_t* pPage) const;
+    // Returns the offset of the row within the page or 0 if the row
+    // is not present.
+    std::size_t pageRowOffset(const uint8_t* pPage, int rowIndex) const;
+
+    const uint8_t* m_pData;
+    std::size_t m_size;
+    std::size_t m_pageSize;
+    uint32_t m_numTables;
+};
+
+/// A read-only stream buffer on a memory buffer, e.g. a memory mapped
+/// file, that supports the seeking required by the Kaitai runtime.
+class RekordboxMemoryStreamBuf : public std::streambuf {
+  public:
+    RekordboxMemoryStreamBuf(const uint8_t* pData, std::size_t size);
+
+  protected:
+    pos_type seekoff(off_type off,
+            std::ios_base::seekdir dir,
+            std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
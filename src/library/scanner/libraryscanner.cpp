@@ -22,6 +22,10 @@ namespace {
 // TODO(rryan) make configurable
 constexpr int kScannerThreadPoolSize = 1;
 
+// The number of files outside of the library whose metadata is cached
+// for the Browse view
+constexpr int kMaxBrowseMetadataEntries = 50000;
+
 mixxx::Logger kLogger("LibraryScanner");
 
 QAtomicInt s_instanceCounter(0);
@@ -173,6 +177,13 @@ void LibraryScanner::run() {
         m_playlistDao.initialize(dbConnection);
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
+        m_browseMetadataDao.initialize(dbConnection);
+
+        // Regenerating the sort keys blocks scans that have been
+        // requested in the meantime until the event loop starts, but
+        // not the GUI. Models that have been selected before pick up
+        // the new order when they are selected again.
+        m_trackDao.updateSortKeys();
 
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
@@ -372,6 +383,11 @@ void LibraryScanner::cleanUpScan() {
     // A.
     m_libraryHashDao.removeDeletedDirectoryHashes();
 
+    // The metadata of files that have been added to the library is read
+    // from the library by the Browse view
+    kLogger.debug() << "Cleaning up the Browse metadata cache";
+    m_browseMetadataDao.cleanUp(kMaxBrowseMetadataEntries);
+
     transaction.commit();
 
     kLogger.debug() << "Detecting cover art for unscanned files";
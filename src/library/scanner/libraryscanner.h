@@ -10,6 +10,7 @@
 #include <QThreadPool>
 
 #include "library/dao/analysisdao.h"
+#include "library/dao/browsemetadatadao.h"
 #include "library/dao/cuedao.h"
 #include "library/dao/directorydao.h"
 #include "library/dao/libraryhashdao.h"
@@ -108,6 +109,7 @@ class LibraryScanner : public QThread {
     DirectoryDAO m_directoryDao;
     AnalysisDao m_analysisDao;
     TrackDAO m_trackDao;
+    BrowseMetadataDAO m_browseMetadataDao;
 
     // Global scanner state for scan currently in progress.
     ScannerGlobalPointer m_scannerGlobal;
@@ -4,14 +4,31 @@
 
 namespace mixxx {
 
+namespace {
+
+constexpr int kPrefetchSize = 100;
+
+} // anonymous namespace
+
 std::optional<TrackPointer> TrackByIdCollectionIterator::nextItem() {
-    const auto nextTrackId =
-            m_trackIdListIter.nextItem();
-    if (!nextTrackId) {
+    if (m_nextPrefetchedIndex >= m_prefetchedTracks.size()) {
+        TrackIdList trackIds;
+        trackIds.reserve(kPrefetchSize);
+        while (trackIds.size() < kPrefetchSize) {
+            const auto nextTrackId = m_trackIdListIter.nextItem();
+            if (!nextTrackId) {
+                break;
+            }
+            trackIds.append(*nextTrackId);
+        }
+        m_prefetchedTracks = m_pTrackCollectionManager->getTracksByIds(trackIds);
+        m_nextPrefetchedIndex = 0;
+    }
+    if (m_nextPrefetchedIndex >= m_prefetchedTracks.size()) {
         return std::nullopt;
     }
-    const auto trackPtr =
-            m_pTrackCollectionManager->getTrackById(*nextTrackId);
+    // Don't keep the returned track alive
+    const auto trackPtr = std::move(m_prefetchedTracks[m_nextPrefetchedIndex++]);
     if (!trackPtr) {
         return std::nullopt;
     }
@@ -27,10 +27,16 @@ class TrackByIdCollectionIterator final
 
     void reset() override {
         m_trackIdListIter.reset();
+        m_prefetchedTracks.clear();
+        m_nextPrefetchedIndex = 0;
     }
 
     std::optional<int> estimateItemsRemaining() override {
-        return m_trackIdListIter.estimateItemsRemaining();
+        const auto itemsRemaining = m_trackIdListIter.estimateItemsRemaining();
+        if (!itemsRemaining) {
+            return std::nullopt;
+        }
+        return *itemsRemaining + m_prefetchedTracks.size() - m_nextPrefetchedIndex;
     }
 
     std::optional<TrackPointer> nextItem() override;
@@ -38,6 +44,11 @@ class TrackByIdCollectionIterator final
   private:
     const TrackCollectionManager* const m_pTrackCollectionManager;
     TrackIdListIterator m_trackIdListIter;
+
+    // Tracks are loaded in batches that are much faster than
+    // loading them one by one.
+    TrackPointerList m_prefetchedTracks;
+    int m_nextPrefetchedIndex = 0;
 };
 
 } // namespace mixxx
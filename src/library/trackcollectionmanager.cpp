@@ -4,8 +4,10 @@
 
 #include "library/externaltrackcollection.h"
 #include "library/library_prefs.h"
+#include "library/libraryquerythread.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
+#include "library/tracksavequeue.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -38,9 +40,11 @@ TrackCollectionManager::TrackCollectionManager(
         QObject* parent,
         UserSettingsPointer pConfig,
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        TrackSaveMode evictedTrackSaveMode,
         deleteTrackFn_t /*only-needed-for-testing*/ deleteTrackForTestingFn)
     : QObject(parent),
       m_pConfig(pConfig),
+      m_pDbConnectionPool(pDbConnectionPool),
       m_pInternalCollection(createInternalTrackCollection(this, pConfig, deleteTrackForTestingFn)) {
     const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
 
@@ -59,6 +63,16 @@ TrackCollectionManager::TrackCollectionManager(
     } else {
         // TODO: Add external collections
     }
+    if (evictedTrackSaveMode == TrackSaveMode::WriteBehind) {
+        m_pTrackSaveQueue = std::make_unique<TrackSaveQueue>(pDbConnectionPool, pConfig);
+        TrackDAO* pTrackDAO = &(m_pInternalCollection->getTrackDAO());
+        pTrackDAO->setTrackSaveQueue(m_pTrackSaveQueue.get());
+        connect(m_pTrackSaveQueue.get(),
+                &TrackSaveQueue::tracksSaved,
+                pTrackDAO,
+                &TrackDAO::slotDatabaseTracksSaved);
+    }
+
     for (const auto& externalCollection : std::as_const(m_externalCollections)) {
         kLogger.info()
                 << "Connecting to"
@@ -129,6 +143,11 @@ TrackCollectionManager::TrackCollectionManager(
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    if (m_pQueryThread) {
+        kLogger.info() << "Stopping library query thread";
+        m_pQueryThread.reset();
+    }
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -151,6 +170,12 @@ TrackCollectionManager::~TrackCollectionManager() {
     // components are accessing those files at this point.
     GlobalTrackCacheLocker().deactivateCache();
 
+    if (m_pTrackSaveQueue) {
+        // Save the evicted tracks before disconnecting from the database
+        m_pInternalCollection->getTrackDAO().setTrackSaveQueue(nullptr);
+        m_pTrackSaveQueue.reset();
+    }
+
     for (const auto& externalCollection : std::as_const(m_externalCollections)) {
         kLogger.info()
                 << "Disconnecting from"
@@ -166,6 +191,14 @@ TrackCollectionManager::~TrackCollectionManager() {
     GlobalTrackCache::destroyInstance();
 }
 
+LibraryQueryThread* TrackCollectionManager::queryThread() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (!m_pQueryThread) {
+        m_pQueryThread = std::make_unique<LibraryQueryThread>(m_pDbConnectionPool);
+    }
+    return m_pQueryThread.get();
+}
+
 void TrackCollectionManager::startLibraryScan() {
     VERIFY_OR_DEBUG_ASSERT(m_pScanner) {
         return;
@@ -185,19 +218,25 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return SaveTrackResult::Skipped;
     }
-    const auto res = saveTrack(pTrack.get(), TrackMetadataExportMode::Deferred);
+    const auto res = saveTrack(
+            pTrack.get(),
+            TrackMetadataExportMode::Deferred,
+            TrackSaveMode::Synchronous);
     return res;
 }
 
 // Export metadata and save the track in both the internal database
 // and external libraries.
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
-    saveTrack(pTrack, TrackMetadataExportMode::Immediate);
+    saveTrack(pTrack,
+            TrackMetadataExportMode::Immediate,
+            m_pTrackSaveQueue ? TrackSaveMode::WriteBehind : TrackSaveMode::Synchronous);
 }
 
 TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         Track* pTrack,
-        TrackMetadataExportMode mode) const {
+        TrackMetadataExportMode mode,
+        TrackSaveMode saveMode) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return SaveTrackResult::Skipped;
@@ -248,17 +287,30 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         return SaveTrackResult::Skipped;
     }
 
-    // This operation must be executed synchronously while the cache is
-    // locked to prevent that a new track is created from outdated
-    // metadata in the database before saving has finished.
-    kLogger.debug()
-            << "Saving track"
-            << pTrack->getLocation()
-            << "in internal collection";
-    if (!m_pInternalCollection->saveTrack(pTrack)) {
-        // The dirty flag is not reset when saving fails
-        DEBUG_ASSERT(pTrack->isDirty());
-        return SaveTrackResult::Failed;
+    if (saveMode == TrackSaveMode::WriteBehind &&
+            m_pTrackSaveQueue->enqueue(TrackSnapshot::fromTrack(*pTrack))) {
+        // The evicted track is saved later in a batch with other
+        // tracks. Loading the track again from the database saves
+        // the pending snapshot first to prevent that a new track is
+        // created from outdated metadata.
+        kLogger.debug()
+                << "Enqueued track"
+                << pTrack->getLocation()
+                << "for saving in internal collection";
+        pTrack->markClean();
+    } else {
+        // This operation must be executed synchronously while the cache is
+        // locked to prevent that a new track is created from outdated
+        // metadata in the database before saving has finished.
+        kLogger.debug()
+                << "Saving track"
+                << pTrack->getLocation()
+                << "in internal collection";
+        if (!m_pInternalCollection->saveTrack(pTrack)) {
+            // The dirty flag is not reset when saving fails
+            DEBUG_ASSERT(pTrack->isDirty());
+            return SaveTrackResult::Failed;
+        }
     }
     // The dirty flag is reset after the track has been saved successfully
     DEBUG_ASSERT(!pTrack->isDirty());
@@ -569,6 +621,12 @@ TrackPointer TrackCollectionManager::getTrackById(
             trackId);
 }
 
+QList<TrackPointer> TrackCollectionManager::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    return internalCollection()->getTracksByIds(
+            trackIds);
+}
+
 TrackPointer TrackCollectionManager::getTrackByRef(
         const TrackRef& trackRef) const {
     return internalCollection()->getTrackByRef(
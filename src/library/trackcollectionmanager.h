@@ -13,8 +13,10 @@
 #include "util/parented_ptr.h"
 #include "util/thread_affinity.h"
 
+class LibraryQueryThread;
 class LibraryScanner;
 class TrackCollection;
+class TrackSaveQueue;
 class ExternalTrackCollection;
 
 // Manages Mixxx's internal database of tracks as well as external track collections.
@@ -30,10 +32,19 @@ class TrackCollectionManager: public QObject,
     Q_OBJECT
 
   public:
+    /// How the modifications of evicted tracks are saved
+    enum class TrackSaveMode {
+        Synchronous,
+        // Saved in batches by a TrackSaveQueue. Only for evicted
+        // tracks that are not accessed anymore.
+        WriteBehind,
+    };
+
     TrackCollectionManager(
             QObject* parent,
             UserSettingsPointer pConfig,
             mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            TrackSaveMode evictedTrackSaveMode = TrackSaveMode::WriteBehind,
             deleteTrackFn_t deleteTrackForTestingFn = nullptr);
     ~TrackCollectionManager() override;
 
@@ -47,8 +58,20 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    /// Executes the queries of table models in the background. The
+    /// thread is started on first use.
+    LibraryQueryThread* queryThread();
+
+    /// Saves the modifications of evicted tracks. Only available
+    /// in TrackSaveMode::WriteBehind.
+    TrackSaveQueue* trackSaveQueue() const {
+        return m_pTrackSaveQueue.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
     TrackPointer getTrackByRef(
             const TrackRef& trackRef) const;
     QList<TrackId> resolveTrackIdsFromUrls(
@@ -114,17 +137,25 @@ class TrackCollectionManager: public QObject,
     };
     SaveTrackResult saveTrack(
             Track* pTrack,
-            TrackMetadataExportMode mode) const;
+            TrackMetadataExportMode mode,
+            TrackSaveMode saveMode) const;
     ExportTrackMetadataResult exportTrackMetadataBeforeSaving(
             Track* pTrack,
             TrackMetadataExportMode mode) const;
 
     const UserSettingsPointer m_pConfig;
 
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
     const parented_ptr<TrackCollection> m_pInternalCollection;
 
     QList<ExternalTrackCollection*> m_externalCollections;
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<LibraryQueryThread> m_pQueryThread;
+
+    // Saves evicted tracks in the background
+    std::unique_ptr<TrackSaveQueue> m_pTrackSaveQueue;
 };
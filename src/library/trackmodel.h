@@ -212,6 +212,14 @@ class TrackModel {
     virtual void select() {
     }
 
+    /// Called by the view with the rows that have become visible, e.g.
+    /// after scrolling or after the rows have changed. Models that load
+    /// the data of their rows lazily fetch it here, rather than while
+    /// the data is requested for painting.
+    virtual void prefetchRows(const QModelIndexList& indices) {
+        Q_UNUSED(indices);
+    }
+
     /// @brief modelKey returns a unique identifier for the model
     /// @param noSearch don't include the current search in the key
     /// @param baseOnly return only a identifier for the whole subsystem
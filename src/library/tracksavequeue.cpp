@@ -0,0 +1,213 @@
+#include "library/tracksavequeue.h"
+
+#include "moc_tracksavequeue.cpp"
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+#include "util/stat.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackSaveQueue");
+
+const QString kQueueDepthStatTag = QStringLiteral("TrackSaveQueue queue depth");
+
+// The maximum number of tracks that are saved in a single transaction
+constexpr int kMaxBatchSize = 256;
+
+// The maximum time a snapshot is pending before it is saved
+constexpr qint64 kMaxPendingMillis = 500;
+
+} // anonymous namespace
+
+TrackSaveQueue::TrackSaveQueue(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        UserSettingsPointer pConfig)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_analysisDao(pConfig),
+          m_trackDao(m_cueDao,
+                  m_playlistDao,
+                  m_analysisDao,
+                  m_libraryHashDao,
+                  pConfig),
+          m_bFlushRequested(false),
+          m_bStopThread(false),
+          m_bPaused(false) {
+    start(QThread::LowPriority);
+}
+
+TrackSaveQueue::~TrackSaveQueue() {
+    {
+        QMutexLocker locker(&m_mutex);
+        const int queueDepth = m_pendingTrackIds.size() + m_savingTrackIds.size();
+        if (queueDepth > 0) {
+            kLogger.info()
+                    << "Saving"
+                    << queueDepth
+                    << "pending track(s) before stopping";
+        }
+        m_bStopThread = true;
+        m_snapshotEnqueued.wakeAll();
+    }
+    wait();
+    DEBUG_ASSERT(m_pendingSnapshots.isEmpty());
+}
+
+bool TrackSaveQueue::enqueue(TrackSnapshot trackSnapshot) {
+    const TrackId trackId = trackSnapshot.getId();
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return false;
+    }
+    QMutexLocker locker(&m_mutex);
+    if (m_bStopThread) {
+        return false;
+    }
+    const auto it = m_pendingSnapshots.find(trackId);
+    if (it != m_pendingSnapshots.end()) {
+        // The newer snapshot replaces the pending one without
+        // changing its position in the queue
+        it.value() = std::move(trackSnapshot);
+        Counter("TrackSaveQueue coalesced")++;
+        return true;
+    }
+    if (m_pendingTrackIds.isEmpty()) {
+        m_pendingTimer.start();
+    }
+    m_pendingSnapshots.insert(trackId, std::move(trackSnapshot));
+    m_pendingTrackIds.append(trackId);
+    Stat::track(kQueueDepthStatTag,
+            Stat::UNSPECIFIED,
+            Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+            m_pendingTrackIds.size() + m_savingTrackIds.size());
+    m_snapshotEnqueued.wakeAll();
+    return true;
+}
+
+std::optional<TrackSnapshot> TrackSaveQueue::takePendingSnapshot(TrackId trackId) {
+    QMutexLocker locker(&m_mutex);
+    while (m_savingTrackIds.contains(trackId)) {
+        m_batchSaved.wait(&m_mutex);
+    }
+    const auto it = m_pendingSnapshots.find(trackId);
+    if (it == m_pendingSnapshots.end()) {
+        return std::nullopt;
+    }
+    TrackSnapshot trackSnapshot = std::move(it.value());
+    m_pendingSnapshots.erase(it);
+    m_pendingTrackIds.removeOne(trackId);
+    return trackSnapshot;
+}
+
+void TrackSaveQueue::flush() {
+    QMutexLocker locker(&m_mutex);
+    while (!m_pendingTrackIds.isEmpty() || !m_savingTrackIds.isEmpty()) {
+        m_bFlushRequested = true;
+        m_snapshotEnqueued.wakeAll();
+        m_batchSaved.wait(&m_mutex);
+    }
+}
+
+int TrackSaveQueue::queueDepth() const {
+    QMutexLocker locker(&m_mutex);
+    return m_pendingTrackIds.size() + m_savingTrackIds.size();
+}
+
+void TrackSaveQueue::setPausedForTesting(bool paused) {
+    QMutexLocker locker(&m_mutex);
+    m_bPaused = paused;
+    m_snapshotEnqueued.wakeAll();
+}
+
+QList<TrackSnapshot> TrackSaveQueue::takeNextBatchLocked() {
+    DEBUG_ASSERT(m_savingTrackIds.isEmpty());
+    const int batchSize = qMin(m_pendingTrackIds.size(), kMaxBatchSize);
+    QList<TrackSnapshot> batch;
+    batch.reserve(batchSize);
+    for (int i = 0; i < batchSize; ++i) {
+        const TrackId trackId = m_pendingTrackIds.takeFirst();
+        batch.append(m_pendingSnapshots.take(trackId));
+        m_savingTrackIds.insert(trackId);
+    }
+    if (m_pendingTrackIds.isEmpty()) {
+        m_bFlushRequested = false;
+    } else {
+        // The remaining snapshots are saved with the next batch
+        // without waiting for more snapshots
+        m_pendingTimer.invalidate();
+    }
+    return batch;
+}
+
+void TrackSaveQueue::run() {
+    QThread::currentThread()->setObjectName("TrackSaveQueue");
+    // The pooler limits the lifetime of the thread-local database
+    // connection to the lifetime of this thread.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    VERIFY_OR_DEBUG_ASSERT(database.isOpen()) {
+        kLogger.warning() << "No database connection available";
+        QMutexLocker locker(&m_mutex);
+        m_bStopThread = true;
+        if (!m_pendingTrackIds.isEmpty()) {
+            kLogger.warning()
+                    << "Discarding modifications of"
+                    << m_pendingTrackIds.size()
+                    << "evicted track(s)";
+        }
+        m_pendingSnapshots.clear();
+        m_pendingTrackIds.clear();
+        m_batchSaved.wakeAll();
+        return;
+    }
+    m_libraryHashDao.initialize(database);
+    m_cueDao.initialize(database);
+    m_playlistDao.initialize(database);
+    m_analysisDao.initialize(database);
+    m_trackDao.initialize(database);
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_pendingTrackIds.isEmpty() || !m_bStopThread) {
+        if (m_pendingTrackIds.isEmpty()) {
+            m_snapshotEnqueued.wait(&m_mutex);
+            continue;
+        }
+        if (m_bPaused && !m_bStopThread && !m_bFlushRequested) {
+            m_snapshotEnqueued.wait(&m_mutex);
+            continue;
+        }
+        if (!m_bStopThread &&
+                !m_bFlushRequested &&
+                m_pendingTimer.isValid() &&
+                m_pendingTrackIds.size() < kMaxBatchSize) {
+            // Collect more snapshots for the batch
+            const qint64 remainingMillis = kMaxPendingMillis - m_pendingTimer.elapsed();
+            if (remainingMillis > 0) {
+                m_snapshotEnqueued.wait(&m_mutex, static_cast<unsigned long>(remainingMillis));
+                continue;
+            }
+        }
+        const QList<TrackSnapshot> batch = takeNextBatchLocked();
+        locker.unlock();
+
+        PerformanceTimer time;
+        time.start();
+        const QList<TrackId> savedTrackIds = m_trackDao.updateTracks(batch);
+        kLogger.debug()
+                << "Saving"
+                << savedTrackIds.size()
+                << '/'
+                << batch.size()
+                << "track(s) took"
+                << time.elapsed().debugMillisWithUnit();
+        if (!savedTrackIds.isEmpty()) {
+            emit tracksSaved(savedTrackIds);
+        }
+
+        locker.relock();
+        m_savingTrackIds.clear();
+        m_batchSaved.wakeAll();
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QThread>
+#include <QWaitCondition>
+#include <optional>
+
+#include "library/dao/analysisdao.h"
+#include "library/dao/cuedao.h"
+#include "library/dao/libraryhashdao.h"
+#include "library/dao/playlistdao.h"
+#include "library/dao/trackdao.h"
+#include "library/dao/tracksnapshot.h"
+#include "preferences/usersettings.h"
+#include "util/db/dbconnectionpool.h"
+
+/// Saves the modifications of evicted tracks in the database on a
+/// separate thread and connection (write-behind).
+///
+/// Saving each evicted track immediately requires a separate transaction
+/// per track. Batch operations on many tracks cause a lot of small
+/// transactions when the tracks are evicted afterwards. Instead the
+/// snapshots of evicted tracks are collected for a short time and
+/// then saved together in a single transaction. A pending snapshot
+/// is replaced if the same track is evicted again.
+///
+/// A track with a pending snapshot must not be loaded from the database
+/// before its snapshot has been saved, see takePendingSnapshot().
+class TrackSaveQueue : public QThread {
+    Q_OBJECT
+  public:
+    TrackSaveQueue(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            UserSettingsPointer pConfig);
+    /// Saves all pending snapshots before returning.
+    ~TrackSaveQueue() override;
+
+    /// Returns false if the snapshot could not be enqueued, e.g.
+    /// when the queue has already been stopped. The track needs
+    /// to be saved synchronously then.
+    bool enqueue(TrackSnapshot trackSnapshot);
+
+    /// Removes and returns the pending snapshot of a track for saving
+    /// it synchronously before loading the track again. Blocks while
+    /// the track is currently being saved by this thread.
+    std::optional<TrackSnapshot> takePendingSnapshot(TrackId trackId);
+
+    /// Blocks until all pending snapshots have been saved.
+    void flush();
+
+    /// The number of snapshots that have not been saved yet,
+    /// including those that are currently being saved.
+    int queueDepth() const;
+
+    /// Holds back all pending snapshots until resumed, except when
+    /// flushing or stopping the queue. Only needed for testing.
+    void setPausedForTesting(bool paused);
+
+  signals:
+    /// Emitted from this thread after a batch has been saved.
+    void tracksSaved(const QList<TrackId>& trackIds);
+
+  protected:
+    void run() override;
+
+  private:
+    // Must be called with m_mutex locked
+    QList<TrackSnapshot> takeNextBatchLocked();
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    // Only accessed from this thread
+    LibraryHashDAO m_libraryHashDao;
+    CueDAO m_cueDao;
+    PlaylistDAO m_playlistDao;
+    AnalysisDao m_analysisDao;
+    TrackDAO m_trackDao;
+
+    // You must hold m_mutex to touch the following members
+    mutable QMutex m_mutex;
+    QWaitCondition m_snapshotEnqueued;
+    QWaitCondition m_batchSaved;
+    QHash<TrackId, TrackSnapshot> m_pendingSnapshots;
+    // The order in which pending snapshots are saved
+    QList<TrackId> m_pendingTrackIds;
+    // The tracks of the batch that is currently being saved
+    QSet<TrackId> m_savingTrackIds;
+    // Started when the first snapshot is enqueued into an empty queue
+    QElapsedTimer m_pendingTimer;
+    bool m_bFlushRequested;
+    bool m_bStopThread;
+    bool m_bPaused;
+};
@@ -46,6 +46,7 @@ BasePlaylistFeature::BasePlaylistFeature(
                                 ->getPlaylistDAO()),
           m_pPlaylistTableModel(pModel) {
     pModel->setParent(this);
+    pModel->setSelectAsync(true);
 
     initActions();
 }
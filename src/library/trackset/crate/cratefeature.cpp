@@ -51,6 +51,7 @@ CrateFeature::CrateFeature(Library* pLibrary,
           m_lockedCrateIcon(":/images/library/ic_library_locked_tracklist.svg"),
           m_pTrackCollection(pLibrary->trackCollectionManager()->internalCollection()),
           m_crateTableModel(this, pLibrary->trackCollectionManager()) {
+    m_crateTableModel.setSelectAsync(true);
     initActions();
 
     // construct child model
@@ -328,7 +328,7 @@ void SetlogFeature::slotJoinWithPrevious() {
                 if (currentPlaylistId == m_playlistId) {
                     // mark all the Tracks in the previous Playlist as played
 
-                    m_pPlaylistTableModel->select();
+                    m_pPlaylistTableModel->selectSync();
                     int rows = m_pPlaylistTableModel->rowCount();
                     for (int i = 0; i < rows; ++i) {
                         QModelIndex index = m_pPlaylistTableModel->index(i, 0);
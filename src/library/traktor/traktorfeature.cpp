@@ -8,6 +8,8 @@
 #include <QXmlStreamReader>
 #include <QtDebug>
 
+#include "library/dao/settingsdao.h"
+#include "library/externallibrarysync.h"
 #include "library/library.h"
 #include "library/librarytablemodel.h"
 #include "library/missingtablemodel.h"
@@ -22,6 +24,26 @@
 
 namespace {
 
+const QString kFingerprintKey = QStringLiteral("mixxx.traktorfeature.fingerprint");
+
+const QString kPlaylistPathDelimiter = QStringLiteral("-->");
+
+// The value columns of traktor_library, in the order of parseTrack()
+const QStringList kTrackValueColumns = {
+        QStringLiteral("artist"),
+        QStringLiteral("title"),
+        QStringLiteral("album"),
+        QStringLiteral("year"),
+        QStringLiteral("genre"),
+        QStringLiteral("comment"),
+        QStringLiteral("tracknumber"),
+        QStringLiteral("bpm"),
+        QStringLiteral("bitrate"),
+        QStringLiteral("duration"),
+        QStringLiteral("rating"),
+        QStringLiteral("key"),
+};
+
 QString fromTraktorSeparators(QString path) {
     // Traktor uses /: instead of just / as delimiting character for some reasons
     return path.replace("/:", "/");
@@ -201,20 +223,6 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     thisThread->setPriority(QThread::LowPriority);
     //Invisible root item of Traktor's child model
     TreeItem* root = nullptr;
-    //Delete all table entries of Traktor feature
-    ScopedTransaction transaction(m_database);
-    clearTable("traktor_playlist_tracks");
-    clearTable("traktor_library");
-    clearTable("traktor_playlists");
-    transaction.commit();
-
-    transaction.transaction();
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO traktor_library (artist, title, album, year,"
-                  "genre,comment,tracknumber,bpm, bitrate,duration, location,"
-                  "rating,key) VALUES (:artist, :title, :album, :year,:genre,"
-                  ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
-                  ":rating,:key)");
 
     //Parse Trakor XML file using SAX (for performance)
     mixxx::FileInfo fileInfo(file);
@@ -223,6 +231,34 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
         qDebug() << "Cannot open Traktor music collection";
         return nullptr;
     }
+
+    // Skip parsing if the file has not changed since the last import, the
+    // tables still contain its contents.
+    SettingsDAO settings(m_database);
+    const QString fingerprint = externalLibraryFileFingerprint(file);
+    if (!fingerprint.isEmpty() && settings.getValue(kFingerprintKey) == fingerprint) {
+        qDebug() << "Traktor music collection is unchanged since the last import";
+        return loadPlaylistsFromDatabase();
+    }
+
+    // All changes are applied in a single transaction. The models of this
+    // feature keep showing the previous import until it is committed.
+    ScopedTransaction transaction(m_database);
+    ExternalLibraryTableSync trackSync(m_database,
+            QStringLiteral("traktor_library"),
+            QStringLiteral("location"),
+            kTrackValueColumns);
+    ExternalLibraryTableSync playlistSync(m_database,
+            QStringLiteral("traktor_playlists"),
+            QStringLiteral("name"),
+            QStringList());
+    ExternalLibraryPlaylistTracksSync playlistTracksSync(m_database,
+            QStringLiteral("traktor_playlist_tracks"));
+    if (!trackSync.load() || !playlistSync.load() || !playlistTracksSync.load()) {
+        return nullptr;
+    }
+
+    ExternalLibraryImportProgress progress(&traktor_file);
     QXmlStreamReader xml(&traktor_file);
     bool inCollectionTag = false;
     bool inPlaylistsTag = false;
@@ -238,8 +274,12 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             // Each "ENTRY" tag in <COLLECTION> represents a track
             if (inCollectionTag && xml.name() == QLatin1String("ENTRY")) {
                 //parse track
-                parseTrack(xml, query);
+                parseTrack(xml, &trackSync);
                 ++nAudioFiles; //increment number of files in the music collection
+                const int percent = progress.update();
+                if (percent >= 0) {
+                    reportImportProgress(percent);
+                }
             }
             if (xml.name() == QLatin1String("PLAYLISTS")) {
                 inPlaylistsTag = true;
@@ -251,7 +291,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
 
                 if (nodetype == "FOLDER" && name == "$ROOT") {
                     //process all playlists
-                    root = parsePlaylists(xml);
+                    root = parsePlaylists(xml, &playlistSync, &playlistTracksSync, &progress);
                     isRootFolderParsed = true;
                 }
             }
@@ -265,8 +305,9 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             }
         }
     }
-    if (xml.hasError()) {
-         // do error handling
+    if (xml.hasError() || m_cancelImport) {
+         // do error handling, the transaction is rolled back and the
+         // previous import is kept
          qDebug() << "Cannot process Traktor music collection";
          if (root) {
              delete root;
@@ -274,14 +315,71 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
          return nullptr;
     }
 
+    trackSync.removeUnwritten();
+    playlistSync.removeUnwritten();
+    playlistTracksSync.removeUnwritten();
+    settings.setValue(kFingerprintKey, fingerprint);
+
     qDebug() << "Found: " << nAudioFiles << " audio files in Traktor";
     //initialize TraktorTableModel
     transaction.commit();
 
+    const ExternalLibraryTableSync::Stats& stats = trackSync.stats();
+    qDebug() << "Traktor music collection imported:"
+             << stats.inserted << "tracks inserted,"
+             << stats.updated << "updated,"
+             << stats.deleted << "deleted,"
+             << stats.unchanged << "unchanged,"
+             << playlistTracksSync.numRewrittenPlaylists() << "playlists rewritten";
     return root;
 }
 
-void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
+TreeItem* TraktorFeature::loadPlaylistsFromDatabase() {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT name FROM traktor_playlists ORDER BY id")) {
+        LOG_FAILED_QUERY(query);
+        return nullptr;
+    }
+    // Rebuild the folders from the paths of the playlists, which are stored
+    // in the order of parsePlaylists(). Empty folders are not stored and
+    // thus will be missing until the collection is parsed again.
+    std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
+    QHash<QString, TreeItem*> folders;
+    while (query.next()) {
+        const QString playlist_path = query.value(0).toString();
+        const QStringList names = playlist_path.split(kPlaylistPathDelimiter);
+        TreeItem* parent = rootItem.get();
+        QString current_path;
+        // The path starts with a delimiter, so the first name is empty
+        for (int i = 1; i < names.size() - 1; ++i) {
+            current_path += kPlaylistPathDelimiter;
+            current_path += names.at(i);
+            TreeItem*& folder = folders[current_path];
+            if (!folder) {
+                folder = parent->appendChild(names.at(i), current_path);
+            }
+            parent = folder;
+        }
+        parent->appendChild(names.last(), playlist_path);
+    }
+    return rootItem.release();
+}
+
+void TraktorFeature::reportImportProgress(int percent) {
+    QMetaObject::invokeMethod(
+            this,
+            [this, percent] {
+                if (!m_future.isRunning()) {
+                    return;
+                }
+                m_title = tr("(loading %1%) Traktor").arg(percent);
+                emit featureIsLoading(this, false);
+            },
+            Qt::QueuedConnection);
+}
+
+void TraktorFeature::parseTrack(QXmlStreamReader& xml, ExternalLibraryTableSync* pTrackSync) {
     QString title;
     QString artist;
     QString album;
@@ -378,27 +476,21 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
     }
 
     // If we reach the end of ENTRY within the COLLECTION tag
-    // Save parsed track to database
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":genre", genre);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":key", key);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-
-    bool success = query.exec();
-    if (!success) {
-        qDebug() << "SQL Error in TraktorTableModel.cpp: line"
-                 << __LINE__ << " " << query.lastError();
-        return;
-    }
+    // Save parsed track to database, unless it is unchanged. The bpm is
+    // widened to double like when it is read back from the database.
+    pTrackSync->write(location,
+            QVariantList{artist,
+                    title,
+                    album,
+                    year,
+                    genre,
+                    comment,
+                    tracknumber,
+                    static_cast<double>(bpm),
+                    bitrate,
+                    playtime,
+                    rating,
+                    key});
 }
 
 // Purpose: Parsing all the folder and playlists of Traktor
@@ -406,26 +498,34 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
 // A folder can contain folders and playlists. A playlist contains entries but no folders.
 // In other words, Traktor uses a tree structure to organize music.
 // Inner nodes represent folders while leaves are playlists.
-TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
+TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader& xml,
+        ExternalLibraryTableSync* pPlaylistSync,
+        ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync,
+        ExternalLibraryImportProgress* pProgress) {
 
     qDebug() << "Process RootFolder";
     //Each playlist is unique and can be identified by a path in the tree structure.
     QString current_path = "";
     QMap<QString,QString> map;
 
-    QString delimiter = "-->";
+    const QString& delimiter = kPlaylistPathDelimiter;
 
     std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
     TreeItem* parent = rootItem.get();
 
-    QSqlQuery query_insert_to_playlists(m_database);
-    query_insert_to_playlists.prepare("INSERT INTO traktor_playlists (name) "
-                  "VALUES (:name)");
-
-    QSqlQuery query_insert_to_playlist_tracks(m_database);
-    query_insert_to_playlist_tracks.prepare(
-        "INSERT INTO traktor_playlist_tracks (playlist_id, track_id, position) "
-        "VALUES (:playlist_id, :track_id, :position)");
+    // The collection precedes the playlists, so all tracks have been
+    // written. Look up their ids once instead of once per playlist entry.
+    QHash<QString, int> trackIdsByLocation;
+    QSqlQuery track_id_query(m_database);
+    track_id_query.setForwardOnly(true);
+    if (track_id_query.exec("SELECT id, location FROM traktor_library")) {
+        while (track_id_query.next()) {
+            trackIdsByLocation.insert(track_id_query.value(1).toString(),
+                    track_id_query.value(0).toInt());
+        }
+    } else {
+        LOG_FAILED_QUERY(track_id_query);
+    }
 
     while (!xml.atEnd() && !m_cancelImport) {
         //read next XML element
@@ -454,8 +554,13 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
                     // process all the entries within the playlist 'name' having path 'current_path'
                     parsePlaylistEntries(xml,
                             current_path,
-                            std::move(query_insert_to_playlists),
-                            std::move(query_insert_to_playlist_tracks));
+                            trackIdsByLocation,
+                            pPlaylistSync,
+                            pPlaylistTracksSync);
+                    const int percent = pProgress->update();
+                    if (percent >= 0) {
+                        reportImportProgress(percent);
+                    }
                 }
             }
         }
@@ -484,16 +589,14 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
 void TraktorFeature::parsePlaylistEntries(
         QXmlStreamReader& xml,
         const QString& playlist_path,
-        QSqlQuery query_insert_into_playlist,
-        QSqlQuery query_insert_into_playlisttracks) {
+        const QHash<QString, int>& trackIdsByLocation,
+        ExternalLibraryTableSync* pPlaylistSync,
+        ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync) {
     // In the database, the name of a playlist is specified by the unique path,
     // e.g., /someFolderA/someFolderB/playlistA"
-    query_insert_into_playlist.bindValue(":name", playlist_path);
-
-    if (!query_insert_into_playlist.exec()) {
-        LOG_FAILED_QUERY(query_insert_into_playlist)
-                << "Failed to insert playlist in TraktorTableModel:"
-                << playlist_path;
+    if (!pPlaylistSync->write(playlist_path, QVariantList())) {
+        qDebug() << "Failed to insert playlist in TraktorTableModel:"
+                 << playlist_path;
         return;
     }
 
@@ -515,7 +618,7 @@ void TraktorFeature::parsePlaylistEntries(
         playlist_id = id_query.value(idColumn).toInt();
     }
 
-    int playlist_position = 1;
+    QVector<int> trackIds;
     while (!xml.atEnd() && !m_cancelImport) {
         //read next XML element
         xml.readNext();
@@ -530,29 +633,7 @@ void TraktorFeature::parsePlaylistEntries(
                     key.prepend("/Volumes/");
                     #endif
 
-                    //insert to database
-                    int track_id = -1;
-                    QSqlQuery finder_query(m_database);
-                    finder_query.prepare("select id from traktor_library where location=:path");
-                    finder_query.bindValue(":path", key);
-
-                    if (!finder_query.exec()) {
-                        LOG_FAILED_QUERY(finder_query) << "Could not get track id:" << key;
-                        continue;
-                    }
-
-                    if (finder_query.next()) {
-                        track_id = finder_query.value(finder_query.record().indexOf("id")).toInt();
-                    }
-
-                    query_insert_into_playlisttracks.bindValue(":playlist_id", playlist_id);
-                    query_insert_into_playlisttracks.bindValue(":track_id", track_id);
-                    query_insert_into_playlisttracks.bindValue(":position", playlist_position++);
-                    if (!query_insert_into_playlisttracks.exec()) {
-                        LOG_FAILED_QUERY(query_insert_into_playlisttracks)
-                                << "trackid" << track_id << " with path " << key
-                                << "playlistname; " << playlist_path <<" with ID " << playlist_id;
-                    }
+                    trackIds.append(trackIdsByLocation.value(key, -1));
                 }
             }
         }
@@ -563,17 +644,11 @@ void TraktorFeature::parsePlaylistEntries(
             }
         }
     }
-}
 
-void TraktorFeature::clearTable(const QString& table_name) {
-    QSqlQuery query(m_database);
-    query.prepare("delete from "+table_name);
-
-    if (!query.exec()) {
-        qDebug() << "Could not delete remove old entries from table "
-                 << table_name << " : " << query.lastError();
-    } else {
-        qDebug() << "Traktor table entries of '" << table_name << "' have been cleared.";
+    //insert to database
+    if (!pPlaylistTracksSync->write(playlist_id, trackIds)) {
+        qDebug() << "Failed to write the tracks of Traktor playlist"
+                 << playlist_path << "with ID" << playlist_id;
     }
 }
 
@@ -12,6 +12,10 @@
 #include "library/baseexternalplaylistmodel.h"
 #include "library/treeitemmodel.h"
 
+class ExternalLibraryImportProgress;
+class ExternalLibraryPlaylistTracksSync;
+class ExternalLibraryTableSync;
+
 class TraktorTrackModel : public BaseExternalTrackModel {
     Q_OBJECT
   public:
@@ -50,16 +54,23 @@ class TraktorFeature : public BaseExternalLibraryFeature {
   private:
     BaseSqlTableModel* getPlaylistModelForPlaylist(const QString& playlist) override;
     TreeItem* importLibrary(const QString& file);
+    // builds the sidebar model from the playlists of the previous import
+    TreeItem* loadPlaylistsFromDatabase();
     // parses a track in the music collection
-    void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
+    void parseTrack(QXmlStreamReader& xml, ExternalLibraryTableSync* pTrackSync);
     // Iterates over all playliost and folders and constructs the childmodel
-    TreeItem* parsePlaylists(QXmlStreamReader &xml);
+    TreeItem* parsePlaylists(QXmlStreamReader& xml,
+            ExternalLibraryTableSync* pPlaylistSync,
+            ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync,
+            ExternalLibraryImportProgress* pProgress);
     // processes a particular playlist
     void parsePlaylistEntries(QXmlStreamReader& xml,
             const QString& playlist_path,
-            QSqlQuery query_insert_into_playlist,
-            QSqlQuery query_insert_into_playlisttracks);
-    void clearTable(const QString& table_name);
+            const QHash<QString, int>& trackIdsByLocation,
+            ExternalLibraryTableSync* pPlaylistSync,
+            ExternalLibraryPlaylistTracksSync* pPlaylistTracksSync);
+    // called from the import thread
+    void reportImportProgress(int percent);
     static QString getTraktorMusicDatabase();
     // private fields
     parented_ptr<TreeItemModel> m_pSidebarModel;
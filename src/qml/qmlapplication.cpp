@@ -1,7 +1,9 @@
 #include "qmlapplication.h"
 
+#include <QQuickWindow>
 #include <QtQml/qqmlextensionplugin.h>
 
+#include "control/controlchangebus.h"
 #include "control/controlsortfiltermodel.h"
 #include "moc_qmlapplication.cpp"
 #include "qml/asyncimageprovider.h"
@@ -108,6 +110,21 @@ void QmlApplication::loadQml(const QString& path) {
     m_pAppEngine->load(path);
     if (m_pAppEngine->rootObjects().isEmpty()) {
         qCritical() << "Failed to load QML file" << path;
+        return;
+    }
+
+    // There is no GuiTick in the QML GUI, so deliver the coalesced control
+    // changes once per frame instead. afterAnimating is emitted in the GUI
+    // thread before the scene graph is synchronized, so the changes are
+    // rendered in the same frame.
+    for (QObject* pObject : m_pAppEngine->rootObjects()) {
+        auto* pWindow = qobject_cast<QQuickWindow*>(pObject);
+        if (pWindow) {
+            connect(pWindow,
+                    &QQuickWindow::afterAnimating,
+                    ControlChangeBus::instance(),
+                    &ControlChangeBus::process);
+        }
     }
 }
 
@@ -138,9 +138,13 @@ void QmlControlProxy::reinitializeFromKey() {
     // check below and print a warning anyway. If the key is invalid, this will
     // still trigger an assertion because we checked the key validity above. If
     // it's still invalid, that's a programming error.
+    // Value changes are coalesced and delivered once per GUI tick, because
+    // QML only needs the latest value for rendering.
     std::unique_ptr<ControlProxy> pControlProxy =
             std::make_unique<ControlProxy>(
-                    m_coKey, this, ControlFlag::NoWarnIfMissing);
+                    m_coKey,
+                    this,
+                    ControlFlag::NoWarnIfMissing | ControlFlag::CoalesceChanges);
 
     // This should never happen, but it doesn't hurt to check.
     VERIFY_OR_DEBUG_ASSERT(pControlProxy != nullptr) {
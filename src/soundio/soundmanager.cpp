@@ -3,6 +3,7 @@
 #include <portaudio.h>
 
 #include <QLibrary>
+#include <QMutex>
 #include <QThread>
 #include <QtDebug>
 #include <cstring> // for memcpy and strcmp
@@ -41,6 +42,13 @@ struct DeviceMode {
 #ifdef __LINUX__
 constexpr unsigned int kSleepSecondsAfterClosingDevice = 5;
 #endif
+
+// The result of SoundManager::preinitializePortAudio() until it is
+// adopted by the SoundManager
+QMutex s_paPreinitializationMutex;
+bool s_paPreinitialized = false;
+PaError s_paPreinitializationError = paNoError;
+
 } // anonymous namespace
 
 SoundManager::SoundManager(UserSettingsPointer pConfig,
@@ -252,13 +260,34 @@ void SoundManager::clearAndQueryDevices() {
     queryDevices();
 }
 
+//static
+void SoundManager::preinitializePortAudio() {
+    const QMutexLocker locker(&s_paPreinitializationMutex);
+    if (s_paPreinitialized) {
+        return;
+    }
+#ifdef Q_OS_LINUX
+    setJACKName();
+#endif
+    s_paPreinitializationError = Pa_Initialize();
+    s_paPreinitialized = true;
+}
+
 void SoundManager::queryDevicesPortaudio() {
     PaError err = paNoError;
     if (!m_paInitialized) {
+        // Blocks while PortAudio is initialized concurrently
+        QMutexLocker locker(&s_paPreinitializationMutex);
+        if (s_paPreinitialized) {
+            err = s_paPreinitializationError;
+            s_paPreinitialized = false;
+        } else {
+            locker.unlock();
 #ifdef Q_OS_LINUX
-        setJACKName();
+            setJACKName();
 #endif
-        err = Pa_Initialize();
+            err = Pa_Initialize();
+        }
         m_paInitialized = true;
     }
     if (err != paNoError) {
@@ -650,7 +679,8 @@ QList<AudioInput> SoundManager::registeredInputs() const {
     return m_registeredDestinations.keys();
 }
 
-void SoundManager::setJACKName() const {
+//static
+void SoundManager::setJACKName() {
 #ifdef Q_OS_LINUX
     typedef PaError (*SetJackClientName)(const char *name);
     QLibrary portaudio("libportaudio.so.2");
@@ -42,6 +42,12 @@ class SoundManager : public QObject {
     SoundManager(UserSettingsPointer pConfig, EngineMaster *_master);
     ~SoundManager() override;
 
+    /// Initializes PortAudio, which enumerates all devices and might take
+    /// a while. May be called from any thread before the SoundManager is
+    /// created, which then adopts the initialized PortAudio instead of
+    /// initializing it again.
+    static void preinitializePortAudio();
+
     // Returns a list of all devices we've enumerated that match the provided
     // filterApi, and have at least one output or input channel if the
     // bOutputDevices or bInputDevices are set, respectively.
@@ -125,7 +131,7 @@ class SoundManager : public QObject {
     // isn't open is safe.
     void closeDevices(bool sleepAfterClosing);
 
-    void setJACKName() const;
+    static void setJACKName();
 
     EngineMaster *m_pMaster;
     UserSettingsPointer m_pConfig;
@@ -0,0 +1,202 @@
+#include "library/autodj/autodjcratetracks.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+
+namespace {
+
+AutoDJCrateTracks::TrackInfo trackInfo(
+        int id,
+        int timesPlayed = 0,
+        const QDateTime& lastPlayed = QDateTime()) {
+    AutoDJCrateTracks::TrackInfo trackInfo;
+    trackInfo.id = TrackId(id);
+    trackInfo.timesPlayed = timesPlayed;
+    trackInfo.lastPlayed = lastPlayed;
+    return trackInfo;
+}
+
+QDateTime daysAgo(int days) {
+    return QDateTime::currentDateTimeUtc().addDays(-days);
+}
+
+} // anonymous namespace
+
+class AutoDJCrateTracksTest : public testing::Test {
+  protected:
+    QList<TrackId> activeTracks() const {
+        QList<TrackId> trackIds;
+        for (int i = 0; i < m_crateTracks.activeTrackCount(); ++i) {
+            trackIds.append(m_crateTracks.activeTrackAt(i));
+        }
+        return trackIds;
+    }
+
+    AutoDJCrateTracks m_crateTracks;
+};
+
+TEST_F(AutoDJCrateTracksTest, orderByTimesPlayedAndLastPlayed) {
+    m_crateTracks.addCrateTracks(CrateId(1),
+            {trackInfo(1, 2, daysAgo(1)),
+                    trackInfo(2, 0),
+                    trackInfo(3, 2, daysAgo(5)),
+                    trackInfo(4, 1, daysAgo(1))});
+
+    EXPECT_EQ(4, m_crateTracks.activeTrackCount());
+    EXPECT_EQ(1, m_crateTracks.unplayedActiveTrackCount());
+    EXPECT_EQ(QList<TrackId>({TrackId(2), TrackId(4), TrackId(3), TrackId(1)}),
+            activeTracks());
+
+    m_crateTracks.setOrderByLastPlayed(true);
+    EXPECT_EQ(QList<TrackId>({TrackId(2), TrackId(3), TrackId(1), TrackId(4)}),
+            activeTracks());
+    // Tracks that have never been played are not counted
+    EXPECT_EQ(1, m_crateTracks.activeTrackCountLastPlayedBefore(daysAgo(2)));
+
+    m_crateTracks.setOrderByLastPlayed(false);
+    EXPECT_EQ(1, m_crateTracks.activeTrackCountLastPlayedBefore(daysAgo(2)));
+}
+
+TEST_F(AutoDJCrateTracksTest, updateTimesPlayed) {
+    m_crateTracks.addCrateTracks(CrateId(1),
+            {trackInfo(1, 0), trackInfo(2, 1), trackInfo(3, 2)});
+
+    m_crateTracks.setTimesPlayed(TrackId(1), 3);
+    EXPECT_EQ(0, m_crateTracks.unplayedActiveTrackCount());
+    EXPECT_EQ(QList<TrackId>({TrackId(2), TrackId(3), TrackId(1)}),
+            activeTracks());
+}
+
+TEST_F(AutoDJCrateTracksTest, autoDjReferences) {
+    auto queuedTrack = trackInfo(2);
+    queuedTrack.autoDjRefs = 1;
+    m_crateTracks.addCrateTracks(CrateId(1),
+            {trackInfo(1), queuedTrack, trackInfo(3)});
+
+    EXPECT_EQ(QList<TrackId>({TrackId(1), TrackId(3)}), activeTracks());
+    EXPECT_EQ(1, m_crateTracks.queuedTrackCount());
+
+    // Queued and loaded into a deck
+    m_crateTracks.addAutoDjReference(TrackId(1));
+    m_crateTracks.addAutoDjReference(TrackId(1));
+    EXPECT_EQ(QList<TrackId>({TrackId(3)}), activeTracks());
+    EXPECT_EQ(2, m_crateTracks.queuedTrackCount());
+
+    m_crateTracks.removeAutoDjReference(TrackId(1));
+    EXPECT_EQ(QList<TrackId>({TrackId(3)}), activeTracks());
+    m_crateTracks.removeAutoDjReference(TrackId(1));
+    m_crateTracks.removeAutoDjReference(TrackId(2));
+    EXPECT_EQ(QList<TrackId>({TrackId(1), TrackId(2), TrackId(3)}), activeTracks());
+    EXPECT_EQ(0, m_crateTracks.queuedTrackCount());
+
+    // Tracks that are not contained in any crate are ignored
+    m_crateTracks.addAutoDjReference(TrackId(4));
+    EXPECT_EQ(3, m_crateTracks.activeTrackCount());
+}
+
+TEST_F(AutoDJCrateTracksTest, tracksInMultipleCrates) {
+    m_crateTracks.addCrateTracks(CrateId(1), {trackInfo(1), trackInfo(2)});
+    m_crateTracks.addCrateTracks(CrateId(2), {trackInfo(2), trackInfo(3)});
+    // Adding a track twice to the same crate has no effect
+    m_crateTracks.addCrateTracks(CrateId(2), {trackInfo(2)});
+    EXPECT_EQ(3, m_crateTracks.size());
+
+    m_crateTracks.removeCrate(CrateId(1));
+    EXPECT_FALSE(m_crateTracks.containsCrate(CrateId(1)));
+    EXPECT_EQ(QList<TrackId>({TrackId(2), TrackId(3)}), activeTracks());
+
+    m_crateTracks.removeCrateTracks(CrateId(2), {TrackId(2)});
+    EXPECT_EQ(QList<TrackId>({TrackId(3)}), activeTracks());
+    EXPECT_TRUE(m_crateTracks.containsCrate(CrateId(2)));
+}
+
+TEST_F(AutoDJCrateTracksTest, largeBatches) {
+    QVector<AutoDJCrateTracks::TrackInfo> tracks;
+    for (int i = 1000; i > 0; --i) {
+        tracks.append(trackInfo(i, i % 10));
+    }
+    m_crateTracks.addCrateTracks(CrateId(1), tracks);
+    // Incremental updates before the active tracks are sorted again
+    m_crateTracks.addAutoDjReference(TrackId(10));
+    m_crateTracks.setTimesPlayed(TrackId(20), 5);
+
+    EXPECT_EQ(999, m_crateTracks.activeTrackCount());
+    EXPECT_EQ(98, m_crateTracks.unplayedActiveTrackCount());
+    const QList<TrackId> trackIds = activeTracks();
+    EXPECT_EQ(TrackId(30), trackIds.first());
+    EXPECT_EQ(TrackId(999), trackIds.last());
+
+    QList<TrackId> removedTrackIds;
+    for (int i = 1; i <= 500; ++i) {
+        removedTrackIds.append(TrackId(i));
+    }
+    m_crateTracks.removeCrateTracks(CrateId(1), removedTrackIds);
+    EXPECT_EQ(500, m_crateTracks.activeTrackCount());
+    EXPECT_EQ(0, m_crateTracks.queuedTrackCount());
+}
+
+namespace {
+
+constexpr int kBenchmarkCrateCount = 500;
+constexpr int kBenchmarkTrackCount = 100000;
+// Each track is contained in two crates on average
+constexpr int kBenchmarkCrateSize = 2 * kBenchmarkTrackCount / kBenchmarkCrateCount;
+
+void addBenchmarkCrates(AutoDJCrateTracks* pCrateTracks) {
+    auto* pRandom = QRandomGenerator::global();
+    for (int crateId = 1; crateId <= kBenchmarkCrateCount; ++crateId) {
+        QVector<AutoDJCrateTracks::TrackInfo> tracks;
+        tracks.reserve(kBenchmarkCrateSize);
+        for (int i = 0; i < kBenchmarkCrateSize; ++i) {
+            tracks.append(trackInfo(
+                    pRandom->bounded(1, kBenchmarkTrackCount + 1),
+                    pRandom->bounded(10),
+                    daysAgo(pRandom->bounded(365))));
+        }
+        pCrateTracks->addCrateTracks(CrateId(crateId), tracks);
+    }
+}
+
+} // anonymous namespace
+
+static void BM_AutoDJCrateTracksLoad(benchmark::State& state) {
+    for (auto _ : state) {
+        AutoDJCrateTracks crateTracks;
+        addBenchmarkCrates(&crateTracks);
+        benchmark::DoNotOptimize(crateTracks.activeTrackCount());
+    }
+}
+BENCHMARK(BM_AutoDJCrateTracksLoad)->Unit(benchmark::kMillisecond);
+
+// Selecting a random track and queuing it in the Auto DJ playlist,
+// i.e. what AutoDJProcessor does when refilling its queue.
+static void BM_AutoDJCrateTracksSelectAndQueue(benchmark::State& state) {
+    AutoDJCrateTracks crateTracks;
+    addBenchmarkCrates(&crateTracks);
+    auto* pRandom = QRandomGenerator::global();
+    for (auto _ : state) {
+        const TrackId trackId = crateTracks.activeTrackAt(
+                pRandom->bounded(crateTracks.activeTrackCount()));
+        crateTracks.addAutoDjReference(trackId);
+        crateTracks.setTimesPlayed(trackId, 10);
+        crateTracks.removeAutoDjReference(trackId);
+    }
+}
+BENCHMARK(BM_AutoDJCrateTracksSelectAndQueue);
+
+static void BM_AutoDJCrateTracksCrateToggle(benchmark::State& state) {
+    AutoDJCrateTracks crateTracks;
+    addBenchmarkCrates(&crateTracks);
+    QVector<AutoDJCrateTracks::TrackInfo> tracks;
+    for (int i = 0; i < kBenchmarkCrateSize; ++i) {
+        tracks.append(trackInfo(kBenchmarkTrackCount + i + 1));
+    }
+    for (auto _ : state) {
+        crateTracks.addCrateTracks(CrateId(kBenchmarkCrateCount + 1), tracks);
+        crateTracks.removeCrate(CrateId(kBenchmarkCrateCount + 1));
+        benchmark::DoNotOptimize(crateTracks.activeTrackAt(0));
+    }
+}
+BENCHMARK(BM_AutoDJCrateTracksCrateToggle)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,112 @@
+#include "library/basetrackcache.h"
+
+#include <gtest/gtest.h>
+
+#include "library/dao/trackschema.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace {
+
+const QStringList kTrackLocations = {
+        QStringLiteral("id3-test-data/cover-test-jpg.mp3"),
+        QStringLiteral("id3-test-data/cover-test-png.mp3"),
+        QStringLiteral("id3-test-data/cover-test-vbr.mp3"),
+};
+
+class BaseTrackCacheTest : public LibraryTest {
+  protected:
+    void SetUp() override {
+        for (const auto& trackLocation : kTrackLocations) {
+            const TrackPointer pTrack = getOrAddTrackByLocation(
+                    getTestDir().filePath(trackLocation));
+            ASSERT_NE(nullptr, pTrack);
+            m_trackIds.append(pTrack->getId());
+        }
+        m_pTrackCache = std::make_unique<BaseTrackCache>(internalCollection(),
+                LIBRARY_TABLE,
+                LIBRARYTABLE_ID,
+                QStringList{LIBRARYTABLE_ID, LIBRARYTABLE_TITLE},
+                false);
+        m_pTrackCache->setWindowSize(2);
+        m_pTrackCache->buildIndex();
+    }
+
+    QVariant title(TrackId trackId) const {
+        return m_pTrackCache->data(
+                trackId, m_pTrackCache->fieldIndex(LIBRARYTABLE_TITLE));
+    }
+
+    QList<TrackId> m_trackIds;
+    std::unique_ptr<BaseTrackCache> m_pTrackCache;
+};
+
+TEST_F(BaseTrackCacheTest, tracksAreFetchedOnDemand) {
+    ASSERT_TRUE(m_pTrackCache->isWindowed());
+    for (const auto& trackId : qAsConst(m_trackIds)) {
+        EXPECT_FALSE(m_pTrackCache->isCached(trackId));
+    }
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]});
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[0]));
+    EXPECT_FALSE(m_pTrackCache->isCached(m_trackIds[1]));
+}
+
+TEST_F(BaseTrackCacheTest, fetchReturnsMissingTracks) {
+    const TrackId missingTrackId(m_trackIds.last().value() + 1);
+    EXPECT_EQ(QSet<TrackId>{missingTrackId},
+            m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0], missingTrackId}));
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[0]));
+    EXPECT_FALSE(m_pTrackCache->isCached(missingTrackId));
+
+    // Tracks that are cached already are not missing
+    EXPECT_TRUE(m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]}).isEmpty());
+}
+
+TEST_F(BaseTrackCacheTest, evictLeastRecentlyUsedTrack) {
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]});
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[1]});
+    // Reading the first track makes the second one the least recently used
+    title(m_trackIds[0]);
+
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[2]});
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[0]));
+    EXPECT_FALSE(m_pTrackCache->isCached(m_trackIds[1]));
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[2]));
+}
+
+TEST_F(BaseTrackCacheTest, refillEvictedTrack) {
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]});
+    const QVariant expectedTitle = title(m_trackIds[0]);
+    ASSERT_TRUE(expectedTitle.isValid());
+
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[1]});
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[2]});
+    ASSERT_FALSE(m_pTrackCache->isCached(m_trackIds[0]));
+    EXPECT_FALSE(title(m_trackIds[0]).isValid());
+
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]});
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[0]));
+    EXPECT_EQ(expectedTitle, title(m_trackIds[0]));
+    // The track that has been used least recently has been evicted
+    EXPECT_FALSE(m_pTrackCache->isCached(m_trackIds[1]));
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[2]));
+}
+
+TEST_F(BaseTrackCacheTest, removedTracksDoNotOccupyWindow) {
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]});
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[1]});
+    m_pTrackCache->slotTracksRemoved(QSet<TrackId>{m_trackIds[0]});
+    EXPECT_FALSE(m_pTrackCache->isCached(m_trackIds[0]));
+
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[2]});
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[1]));
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[2]));
+
+    // Fetching the removed track again evicts the least recently used one
+    m_pTrackCache->fetch(QSet<TrackId>{m_trackIds[0]});
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[0]));
+    EXPECT_FALSE(m_pTrackCache->isCached(m_trackIds[1]));
+    EXPECT_TRUE(m_pTrackCache->isCached(m_trackIds[2]));
+}
+
+} // anonymous namespace
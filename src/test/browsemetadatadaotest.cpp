@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "library/dao/browsemetadatadao.h"
+#include "test/librarytest.h"
+
+class BrowseMetadataDAOTest : public LibraryTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_browseMetadataDao.initialize(dbConnection());
+    }
+
+    mixxx::FileInfo createFile(const QString& fileName, const QByteArray& content) {
+        const QString filePath = m_tempDir.filePath(fileName);
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        EXPECT_EQ(content.size(), file.write(content));
+        file.close();
+        return mixxx::FileInfo(filePath);
+    }
+
+    static mixxx::TrackMetadata trackMetadata(const QString& title) {
+        mixxx::TrackMetadata trackMetadata;
+        trackMetadata.refTrackInfo().setTitle(title);
+        trackMetadata.refTrackInfo().setArtist(QStringLiteral("Artist"));
+        trackMetadata.refTrackInfo().setBpm(mixxx::Bpm(123.0));
+        return trackMetadata;
+    }
+
+    QString directory() const {
+        return mixxx::FileInfo(m_tempDir.path()).location();
+    }
+
+    QTemporaryDir m_tempDir;
+    BrowseMetadataDAO m_browseMetadataDao;
+};
+
+TEST_F(BrowseMetadataDAOTest, saveAndLoad) {
+    mixxx::FileInfo fileInfo = createFile(QStringLiteral("a.mp3"), "abc");
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo, trackMetadata("Title")));
+
+    const auto entries = m_browseMetadataDao.loadDirectory(directory());
+    ASSERT_EQ(1, entries.size());
+    const auto it = entries.constFind(fileInfo.location());
+    ASSERT_NE(entries.constEnd(), it);
+    EXPECT_FALSE(it.value().fromLibrary);
+    EXPECT_TRUE(it.value().isValid(fileInfo));
+    EXPECT_EQ(QStringLiteral("Title"), it.value().trackMetadata.getTrackInfo().getTitle());
+    EXPECT_EQ(QStringLiteral("Artist"), it.value().trackMetadata.getTrackInfo().getArtist());
+    EXPECT_EQ(mixxx::Bpm(123.0), it.value().trackMetadata.getTrackInfo().getBpm());
+
+    // Entries of other directories are not loaded
+    EXPECT_TRUE(m_browseMetadataDao.loadDirectory(directory() + QStringLiteral("/sub")).isEmpty());
+}
+
+TEST_F(BrowseMetadataDAOTest, modifiedFileIsInvalid) {
+    mixxx::FileInfo fileInfo = createFile(QStringLiteral("a.mp3"), "abc");
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo, trackMetadata("Title")));
+
+    createFile(QStringLiteral("a.mp3"), "abcdef");
+    fileInfo.refresh();
+
+    const auto entries = m_browseMetadataDao.loadDirectory(directory());
+    ASSERT_EQ(1, entries.size());
+    EXPECT_FALSE(entries.value(fileInfo.location()).isValid(fileInfo));
+}
+
+TEST_F(BrowseMetadataDAOTest, cleanUpRemovesOldestEntries) {
+    const mixxx::FileInfo fileInfo1 = createFile(QStringLiteral("1.mp3"), "1");
+    const mixxx::FileInfo fileInfo2 = createFile(QStringLiteral("2.mp3"), "2");
+    const mixxx::FileInfo fileInfo3 = createFile(QStringLiteral("3.mp3"), "3");
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo1, trackMetadata("1")));
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo2, trackMetadata("2")));
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo3, trackMetadata("3")));
+    // Reading a file again makes it the newest entry
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo1, trackMetadata("1")));
+
+    m_browseMetadataDao.cleanUp(2);
+
+    const auto entries = m_browseMetadataDao.loadDirectory(directory());
+    EXPECT_EQ(2, entries.size());
+    EXPECT_TRUE(entries.contains(fileInfo1.location()));
+    EXPECT_FALSE(entries.contains(fileInfo2.location()));
+    EXPECT_TRUE(entries.contains(fileInfo3.location()));
+}
+
+TEST_F(BrowseMetadataDAOTest, cleanUpRemovesLibraryTracks) {
+    const QString trackLocation =
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-png.mp3"));
+    const mixxx::FileInfo fileInfo(trackLocation);
+    ASSERT_TRUE(m_browseMetadataDao.saveMetadata(fileInfo, trackMetadata("Title")));
+    ASSERT_FALSE(m_browseMetadataDao.loadDirectory(fileInfo.locationPath()).isEmpty());
+
+    ASSERT_NE(nullptr, getOrAddTrackByLocation(trackLocation));
+    m_browseMetadataDao.cleanUp(100);
+
+    // Only the library entry is left
+    const auto entries = m_browseMetadataDao.loadDirectory(fileInfo.locationPath());
+    for (const auto& entry : entries) {
+        EXPECT_TRUE(entry.fromLibrary);
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+
+#include "util/collationsortkey.h"
+#include "util/string.h"
+
+namespace {
+
+const QStringList kStrings = {
+        QString(),
+        QStringLiteral(""),
+        QStringLiteral("a"),
+        QStringLiteral("Ä"),
+        QStringLiteral("ab"),
+        QStringLiteral("Ärger"),
+        QStringLiteral("Zebra"),
+        QStringLiteral("zz top"),
+        QStringLiteral("Ölfass"),
+        QStringLiteral("Ostern"),
+        QStringLiteral("10 Years"),
+        QStringLiteral("2 Unlimited"),
+};
+
+// Byte-wise comparison like SQLite for BLOB columns
+int compareSortKeys(const QByteArray& key1, const QByteArray& key2) {
+    const int keyCompare = std::memcmp(key1.constData(),
+            key2.constData(),
+            std::min(key1.size(), key2.size()));
+    return keyCompare != 0 ? keyCompare : key1.size() - key2.size();
+}
+
+class CollationSortKeyTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        if (!mixxx::CollationSortKeyGenerator::isSupported()) {
+            GTEST_SKIP() << "Built without the SORTKEYS option";
+        }
+    }
+};
+
+TEST_F(CollationSortKeyTest, versionDependsOnLocale) {
+    const mixxx::CollationSortKeyGenerator english(QLocale(QLocale::English));
+    const mixxx::CollationSortKeyGenerator german(QLocale(QLocale::German));
+    ASSERT_TRUE(english.isValid());
+    ASSERT_TRUE(german.isValid());
+    EXPECT_FALSE(english.version().isEmpty());
+    EXPECT_NE(english.version(), german.version());
+}
+
+TEST_F(CollationSortKeyTest, caseInsensitive) {
+    const mixxx::CollationSortKeyGenerator generator(QLocale(QLocale::English));
+    EXPECT_EQ(generator.sortKey(QStringLiteral("Daft Punk")),
+            generator.sortKey(QStringLiteral("daft punk")));
+}
+
+TEST_F(CollationSortKeyTest, nullString) {
+    const mixxx::CollationSortKeyGenerator generator(QLocale(QLocale::English));
+    EXPECT_TRUE(generator.sortKey(QString()).isNull());
+}
+
+TEST_F(CollationSortKeyTest, orderMatchesStringCollator) {
+    const QLocale locale(QLocale::German);
+    const mixxx::CollationSortKeyGenerator generator(locale);
+    const mixxx::StringCollator collator(locale);
+    for (const auto& s1 : kStrings) {
+        for (const auto& s2 : kStrings) {
+            const int keyOrder = compareSortKeys(generator.sortKey(s1), generator.sortKey(s2));
+            const int stringOrder = collator.compare(s1, s2);
+            EXPECT_EQ(keyOrder < 0, stringOrder < 0) << s1.toStdString() << " " << s2.toStdString();
+            EXPECT_EQ(keyOrder > 0, stringOrder > 0) << s1.toStdString() << " " << s2.toStdString();
+        }
+    }
+}
+
+TEST_F(CollationSortKeyTest, compareMatchesSortKeys) {
+    const mixxx::CollationSortKeyGenerator generator(QLocale(QLocale::German));
+    for (const auto& s1 : kStrings) {
+        for (const auto& s2 : kStrings) {
+            const int keyOrder = compareSortKeys(generator.sortKey(s1), generator.sortKey(s2));
+            const int order = generator.compare(s1, s2);
+            EXPECT_EQ(keyOrder < 0, order < 0) << s1.toStdString() << " " << s2.toStdString();
+            EXPECT_EQ(keyOrder > 0, order > 0) << s1.toStdString() << " " << s2.toStdString();
+        }
+    }
+}
+
+} // namespace
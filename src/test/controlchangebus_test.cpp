@@ -0,0 +1,152 @@
+#include "control/controlchangebus.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ValueChangedCounter : public QObject {
+  public:
+    void slotValueChanged(double value) {
+        ++m_count;
+        m_lastValue = value;
+    }
+
+    int m_count = 0;
+    double m_lastValue = 0.0;
+};
+
+class ControlChangeBusTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pControl = std::make_unique<ControlObject>(ConfigKey("[Channel1]", "playposition"));
+    }
+
+    void processEvents() {
+        application()->processEvents();
+        application()->processEvents();
+    }
+
+    std::unique_ptr<ControlObject> m_pControl;
+};
+
+TEST_F(ControlChangeBusTest, coalesceChanges) {
+    ControlProxy proxy(m_pControl->getKey(), nullptr, ControlFlag::CoalesceChanges);
+    ValueChangedCounter counter;
+    ASSERT_TRUE(proxy.connectValueChanged(&counter, &ValueChangedCounter::slotValueChanged));
+
+    for (int i = 1; i <= 100; ++i) {
+        m_pControl->set(i);
+    }
+    processEvents();
+    // Nothing has been queued
+    EXPECT_EQ(0, counter.m_count);
+
+    ControlChangeBus::instance()->process();
+    EXPECT_EQ(1, counter.m_count);
+    EXPECT_DOUBLE_EQ(100.0, counter.m_lastValue);
+
+    // No change, no notification
+    ControlChangeBus::instance()->process();
+    EXPECT_EQ(1, counter.m_count);
+}
+
+TEST_F(ControlChangeBusTest, unsubscribe) {
+    const int numSubscribedControls = ControlChangeBus::instance()->numSubscribedControls();
+    auto pProxy = std::make_unique<ControlProxy>(
+            m_pControl->getKey(), nullptr, ControlFlag::CoalesceChanges);
+    auto pProxy2 = std::make_unique<ControlProxy>(
+            m_pControl->getKey(), nullptr, ControlFlag::CoalesceChanges);
+    EXPECT_EQ(numSubscribedControls + 1,
+            ControlChangeBus::instance()->numSubscribedControls());
+    pProxy.reset();
+    EXPECT_EQ(numSubscribedControls + 1,
+            ControlChangeBus::instance()->numSubscribedControls());
+    pProxy2.reset();
+    EXPECT_EQ(numSubscribedControls,
+            ControlChangeBus::instance()->numSubscribedControls());
+}
+
+TEST_F(ControlChangeBusTest, regularProxyIsNotCoalesced) {
+    ControlProxy proxy(m_pControl->getKey());
+    ValueChangedCounter counter;
+    ASSERT_TRUE(proxy.connectValueChanged(&counter,
+            &ValueChangedCounter::slotValueChanged,
+            Qt::QueuedConnection));
+
+    m_pControl->set(1.0);
+    m_pControl->set(2.0);
+    processEvents();
+    EXPECT_EQ(2, counter.m_count);
+}
+
+constexpr int kNumDecks = 8;
+// Updated by the engine in every callback
+const char* kEngineUpdatedControls[] = {
+        "playposition",
+        "vu_meter",
+        "vu_meter_left",
+        "vu_meter_right",
+        "peak_indicator",
+        "visual_bpm",
+};
+// GUI ticks at 60 fps
+constexpr int kNumGuiTicksPerSecond = 60;
+// 256 frames at 44100 Hz result in ~172 engine callbacks per second
+constexpr int kNumCallbacksPerGuiTick = 3;
+
+// Emulates the event loop load caused by the GUI for one second with all
+// decks playing.
+void benchmarkGuiNotification(benchmark::State& state, ControlFlags flags) {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    std::vector<std::unique_ptr<ControlProxy>> proxies;
+    ValueChangedCounter counter;
+    for (int deck = 1; deck <= kNumDecks; ++deck) {
+        for (const char* item : kEngineUpdatedControls) {
+            const ConfigKey key(QStringLiteral("[Channel%1]").arg(deck), item);
+            controls.push_back(std::make_unique<ControlObject>(key));
+            proxies.push_back(std::make_unique<ControlProxy>(key, nullptr, flags));
+            proxies.back()->connectValueChanged(&counter,
+                    &ValueChangedCounter::slotValueChanged,
+                    Qt::QueuedConnection);
+        }
+    }
+    double value = 0;
+    for (auto _ : state) {
+        for (int tick = 0; tick < kNumGuiTicksPerSecond; ++tick) {
+            // Engine callbacks since the last GUI tick
+            for (int i = 0; i < kNumCallbacksPerGuiTick; ++i) {
+                value += 1.0;
+                for (const auto& pControl : controls) {
+                    pControl->set(value);
+                }
+            }
+            QCoreApplication::processEvents();
+            if (flags.testFlag(ControlFlag::CoalesceChanges)) {
+                ControlChangeBus::instance()->process();
+            }
+        }
+    }
+    state.counters["notifications"] = benchmark::Counter(
+            counter.m_count, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_GuiNotificationQueued(benchmark::State& state) {
+    benchmarkGuiNotification(state, ControlFlag::None);
+}
+BENCHMARK(BM_GuiNotificationQueued);
+
+static void BM_GuiNotificationCoalesced(benchmark::State& state) {
+    benchmarkGuiNotification(state, ControlFlag::CoalesceChanges);
+}
+BENCHMARK(BM_GuiNotificationCoalesced);
+
+} // namespace
@@ -109,6 +109,30 @@ TEST_F(ControllerScriptEngineLegacyTest, getSetValue) {
     EXPECT_DOUBLE_EQ(1.0, co->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, getSetValues) {
+    auto co1 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co1"));
+    auto co2 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co2"));
+    co1->set(1.0);
+    co2->set(2.0);
+    EXPECT_TRUE(evaluateAndAssert(
+            "var handles = [engine.getControlHandle('[Test]', 'co1'),"
+            "               engine.getControlHandle('[Test]', 'co2')];"
+            "var values = engine.getValues(handles);"
+            "engine.setValues(handles, [values[1] + 10, values[0] + 10]);"));
+    EXPECT_DOUBLE_EQ(12.0, co1->get());
+    EXPECT_DOUBLE_EQ(11.0, co2->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, setValues_IgnoresNaNAndInvalidHandles) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    co->set(10.0);
+    EXPECT_EQ(-1, evaluate("engine.getControlHandle('[Nothing]', 'nothing');").toInt());
+    EXPECT_TRUE(evaluateAndAssert(
+            "engine.setValues([engine.getControlHandle('[Test]', 'co'), -1, 42],"
+            "                 [NaN, 1.0, 1.0]);"));
+    EXPECT_DOUBLE_EQ(10.0, co->get());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, setParameter) {
     auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
             -10.0,
@@ -0,0 +1,36 @@
+#include "controllers/controllerthread.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+
+#include "controllers/controllermanager.h"
+#include "test/controller_mapping_validation_test.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControllerThreadTest : public MixxxTest {
+};
+
+TEST_F(ControllerThreadTest, invokeInControllerThread) {
+    FakeController controller;
+    QThread* pControllerThread = nullptr;
+    {
+        ControllerThread thread(&controller, ControllerManager::kPollInterval);
+        EXPECT_NE(QThread::currentThread(), controller.thread());
+
+        thread.invokeBlocking([&pControllerThread] {
+            pControllerThread = QThread::currentThread();
+        });
+        EXPECT_EQ(controller.thread(), pControllerThread);
+        EXPECT_NE(QThread::currentThread(), pControllerThread);
+
+        // Not open, so this must not start polling
+        thread.updatePolling();
+    }
+    // Moved back on destruction
+    EXPECT_EQ(QThread::currentThread(), controller.thread());
+}
+
+} // namespace
@@ -1,5 +1,8 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
+
 #include <QtDebug>
+#include <vector>
 
 #include "control/controlobject.h"
 #include "util/memory.h"
@@ -50,6 +53,78 @@ TEST_F(ControlObjectTest, AliasRetrieval) {
     EXPECT_EQ(ControlObject::getControl(ckAlias), co.get());
 }
 
+TEST_F(ControlObjectTest, resolveHandle) {
+    const ControlHandle handle1 = ControlDoublePrivate::resolveHandle(ck1);
+    const ControlHandle handle2 = ControlDoublePrivate::resolveHandle(ck2);
+    ASSERT_TRUE(handle1.valid());
+    ASSERT_TRUE(handle2.valid());
+    EXPECT_NE(handle1, handle2);
+    EXPECT_EQ(handle1, ControlDoublePrivate::resolveHandle(ck1));
+    EXPECT_EQ(ControlObject::getControl(handle1), co1.get());
+    EXPECT_EQ(ControlObject::getControl(handle2), co2.get());
+
+    EXPECT_FALSE(ControlDoublePrivate::resolveHandle(ConfigKey()).valid());
+}
+
+TEST_F(ControlObjectTest, resolveHandleBeforeCreation) {
+    ConfigKey ck("[Channel1]", "co3");
+    const ControlHandle handle = ControlDoublePrivate::resolveHandle(ck);
+    ASSERT_TRUE(handle.valid());
+    EXPECT_EQ(ControlObject::getControl(handle, ControlFlag::NoAssertIfMissing),
+            (ControlObject*)nullptr);
+
+    // The handle stays valid while the control is created and deleted
+    auto co = std::make_unique<ControlObject>(ck);
+    EXPECT_EQ(ControlObject::getControl(handle), co.get());
+    co.reset();
+    EXPECT_EQ(ControlObject::getControl(handle, ControlFlag::NoAssertIfMissing),
+            (ControlObject*)nullptr);
+    co = std::make_unique<ControlObject>(ck);
+    EXPECT_EQ(ControlObject::getControl(handle), co.get());
+    EXPECT_EQ(handle, ControlDoublePrivate::resolveHandle(ck));
+}
+
+TEST_F(ControlObjectTest, AliasHandle) {
+    ConfigKey ck("[Microphone1]", "volume");
+    ConfigKey ckAlias("[Microphone]", "volume");
+
+    auto co = std::make_unique<ControlObject>(ck);
+    ControlDoublePrivate::insertAlias(ckAlias, ck);
+
+    const ControlHandle handle = ControlDoublePrivate::resolveHandle(ckAlias);
+    EXPECT_EQ(ControlDoublePrivate::resolveHandle(ck), handle);
+    EXPECT_EQ(ControlObject::getControl(handle), co.get());
+}
+
+TEST_F(ControlObjectTest, AliasResolvedBeforeCreation) {
+    ConfigKey ck("[Microphone1]", "volume");
+    ConfigKey ckAlias("[Microphone]", "volume");
+
+    const ControlHandle aliasHandle = ControlDoublePrivate::resolveHandle(ckAlias);
+    auto co = std::make_unique<ControlObject>(ck);
+    ControlDoublePrivate::insertAlias(ckAlias, ck);
+
+    // The handle resolved before inserting the alias keeps working
+    EXPECT_EQ(ControlObject::getControl(aliasHandle), co.get());
+    EXPECT_EQ(ControlObject::getControl(ckAlias), co.get());
+}
+
+TEST_F(ControlObjectTest, takeAllInstancesRemovesAliases) {
+    ConfigKey ckAlias("[Microphone]", "volume");
+    ControlDoublePrivate::insertAlias(ckAlias, ck1);
+    EXPECT_EQ(ControlObject::getControl(ckAlias), co1.get());
+
+    // Like MixxxTest after each test
+    ControlDoublePrivate::takeAllInstances();
+
+    // A control created with the key of the former alias must not
+    // take the place of the aliased control.
+    auto co = std::make_unique<ControlObject>(ckAlias);
+    EXPECT_EQ(ControlObject::getControl(ckAlias), co.get());
+    EXPECT_EQ(ControlObject::getControl(ck1, ControlFlag::NoAssertIfMissing),
+            (ControlObject*)nullptr);
+}
+
 TEST_F(ControlObjectTest, Persistence_NotPresent) {
     ConfigKey ck("[Test]", "persist");
     ASSERT_FALSE(m_pConfig->exists(ck));
@@ -85,4 +160,54 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+constexpr int kNumBenchmarkControls = 2000;
+
+// Emulates a controller mapping that accesses many different controls
+class BenchmarkControls {
+  public:
+    BenchmarkControls() {
+        for (int i = 0; i < kNumBenchmarkControls; ++i) {
+            m_keys.emplace_back(
+                    QStringLiteral("[Channel%1]").arg(i % 8 + 1),
+                    QStringLiteral("benchmark_%1").arg(i));
+            m_controls.push_back(std::make_unique<ControlObject>(m_keys.back()));
+        }
+    }
+
+    const std::vector<ConfigKey>& keys() const {
+        return m_keys;
+    }
+
+  private:
+    std::vector<ConfigKey> m_keys;
+    std::vector<std::unique_ptr<ControlObject>> m_controls;
+};
+
+static void BM_ControlLookupByKey(benchmark::State& state) {
+    BenchmarkControls controls;
+    for (auto _ : state) {
+        for (const auto& key : controls.keys()) {
+            benchmark::DoNotOptimize(ControlDoublePrivate::getControl(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kNumBenchmarkControls);
+}
+BENCHMARK(BM_ControlLookupByKey);
+
+static void BM_ControlLookupByHandle(benchmark::State& state) {
+    BenchmarkControls controls;
+    std::vector<ControlHandle> handles;
+    handles.reserve(kNumBenchmarkControls);
+    for (const auto& key : controls.keys()) {
+        handles.push_back(ControlDoublePrivate::resolveHandle(key));
+    }
+    for (auto _ : state) {
+        for (const auto& handle : handles) {
+            benchmark::DoNotOptimize(ControlDoublePrivate::getControl(handle));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kNumBenchmarkControls);
+}
+BENCHMARK(BM_ControlLookupByHandle);
+
 } // namespace
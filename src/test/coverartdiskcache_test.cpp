@@ -0,0 +1,68 @@
+#include "library/coverartdiskcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kWidth = 50;
+
+QImage createImage(QColor color) {
+    QImage image(kWidth, kWidth, QImage::Format_RGB32);
+    image.fill(color);
+    return image;
+}
+
+} // anonymous namespace
+
+class CoverArtDiskCacheTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    QString cacheDirectory(const QString& name) const {
+        return m_tempDir.filePath(name);
+    }
+
+    const QTemporaryDir m_tempDir;
+};
+
+TEST_F(CoverArtDiskCacheTest, storeAndLoad) {
+    CoverArtDiskCache cache(cacheDirectory("cache"), 1024 * 1024);
+    EXPECT_TRUE(cache.load(1, kWidth).isNull());
+
+    cache.store(1, kWidth, createImage(Qt::red));
+    const QImage thumbnail = cache.load(1, kWidth);
+    ASSERT_FALSE(thumbnail.isNull());
+    EXPECT_EQ(kWidth, thumbnail.width());
+    // The width is part of the key
+    EXPECT_TRUE(cache.load(1, kWidth * 2).isNull());
+
+    // Thumbnails are persistent
+    CoverArtDiskCache reopenedCache(cacheDirectory("cache"), 1024 * 1024);
+    EXPECT_FALSE(reopenedCache.load(1, kWidth).isNull());
+}
+
+TEST_F(CoverArtDiskCacheTest, evictLeastRecentlyUsed) {
+    qint64 thumbnailSize;
+    {
+        CoverArtDiskCache cache(cacheDirectory("measure"), 1024 * 1024);
+        cache.store(1, kWidth, createImage(Qt::red));
+        thumbnailSize = QFileInfo(cache.filePath(1, kWidth)).size();
+        ASSERT_LT(0, thumbnailSize);
+    }
+
+    // Room for a single thumbnail
+    CoverArtDiskCache cache(cacheDirectory("cache"), thumbnailSize * 3 / 2);
+    cache.store(1, kWidth, createImage(Qt::red));
+    EXPECT_FALSE(cache.load(1, kWidth).isNull());
+    cache.store(2, kWidth, createImage(Qt::red));
+    EXPECT_TRUE(cache.load(1, kWidth).isNull());
+    EXPECT_FALSE(QFileInfo::exists(cache.filePath(1, kWidth)));
+    EXPECT_FALSE(cache.load(2, kWidth).isNull());
+}
@@ -0,0 +1,72 @@
+#include "util/db/dbconnection.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <QSqlQuery>
+#include <QThread>
+#include <memory>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+// Longer than the threshold for slow statements
+constexpr unsigned long kLockMillis = 200;
+
+} // anonymous namespace
+
+// Uses a database file that is shared by the connections of
+// multiple threads
+class DbConnectionTest : public MixxxDbTest {
+  protected:
+    // Holds an exclusive lock on the database on another thread
+    // for kLockMillis
+    std::unique_ptr<QThread> lockDatabase(QSemaphore* pLocked) {
+        std::unique_ptr<QThread> pThread(QThread::create([this, pLocked] {
+            const mixxx::DbConnectionPooler dbConnectionPooler(this->dbConnectionPooler());
+            QSqlQuery query(mixxx::DbConnectionPooled(this->dbConnectionPooler()));
+            EXPECT_TRUE(query.exec(QStringLiteral("BEGIN EXCLUSIVE")));
+            pLocked->release();
+            QThread::msleep(kLockMillis);
+            EXPECT_TRUE(query.exec(QStringLiteral("COMMIT")));
+        }));
+        pThread->start();
+        pLocked->acquire();
+        return pThread;
+    }
+};
+
+TEST_F(DbConnectionTest, waitForLock) {
+    const auto statisticsBefore = mixxx::DbConnection::statistics();
+
+    QSemaphore locked;
+    const auto pLockingThread = lockDatabase(&locked);
+    {
+        // The busy handler retries until the lock has been released
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral("BEGIN IMMEDIATE")));
+        EXPECT_TRUE(query.exec(QStringLiteral("COMMIT")));
+    }
+    pLockingThread->wait();
+
+    const auto statisticsAfter = mixxx::DbConnection::statistics();
+    EXPECT_EQ(statisticsBefore.lockWaits + 1, statisticsAfter.lockWaits);
+    EXPECT_EQ(statisticsBefore.lockTimeouts, statisticsAfter.lockTimeouts);
+    // The profiling callback includes the lock wait in the
+    // duration of the statement
+    EXPECT_LT(statisticsBefore.slowStatements, statisticsAfter.slowStatements);
+}
+
+TEST_F(DbConnectionTest, fastStatementsAreNotRecorded) {
+    const auto statisticsBefore = mixxx::DbConnection::statistics();
+
+    QSqlQuery query(dbConnection());
+    EXPECT_TRUE(query.exec(QStringLiteral("SELECT 1")));
+    EXPECT_TRUE(query.next());
+    query.finish();
+
+    const auto statisticsAfter = mixxx::DbConnection::statistics();
+    EXPECT_EQ(statisticsBefore.lockWaits, statisticsAfter.lockWaits);
+    EXPECT_EQ(statisticsBefore.slowStatements, statisticsAfter.slowStatements);
+}
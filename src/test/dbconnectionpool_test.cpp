@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <QSqlQuery>
+
 #include "library/dao/settingsdao.h"
 #include "test/mixxxdbtest.h"
+#include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 
 class DbConnectionPoolTest : public MixxxTest {};
@@ -20,3 +23,18 @@ TEST_F(DbConnectionPoolTest, MoveSemantics) {
     EXPECT_TRUE(p1.isPooling());
     EXPECT_FALSE(p2.isPooling());
 }
+
+TEST_F(DbConnectionPoolTest, ApplyPragmasToPooledConnections) {
+    const mixxx::DbConnectionPooler dbConnectionPooler(MixxxDb(config()).connectionPool());
+    ASSERT_TRUE(dbConnectionPooler.isPooling());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(dbConnectionPooler);
+    ASSERT_TRUE(database.isOpen());
+
+    QSqlQuery query(database);
+    ASSERT_TRUE(query.exec(QStringLiteral("PRAGMA journal_mode")));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(QStringLiteral("wal"), query.value(0).toString());
+    ASSERT_TRUE(query.exec(QStringLiteral("PRAGMA cache_size")));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(-16384, query.value(0).toInt());
+}
@@ -0,0 +1,76 @@
+#include "engine/effects/effectchainsilencetracker.h"
+
+#include <gtest/gtest.h>
+
+#include "effects/backends/effectmanifest.h"
+
+namespace {
+
+constexpr unsigned int kSampleRate = 44100;
+constexpr SINT kFramesPerBuffer = 1024;
+
+class EffectChainSilenceTrackerTest : public testing::Test {
+  protected:
+    EffectEnableState process(
+            EffectEnableState enableState,
+            bool inputSilent,
+            double tailLengthSeconds) {
+        return m_tracker.process(enableState,
+                inputSilent,
+                kFramesPerBuffer,
+                tailLengthSeconds,
+                kSampleRate);
+    }
+
+    EffectChainSilenceTracker m_tracker;
+};
+
+TEST_F(EffectChainSilenceTrackerTest, skipAfterTail) {
+    // 3 buffers
+    const double tailLengthSeconds = 3.0 * kFramesPerBuffer / kSampleRate;
+    EXPECT_EQ(EffectEnableState::Enabled,
+            process(EffectEnableState::Enabled, false, tailLengthSeconds));
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(EffectEnableState::Enabled,
+                process(EffectEnableState::Enabled, true, tailLengthSeconds));
+    }
+    EXPECT_EQ(EffectEnableState::Disabled,
+            process(EffectEnableState::Enabled, true, tailLengthSeconds));
+    EXPECT_EQ(EffectEnableState::Disabled,
+            process(EffectEnableState::Enabled, true, tailLengthSeconds));
+
+    // Non-silent input restarts processing immediately
+    EXPECT_EQ(EffectEnableState::Enabled,
+            process(EffectEnableState::Enabled, false, tailLengthSeconds));
+    EXPECT_EQ(0, m_tracker.silentFrames());
+    EXPECT_EQ(EffectEnableState::Enabled,
+            process(EffectEnableState::Enabled, true, tailLengthSeconds));
+}
+
+TEST_F(EffectChainSilenceTrackerTest, skipWithoutTail) {
+    EXPECT_EQ(EffectEnableState::Enabled,
+            process(EffectEnableState::Enabled, true, 0.0));
+    EXPECT_EQ(EffectEnableState::Disabled,
+            process(EffectEnableState::Enabled, true, 0.0));
+}
+
+TEST_F(EffectChainSilenceTrackerTest, neverSkipUnknownTail) {
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(EffectEnableState::Enabled,
+                process(EffectEnableState::Enabled,
+                        true,
+                        EffectManifest::kTailLengthUnknown));
+    }
+}
+
+TEST_F(EffectChainSilenceTrackerTest, neverSkipIntermediateStates) {
+    for (int i = 0; i < 10; ++i) {
+        process(EffectEnableState::Enabled, true, 0.0);
+    }
+    EXPECT_EQ(EffectEnableState::Disabling,
+            process(EffectEnableState::Disabling, true, 0.0));
+    EXPECT_EQ(EffectEnableState::Enabling,
+            process(EffectEnableState::Enabling, true, 0.0));
+}
+
+} // anonymous namespace
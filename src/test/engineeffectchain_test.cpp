@@ -0,0 +1,190 @@
+#include "engine/effects/engineeffectchain.h"
+
+#include <gtest/gtest.h>
+
+#include <QPair>
+#include <memory>
+
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/message.h"
+#include "test/mixxxtest.h"
+#include "util/defs.h"
+#include "util/messagepipe.h"
+#include "util/realtimeguard.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr unsigned int kSampleRate = 44100;
+constexpr unsigned int kNumSamples = 1024;
+constexpr int kMessagePipeFifoSize = 64;
+
+class EngineEffectChainTest : public MixxxTest {
+  protected:
+    EngineEffectChainTest()
+            : m_pBackendManager(new EffectsBackendManager()),
+              m_channel1(m_factory.getOrCreateHandle("[Channel1]"), "[Channel1]"),
+              m_master(m_factory.getOrCreateHandle("[Master]"), "[Master]"),
+              m_inputChannels({m_channel1}),
+              m_outputChannels({m_master}) {
+        QPair<EffectsRequestPipe*, EffectsResponsePipe*> requestPipes =
+                TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                        kMessagePipeFifoSize, kMessagePipeFifoSize);
+        m_pRequestPipe.reset(requestPipes.first);
+        m_pResponsePipe.reset(requestPipes.second);
+        m_pChain = std::make_unique<EngineEffectChain>(
+                "[EffectRack1_EffectUnit1]", m_inputChannels, m_outputChannels);
+    }
+
+    void loadEffect(const QString& effectId) {
+        EffectManifestPointer pManifest =
+                m_pBackendManager->getManifest(effectId, EffectBackendType::BuiltIn);
+        ASSERT_TRUE(pManifest);
+        m_pEffect = std::make_unique<EngineEffect>(pManifest,
+                m_pBackendManager,
+                QSet<ChannelHandleAndGroup>(),
+                m_inputChannels,
+                m_outputChannels);
+
+        EffectsRequest addRequest;
+        addRequest.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+        addRequest.pTargetChain = m_pChain.get();
+        addRequest.AddEffectToChain.pEffect = m_pEffect.get();
+        addRequest.AddEffectToChain.iIndex = 0;
+        ASSERT_TRUE(m_pChain->processEffectsRequest(addRequest, m_pResponsePipe.get()));
+
+        EffectsRequest enableRequest;
+        enableRequest.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        enableRequest.pTargetEffect = m_pEffect.get();
+        enableRequest.SetEffectParameters.enabled = true;
+        ASSERT_TRUE(m_pEffect->processEffectsRequest(enableRequest, m_pResponsePipe.get()));
+
+        EffectsRequest mixRequest;
+        mixRequest.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+        mixRequest.pTargetChain = m_pChain.get();
+        mixRequest.SetEffectChainParameters.enabled = true;
+        mixRequest.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+        mixRequest.SetEffectChainParameters.mix = 1.0;
+        ASSERT_TRUE(m_pChain->processEffectsRequest(mixRequest, m_pResponsePipe.get()));
+    }
+
+    void enableForInputChannel() {
+        // Like EffectChain::enableForInputChannel in the main thread
+        const mixxx::EngineParameters engineParameters(
+                mixxx::audio::SampleRate(96000),
+                MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+        auto* pEffectStatesMapArray = new EffectStatesMapArray;
+        (*pEffectStatesMapArray)[0].insert(m_master.handle(),
+                m_pEffect->createState(engineParameters));
+        // All registered input channels are routed now
+        m_pEffect->refillStatePool(engineParameters, 0);
+
+        EffectsRequest request;
+        request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+        request.pTargetChain = m_pChain.get();
+        request.EnableInputChannelForChain.channelHandle = m_channel1.handle();
+        request.EnableInputChannelForChain.pEffectStatesMapArray = pEffectStatesMapArray;
+        ASSERT_TRUE(m_pChain->processEffectsRequest(request, m_pResponsePipe.get()));
+    }
+
+    ChannelHandleFactory m_factory;
+    EffectsBackendManagerPointer m_pBackendManager;
+    const ChannelHandleAndGroup m_channel1;
+    const ChannelHandleAndGroup m_master;
+    const QSet<ChannelHandleAndGroup> m_inputChannels;
+    const QSet<ChannelHandleAndGroup> m_outputChannels;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
+    std::unique_ptr<EngineEffectChain> m_pChain;
+    std::unique_ptr<EngineEffect> m_pEffect;
+};
+
+TEST_F(EngineEffectChainTest, processWithoutRealtimeViolations) {
+    if (!mixxx::RealtimeGuard::isEnabled()) {
+        GTEST_SKIP() << "Built without the REALTIME_GUARD option";
+    }
+    // The Echo state holds the delay buffer, which is the largest allocation
+    // of the built-in effects.
+    loadEffect(EchoEffect::getId());
+    enableForInputChannel();
+
+    mixxx::SampleBuffer input(kNumSamples);
+    input.fill(0.5f);
+    mixxx::SampleBuffer output(kNumSamples);
+    const GroupFeatureState groupFeatures;
+
+    mixxx::RealtimeGuard::resetViolationCount();
+    for (int i = 0; i < 16; ++i) {
+        mixxx::ScopedRealtimeSection realtimeSection;
+        m_pEffect->onCallbackStart();
+        EXPECT_TRUE(m_pChain->process(m_channel1.handle(),
+                m_master.handle(),
+                input.data(),
+                output.data(),
+                kNumSamples,
+                kSampleRate,
+                groupFeatures));
+    }
+    EXPECT_EQ(0, mixxx::RealtimeGuard::violationCount());
+}
+
+TEST_F(EngineEffectChainTest, processWithPooledStates) {
+    loadEffect(EchoEffect::getId());
+    // Fill the pool before routing the input channel, so the states
+    // are taken from it.
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(96000),
+            MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+    m_pEffect->refillStatePool(engineParameters, 1);
+    enableForInputChannel();
+
+    mixxx::SampleBuffer input(kNumSamples);
+    input.fill(0.5f);
+    mixxx::SampleBuffer output(kNumSamples);
+    output.clear();
+    const GroupFeatureState groupFeatures;
+
+    m_pEffect->onCallbackStart();
+    EXPECT_TRUE(m_pChain->process(m_channel1.handle(),
+            m_master.handle(),
+            input.data(),
+            output.data(),
+            kNumSamples,
+            kSampleRate,
+            groupFeatures));
+    // The effect is faded in from the dry signal within the first buffer
+    EXPECT_NE(0.0f, output[kNumSamples - 1]);
+}
+
+TEST_F(EngineEffectChainTest, recycleStatePoolOnUnload) {
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(96000),
+            MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+    loadEffect(EchoEffect::getId());
+    const EffectManifestPointer pManifest = m_pEffect->getManifest();
+    m_pEffect->refillStatePool(engineParameters, 1);
+
+    // Unloading hands the unused state over to the backend manager
+    m_pEffect.reset();
+    const QList<EffectState*> recycledStates =
+            m_pBackendManager->takeRecycledEffectStates(pManifest);
+    ASSERT_EQ(1, recycledStates.size());
+    EffectState* pRecycledState = recycledStates.first();
+    EXPECT_TRUE(m_pBackendManager->takeRecycledEffectStates(pManifest).isEmpty());
+
+    // The next processor of the same effect takes it instead of allocating
+    m_pBackendManager->recycleEffectStates(pManifest, recycledStates);
+    auto pEffect = std::make_unique<EngineEffect>(pManifest,
+            m_pBackendManager,
+            QSet<ChannelHandleAndGroup>(),
+            m_inputChannels,
+            m_outputChannels);
+    EXPECT_TRUE(m_pBackendManager->takeRecycledEffectStates(pManifest).isEmpty());
+    EffectState* pState = pEffect->createState(engineParameters);
+    EXPECT_EQ(pRecycledState, pState);
+    delete pState;
+}
+
+} // anonymous namespace
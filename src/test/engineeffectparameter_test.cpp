@@ -0,0 +1,56 @@
+#include "engine/effects/engineeffectparameter.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class EngineEffectParameterTest : public testing::Test {
+  protected:
+    EngineEffectParameterTest()
+            : m_pManifest(new EffectManifestParameter()) {
+        m_pManifest->setRange(0.0, 1.0, 2.0);
+    }
+
+    EffectManifestParameterPointer m_pManifest;
+};
+
+TEST_F(EngineEffectParameterTest, rampWithinCallback) {
+    EngineEffectParameter parameter(m_pManifest);
+    EXPECT_FALSE(parameter.isRamping());
+    EXPECT_EQ(1.0, parameter.previousValue());
+
+    parameter.onCallbackStart();
+    parameter.setValue(2.0);
+    EXPECT_TRUE(parameter.isRamping());
+    EXPECT_EQ(1.0, parameter.previousValue());
+    EXPECT_EQ(2.0, parameter.value());
+    EXPECT_EQ(1.0, parameter.valueAt(0, 1024));
+    EXPECT_EQ(1.25, parameter.valueAt(256, 1024));
+    EXPECT_EQ(1.5, parameter.valueAt(512, 1024));
+    EXPECT_EQ(2.0, parameter.valueAt(1024, 1024));
+    // Out of range frames and empty buffers use the current value
+    EXPECT_EQ(2.0, parameter.valueAt(2048, 1024));
+    EXPECT_EQ(2.0, parameter.valueAt(0, 0));
+
+    // Without further changes the value is constant in the next callback
+    parameter.onCallbackStart();
+    EXPECT_FALSE(parameter.isRamping());
+    EXPECT_EQ(2.0, parameter.valueAt(0, 1024));
+    EXPECT_EQ(2.0, parameter.valueAt(512, 1024));
+}
+
+TEST_F(EngineEffectParameterTest, coalesceChangesWithinCallback) {
+    EngineEffectParameter parameter(m_pManifest);
+    parameter.onCallbackStart();
+    parameter.setValue(0.0);
+    parameter.setValue(0.5);
+    // Ramps from the value at the start of the callback to the latest value
+    EXPECT_EQ(1.0, parameter.previousValue());
+    EXPECT_EQ(0.75, parameter.valueAt(512, 1024));
+
+    // A change back to the previous value does not ramp
+    parameter.setValue(1.0);
+    EXPECT_FALSE(parameter.isRamping());
+}
+
+} // anonymous namespace
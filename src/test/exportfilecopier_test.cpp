@@ -0,0 +1,127 @@
+#include "library/export/exportfilecopier.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace mixxx {
+
+class ExportFileCopierTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_sourceDir.isValid());
+        ASSERT_TRUE(m_destDir.isValid());
+    }
+
+    static bool writeFile(const QString& filePath, const QByteArray& content) {
+        QFile file(filePath);
+        return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+    }
+
+    static QByteArray readFile(const QString& filePath) {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QByteArray();
+        }
+        return file.readAll();
+    }
+
+    QString sourcePath(const QString& fileName) const {
+        return QDir(m_sourceDir.path()).filePath(fileName);
+    }
+
+    QString destPath(const QString& fileName) const {
+        return QDir(m_destDir.path()).filePath(fileName);
+    }
+
+    QTemporaryDir m_sourceDir;
+    QTemporaryDir m_destDir;
+};
+
+TEST_F(ExportFileCopierTest, copyFiles) {
+    // Larger than a single copy buffer
+    const QByteArray content1(5 * 1024 * 1024 + 17, 'a');
+    const QByteArray content2("content2");
+    ASSERT_TRUE(writeFile(sourcePath("file1"), content1));
+    ASSERT_TRUE(writeFile(sourcePath("file2"), content2));
+
+    ExportFileCopier fileCopier;
+    fileCopier.copyFile(sourcePath("file1"), destPath("file1"));
+    fileCopier.copyFile(sourcePath("file2"), destPath("file2"));
+    int copiedCount = 0;
+    while (const auto result = fileCopier.waitForResult()) {
+        EXPECT_EQ(ExportFileCopier::Status::Copied, result->status);
+        ++copiedCount;
+    }
+    fileCopier.syncToDisk();
+
+    EXPECT_EQ(2, copiedCount);
+    EXPECT_EQ(0, fileCopier.pendingCount());
+    EXPECT_EQ(0, fileCopier.queuedBytes());
+    EXPECT_EQ(content1.size() + content2.size(), fileCopier.processedBytes());
+    EXPECT_EQ(content1, readFile(destPath("file1")));
+    EXPECT_EQ(content2, readFile(destPath("file2")));
+}
+
+TEST_F(ExportFileCopierTest, skipIdenticalFile) {
+    const QByteArray content("content");
+    ASSERT_TRUE(writeFile(sourcePath("file"), content));
+    ASSERT_TRUE(writeFile(destPath("file"), content));
+
+    ExportFileCopier fileCopier;
+    fileCopier.copyFile(sourcePath("file"), destPath("file"));
+    const auto result = fileCopier.waitForResult();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(ExportFileCopier::Status::Identical, result->status);
+    EXPECT_EQ(content.size(), result->sizeInBytes);
+}
+
+TEST_F(ExportFileCopierTest, replaceFileWithSameSize) {
+    const QByteArray content("content");
+    ASSERT_TRUE(writeFile(sourcePath("file"), content));
+    ASSERT_TRUE(writeFile(destPath("file"), QByteArray("CONTENT")));
+
+    ExportFileCopier fileCopier;
+    fileCopier.copyFile(sourcePath("file"), destPath("file"));
+    const auto result = fileCopier.waitForResult();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(ExportFileCopier::Status::Copied, result->status);
+    EXPECT_EQ(content, readFile(destPath("file")));
+}
+
+TEST_F(ExportFileCopierTest, missingSourceFile) {
+    ExportFileCopier fileCopier;
+    fileCopier.copyFile(sourcePath("missing"), destPath("missing"));
+    const auto result = fileCopier.waitForResult();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(ExportFileCopier::Status::Failed, result->status);
+    EXPECT_FALSE(result->errorString.isEmpty());
+    EXPECT_FALSE(QFile::exists(destPath("missing")));
+    EXPECT_FALSE(fileCopier.waitForResult().has_value());
+}
+
+TEST_F(ExportFileCopierTest, cancelPendingCopies) {
+    const QByteArray content("content");
+    ASSERT_TRUE(writeFile(sourcePath("file1"), content));
+    ASSERT_TRUE(writeFile(sourcePath("file2"), content));
+    ASSERT_TRUE(writeFile(destPath("file2"), QByteArray("CONTENT")));
+
+    ExportFileCopier fileCopier;
+    fileCopier.cancel();
+    fileCopier.copyFile(sourcePath("file1"), destPath("file1"));
+    fileCopier.copyFile(sourcePath("file2"), destPath("file2"));
+    int canceledCount = 0;
+    while (const auto result = fileCopier.waitForResult()) {
+        EXPECT_EQ(ExportFileCopier::Status::Canceled, result->status);
+        ++canceledCount;
+    }
+
+    EXPECT_EQ(2, canceledCount);
+    // Queued files are skipped without touching existing files
+    EXPECT_FALSE(QFile::exists(destPath("file1")));
+    EXPECT_EQ(QByteArray("CONTENT"), readFile(destPath("file2")));
+}
+
+} // namespace mixxx
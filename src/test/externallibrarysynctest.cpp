@@ -0,0 +1,163 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "library/externallibrarysync.h"
+#include "test/mixxxdbtest.h"
+
+using ::testing::ElementsAre;
+
+namespace {
+
+const QString kTableName = QStringLiteral("external_library_sync_test");
+const QString kPlaylistTracksTableName = QStringLiteral("external_library_sync_test_tracks");
+
+} // namespace
+
+class ExternalLibrarySyncTest : public MixxxDbTest {
+  protected:
+    ExternalLibrarySyncTest() {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "CREATE TEMPORARY TABLE %1 "
+                "(id INTEGER PRIMARY KEY, artist TEXT, year INTEGER)")
+                                       .arg(kTableName)));
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "CREATE TEMPORARY TABLE %1 "
+                "(playlist_id INTEGER, track_id INTEGER, position INTEGER)")
+                                       .arg(kPlaylistTracksTableName)));
+    }
+
+    ExternalLibraryTableSync::Stats sync(const QList<QPair<int, QVariantList>>& rows,
+            QList<QVariant>* pDeletedKeys = nullptr) {
+        ExternalLibraryTableSync tableSync(dbConnection(),
+                kTableName,
+                QStringLiteral("id"),
+                QStringList{QStringLiteral("artist"), QStringLiteral("year")});
+        EXPECT_TRUE(tableSync.load());
+        for (const auto& row : rows) {
+            EXPECT_TRUE(tableSync.write(row.first, row.second));
+        }
+        const QList<QVariant> deletedKeys = tableSync.removeUnwritten();
+        if (pDeletedKeys) {
+            *pDeletedKeys = deletedKeys;
+        }
+        return tableSync.stats();
+    }
+
+    QStringList rows() const {
+        QStringList result;
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "SELECT id, artist, year FROM %1 ORDER BY id")
+                                       .arg(kTableName)));
+        while (query.next()) {
+            QStringList values;
+            for (int i = 0; i < 3; ++i) {
+                values.append(query.value(i).isNull()
+                                ? QStringLiteral("NULL")
+                                : query.value(i).toString());
+            }
+            result.append(values.join(QChar('|')));
+        }
+        return result;
+    }
+
+    QVector<int> playlistTracks(int playlistId) const {
+        QVector<int> result;
+        QSqlQuery query(dbConnection());
+        query.prepare(QStringLiteral(
+                "SELECT track_id FROM %1 WHERE playlist_id=:playlist_id "
+                "ORDER BY position")
+                              .arg(kPlaylistTracksTableName));
+        query.bindValue(QStringLiteral(":playlist_id"), playlistId);
+        EXPECT_TRUE(query.exec());
+        while (query.next()) {
+            result.append(query.value(0).toInt());
+        }
+        return result;
+    }
+};
+
+TEST_F(ExternalLibrarySyncTest, insertUpdateDelete) {
+    ExternalLibraryTableSync::Stats stats = sync({
+            {1, {QStringLiteral("Artist 1"), 2001}},
+            {2, {QStringLiteral("Artist 2"), 2002}},
+            {3, {QStringLiteral("Artist 3"), 2003}},
+    });
+    EXPECT_EQ(3, stats.inserted);
+    EXPECT_EQ(0, stats.updated);
+    EXPECT_EQ(0, stats.deleted);
+    EXPECT_EQ(0, stats.unchanged);
+
+    QList<QVariant> deletedKeys;
+    stats = sync({
+                         {1, {QStringLiteral("Artist 1"), 2001}},
+                         {2, {QStringLiteral("Artist 2"), 2012}},
+                         {4, {QStringLiteral("Artist 4"), 2004}},
+                 },
+            &deletedKeys);
+    EXPECT_EQ(1, stats.inserted);
+    EXPECT_EQ(1, stats.updated);
+    EXPECT_EQ(1, stats.deleted);
+    EXPECT_EQ(1, stats.unchanged);
+    EXPECT_THAT(deletedKeys, ElementsAre(QVariant(QStringLiteral("3"))));
+    EXPECT_THAT(rows(),
+            ElementsAre(QStringLiteral("1|Artist 1|2001"),
+                    QStringLiteral("2|Artist 2|2012"),
+                    QStringLiteral("4|Artist 4|2004")));
+}
+
+TEST_F(ExternalLibrarySyncTest, nullIsNotEmpty) {
+    sync({
+            {1, {QVariant(), 2001}},
+            {2, {QString(""), 2002}},
+    });
+    EXPECT_THAT(rows(),
+            ElementsAre(QStringLiteral("1|NULL|2001"), QStringLiteral("2||2002")));
+
+    // Swapping NULL and the empty string must be written
+    ExternalLibraryTableSync::Stats stats = sync({
+            {1, {QString(""), 2001}},
+            {2, {QVariant(), 2002}},
+    });
+    EXPECT_EQ(2, stats.updated);
+    EXPECT_EQ(0, stats.unchanged);
+    EXPECT_THAT(rows(),
+            ElementsAre(QStringLiteral("1||2001"), QStringLiteral("2|NULL|2002")));
+
+    // Unchanged NULL values are not written again
+    stats = sync({
+            {1, {QString(""), 2001}},
+            {2, {QVariant(), 2002}},
+    });
+    EXPECT_EQ(0, stats.updated);
+    EXPECT_EQ(2, stats.unchanged);
+}
+
+TEST_F(ExternalLibrarySyncTest, playlistTracks) {
+    {
+        ExternalLibraryPlaylistTracksSync tracksSync(dbConnection(), kPlaylistTracksTableName);
+        ASSERT_TRUE(tracksSync.load());
+        EXPECT_TRUE(tracksSync.write(1, {1, 2, 3}));
+        EXPECT_TRUE(tracksSync.write(2, {4, 5}));
+        EXPECT_TRUE(tracksSync.write(3, {6}));
+        EXPECT_TRUE(tracksSync.removeUnwritten());
+        EXPECT_EQ(3, tracksSync.numRewrittenPlaylists());
+    }
+    {
+        ExternalLibraryPlaylistTracksSync tracksSync(dbConnection(), kPlaylistTracksTableName);
+        ASSERT_TRUE(tracksSync.load());
+        // Unchanged
+        EXPECT_TRUE(tracksSync.write(1, {1, 2, 3}));
+        // Reordered
+        EXPECT_TRUE(tracksSync.write(2, {5, 4}));
+        // Playlist 3 has been deleted
+        EXPECT_TRUE(tracksSync.removeUnwritten());
+        EXPECT_EQ(1, tracksSync.numRewrittenPlaylists());
+    }
+    EXPECT_THAT(playlistTracks(1), ElementsAre(1, 2, 3));
+    EXPECT_THAT(playlistTracks(2), ElementsAre(5, 4));
+    EXPECT_TRUE(playlistTracks(3).isEmpty());
+}
@@ -0,0 +1,148 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "test/librarytest.h"
+#include "track/audiofingerprint.h"
+
+using ::testing::ElementsAre;
+
+namespace {
+
+constexpr int kNumItems = 160;
+
+QVector<uint32_t> randomItems(std::mt19937* pGenerator) {
+    QVector<uint32_t> items(kNumItems);
+    for (auto& item : items) {
+        item = static_cast<uint32_t>((*pGenerator)());
+    }
+    return items;
+}
+
+// Simulates a different encoding of the same audio, which is slightly
+// shifted and differs in a few bits. The bits are flipped at random
+// positions, so most of the modified items end up with a different key
+// of the sketch.
+QVector<uint32_t> reencodedItems(const QVector<uint32_t>& items, std::mt19937* pGenerator) {
+    QVector<uint32_t> reencoded = items.mid(1);
+    for (auto& item : reencoded) {
+        if ((*pGenerator)() % 3 == 0) {
+            item ^= 1u << ((*pGenerator)() % 32);
+        }
+    }
+    return reencoded;
+}
+
+// Flips the most significant bit of every other item, which changes the
+// keys of those items
+QVector<uint32_t> rekeyedItems(const QVector<uint32_t>& items) {
+    QVector<uint32_t> rekeyed = items;
+    for (int i = 0; i < rekeyed.size(); i += 2) {
+        rekeyed[i] ^= 1u << 31;
+    }
+    return rekeyed;
+}
+
+} // namespace
+
+class FingerprintDAOTest : public LibraryTest {
+  protected:
+    FingerprintDAOTest()
+            : m_generator(42) {
+    }
+
+    std::mt19937 m_generator;
+};
+
+TEST_F(FingerprintDAOTest, serialize) {
+    const QVector<uint32_t> items = randomItems(&m_generator);
+    EXPECT_EQ(items,
+            mixxx::AudioFingerprint::deserialize(
+                    mixxx::AudioFingerprint::serialize(items)));
+}
+
+TEST_F(FingerprintDAOTest, similarity) {
+    const mixxx::AudioFingerprint original(randomItems(&m_generator));
+    const mixxx::AudioFingerprint reencoded(reencodedItems(original.items(), &m_generator));
+    const mixxx::AudioFingerprint unrelated(randomItems(&m_generator));
+
+    EXPECT_DOUBLE_EQ(1.0, original.similarity(original));
+    EXPECT_LT(0.95, original.similarity(reencoded));
+    EXPECT_GT(0.6, original.similarity(unrelated));
+
+    EXPECT_EQ(mixxx::AudioFingerprint::kSketchSize, original.sketch().size());
+    EXPECT_EQ(original.sketch(), original.sketch());
+}
+
+TEST_F(FingerprintDAOTest, findDuplicates) {
+    FingerprintDAO& fingerprintDao = internalCollection()->getFingerprintDAO();
+
+    const TrackId originalId(1);
+    const TrackId reencodedId(2);
+    const TrackId unrelatedId(3);
+    const mixxx::AudioFingerprint original(randomItems(&m_generator));
+
+    EXPECT_FALSE(fingerprintDao.hasFingerprint(originalId));
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(originalId, original));
+    EXPECT_TRUE(fingerprintDao.hasFingerprint(originalId));
+    EXPECT_EQ(original.items(), fingerprintDao.getFingerprint(originalId).items());
+    EXPECT_TRUE(fingerprintDao.findDuplicates(originalId).isEmpty());
+
+    // Fingerprints that are stored after the index has been built
+    // are found, too
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(reencodedId,
+            mixxx::AudioFingerprint(reencodedItems(original.items(), &m_generator))));
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(unrelatedId,
+            mixxx::AudioFingerprint(randomItems(&m_generator))));
+    EXPECT_THAT(fingerprintDao.findDuplicates(originalId), ElementsAre(reencodedId));
+    EXPECT_THAT(fingerprintDao.findDuplicates(reencodedId), ElementsAre(originalId));
+    EXPECT_TRUE(fingerprintDao.findDuplicates(unrelatedId).isEmpty());
+
+    fingerprintDao.deleteFingerprints(QList<TrackId>{reencodedId});
+    EXPECT_FALSE(fingerprintDao.hasFingerprint(reencodedId));
+    EXPECT_TRUE(fingerprintDao.findDuplicates(originalId).isEmpty());
+}
+
+TEST_F(FingerprintDAOTest, findDuplicatesWithChangedKeys) {
+    FingerprintDAO& fingerprintDao = internalCollection()->getFingerprintDAO();
+
+    const TrackId originalId(1);
+    const TrackId rekeyedId(2);
+    const mixxx::AudioFingerprint original(randomItems(&m_generator));
+    const mixxx::AudioFingerprint rekeyed(rekeyedItems(original.items()));
+    // Half of the keys of the sketch differ
+    const QVector<uint32_t> originalSketch = original.sketch();
+    int numSharedKeys = 0;
+    for (const auto key : rekeyed.sketch()) {
+        if (originalSketch.contains(key)) {
+            ++numSharedKeys;
+        }
+    }
+    EXPECT_GT(mixxx::AudioFingerprint::kSketchSize, numSharedKeys);
+    EXPECT_LT(0.95, original.similarity(rekeyed));
+
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(originalId, original));
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(rekeyedId, rekeyed));
+    EXPECT_THAT(fingerprintDao.findDuplicates(originalId), ElementsAre(rekeyedId));
+    EXPECT_THAT(fingerprintDao.findDuplicates(rekeyedId), ElementsAre(originalId));
+}
+
+TEST_F(FingerprintDAOTest, replaceFingerprint) {
+    FingerprintDAO& fingerprintDao = internalCollection()->getFingerprintDAO();
+
+    const TrackId originalId(1);
+    const TrackId replacedId(2);
+    const mixxx::AudioFingerprint original(randomItems(&m_generator));
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(originalId, original));
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(replacedId,
+            mixxx::AudioFingerprint(reencodedItems(original.items(), &m_generator))));
+    EXPECT_THAT(fingerprintDao.findDuplicates(originalId), ElementsAre(replacedId));
+
+    // The track has been reanalyzed, e.g. after the file has been replaced
+    // with a different recording. The old keys must not be found anymore.
+    ASSERT_TRUE(fingerprintDao.saveFingerprint(replacedId,
+            mixxx::AudioFingerprint(randomItems(&m_generator))));
+    EXPECT_TRUE(fingerprintDao.findDuplicates(originalId).isEmpty());
+    EXPECT_TRUE(fingerprintDao.findDuplicates(replacedId).isEmpty());
+}
@@ -0,0 +1,64 @@
+#include "controllers/hid/hidiooutputbandwidthlimiter.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr int kBytesPerSecond = 1000;
+
+mixxx::Duration millis(qint64 millis) {
+    return mixxx::Duration::fromMillis(millis);
+}
+
+TEST(HidIoOutputBandwidthLimiterTest, unlimitedByDefault) {
+    HidIoOutputBandwidthLimiter limiter;
+    EXPECT_EQ(0, limiter.limit());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(limiter.isBudgetAvailable(millis(1)));
+        limiter.consume(64);
+    }
+}
+
+TEST(HidIoOutputBandwidthLimiterTest, negativeLimitMeansUnlimited) {
+    HidIoOutputBandwidthLimiter limiter;
+    limiter.setLimit(-1);
+    EXPECT_EQ(0, limiter.limit());
+}
+
+TEST(HidIoOutputBandwidthLimiterTest, budgetIsRefilledOverTime) {
+    HidIoOutputBandwidthLimiter limiter;
+    limiter.setLimit(kBytesPerSecond);
+
+    // The bucket is full after one second
+    ASSERT_TRUE(limiter.isBudgetAvailable(millis(1000)));
+    limiter.consume(kBytesPerSecond);
+    EXPECT_FALSE(limiter.isBudgetAvailable(millis(1000)));
+
+    // 100 ms refill 100 bytes
+    EXPECT_TRUE(limiter.isBudgetAvailable(millis(1100)));
+    limiter.consume(300);
+    EXPECT_FALSE(limiter.isBudgetAvailable(millis(1200)));
+    EXPECT_FALSE(limiter.isBudgetAvailable(millis(1299)));
+    EXPECT_TRUE(limiter.isBudgetAvailable(millis(1302)));
+}
+
+TEST(HidIoOutputBandwidthLimiterTest, burstIsLimitedToOneSecond) {
+    HidIoOutputBandwidthLimiter limiter;
+    limiter.setLimit(kBytesPerSecond);
+
+    // Idle for a long time, but the budget does not exceed one second
+    ASSERT_TRUE(limiter.isBudgetAvailable(millis(60000)));
+    limiter.consume(kBytesPerSecond);
+    EXPECT_FALSE(limiter.isBudgetAvailable(millis(60000)));
+}
+
+TEST(HidIoOutputBandwidthLimiterTest, unlimitedTrafficDoesNotBlockAfterLimiting) {
+    HidIoOutputBandwidthLimiter limiter;
+    ASSERT_TRUE(limiter.isBudgetAvailable(millis(1000)));
+    limiter.consume(100 * kBytesPerSecond);
+
+    limiter.setLimit(kBytesPerSecond);
+    EXPECT_TRUE(limiter.isBudgetAvailable(millis(2000)));
+}
+
+} // namespace
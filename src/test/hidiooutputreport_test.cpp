@@ -0,0 +1,110 @@
+#include "controllers/hid/hidiooutputreport.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+
+namespace {
+
+constexpr quint8 kReportId = 0x42;
+constexpr unsigned int kReportDataSize = 4;
+
+/// Records the reports instead of writing them to a device
+class FakeOutputReport : public HidIoOutputReport {
+  public:
+    FakeOutputReport()
+            : HidIoOutputReport(kReportId, kReportDataSize) {
+    }
+
+    QList<QByteArray> writtenReports;
+
+  protected:
+    int writeReport(hid_device* pHidDevice, const QByteArray& reportData) override {
+        Q_UNUSED(pHidDevice);
+        writtenReports.append(reportData);
+        return reportData.size();
+    }
+};
+
+class HidIoOutputReportTest : public testing::Test {
+  protected:
+    HidIoOutputReportTest()
+            : m_deviceInfo(makeDeviceInfo()),
+              m_logOutput(QStringLiteral("controller.test.output")) {
+    }
+
+    static hid_device_info makeDeviceInfo() {
+        static char path[] = "test";
+        static wchar_t serialNumber[] = L"1";
+        static wchar_t manufacturer[] = L"Mixxx";
+        static wchar_t product[] = L"Test Device";
+        hid_device_info deviceInfo = {};
+        deviceInfo.path = path;
+        deviceInfo.serial_number = serialNumber;
+        deviceInfo.manufacturer_string = manufacturer;
+        deviceInfo.product_string = product;
+        return deviceInfo;
+    }
+
+    void update(const QByteArray& data, bool resendUnchangedReport = false) {
+        m_report.updateCachedData(data, m_deviceInfo, m_logOutput, resendUnchangedReport);
+    }
+
+    bool send() {
+        return m_report.sendCachedData(&m_hidDeviceMutex, nullptr, m_deviceInfo, m_logOutput);
+    }
+
+    const mixxx::hid::DeviceInfo m_deviceInfo;
+    const RuntimeLoggingCategory m_logOutput;
+    QMutex m_hidDeviceMutex;
+    FakeOutputReport m_report;
+};
+
+TEST_F(HidIoOutputReportTest, sendCachedData) {
+    EXPECT_FALSE(send());
+
+    update(QByteArray("\x01\x02\x03\x04", 4));
+    EXPECT_TRUE(send());
+    ASSERT_EQ(1, m_report.writtenReports.size());
+    EXPECT_EQ(QByteArray("\x42\x01\x02\x03\x04", 5), m_report.writtenReports.first());
+    EXPECT_EQ(5u, m_report.statistics().bytesSent);
+
+    // Nothing new to send
+    EXPECT_FALSE(send());
+    EXPECT_EQ(1, m_report.writtenReports.size());
+}
+
+TEST_F(HidIoOutputReportTest, skipIdenticalReports) {
+    const QByteArray data("\x01\x02\x03\x04", 4);
+    update(data);
+    EXPECT_TRUE(send());
+
+    update(data);
+    EXPECT_FALSE(send());
+    EXPECT_EQ(1u, m_report.statistics().skippedIdenticalReports);
+    EXPECT_EQ(1, m_report.writtenReports.size());
+
+    // Unless requested by the mapping
+    update(data, true);
+    EXPECT_TRUE(send());
+    EXPECT_EQ(1u, m_report.statistics().skippedIdenticalReports);
+    EXPECT_EQ(2, m_report.writtenReports.size());
+}
+
+TEST_F(HidIoOutputReportTest, countSupersededReports) {
+    update(QByteArray("\x01\x00\x00\x00", 4));
+    update(QByteArray("\x02\x00\x00\x00", 4));
+    update(QByteArray("\x03\x00\x00\x00", 4));
+    EXPECT_EQ(2u, m_report.statistics().supersededReports);
+
+    // Only the latest data is sent
+    EXPECT_TRUE(send());
+    ASSERT_EQ(1, m_report.writtenReports.size());
+    EXPECT_EQ(QByteArray("\x42\x03\x00\x00\x00", 5), m_report.writtenReports.first());
+
+    // Sent reports are not superseded
+    update(QByteArray("\x04\x00\x00\x00", 4));
+    EXPECT_EQ(2u, m_report.statistics().supersededReports);
+}
+
+} // namespace
@@ -0,0 +1,154 @@
+#include "library/libraryquerythread.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QSqlQuery>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+constexpr int kTimeoutMillis = 10000;
+
+// Takes much longer than kTimeoutMillis unless it is interrupted
+const QString kSlowQuery = QStringLiteral(
+        "WITH RECURSIVE counter(x) AS "
+        "(SELECT 1 UNION ALL SELECT x+1 FROM counter) "
+        "SELECT count(*) FROM (SELECT x FROM counter LIMIT 10000000000)");
+
+const QString kFastQuery = QStringLiteral("SELECT 1");
+
+class LibraryQueryThreadTest : public MixxxDbTest {
+  protected:
+    LibraryQueryThreadTest()
+            : m_queryThread(dbConnectionPooler()) {
+    }
+
+    static LibraryQueryRequest request(const QString& tableQuery) {
+        LibraryQueryRequest request;
+        request.tableQuery = tableQuery;
+        return request;
+    }
+
+    // Processes events until the flag has been set
+    bool waitFor(const bool& flag) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!flag) {
+            if (timer.hasExpired(kTimeoutMillis)) {
+                return false;
+            }
+            application()->processEvents();
+            QThread::msleep(1);
+        }
+        return true;
+    }
+
+    LibraryQueryThread m_queryThread;
+};
+
+TEST_F(LibraryQueryThreadTest, executeQueries) {
+    LibraryQueryRequest queryRequest = request(
+            QStringLiteral("SELECT 1,'a' UNION ALL SELECT 2,'b'"));
+    queryRequest.trackSourceQuery = QStringLiteral("SELECT 2 UNION ALL SELECT 1");
+
+    const QObject requester;
+    bool delivered = false;
+    LibraryQueryResult result;
+    m_queryThread.submit(&requester,
+            std::move(queryRequest),
+            [&](LibraryQueryResult queryResult) {
+                delivered = true;
+                result = std::move(queryResult);
+            });
+    ASSERT_TRUE(waitFor(delivered));
+
+    EXPECT_TRUE(result.succeeded);
+    ASSERT_EQ(2, result.tableRows.size());
+    EXPECT_EQ(QVariant(QStringLiteral("b")), result.tableRows[1][1]);
+    EXPECT_EQ((QVector<TrackId>{TrackId(QVariant(2)), TrackId(QVariant(1))}),
+            result.trackSourceOrder);
+}
+
+TEST_F(LibraryQueryThreadTest, supersededResultIsNotDelivered) {
+    const QObject requester;
+    bool slowDelivered = false;
+    m_queryThread.submit(&requester,
+            request(kSlowQuery),
+            [&](LibraryQueryResult) {
+                slowDelivered = true;
+            });
+    // Interrupts the slow query if it is already running
+    bool fastDelivered = false;
+    m_queryThread.submit(&requester,
+            request(kFastQuery),
+            [&](LibraryQueryResult result) {
+                fastDelivered = true;
+                EXPECT_TRUE(result.succeeded);
+            });
+
+    ASSERT_TRUE(waitFor(fastDelivered));
+    // Results are delivered in the order of the requests
+    EXPECT_FALSE(slowDelivered);
+}
+
+TEST_F(LibraryQueryThreadTest, cancelledResultIsNotDelivered) {
+    const QObject requester;
+    bool slowDelivered = false;
+    m_queryThread.submit(&requester,
+            request(kSlowQuery),
+            [&](LibraryQueryResult) {
+                slowDelivered = true;
+            });
+    m_queryThread.cancel(&requester);
+
+    // The thread is available for other requesters
+    const QObject otherRequester;
+    bool fastDelivered = false;
+    m_queryThread.submit(&otherRequester,
+            request(kFastQuery),
+            [&](LibraryQueryResult result) {
+                fastDelivered = true;
+                EXPECT_TRUE(result.succeeded);
+            });
+
+    ASSERT_TRUE(waitFor(fastDelivered));
+    EXPECT_FALSE(slowDelivered);
+}
+
+TEST_F(LibraryQueryThreadTest, temporaryViewsIncludeDependencies) {
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "CREATE TEMPORARY VIEW query_test_tracks AS "
+            "SELECT id FROM library")));
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "CREATE TEMPORARY VIEW query_test_count AS "
+            "SELECT count(*) FROM query_test_tracks")));
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "CREATE TEMPORARY VIEW query_test_unrelated AS SELECT 1")));
+
+    const LibraryQueryTemporaryViews temporaryViews =
+            LibraryQueryThread::temporaryViews(
+                    dbConnection(), QStringList{QStringLiteral("query_test_count")});
+    ASSERT_EQ(2, temporaryViews.size());
+    EXPECT_EQ(QStringLiteral("query_test_tracks"), temporaryViews[0].first);
+    EXPECT_EQ(QStringLiteral("query_test_count"), temporaryViews[1].first);
+
+    // The views are recreated on the connection of the thread
+    LibraryQueryRequest queryRequest = request(
+            QStringLiteral("SELECT * FROM query_test_count"));
+    queryRequest.temporaryViews = temporaryViews;
+    const QObject requester;
+    bool delivered = false;
+    m_queryThread.submit(&requester,
+            std::move(queryRequest),
+            [&](LibraryQueryResult result) {
+                delivered = true;
+                EXPECT_TRUE(result.succeeded);
+                EXPECT_EQ(1, result.tableRows.size());
+            });
+    ASSERT_TRUE(waitFor(delivered));
+}
+
+} // anonymous namespace
@@ -15,7 +15,8 @@ void deleteTrack(Track* pTrack) {
 
 std::unique_ptr<TrackCollectionManager> newTrackCollectionManager(
         UserSettingsPointer userSettings,
-        mixxx::DbConnectionPoolPtr dbConnectionPool) {
+        mixxx::DbConnectionPoolPtr dbConnectionPool,
+        TrackCollectionManager::TrackSaveMode evictedTrackSaveMode) {
     const auto dbConnection = mixxx::DbConnectionPooled(dbConnectionPool);
     if (!MixxxDb::initDatabaseSchema(dbConnection)) {
         return nullptr;
@@ -24,14 +25,17 @@ std::unique_ptr<TrackCollectionManager> newTrackCollectionManager(
             nullptr,
             std::move(userSettings),
             std::move(dbConnectionPool),
+            evictedTrackSaveMode,
             deleteTrack);
 }
 
 } // namespace
 
-LibraryTest::LibraryTest()
+LibraryTest::LibraryTest(
+        TrackCollectionManager::TrackSaveMode evictedTrackSaveMode)
         : MixxxDbTest(kInMemoryDbConnection),
-          m_pTrackCollectionManager(newTrackCollectionManager(config(), dbConnectionPooler())),
+          m_pTrackCollectionManager(newTrackCollectionManager(
+                  config(), dbConnectionPooler(), evictedTrackSaveMode)),
           m_keyNotationCO(mixxx::library::prefs::kKeyNotationConfigKey) {
 }
 
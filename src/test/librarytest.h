@@ -13,7 +13,11 @@
 
 class LibraryTest : public MixxxDbTest, SoundSourceProviderRegistration {
   protected:
-    LibraryTest();
+    // Tests without an event loop expect that evicted tracks
+    // are saved immediately by default
+    explicit LibraryTest(
+            TrackCollectionManager::TrackSaveMode evictedTrackSaveMode =
+                    TrackCollectionManager::TrackSaveMode::Synchronous);
     ~LibraryTest() override = default;
 
     TrackCollectionManager* trackCollectionManager() const {
@@ -0,0 +1,95 @@
+#include "effects/backends/lv2/lv2drysignalaligner.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+
+constexpr SINT kNumSamples = 8;
+constexpr SINT kMaxDelaySamples = 32;
+
+class LV2DrySignalAlignerTest : public testing::Test {
+  protected:
+    LV2DrySignalAlignerTest() {
+        m_aligner.allocate(kNumSamples, kMaxDelaySamples);
+    }
+
+    // Returns buffers with increasing sample values, so the delay of each
+    // sample can be read from its value
+    const CSAMPLE* nextInput() {
+        for (SINT i = 0; i < kNumSamples; ++i) {
+            m_input[i] = static_cast<CSAMPLE>(m_numSamplesProcessed + i + 1);
+        }
+        m_numSamplesProcessed += kNumSamples;
+        return m_input;
+    }
+
+    LV2DrySignalAligner m_aligner;
+    CSAMPLE m_input[kNumSamples];
+    SINT m_numSamplesProcessed = 0;
+};
+
+TEST_F(LV2DrySignalAlignerTest, outputLatencyTransitions) {
+    using OutputLatency = LV2DrySignalAligner::OutputLatency;
+    // Running on the worker thread, the first buffer is not delayed
+    EXPECT_EQ(OutputLatency::None,
+            m_aligner.updateOutputLatency(false, EffectEnableState::Enabling));
+    EXPECT_EQ(OutputLatency::FadingIn,
+            m_aligner.updateOutputLatency(true, EffectEnableState::Enabled));
+    EXPECT_EQ(OutputLatency::Delayed,
+            m_aligner.updateOutputLatency(true, EffectEnableState::Enabled));
+    EXPECT_EQ(OutputLatency::FadingOut,
+            m_aligner.updateOutputLatency(true, EffectEnableState::Disabling));
+    // A plugin that reports latency is delayed from the first buffer on
+    EXPECT_EQ(OutputLatency::FadingIn,
+            m_aligner.updateOutputLatency(true, EffectEnableState::Enabling));
+    EXPECT_EQ(OutputLatency::Delayed,
+            m_aligner.updateOutputLatency(true, EffectEnableState::Enabled));
+    // The plugin stopped reporting latency
+    EXPECT_EQ(OutputLatency::None,
+            m_aligner.updateOutputLatency(false, EffectEnableState::Enabled));
+}
+
+TEST_F(LV2DrySignalAlignerTest, undelayedOutputPassesDrySignal) {
+    m_aligner.updateOutputLatency(false, EffectEnableState::Enabling);
+    const CSAMPLE* pDry = nextInput();
+    EXPECT_EQ(pDry, m_aligner.process(pDry, kNumSamples, kNumSamples));
+}
+
+TEST_F(LV2DrySignalAlignerTest, delayedOutputDelaysDrySignal) {
+    // Not a multiple of the buffer size, like the latency of plugins
+    constexpr SINT kDelaySamples = 2 * kNumSamples + 6;
+
+    m_aligner.updateOutputLatency(true, EffectEnableState::Enabling);
+    m_aligner.process(nextInput(), kNumSamples, kDelaySamples);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(LV2DrySignalAligner::OutputLatency::Delayed,
+                m_aligner.updateOutputLatency(true, EffectEnableState::Enabled));
+        const CSAMPLE* pDry = nextInput();
+        const CSAMPLE* pAlignedDry = m_aligner.process(pDry, kNumSamples, kDelaySamples);
+        for (SINT j = 0; j < kNumSamples; ++j) {
+            const CSAMPLE expected = std::max(pDry[j] - kDelaySamples, 0.0f);
+            EXPECT_EQ(expected, pAlignedDry[j]) << "buffer " << i << " sample " << j;
+        }
+    }
+}
+
+TEST_F(LV2DrySignalAlignerTest, enablingClearsDelayLine) {
+    m_aligner.updateOutputLatency(true, EffectEnableState::Enabling);
+    m_aligner.process(nextInput(), kNumSamples, kNumSamples);
+    m_aligner.updateOutputLatency(true, EffectEnableState::Disabling);
+    m_aligner.process(nextInput(), kNumSamples, kNumSamples);
+
+    // The first buffer after enabling again is crossfaded from the dry signal
+    // to silence instead of the dry signal from before disabling.
+    m_aligner.updateOutputLatency(true, EffectEnableState::Enabling);
+    const CSAMPLE* pDry = nextInput();
+    const CSAMPLE* pAlignedDry = m_aligner.process(pDry, kNumSamples, kNumSamples);
+    for (SINT i = 0; i < kNumSamples; ++i) {
+        const CSAMPLE fadeIn = static_cast<CSAMPLE>(i / 2) / (kNumSamples / 2);
+        EXPECT_FLOAT_EQ(pDry[i] * (1.0f - fadeIn), pAlignedDry[i]) << "sample " << i;
+    }
+}
+
+} // anonymous namespace
@@ -0,0 +1,90 @@
+#include "effects/backends/lv2/lv2workerthread.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+constexpr int kTimeoutMillis = 5000;
+
+class CountingJob : public LV2WorkerJob {
+  public:
+    void runJob() override {
+        m_pThread = QThread::currentThread();
+        m_numRuns.fetch_add(1);
+        m_semaDone.release();
+    }
+
+    bool waitDone() {
+        return m_semaDone.tryAcquire(1, kTimeoutMillis);
+    }
+
+    QThread* thread() const {
+        return m_pThread.load();
+    }
+
+    int numRuns() const {
+        return m_numRuns.load();
+    }
+
+  private:
+    std::atomic<QThread*> m_pThread{nullptr};
+    std::atomic<int> m_numRuns{0};
+    QSemaphore m_semaDone;
+};
+
+TEST(LV2WorkerThreadTest, runsJobsOnWorkerThread) {
+    LV2WorkerThread workerThread;
+    workerThread.start();
+
+    CountingJob job;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(workerThread.submit(&job));
+        ASSERT_TRUE(job.waitDone());
+    }
+    EXPECT_EQ(3, job.numRuns());
+    EXPECT_EQ(&workerThread, job.thread());
+
+    workerThread.stop();
+}
+
+TEST(LV2WorkerThreadTest, stopRunsPendingJobs) {
+    // Not started, so the jobs remain queued until stop()
+    LV2WorkerThread workerThread;
+    CountingJob job1;
+    CountingJob job2;
+    ASSERT_TRUE(workerThread.submit(&job1));
+    ASSERT_TRUE(workerThread.submit(&job2));
+    EXPECT_EQ(0, job1.numRuns());
+
+    workerThread.stop();
+    EXPECT_EQ(1, job1.numRuns());
+    EXPECT_EQ(1, job2.numRuns());
+}
+
+TEST(LV2WorkerThreadTest, submitFailsWhenQueueIsFull) {
+    LV2WorkerThread workerThread;
+    // More jobs than any number of chains would submit in one callback
+    std::vector<CountingJob> jobs(4096);
+    int numSubmitted = 0;
+    for (auto& job : jobs) {
+        if (!workerThread.submit(&job)) {
+            break;
+        }
+        ++numSubmitted;
+    }
+    ASSERT_GT(numSubmitted, 0);
+    ASSERT_LT(numSubmitted, static_cast<int>(jobs.size()));
+
+    // Rejected jobs are never run, all others are
+    workerThread.stop();
+    for (int i = 0; i < static_cast<int>(jobs.size()); ++i) {
+        EXPECT_EQ(i < numSubmitted ? 1 : 0, jobs[i].numRuns()) << "job " << i;
+    }
+}
+
+} // anonymous namespace
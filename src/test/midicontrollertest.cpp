@@ -1,6 +1,9 @@
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 
 #include <QScopedPointer>
+#include <memory>
+#include <vector>
 
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
@@ -18,6 +21,8 @@ class MockMidiController : public MidiController {
     }
     ~MockMidiController() override { }
 
+    using MidiController::receivedShortMessage;
+
     MOCK_METHOD0(open, int());
     MOCK_METHOD0(close, int());
     MOCK_METHOD3(sendShortMsg, void(unsigned char status,
@@ -596,3 +601,101 @@ TEST_F(MidiControllerTest, ReceiveMessage_PotMeterCO_14BitPitchBend) {
     receivedShortMessage(MidiOpCode::PitchBendChange, channel, 0x01, 0x40);
     EXPECT_LT(kMiddleValue, potmeter.get());
 }
+
+TEST_F(MidiControllerTest, ReceiveMessage_MultipleMappingsSameKey) {
+    ConfigKey key1("[Channel1]", "pregain");
+    ConfigKey key2("[Channel2]", "pregain");
+    ControlPotmeter potmeter1(key1, 0.0, 1.0);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+    MidiKey midiKey(MidiUtils::statusFromOpCodeAndChannel(
+                            MidiOpCode::ControlChange, channel),
+            control);
+    addMapping(MidiInputMapping(midiKey, MidiOptions(), key1));
+    addMapping(MidiInputMapping(midiKey, MidiOptions(), key2));
+    m_pController->setMapping(m_pMapping->clone());
+
+    // The second control does not exist yet when the mappings are compiled
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter1.get());
+
+    ControlPotmeter potmeter2(key2, 0.0, 1.0);
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(0.0, potmeter1.get());
+    EXPECT_DOUBLE_EQ(0.0, potmeter2.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter1.get());
+    EXPECT_DOUBLE_EQ(1.0, potmeter2.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_MappingReplaced) {
+    ConfigKey key1("[Channel1]", "pregain");
+    ConfigKey key2("[Channel2]", "pregain");
+    ControlPotmeter potmeter1(key1, 0.0, 1.0);
+    ControlPotmeter potmeter2(key2, 0.0, 1.0);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+    MidiKey midiKey(MidiUtils::statusFromOpCodeAndChannel(
+                            MidiOpCode::ControlChange, channel),
+            control);
+    addMapping(MidiInputMapping(midiKey, MidiOptions(), key1));
+    m_pController->setMapping(m_pMapping->clone());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter1.get());
+    EXPECT_DOUBLE_EQ(0.0, potmeter2.get());
+
+    // Setting a new mapping invalidates the compiled mappings
+    m_pMapping->removeInputMapping(midiKey.key);
+    addMapping(MidiInputMapping(midiKey, MidiOptions(), key2));
+    m_pController->setMapping(m_pMapping->clone());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(1.0, potmeter1.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter2.get());
+}
+
+namespace {
+
+constexpr int kNumBenchmarkDecks = 4;
+constexpr int kNumBenchmarkControlsPerDeck = 32;
+
+// Emulates a controller with a pure XML mapping that sends a control change
+// message for each of its knobs and faders. The dispatch time per message
+// should stay well below 10 us.
+static void BM_MidiControllerReceiveShortMessage(benchmark::State& state) {
+    MockMidiController controller;
+    auto pMapping = std::make_shared<LegacyMidiControllerMapping>();
+    std::vector<std::unique_ptr<ControlPotmeter>> controls;
+    for (int deck = 0; deck < kNumBenchmarkDecks; ++deck) {
+        for (int i = 0; i < kNumBenchmarkControlsPerDeck; ++i) {
+            const ConfigKey key(QStringLiteral("[Channel%1]").arg(deck + 1),
+                    QStringLiteral("benchmark_%1").arg(i));
+            controls.push_back(std::make_unique<ControlPotmeter>(key, 0.0, 1.0));
+            const MidiKey midiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                          MidiOpCode::ControlChange, deck),
+                    i);
+            pMapping->addInputMapping(midiKey.key,
+                    MidiInputMapping(midiKey, MidiOptions(), key));
+        }
+    }
+    controller.setMapping(pMapping);
+
+    unsigned char value = 0;
+    for (auto _ : state) {
+        for (int deck = 0; deck < kNumBenchmarkDecks; ++deck) {
+            const unsigned char status = MidiUtils::statusFromOpCodeAndChannel(
+                    MidiOpCode::ControlChange, deck);
+            for (int i = 0; i < kNumBenchmarkControlsPerDeck; ++i) {
+                controller.receivedShortMessage(status, i, value, mixxx::Time::elapsed());
+            }
+        }
+        value = (value + 1) & 0x7F;
+    }
+    state.SetItemsProcessed(
+            state.iterations() * kNumBenchmarkDecks * kNumBenchmarkControlsPerDeck);
+}
+BENCHMARK(BM_MidiControllerReceiveShortMessage);
+
+} // namespace
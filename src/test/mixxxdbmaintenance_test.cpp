@@ -0,0 +1,44 @@
+#include "database/mixxxdbmaintenance.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSqlQuery>
+
+#include "test/mixxxdbtest.h"
+
+class MixxxDbMaintenanceTest : public MixxxDbTest {
+  protected:
+    qint64 writeAheadLogSize() const {
+        return QFileInfo(QDir(config()->getSettingsPath())
+                                 .filePath(QStringLiteral("mixxxdb.sqlite-wal")))
+                .size();
+    }
+};
+
+TEST_F(MixxxDbMaintenanceTest, truncateWriteAheadLogWhenStopped) {
+    {
+        QSqlQuery query(dbConnection());
+        ASSERT_TRUE(query.exec(QStringLiteral("PRAGMA journal_mode")));
+        ASSERT_TRUE(query.next());
+        ASSERT_EQ(QStringLiteral("wal"), query.value(0).toString());
+        // Committed transactions are appended to the log
+        ASSERT_TRUE(query.exec(QStringLiteral(
+                "CREATE TABLE maintenance_test (id INTEGER PRIMARY KEY)")));
+        ASSERT_TRUE(query.exec(QStringLiteral(
+                "INSERT INTO maintenance_test (id) VALUES (1)")));
+    }
+    ASSERT_LT(0, writeAheadLogSize());
+
+    {
+        MixxxDbMaintenance dbMaintenance(dbConnectionPooler());
+    }
+    EXPECT_EQ(0, writeAheadLogSize());
+
+    // The data has been written back into the database
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral("SELECT COUNT(*) FROM maintenance_test")));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(1, query.value(0).toInt());
+}
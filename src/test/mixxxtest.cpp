@@ -6,6 +6,7 @@
 #include "library/coverartutils.h"
 #include "util/cmdlineargs.h"
 #include "util/logging.h"
+#include "util/realtimeguard.h"
 
 namespace {
 
@@ -58,9 +59,15 @@ MixxxTest::MixxxTest() {
     m_pConfig = UserSettingsPointer(new UserSettings(
             makeTestConfigFile(getTestDataDir().filePath("test.cfg"))));
     ControlDoublePrivate::setUserConfig(m_pConfig);
+    mixxx::RealtimeGuard::resetViolationCount();
 }
 
 MixxxTest::~MixxxTest() {
+    // Fail tests that cause allocations or locking in the audio thread
+    // when built with the REALTIME_GUARD option.
+    EXPECT_EQ(0, mixxx::RealtimeGuard::violationCount())
+            << "Realtime violations were detected, see the log for stack traces";
+
     // Mixxx leaks a ton of COs normally. To make new tests not affected by
     // previous tests, we clear our all COs after every MixxxTest completion.
     const auto controls = ControlDoublePrivate::takeAllInstances();
@@ -69,6 +69,7 @@ class PlayerManagerTest : public MixxxDbTest, SoundSourceProviderRegistration {
                 nullptr,
                 m_pConfig,
                 dbConnectionPooler(),
+                TrackCollectionManager::TrackSaveMode::Synchronous,
                 deleteTrack);
 
         m_pRecordingManager = std::make_shared<RecordingManager>(m_pConfig, m_pEngine.get());
@@ -1,14 +1,25 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <QCoreApplication>
 #include <QScopedPointer>
-
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "controllers/midi/legacymidicontrollermapping.h"
+#include "controllers/midi/midiutils.h"
 #include "controllers/midi/portmidicontroller.h"
 #include "controllers/midi/portmididevice.h"
 #include "test/mixxxtest.h"
+#include "util/time.h"
 
 using ::testing::_;
+using ::testing::AnyNumber;
 using ::testing::DoAll;
+using ::testing::InvokeWithoutArgs;
 using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::Sequence;
@@ -82,6 +93,8 @@ class PortMidiControllerTest : public MixxxTest {
                 &m_inputDeviceInfo, &m_outputDeviceInfo, 0, 0));
         m_pController->setPortMidiInputDevice(m_mockInput);
         m_pController->setPortMidiOutputDevice(m_mockOutput);
+        // Most tests read the input device explicitly with pollDevice()
+        m_pController->setUseInputThread(false);
     }
 
     void openDevice() {
@@ -96,6 +109,10 @@ class PortMidiControllerTest : public MixxxTest {
         m_pController->poll();
     }
 
+    bool isPolling() const {
+        return m_pController->isPolling();
+    }
+
     PmDeviceInfo m_inputDeviceInfo;
     PmDeviceInfo m_outputDeviceInfo;
     MockPortMidiDevice* m_mockInput;
@@ -438,3 +455,183 @@ TEST_F(PortMidiControllerTest, Poll_Read_SysEx_BufferOverflow) {
     pollDevice();
     pollDevice();
 };
+
+TEST_F(PortMidiControllerTest, InputThread_Read_Basic) {
+    m_pController->setUseInputThread(true);
+
+    std::vector<PmEvent> messages;
+    messages.push_back(MakeEvent(0x403C90, 0x0));
+    messages.push_back(MakeEvent(0x403C80, 0x1));
+
+    ON_CALL(*m_mockInput, isOpen())
+            .WillByDefault(Return(true));
+    EXPECT_CALL(*m_mockInput, isOpen())
+            .Times(AnyNumber());
+    EXPECT_CALL(*m_mockInput, openInput(MIXXX_PORTMIDI_BUFFER_LEN))
+            .WillOnce(Return(pmNoError));
+    EXPECT_CALL(*m_mockInput, close())
+            .WillOnce(Return(pmNoError));
+    EXPECT_CALL(*m_mockOutput, isOpen())
+            .WillRepeatedly(Return(false));
+    EXPECT_CALL(*m_mockOutput, openOutput())
+            .WillOnce(Return(pmNoError));
+
+    // The input thread reads the messages once and then finds nothing more
+    // to read until it is stopped.
+    Sequence read;
+    EXPECT_CALL(*m_mockInput, read(NotNull(), _))
+            .InSequence(read)
+            .WillOnce(DoAll(SetArrayArgument<0>(messages.begin(), messages.end()),
+                    Return(static_cast<int>(messages.size()))));
+    EXPECT_CALL(*m_mockInput, read(NotNull(), _))
+            .InSequence(read)
+            .WillRepeatedly(Return(0));
+
+    std::atomic<bool> received(false);
+    Sequence receive;
+    EXPECT_CALL(*m_pController, receivedShortMessage(0x90, 0x3C, 0x40, _))
+            .InSequence(receive);
+    EXPECT_CALL(*m_pController, receivedShortMessage(0x80, 0x3C, 0x40, _))
+            .InSequence(receive)
+            .WillOnce(InvokeWithoutArgs([&received] { received = true; }));
+
+    openDevice();
+    EXPECT_FALSE(isPolling());
+
+    // The messages are delivered through the event loop of this thread
+    const auto deadline = mixxx::Time::elapsed() + mixxx::Duration::fromSeconds(5);
+    while (!received && mixxx::Time::elapsed() < deadline) {
+        QCoreApplication::processEvents();
+    }
+    EXPECT_TRUE(received);
+
+    closeDevice();
+    EXPECT_TRUE(isPolling());
+};
+
+class LoopbackPortMidiController : public PortMidiController {
+  public:
+    LoopbackPortMidiController(const PmDeviceInfo* inputDeviceInfo,
+            const PmDeviceInfo* outputDeviceInfo,
+            int inputDeviceIndex,
+            int outputDeviceIndex)
+            : PortMidiController(inputDeviceInfo,
+                      outputDeviceInfo,
+                      inputDeviceIndex,
+                      outputDeviceIndex) {
+    }
+
+    using PortMidiController::sendShortMsg;
+
+    // The mapping of these tests has no scripts.
+    void startEngine() override {
+    }
+    void stopEngine() override {
+    }
+};
+
+/// Sends messages through a MIDI port that loops its output back to its input,
+/// like the "Midi Through" port of the ALSA sequencer or an IAC bus on macOS.
+/// Another port can be chosen with the MIXXX_TEST_MIDI_LOOPBACK_PORT
+/// environment variable. The tests are skipped if no such port exists.
+class PortMidiLoopbackTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        if (Pm_Initialize() != pmNoError) {
+            GTEST_SKIP() << "PortMidi is not available";
+        }
+        m_bInitialized = true;
+
+        QStringList portNames;
+        const QString portName = qEnvironmentVariable("MIXXX_TEST_MIDI_LOOPBACK_PORT");
+        if (portName.isEmpty()) {
+            portNames << QStringLiteral("Midi Through") << QStringLiteral("IAC");
+        } else {
+            portNames << portName;
+        }
+        int inputDeviceIndex = -1;
+        int outputDeviceIndex = -1;
+        for (int i = 0; i < Pm_CountDevices(); ++i) {
+            const PmDeviceInfo* pDeviceInfo = Pm_GetDeviceInfo(i);
+            const QString deviceName = QString::fromLocal8Bit(pDeviceInfo->name);
+            const bool isLoopback = std::any_of(portNames.cbegin(),
+                    portNames.cend(),
+                    [&deviceName](const QString& name) {
+                        return deviceName.contains(name, Qt::CaseInsensitive);
+                    });
+            if (!isLoopback) {
+                continue;
+            }
+            if (pDeviceInfo->input && inputDeviceIndex < 0) {
+                inputDeviceIndex = i;
+            } else if (pDeviceInfo->output && outputDeviceIndex < 0) {
+                outputDeviceIndex = i;
+            }
+        }
+        if (inputDeviceIndex < 0 || outputDeviceIndex < 0) {
+            GTEST_SKIP() << "No MIDI loopback port found";
+        }
+
+        m_pController = std::make_unique<LoopbackPortMidiController>(
+                Pm_GetDeviceInfo(inputDeviceIndex),
+                Pm_GetDeviceInfo(outputDeviceIndex),
+                inputDeviceIndex,
+                outputDeviceIndex);
+    }
+
+    void TearDown() override {
+        if (m_pController) {
+            m_pController->close();
+            m_pController.reset();
+        }
+        if (m_bInitialized) {
+            Pm_Terminate();
+        }
+    }
+
+    bool m_bInitialized = false;
+    std::unique_ptr<LoopbackPortMidiController> m_pController;
+};
+
+TEST_F(PortMidiLoopbackTest, InputThread_ControlLatency) {
+    // The ControllerManager poll timer alone used to add up to 5 ms
+    const auto kMaxMedianLatency = mixxx::Duration::fromMillis(2);
+    const auto kTimeout = mixxx::Duration::fromSeconds(1);
+    constexpr unsigned char kChannel = 0x0F;
+    constexpr unsigned char kControl = 0x42;
+    constexpr int kNumMessages = 100;
+
+    const ConfigKey key("[Test]", "midi_loopback");
+    ControlObject co(key);
+    const unsigned char status = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::ControlChange, kChannel);
+    auto pMapping = std::make_shared<LegacyMidiControllerMapping>();
+    const MidiInputMapping mapping(MidiKey(status, kControl), MidiOptions(), key);
+    pMapping->addInputMapping(mapping.key.key, mapping);
+    m_pController->setMapping(pMapping);
+
+    ASSERT_EQ(0, m_pController->open());
+    ASSERT_FALSE(m_pController->isPolling());
+
+    // Each message changes the control value, from MIDI out through the
+    // loopback port and the input thread to the mapping
+    std::vector<mixxx::Duration> latencies;
+    latencies.reserve(kNumMessages);
+    for (int i = 0; i < kNumMessages; ++i) {
+        const unsigned char value = static_cast<unsigned char>(i % 0x7F) + 1;
+        const double previousValue = co.get();
+        const auto sent = mixxx::Time::elapsed();
+        m_pController->sendShortMsg(status, kControl, value);
+        while (co.get() == previousValue) {
+            QCoreApplication::processEvents();
+            ASSERT_LT(mixxx::Time::elapsed() - sent, kTimeout) << "message " << i;
+        }
+        latencies.push_back(mixxx::Time::elapsed() - sent);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto medianLatency = latencies[latencies.size() / 2];
+    RecordProperty("median_latency_us", static_cast<int>(medianLatency.toIntegerMicros()));
+    RecordProperty("max_latency_us", static_cast<int>(latencies.back().toIntegerMicros()));
+    EXPECT_LT(medianLatency, kMaxMedianLatency);
+}
@@ -0,0 +1,93 @@
+#include "util/realtimeguard.h"
+
+#include <gtest/gtest.h>
+
+#include <QMutex>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+#include "util/compatibility/qmutex.h"
+#include "util/mutex.h"
+
+namespace {
+
+class RealtimeGuardTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        if (!mixxx::RealtimeGuard::isEnabled()) {
+            GTEST_SKIP() << "Built without the REALTIME_GUARD option";
+        }
+        mixxx::RealtimeGuard::resetViolationCount();
+    }
+
+    void TearDown() override {
+        mixxx::RealtimeGuard::resetViolationCount();
+    }
+};
+
+TEST_F(RealtimeGuardTest, allocationOutsideOfRealtimeSection) {
+    auto pValue = std::make_unique<int>(1);
+    EXPECT_EQ(0, mixxx::RealtimeGuard::violationCount());
+}
+
+TEST_F(RealtimeGuardTest, allocationInRealtimeSection) {
+    {
+        mixxx::ScopedRealtimeSection realtimeSection;
+        auto pValue = std::make_unique<int>(1);
+    }
+    // Allocation and deallocation
+    EXPECT_EQ(2, mixxx::RealtimeGuard::violationCount());
+}
+
+TEST_F(RealtimeGuardTest, lockInRealtimeSection) {
+    MMutex mutex;
+    {
+        mixxx::ScopedRealtimeSection realtimeSection;
+        // Not blocking, so this is allowed
+        ASSERT_TRUE(mutex.tryLock());
+        mutex.unlock();
+        EXPECT_EQ(0, mixxx::RealtimeGuard::violationCount());
+        MMutexLocker locked(&mutex);
+    }
+    EXPECT_EQ(1, mixxx::RealtimeGuard::violationCount());
+}
+
+TEST_F(RealtimeGuardTest, alignedAllocationInRealtimeSection) {
+    void* pMemalign = nullptr;
+    void* pAlignedAlloc = nullptr;
+    {
+        mixxx::ScopedRealtimeSection realtimeSection;
+        ASSERT_EQ(0, posix_memalign(&pMemalign, 64, 1024));
+        pAlignedAlloc = aligned_alloc(64, 1024);
+    }
+    EXPECT_EQ(2, mixxx::RealtimeGuard::violationCount());
+    ASSERT_NE(nullptr, pMemalign);
+    ASSERT_NE(nullptr, pAlignedAlloc);
+    EXPECT_EQ(0u, reinterpret_cast<quintptr>(pMemalign) % 64);
+    EXPECT_EQ(0u, reinterpret_cast<quintptr>(pAlignedAlloc) % 64);
+    free(pMemalign);
+    free(pAlignedAlloc);
+}
+
+TEST_F(RealtimeGuardTest, rawMutexInRealtimeSection) {
+    QMutex qMutex;
+    std::mutex stdMutex;
+    {
+        mixxx::ScopedRealtimeSection realtimeSection;
+        const auto locked = lockMutex(&qMutex);
+        std::lock_guard<std::mutex> stdLocked(stdMutex);
+    }
+    EXPECT_EQ(2, mixxx::RealtimeGuard::violationCount());
+}
+
+TEST_F(RealtimeGuardTest, suspended) {
+    {
+        mixxx::ScopedRealtimeSection realtimeSection;
+        mixxx::ScopedRealtimeGuardSuspender suspender;
+        auto pValue = std::make_unique<int>(1);
+    }
+    EXPECT_EQ(0, mixxx::RealtimeGuard::violationCount());
+}
+
+} // namespace
@@ -0,0 +1,435 @@
+#include "library/rekordbox/rekordboxpdbreader.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kPageSize = 4096;
+constexpr std::size_t kPageHeapOffset = 0x28;
+constexpr std::size_t kRowGroupLength = 0x24;
+constexpr std::size_t kTrackRowStringsOffset = 0x5e;
+constexpr int kTrackRowNumStrings = 21;
+
+void putU8(std::string* pBytes, std::size_t pos, uint8_t value) {
+    if (pBytes->size() < pos + 1) {
+        pBytes->resize(pos + 1);
+    }
+    (*pBytes)[pos] = static_cast<char>(value);
+}
+
+void putU16(std::string* pBytes, std::size_t pos, uint16_t value) {
+    putU8(pBytes, pos, static_cast<uint8_t>(value));
+    putU8(pBytes, pos + 1, static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::string* pBytes, std::size_t pos, uint32_t value) {
+    putU16(pBytes, pos, static_cast<uint16_t>(value));
+    putU16(pBytes, pos + 2, static_cast<uint16_t>(value >> 16));
+}
+
+// Encodes a DeviceSQL string, see rekordbox_pdb.ksy
+std::string pdbString(const std::string& text) {
+    std::string bytes;
+    if (text.size() <= 126) {
+        putU8(&bytes, 0, static_cast<uint8_t>((text.size() + 1) * 2 + 1));
+    } else {
+        putU8(&bytes, 0, 0x40);
+        putU16(&bytes, 1, static_cast<uint16_t>(text.size()));
+    }
+    return bytes + text;
+}
+
+std::string pdbUtf16BeString(const std::u16string& text) {
+    std::string bytes;
+    putU8(&bytes, 0, 0x90);
+    putU16(&bytes, 1, static_cast<uint16_t>(text.size() * 2 + 4));
+    for (const char16_t c : text) {
+        bytes.push_back(static_cast<char>(c >> 8));
+        bytes.push_back(static_cast<char>(c & 0xff));
+    }
+    return bytes;
+}
+
+std::string nameRow(uint32_t id, const std::string& name) {
+    std::string row;
+    putU32(&row, 0, id);
+    return row + pdbString(name);
+}
+
+std::string keyRow(uint32_t id, const std::string& name) {
+    std::string row;
+    putU32(&row, 0, id);
+    putU32(&row, 4, id);
+    return row + pdbString(name);
+}
+
+std::string artistRow(uint32_t id, const std::string& name) {
+    std::string row;
+    putU16(&row, 0, 0x60);
+    putU32(&row, 4, id);
+    putU8(&row, 8, 0x03);
+    putU8(&row, 9, 0x0a);
+    return row + pdbString(name);
+}
+
+std::string playlistTreeRow(uint32_t parentId,
+        uint32_t sortOrder,
+        uint32_t id,
+        bool isFolder,
+        const std::string& name) {
+    std::string row;
+    putU32(&row, 0x00, parentId);
+    putU32(&row, 0x08, sortOrder);
+    putU32(&row, 0x0c, id);
+    putU32(&row, 0x10, isFolder ? 1 : 0);
+    return row + pdbString(name);
+}
+
+std::string playlistEntryRow(uint32_t entryIndex, uint32_t trackId, uint32_t playlistId) {
+    std::string row;
+    putU32(&row, 0x00, entryIndex);
+    putU32(&row, 0x04, trackId);
+    putU32(&row, 0x08, playlistId);
+    return row;
+}
+
+std::string trackRow(uint32_t id,
+        uint32_t artistId,
+        const std::string& title,
+        const std::string& filePath) {
+    std::string row;
+    putU16(&row, 0x00, 0x24);
+    putU32(&row, 0x08, 44100);
+    putU32(&row, 0x30, 320);
+    putU32(&row, 0x34, id % 20 + 1);
+    putU32(&row, 0x38, 12800 + id % 1000);
+    putU32(&row, 0x44, artistId);
+    putU32(&row, 0x48, id);
+    putU16(&row, 0x50, 2000 + id % 20);
+    putU16(&row, 0x54, 180 + id % 200);
+    putU8(&row, 0x59, static_cast<uint8_t>(id % 6));
+    std::vector<std::string> strings(kTrackRowNumStrings);
+    strings[14] = "/PIONEER/USBANLZ/" + std::to_string(id) + "/ANLZ0000.DAT";
+    strings[16] = "Comment " + std::to_string(id);
+    strings[17] = title;
+    strings[19] = filePath.substr(filePath.rfind('/') + 1);
+    strings[20] = filePath;
+    std::size_t stringPos = kTrackRowStringsOffset + 2 * kTrackRowNumStrings;
+    row.resize(stringPos);
+    for (int i = 0; i < kTrackRowNumStrings; ++i) {
+        putU16(&row, kTrackRowStringsOffset + 2 * i, static_cast<uint16_t>(row.size()));
+        row += pdbString(strings[i]);
+    }
+    return row;
+}
+
+// Writes a DeviceSQL database with the same layout as Rekordbox: a file
+// header page followed by the pages of each table, which start with an
+// empty page that does not contain rows.
+class SyntheticPdbBuilder {
+  public:
+    void addTable(RekordboxPdbPageType type, const std::vector<std::string>& rows) {
+        m_tables.push_back({type, rows});
+    }
+
+    std::string build() const {
+        std::vector<std::string> pages(1);
+        std::vector<uint32_t> firstPages;
+        std::vector<uint32_t> lastPages;
+        for (const auto& table : m_tables) {
+            const auto type = static_cast<uint32_t>(table.type);
+            firstPages.push_back(static_cast<uint32_t>(pages.size()));
+            pages.push_back(emptyPage(static_cast<uint32_t>(pages.size()), type));
+            std::vector<std::string> rows;
+            for (const auto& row : table.rows) {
+                const std::size_t numRows = rows.size() + 1;
+                const std::size_t numGroups = (numRows - 1) / 16 + 1;
+                std::size_t heapSize = 0;
+                for (const auto& pageRow : rows) {
+                    heapSize += pageRow.size();
+                }
+                if (kPageHeapOffset + heapSize + row.size() + numGroups * kRowGroupLength >
+                        kPageSize) {
+                    pages.push_back(dataPage(static_cast<uint32_t>(pages.size()), type, rows));
+                    rows.clear();
+                }
+                rows.push_back(row);
+            }
+            if (!rows.empty()) {
+                pages.push_back(dataPage(static_cast<uint32_t>(pages.size()), type, rows));
+            }
+            lastPages.push_back(static_cast<uint32_t>(pages.size() - 1));
+        }
+        // Link the pages of each table
+        for (std::size_t i = 0; i < m_tables.size(); ++i) {
+            for (uint32_t page = firstPages[i]; page <= lastPages[i]; ++page) {
+                putU32(&pages[page], 0x0c, page + 1);
+            }
+        }
+
+        std::string& header = pages[0];
+        putU32(&header, 0x04, static_cast<uint32_t>(kPageSize));
+        putU32(&header, 0x08, static_cast<uint32_t>(m_tables.size()));
+        putU32(&header, 0x0c, static_cast<uint32_t>(pages.size()));
+        for (std::size_t i = 0; i < m_tables.size(); ++i) {
+            const std::size_t tablePos = 0x1c + i * 0x10;
+            putU32(&header, tablePos, static_cast<uint32_t>(m_tables[i].type));
+            putU32(&header, tablePos + 0x08, firstPages[i]);
+            putU32(&header, tablePos + 0x0c, lastPages[i]);
+        }
+
+        std::string file;
+        for (auto& page : pages) {
+            page.resize(kPageSize);
+            file += page;
+        }
+        return file;
+    }
+
+  private:
+    struct Table {
+        RekordboxPdbPageType type;
+        std::vector<std::string> rows;
+    };
+
+    static std::string emptyPage(uint32_t index, uint32_t type) {
+        std::string page(kPageSize, '\0');
+        putU32(&page, 0x04, index);
+        putU32(&page, 0x08, type);
+        putU8(&page, 0x1b, 0x64);
+        putU16(&page, 0x22, 0x1fff);
+        return page;
+    }
+
+    static std::string dataPage(uint32_t index,
+            uint32_t type,
+            const std::vector<std::string>& rows) {
+        std::string page(kPageSize, '\0');
+        putU32(&page, 0x04, index);
+        putU32(&page, 0x08, type);
+        putU8(&page, 0x18, static_cast<uint8_t>(rows.size() < 0x100 ? rows.size() : 0));
+        putU8(&page, 0x1b, 0x34);
+        putU16(&page, 0x22, static_cast<uint16_t>(rows.size()));
+        std::size_t heapPos = kPageHeapOffset;
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            page.replace(heapPos, rows[i].size(), rows[i]);
+            const std::size_t groupBase = kPageSize - (i / 16) * kRowGroupLength;
+            const std::size_t indexInGroup = i % 16;
+            putU16(&page,
+                    groupBase - (6 + 2 * indexInGroup),
+                    static_cast<uint16_t>(heapPos - kPageHeapOffset));
+            const uint16_t presentFlags =
+                    static_cast<uint16_t>(static_cast<uint8_t>(page[groupBase - 4]) |
+                            (static_cast<uint8_t>(page[groupBase - 3]) << 8));
+            putU16(&page,
+                    groupBase - 4,
+                    static_cast<uint16_t>(presentFlags | (1 << indexInGroup)));
+            heapPos += rows[i].size();
+        }
+        return page;
+    }
+
+    std::vector<Table> m_tables;
+};
+
+constexpr uint32_t kNumArtists = 100;
+constexpr uint32_t kNumPlaylists = 50;
+
+// A database resembling a large USB stick with an artist for every 10
+// tracks and playlists that each contain every 10th track.
+std::string buildSyntheticPdb(uint32_t numTracks) {
+    std::vector<std::string> artists;
+    for (uint32_t id = 1; id <= kNumArtists; ++id) {
+        artists.push_back(artistRow(id, "Artist " + std::to_string(id)));
+    }
+    std::vector<std::string> tracks;
+    for (uint32_t id = 1; id <= numTracks; ++id) {
+        tracks.push_back(trackRow(id,
+                id % kNumArtists + 1,
+                "Title " + std::to_string(id),
+                "/Contents/Artist/Album/Track " + std::to_string(id) + ".mp3"));
+    }
+    std::vector<std::string> playlistTree;
+    std::vector<std::string> playlistEntries;
+    for (uint32_t playlistId = 1; playlistId <= kNumPlaylists; ++playlistId) {
+        playlistTree.push_back(playlistTreeRow(
+                0, playlistId - 1, playlistId, false, "Playlist " + std::to_string(playlistId)));
+        uint32_t entryIndex = 1;
+        for (uint32_t trackId = playlistId % 10 + 1; trackId <= numTracks; trackId += 10) {
+            playlistEntries.push_back(playlistEntryRow(entryIndex++, trackId, playlistId));
+        }
+    }
+
+    SyntheticPdbBuilder builder;
+    builder.addTable(RekordboxPdbPageType::Tracks, tracks);
+    builder.addTable(RekordboxPdbPageType::Genres, {nameRow(1, "House")});
+    builder.addTable(RekordboxPdbPageType::Artists, artists);
+    builder.addTable(RekordboxPdbPageType::Keys, {keyRow(1, "Am")});
+    builder.addTable(RekordboxPdbPageType::PlaylistTree, playlistTree);
+    builder.addTable(RekordboxPdbPageType::PlaylistEntries, playlistEntries);
+    return builder.build();
+}
+
+std::string toStdString(const RekordboxPdbString& string) {
+    return std::string(string.data(), string.size());
+}
+
+const uint8_t* bytes(const std::string& file) {
+    return reinterpret_cast<const uint8_t*>(file.data());
+}
+
+class RekordboxPdbReaderTest : public testing::Test {
+};
+
+TEST_F(RekordboxPdbReaderTest, InvalidHeader) {
+    const std::string file(16, '\0');
+    EXPECT_FALSE(RekordboxPdbReader(bytes(file), file.size()).isValid());
+}
+
+TEST_F(RekordboxPdbReaderTest, ReadTracks) {
+    constexpr uint32_t kNumTracks = 1000;
+    const std::string file = buildSyntheticPdb(kNumTracks);
+    const RekordboxPdbReader reader(bytes(file), file.size());
+    ASSERT_TRUE(reader.isValid());
+
+    uint32_t expectedId = 1;
+    reader.forEachRow(RekordboxPdbPageType::Tracks, [&](const RekordboxPdbRow& row) {
+        const RekordboxPdbTrackRow track(row);
+        EXPECT_EQ(expectedId, track.id());
+        EXPECT_EQ(expectedId % kNumArtists + 1, track.artistId());
+        EXPECT_EQ(44100u, track.sampleRate());
+        EXPECT_EQ(12800 + expectedId % 1000, track.tempo());
+        EXPECT_EQ(2000 + expectedId % 20, track.year());
+        EXPECT_EQ(expectedId % 6, track.rating());
+        EXPECT_EQ("Title " + std::to_string(expectedId), toStdString(track.title()));
+        EXPECT_EQ("/Contents/Artist/Album/Track " + std::to_string(expectedId) + ".mp3",
+                toStdString(track.filePath()));
+        EXPECT_EQ("Comment " + std::to_string(expectedId), toStdString(track.comment()));
+        ++expectedId;
+    });
+    EXPECT_EQ(kNumTracks + 1, expectedId);
+}
+
+TEST_F(RekordboxPdbReaderTest, ReadNamesAndPlaylists) {
+    const std::string file = buildSyntheticPdb(100);
+    const RekordboxPdbReader reader(bytes(file), file.size());
+    ASSERT_TRUE(reader.isValid());
+
+    std::map<uint32_t, std::string> artists;
+    reader.forEachRow(RekordboxPdbPageType::Artists, [&](const RekordboxPdbRow& row) {
+        const RekordboxPdbArtistRow artist(row);
+        artists[artist.id()] = toStdString(artist.name());
+    });
+    EXPECT_EQ(kNumArtists, artists.size());
+    EXPECT_EQ("Artist 42", artists[42]);
+
+    std::string key;
+    reader.forEachRow(RekordboxPdbPageType::Keys, [&](const RekordboxPdbRow& row) {
+        const RekordboxPdbNameRow keyRow(RekordboxPdbPageType::Keys, row);
+        EXPECT_EQ(1u, keyRow.id());
+        key = toStdString(keyRow.name());
+    });
+    EXPECT_EQ("Am", key);
+
+    int numPlaylists = 0;
+    reader.forEachRow(RekordboxPdbPageType::PlaylistTree, [&](const RekordboxPdbRow& row) {
+        const RekordboxPdbPlaylistTreeRow playlist(row);
+        ++numPlaylists;
+        EXPECT_EQ(0u, playlist.parentId());
+        EXPECT_FALSE(playlist.isFolder());
+        EXPECT_EQ("Playlist " + std::to_string(playlist.id()), toStdString(playlist.name()));
+    });
+    EXPECT_EQ(static_cast<int>(kNumPlaylists), numPlaylists);
+
+    std::vector<uint32_t> trackIds;
+    reader.forEachRow(RekordboxPdbPageType::PlaylistEntries, [&](const RekordboxPdbRow& row) {
+        const RekordboxPdbPlaylistEntryRow entry(row);
+        if (entry.playlistId() == 3) {
+            EXPECT_EQ(trackIds.size() + 1, entry.entryIndex());
+            trackIds.push_back(entry.trackId());
+        }
+    });
+    EXPECT_EQ((std::vector<uint32_t>{4, 14, 24, 34, 44, 54, 64, 74, 84, 94}), trackIds);
+}
+
+TEST_F(RekordboxPdbReaderTest, ReadLongStrings) {
+    const std::string longTitle(300, 'x');
+    std::string utf16Row;
+    putU32(&utf16Row, 0, 2);
+    utf16Row += pdbUtf16BeString(u"Zürich");
+
+    SyntheticPdbBuilder builder;
+    builder.addTable(RekordboxPdbPageType::Genres, {nameRow(1, longTitle), utf16Row});
+    const std::string file = builder.build();
+    const RekordboxPdbReader reader(bytes(file), file.size());
+    ASSERT_TRUE(reader.isValid());
+
+    std::vector<RekordboxPdbString> names;
+    reader.forEachRow(RekordboxPdbPageType::Genres, [&](const RekordboxPdbRow& row) {
+        names.push_back(RekordboxPdbNameRow(RekordboxPdbPageType::Genres, row).name());
+    });
+    ASSERT_EQ(2u, names.size());
+    EXPECT_EQ(RekordboxPdbString::Encoding::Ascii, names[0].encoding());
+    EXPECT_EQ(longTitle, toStdString(names[0]));
+    EXPECT_EQ(RekordboxPdbString::Encoding::Utf16Be, names[1].encoding());
+    EXPECT_EQ(std::string("\0Z\0\xfc\0r\0i\0c\0h", 12), toStdString(names[1]));
+}
+
+TEST_F(RekordboxPdbReaderTest, CyclicPageLinks) {
+    std::string file = buildSyntheticPdb(100);
+    // Let the last page of the tracks table point to the first one
+    // while claiming that the table ends on another page
+    const uint32_t firstPage = static_cast<uint8_t>(file[0x1c + 0x08]);
+    const uint32_t lastPage = static_cast<uint8_t>(file[0x1c + 0x0c]);
+    putU32(&file, lastPage * kPageSize + 0x0c, firstPage);
+    putU32(&file, 0x1c + 0x0c, 0xffff);
+    const RekordboxPdbReader reader(bytes(file), file.size());
+    ASSERT_TRUE(reader.isValid());
+
+    int numTracks = 0;
+    reader.forEachRow(RekordboxPdbPageType::Tracks, [&](const RekordboxPdbRow&) {
+        ++numTracks;
+    });
+    // Terminates after visiting each page of the file at most once
+    EXPECT_GE(numTracks, 100);
+}
+
+static void BM_RekordboxPdbReadTracks(benchmark::State& state) {
+    const std::string file = buildSyntheticPdb(static_cast<uint32_t>(state.range(0)));
+    const RekordboxPdbReader reader(bytes(file), file.size());
+    for (auto _ : state) {
+        std::size_t numBytes = 0;
+        reader.forEachRow(RekordboxPdbPageType::Tracks, [&](const RekordboxPdbRow& row) {
+            const RekordboxPdbTrackRow track(row);
+            numBytes += track.id() + track.artistId() + track.title().size() +
+                    track.filePath().size() + track.analyzePath().size();
+        });
+        benchmark::DoNotOptimize(numBytes);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RekordboxPdbReadTracks)->Range(1000, 32000);
+
+static void BM_RekordboxPdbReadPlaylistEntries(benchmark::State& state) {
+    const std::string file = buildSyntheticPdb(static_cast<uint32_t>(state.range(0)));
+    const RekordboxPdbReader reader(bytes(file), file.size());
+    for (auto _ : state) {
+        std::vector<uint32_t> trackIds;
+        reader.forEachRow(RekordboxPdbPageType::PlaylistEntries,
+                [&](const RekordboxPdbRow& row) {
+                    const RekordboxPdbPlaylistEntryRow entry(row);
+                    if (entry.playlistId() == 1) {
+                        trackIds.push_back(entry.trackId());
+                    }
+                });
+        benchmark::DoNotOptimize(trackIds.data());
+    }
+}
+BENCHMARK(BM_RekordboxPdbReadPlaylistEntries)->Range(1000, 32000);
+
+} // namespace
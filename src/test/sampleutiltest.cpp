@@ -303,6 +303,22 @@ TEST_F(SampleUtilTest, sumAbsPerChannel) {
     }
 }
 
+TEST_F(SampleUtilTest, isSilent) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        ClearBuffer(buffer, size);
+        EXPECT_TRUE(SampleUtil::isSilent(buffer, size));
+        // A single non-zero sample anywhere in the buffer is not silence,
+        // regardless of its sign.
+        buffer[size - 1] = -0.0001f;
+        EXPECT_FALSE(SampleUtil::isSilent(buffer, size));
+        buffer[size - 1] = CSAMPLE_ZERO;
+        buffer[0] = 0.0001f;
+        EXPECT_FALSE(SampleUtil::isSilent(buffer, size));
+    }
+}
+
 TEST_F(SampleUtilTest, interleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -56,3 +56,41 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, getTracksByIds) {
+    TrackId trackId1;
+    TrackId trackId2;
+    {
+        TrackPointer pTrack1 = getOrAddTrackByLocation(
+                getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.ogg")));
+        ASSERT_NE(nullptr, pTrack1);
+        pTrack1->setTitle(QStringLiteral("Title 1"));
+        pTrack1->createAndAddCue(mixxx::CueType::HotCue,
+                1,
+                mixxx::audio::FramePos(100),
+                mixxx::audio::kInvalidFramePos);
+        TrackPointer pTrack2 = getOrAddTrackByLocation(
+                getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.flac")));
+        ASSERT_NE(nullptr, pTrack2);
+        trackId1 = pTrack1->getId();
+        trackId2 = pTrack2->getId();
+    }
+    ASSERT_TRUE(trackId1.isValid());
+    ASSERT_TRUE(trackId2.isValid());
+
+    // Keep the second track cached
+    const TrackPointer pCachedTrack2 = trackCollectionManager()->getTrackById(trackId2);
+    ASSERT_NE(nullptr, pCachedTrack2);
+
+    const TrackId missingTrackId(trackId2.value() + 1000);
+    const auto tracks = trackCollectionManager()->getTracksByIds(
+            {trackId1, missingTrackId, trackId2, trackId1});
+    ASSERT_EQ(4, tracks.size());
+    ASSERT_NE(nullptr, tracks[0]);
+    EXPECT_EQ(trackId1, tracks[0]->getId());
+    EXPECT_EQ(QStringLiteral("Title 1"), tracks[0]->getTitle());
+    EXPECT_EQ(1, tracks[0]->getCuePoints().size());
+    EXPECT_EQ(nullptr, tracks[1]);
+    EXPECT_EQ(pCachedTrack2, tracks[2]);
+    EXPECT_EQ(tracks[0], tracks[3]);
+}
@@ -0,0 +1,152 @@
+#include "library/tracksavequeue.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "test/librarytest.h"
+#include "track/track.h"
+
+class TrackSaveQueueTest : public LibraryTest {
+  protected:
+    explicit TrackSaveQueueTest(
+            TrackCollectionManager::TrackSaveMode evictedTrackSaveMode =
+                    TrackCollectionManager::TrackSaveMode::Synchronous)
+            : LibraryTest(evictedTrackSaveMode) {
+    }
+
+    TrackId addTrack(const QString& fileName) {
+        const auto pTrack = getOrAddTrackByLocation(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName));
+        if (!pTrack) {
+            return TrackId();
+        }
+        pTrack->setTitle(QStringLiteral("Original"));
+        return pTrack->getId();
+    }
+
+    static TrackSnapshot trackSnapshot(TrackId trackId, const QString& title) {
+        TrackSnapshot trackSnapshot;
+        trackSnapshot.record = mixxx::TrackRecord(trackId);
+        trackSnapshot.record.refMetadata().refTrackInfo().setTitle(title);
+        return trackSnapshot;
+    }
+
+    QString titleInDatabase(TrackId trackId) const {
+        QSqlQuery query(dbConnection());
+        query.prepare(QStringLiteral("SELECT title FROM library WHERE id=:id"));
+        query.bindValue(":id", trackId.toVariant());
+        if (!query.exec() || !query.next()) {
+            return QString();
+        }
+        return query.value(0).toString();
+    }
+};
+
+class EvictedTrackSaveQueueTest : public TrackSaveQueueTest {
+  protected:
+    EvictedTrackSaveQueueTest()
+            : TrackSaveQueueTest(TrackCollectionManager::TrackSaveMode::WriteBehind) {
+    }
+
+    TrackSaveQueue* trackSaveQueue() const {
+        return trackCollectionManager()->trackSaveQueue();
+    }
+
+    void modifyAndEvictTrack(TrackId trackId, const QString& title) {
+        const auto pTrack = trackCollectionManager()->getTrackById(trackId);
+        ASSERT_NE(nullptr, pTrack);
+        pTrack->setTitle(title);
+        // The track is evicted when the last reference is dropped
+    }
+};
+
+TEST_F(TrackSaveQueueTest, saveAndCoalesceSnapshots) {
+    const TrackId trackId1 = addTrack(QStringLiteral("cover-test.ogg"));
+    const TrackId trackId2 = addTrack(QStringLiteral("cover-test.flac"));
+    ASSERT_TRUE(trackId1.isValid());
+    ASSERT_TRUE(trackId2.isValid());
+
+    TrackSaveQueue trackSaveQueue(dbConnectionPooler(), config());
+    EXPECT_TRUE(trackSaveQueue.enqueue(trackSnapshot(trackId1, QStringLiteral("First"))));
+    EXPECT_TRUE(trackSaveQueue.enqueue(trackSnapshot(trackId2, QStringLiteral("Second"))));
+    // Replaces the pending snapshot
+    EXPECT_TRUE(trackSaveQueue.enqueue(trackSnapshot(trackId1, QStringLiteral("Third"))));
+
+    trackSaveQueue.flush();
+    EXPECT_EQ(0, trackSaveQueue.queueDepth());
+    EXPECT_EQ(QStringLiteral("Third"), titleInDatabase(trackId1));
+    EXPECT_EQ(QStringLiteral("Second"), titleInDatabase(trackId2));
+}
+
+TEST_F(TrackSaveQueueTest, takePendingSnapshot) {
+    const TrackId trackId = addTrack(QStringLiteral("cover-test.ogg"));
+    ASSERT_TRUE(trackId.isValid());
+
+    TrackSaveQueue trackSaveQueue(dbConnectionPooler(), config());
+    EXPECT_TRUE(trackSaveQueue.enqueue(trackSnapshot(trackId, QStringLiteral("Modified"))));
+
+    // The snapshot is either still pending or has already been saved
+    const auto pendingSnapshot = trackSaveQueue.takePendingSnapshot(trackId);
+    if (pendingSnapshot) {
+        EXPECT_EQ(QStringLiteral("Modified"),
+                pendingSnapshot->record.getMetadata().getTrackInfo().getTitle());
+        EXPECT_EQ(QStringLiteral("Original"), titleInDatabase(trackId));
+    } else {
+        EXPECT_EQ(QStringLiteral("Modified"), titleInDatabase(trackId));
+    }
+    EXPECT_FALSE(trackSaveQueue.takePendingSnapshot(trackId).has_value());
+    EXPECT_EQ(0, trackSaveQueue.queueDepth());
+}
+
+TEST_F(TrackSaveQueueTest, saveSnapshotsWhenStopped) {
+    const TrackId trackId = addTrack(QStringLiteral("cover-test.ogg"));
+    ASSERT_TRUE(trackId.isValid());
+
+    {
+        TrackSaveQueue trackSaveQueue(dbConnectionPooler(), config());
+        EXPECT_TRUE(trackSaveQueue.enqueue(trackSnapshot(trackId, QStringLiteral("Modified"))));
+    }
+    EXPECT_EQ(QStringLiteral("Modified"), titleInDatabase(trackId));
+}
+
+TEST_F(EvictedTrackSaveQueueTest, reloadEvictedTrackWhileQueued) {
+    ASSERT_NE(nullptr, trackSaveQueue());
+    const TrackId trackId = addTrack(QStringLiteral("cover-test.ogg"));
+    ASSERT_TRUE(trackId.isValid());
+    trackSaveQueue()->flush();
+    ASSERT_EQ(QStringLiteral("Original"), titleInDatabase(trackId));
+
+    // Keep the snapshots of evicted tracks in the queue
+    trackSaveQueue()->setPausedForTesting(true);
+
+    modifyAndEvictTrack(trackId, QStringLiteral("Modified"));
+    EXPECT_EQ(1, trackSaveQueue()->queueDepth());
+    EXPECT_EQ(QStringLiteral("Original"), titleInDatabase(trackId));
+
+    // Loading the track again saves the pending snapshot first
+    {
+        const auto pTrack = trackCollectionManager()->getTrackById(trackId);
+        ASSERT_NE(nullptr, pTrack);
+        EXPECT_EQ(QStringLiteral("Modified"), pTrack->getTitle());
+        EXPECT_FALSE(pTrack->isDirty());
+    }
+    EXPECT_EQ(0, trackSaveQueue()->queueDepth());
+    EXPECT_EQ(QStringLiteral("Modified"), titleInDatabase(trackId));
+
+    modifyAndEvictTrack(trackId, QStringLiteral("Modified again"));
+    const auto pendingSnapshot = trackSaveQueue()->takePendingSnapshot(trackId);
+    ASSERT_TRUE(pendingSnapshot.has_value());
+    EXPECT_EQ(QStringLiteral("Modified again"),
+            pendingSnapshot->record.getMetadata().getTrackInfo().getTitle());
+    EXPECT_EQ(0, trackSaveQueue()->queueDepth());
+    // The taken snapshot has not been saved
+    EXPECT_EQ(QStringLiteral("Modified"), titleInDatabase(trackId));
+    {
+        const auto pTrack = trackCollectionManager()->getTrackById(trackId);
+        ASSERT_NE(nullptr, pTrack);
+        EXPECT_EQ(QStringLiteral("Modified"), pTrack->getTitle());
+    }
+
+    trackSaveQueue()->setPausedForTesting(false);
+}
@@ -0,0 +1,97 @@
+#include "track/audiofingerprint.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <bitset>
+
+namespace mixxx {
+
+namespace {
+
+// Chromaprint item of digital silence, which does not help to tell
+// tracks apart
+constexpr uint32_t kSilenceItem = 627964279;
+
+// Only the most significant bits of an item are used as keys, like the
+// AcoustID server does. Different encodings of the same recording
+// mostly differ in the least significant bits.
+constexpr int kKeyShift = 12;
+
+// The maximum shift between two fingerprints in items, e.g. caused by
+// the different encoder delays of lossy formats
+constexpr int kMaxAlignmentOffset = 3;
+
+// A hash function that permutes the keys for the MinHash
+inline uint32_t permuteKey(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x7feb352du;
+    key ^= key >> 15;
+    key *= 0x846ca68bu;
+    key ^= key >> 16;
+    return key;
+}
+
+} // anonymous namespace
+
+QVector<uint32_t> AudioFingerprint::sketch() const {
+    QVector<uint32_t> keys;
+    keys.reserve(m_items.size());
+    for (const auto item : m_items) {
+        if (item != kSilenceItem) {
+            keys.append(permuteKey(item >> kKeyShift));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (keys.size() > kSketchSize) {
+        keys.resize(kSketchSize);
+    }
+    return keys;
+}
+
+double AudioFingerprint::similarity(const AudioFingerprint& other) const {
+    const int minOverlap = std::min(m_items.size(), other.m_items.size()) / 2;
+    if (minOverlap == 0) {
+        return 0.0;
+    }
+    double bestSimilarity = 0.0;
+    for (int offset = -kMaxAlignmentOffset; offset <= kMaxAlignmentOffset; ++offset) {
+        const int begin = std::max(0, -offset);
+        const int end = std::min(m_items.size(), other.m_items.size() - offset);
+        if (end - begin < minOverlap) {
+            continue;
+        }
+        int bitErrors = 0;
+        for (int i = begin; i < end; ++i) {
+            bitErrors += static_cast<int>(
+                    std::bitset<32>(m_items[i] ^ other.m_items[i + offset]).count());
+        }
+        const double similarity = 1.0 - bitErrors / (32.0 * (end - begin));
+        bestSimilarity = std::max(bestSimilarity, similarity);
+    }
+    return bestSimilarity;
+}
+
+// static
+QByteArray AudioFingerprint::serialize(const QVector<uint32_t>& values) {
+    QByteArray data(values.size() * static_cast<int>(sizeof(uint32_t)), Qt::Uninitialized);
+    uchar* pData = reinterpret_cast<uchar*>(data.data());
+    for (const auto value : values) {
+        qToLittleEndian(value, pData);
+        pData += sizeof(uint32_t);
+    }
+    return data;
+}
+
+// static
+QVector<uint32_t> AudioFingerprint::deserialize(const QByteArray& data) {
+    QVector<uint32_t> values(data.size() / static_cast<int>(sizeof(uint32_t)));
+    const uchar* pData = reinterpret_cast<const uchar*>(data.constData());
+    for (auto& value : values) {
+        value = qFromLittleEndian<uint32_t>(pData);
+        pData += sizeof(uint32_t);
+    }
+    return values;
+}
+
+} // namespace mixxx
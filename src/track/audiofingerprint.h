@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include <cstdint>
+
+namespace mixxx {
+
+/// A raw Chromaprint fingerprint of the beginning of a track that is used
+/// for detecting duplicates in the library, e.g. the same recording in
+/// different encodings. Each item describes the spectral features of
+/// about 1/8 s of audio.
+class AudioFingerprint final {
+  public:
+    /// The number of seconds at the beginning of a track that are
+    /// fingerprinted
+    static constexpr int kDurationSeconds = 20;
+
+    /// The number of keys of a sketch
+    static constexpr int kSketchSize = 16;
+
+    AudioFingerprint() = default;
+    explicit AudioFingerprint(QVector<uint32_t> items)
+            : m_items(std::move(items)) {
+    }
+
+    bool isEmpty() const {
+        return m_items.isEmpty();
+    }
+    const QVector<uint32_t>& items() const {
+        return m_items;
+    }
+
+    /// Returns up to kSketchSize keys for looking up similar fingerprints
+    /// in an index. The keys are a MinHash of the coarse items, so similar
+    /// fingerprints share some of their keys even if they are slightly
+    /// shifted against each other, or if bit errors have changed the keys
+    /// of many items.
+    QVector<uint32_t> sketch() const;
+
+    /// Returns the fraction of matching bits for the best alignment of
+    /// both fingerprints, about 0.5 for unrelated and 1 for identical audio.
+    double similarity(const AudioFingerprint& other) const;
+
+    /// Little-endian serialization of fingerprints and sketches
+    static QByteArray serialize(const QVector<uint32_t>& values);
+    static QVector<uint32_t> deserialize(const QByteArray& data);
+
+  private:
+    QVector<uint32_t> m_items;
+};
+
+} // namespace mixxx
@@ -0,0 +1,121 @@
+#include "util/collationsortkey.h"
+
+#ifdef __SORTKEYS__
+#include <unicode/ucol.h>
+#include <unicode/uversion.h>
+#endif // __SORTKEYS__
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+#ifdef __SORTKEYS__
+const mixxx::Logger kLogger("CollationSortKeyGenerator");
+
+// Large enough for the sort keys of most titles and artists
+constexpr int kInitialSortKeyCapacity = 128;
+#endif // __SORTKEYS__
+
+} // anonymous namespace
+
+namespace mixxx {
+
+CollationSortKeyGenerator::CollationSortKeyGenerator(const QLocale& locale)
+        : m_pCollator(nullptr) {
+#ifdef __SORTKEYS__
+    UErrorCode status = U_ZERO_ERROR;
+    m_pCollator = ucol_open(locale.name().toLatin1().constData(), &status);
+    if (U_FAILURE(status)) {
+        kLogger.warning()
+                << "Failed to open collator for locale"
+                << locale.name()
+                << u_errorName(status);
+        if (m_pCollator) {
+            ucol_close(m_pCollator);
+            m_pCollator = nullptr;
+        }
+        return;
+    }
+    // Case-insensitive comparison like StringCollator
+    ucol_setStrength(m_pCollator, UCOL_SECONDARY);
+
+    UVersionInfo versionInfo;
+    ucol_getVersion(m_pCollator, versionInfo);
+    char versionString[U_MAX_VERSION_STRING_LENGTH];
+    u_versionToString(versionInfo, versionString);
+    m_version = locale.name() +
+            QChar('/') +
+            QString::fromLatin1(versionString);
+#else
+    Q_UNUSED(locale);
+#endif // __SORTKEYS__
+}
+
+CollationSortKeyGenerator::~CollationSortKeyGenerator() {
+#ifdef __SORTKEYS__
+    if (m_pCollator) {
+        ucol_close(m_pCollator);
+    }
+#endif // __SORTKEYS__
+}
+
+//static
+bool CollationSortKeyGenerator::isSupported() {
+#ifdef __SORTKEYS__
+    return true;
+#else
+    return false;
+#endif // __SORTKEYS__
+}
+
+QByteArray CollationSortKeyGenerator::sortKey(const QString& string) const {
+    if (!m_pCollator || string.isNull()) {
+        return QByteArray();
+    }
+#ifdef __SORTKEYS__
+    const auto* pSource = reinterpret_cast<const UChar*>(string.utf16());
+    QByteArray sortKey(kInitialSortKeyCapacity, Qt::Uninitialized);
+    int32_t length = ucol_getSortKey(m_pCollator,
+            pSource,
+            string.size(),
+            reinterpret_cast<uint8_t*>(sortKey.data()),
+            sortKey.size());
+    if (length > sortKey.size()) {
+        sortKey.resize(length);
+        length = ucol_getSortKey(m_pCollator,
+                pSource,
+                string.size(),
+                reinterpret_cast<uint8_t*>(sortKey.data()),
+                sortKey.size());
+    }
+    VERIFY_OR_DEBUG_ASSERT(length > 0) {
+        return QByteArray();
+    }
+    // Strip the terminating null byte
+    sortKey.resize(length - 1);
+    return sortKey;
+#else
+    return QByteArray();
+#endif // __SORTKEYS__
+}
+
+int CollationSortKeyGenerator::compare(const QString& lhs, const QString& rhs) const {
+    if (lhs.isNull() || rhs.isNull()) {
+        return static_cast<int>(!lhs.isNull()) - static_cast<int>(!rhs.isNull());
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_pCollator) {
+        return QString::compare(lhs, rhs, Qt::CaseInsensitive);
+    }
+#ifdef __SORTKEYS__
+    return static_cast<int>(ucol_strcoll(m_pCollator,
+            reinterpret_cast<const UChar*>(lhs.utf16()),
+            lhs.size(),
+            reinterpret_cast<const UChar*>(rhs.utf16()),
+            rhs.size()));
+#else
+    return 0;
+#endif // __SORTKEYS__
+}
+
+} // namespace mixxx
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QByteArray>
+#include <QLocale>
+#include <QString>
+
+#include "util/class.h"
+
+struct UCollator;
+
+namespace mixxx {
+
+/// Generates binary sort keys for strings. Comparing two sort keys
+/// byte-wise (memcmp) yields the same order as the locale-aware,
+/// case-insensitive comparison of the corresponding strings.
+///
+/// Sort keys depend on the locale and on the version of the collation
+/// rules. Stored sort keys must be regenerated whenever version()
+/// changes.
+class CollationSortKeyGenerator final {
+  public:
+    explicit CollationSortKeyGenerator(const QLocale& locale = QLocale());
+    ~CollationSortKeyGenerator();
+
+    /// Sort keys are only available if Mixxx has been built with ICU.
+    static bool isSupported();
+
+    bool isValid() const {
+        return m_pCollator != nullptr;
+    }
+
+    /// Identifies the locale and the version of the collation rules.
+    /// Empty if invalid.
+    const QString& version() const {
+        return m_version;
+    }
+
+    /// Returns a null byte array if invalid or if the string is null.
+    QByteArray sortKey(const QString& string) const;
+
+    /// Compares two strings in the same order as their sort keys without
+    /// generating them. Null strings are ordered first like NULL values
+    /// in SQLite. Must only be called if valid.
+    int compare(const QString& lhs, const QString& rhs) const;
+
+  private:
+    UCollator* m_pCollator;
+    QString m_version;
+
+    DISALLOW_COPY_AND_ASSIGN(CollationSortKeyGenerator);
+};
+
+} // namespace mixxx
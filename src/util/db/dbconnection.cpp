@@ -1,5 +1,11 @@
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <algorithm>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -8,9 +14,13 @@
 #include "util/db/dbconnection.h"
 
 #include "util/db/sqllikewildcards.h"
+#include "util/db/sqlqueryfinisher.h"
 #include "util/memory.h"
 #include "util/logger.h"
 #include "util/assert.h"
+#include "util/counter.h"
+#include "util/performancetimer.h"
+#include "util/stat.h"
 
 
 // Originally from public domain code:
@@ -22,6 +32,16 @@ namespace {
 
 const mixxx::Logger kLogger("DbConnection");
 
+// Only a bounded number of constant statements is expected to be
+// cached per connection. Statements with a variable text, e.g. with
+// IN-lists, must not be cached.
+constexpr std::size_t kMaxCachedStatements = 64;
+
+// All open connections by name for looking up the statement cache
+// of a QSqlDatabase
+QMutex s_openConnectionsMutex;
+QHash<QString, DbConnection*> s_openConnections;
+
 QSqlDatabase createDatabase(
         const DbConnection::Params& params,
         const QString& connectionName) {
@@ -231,6 +251,112 @@ void sqliteLikeUtf8(sqlite3_context* context,
     return;
 }
 
+// Same as the default busy timeout of the Qt SQLite driver
+constexpr qint64 kLockWaitTimeoutMillis = 5000;
+
+// The delays between attempts to acquire a lock, same as
+// sqliteDefaultBusyCallback()
+constexpr int kLockWaitDelaysMillis[] = {1, 2, 5, 10, 15, 20, 25, 25, 25, 50, 50, 100};
+
+// Lock waits and statements that take longer are logged to find
+// out which DAO functions block the calling thread
+constexpr qint64 kSlowStatementThresholdMillis = 100;
+
+const QString kLockWaitStatTag = QStringLiteral("DbConnection lock wait");
+const QString kSlowStatementStatTag = QStringLiteral("DbConnection slow statement");
+
+// SQLite invokes both callbacks on the thread that executes the
+// statement and each connection is owned by a single thread
+thread_local PerformanceTimer tLockWaitTimer;
+thread_local bool tLockWaiting = false;
+
+// Process-wide, see DbConnection::statistics()
+QAtomicInt sLockWaitCount;
+QAtomicInt sLockTimeoutCount;
+QAtomicInt sSlowStatementCount;
+
+QString currentThreadName() {
+    return QThread::currentThread()->objectName();
+}
+
+Duration finishLockWait() {
+    DEBUG_ASSERT(tLockWaiting);
+    tLockWaiting = false;
+    const Duration lockWait = tLockWaitTimer.elapsed();
+    Stat::track(kLockWaitStatTag,
+            Stat::DURATION_MSEC,
+            Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+            lockWait.toDoubleMillis());
+    return lockWait;
+}
+
+// Replaces the busy timeout of the Qt SQLite driver for recording how
+// long a connection waits for the locks held by other connections
+int sqliteBusyHandler(void* pArg, int count) {
+    Q_UNUSED(pArg);
+    if (!tLockWaiting) {
+        tLockWaiting = true;
+        tLockWaitTimer.start();
+        Counter("DbConnection lock waits")++;
+        sLockWaitCount.fetchAndAddRelaxed(1);
+    }
+    const qint64 waitedMillis = tLockWaitTimer.elapsed().toIntegerMillis();
+    if (waitedMillis >= kLockWaitTimeoutMillis) {
+        const Duration lockWait = finishLockWait();
+        Counter("DbConnection lock timeouts")++;
+        sLockTimeoutCount.fetchAndAddRelaxed(1);
+        kLogger.warning()
+                << "Giving up waiting for a database lock after"
+                << lockWait.debugMillisWithUnit()
+                << "on thread"
+                << currentThreadName();
+        return 0; // SQLITE_BUSY
+    }
+    constexpr int kDelayCount =
+            sizeof(kLockWaitDelaysMillis) / sizeof(kLockWaitDelaysMillis[0]);
+    const int delayMillis = static_cast<int>(qMin(
+            static_cast<qint64>(kLockWaitDelaysMillis[qMin(count, kDelayCount - 1)]),
+            kLockWaitTimeoutMillis - waitedMillis));
+    sqlite3_sleep(delayMillis);
+    return 1; // retry
+}
+
+// Invoked with SQLITE_TRACE_PROFILE after a statement has finished
+int sqliteTraceProfile(unsigned int type, void* pArg, void* pStatement, void* pNanos) {
+    Q_UNUSED(pArg);
+    VERIFY_OR_DEBUG_ASSERT(type == SQLITE_TRACE_PROFILE) {
+        return 0;
+    }
+    if (tLockWaiting) {
+        const Duration lockWait = finishLockWait();
+        if (lockWait.toIntegerMillis() >= kSlowStatementThresholdMillis) {
+            kLogger.info()
+                    << "Waited"
+                    << lockWait.debugMillisWithUnit()
+                    << "for a database lock on thread"
+                    << currentThreadName()
+                    << ':'
+                    << sqlite3_sql(static_cast<sqlite3_stmt*>(pStatement));
+        }
+    }
+    const auto duration = Duration::fromNanos(*static_cast<sqlite3_int64*>(pNanos));
+    if (duration.toIntegerMillis() >= kSlowStatementThresholdMillis) {
+        Stat::track(kSlowStatementStatTag,
+                Stat::DURATION_MSEC,
+                Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+                duration.toDoubleMillis());
+        sSlowStatementCount.fetchAndAddRelaxed(1);
+        kLogger.info()
+                << "Executing statement took"
+                << duration.debugMillisWithUnit()
+                << "on thread"
+                << currentThreadName()
+                << ':'
+                << sqlite3_sql(static_cast<sqlite3_stmt*>(pStatement));
+    }
+    return 0;
+}
+
 #endif // __SQLITE3__
 
 bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator) {
@@ -305,6 +431,20 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
                 << "Failed to install custom 3-arg LIKE function for SQLite3:"
                 << result;
     }
+
+    result = sqlite3_busy_handler(handle, sqliteBusyHandler, nullptr);
+    VERIFY_OR_DEBUG_ASSERT(result == SQLITE_OK) {
+        kLogger.warning()
+                << "Failed to install busy handler for SQLite3:"
+                << result;
+    }
+
+    result = sqlite3_trace_v2(handle, SQLITE_TRACE_PROFILE, sqliteTraceProfile, nullptr);
+    VERIFY_OR_DEBUG_ASSERT(result == SQLITE_OK) {
+        kLogger.warning()
+                << "Failed to install profiling callback for SQLite3:"
+                << result;
+    }
 #else
     Q_UNUSED(database);
     Q_UNUSED(pCollator);
@@ -317,13 +457,15 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_pragmas(params.pragmas) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_pragmas(prototype.m_pragmas) {
 }
 
 DbConnection::~DbConnection() {
@@ -351,9 +493,35 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    applyPragmas();
+    const QMutexLocker locker(&s_openConnectionsMutex);
+    s_openConnections.insert(name(), this);
     return true;
 }
 
+void DbConnection::applyPragmas() {
+    for (const auto& pragma : qAsConst(m_pragmas)) {
+        QSqlQuery query(m_sqlDatabase);
+        // Failures only affect the performance but not the
+        // integrity of the database
+        if (!query.exec(pragma)) {
+            kLogger.warning()
+                    << "Failed to execute"
+                    << pragma
+                    << "for database connection"
+                    << *this
+                    << query.lastError();
+            continue;
+        }
+        if (kLogger.debugEnabled() && query.next()) {
+            kLogger.debug()
+                    << pragma
+                    << "returned"
+                    << query.value(0);
+        }
+    }
+}
+
 void DbConnection::close() {
     if (m_sqlDatabase.isOpen()) {
         // There should never be an outstanding transaction when this code is
@@ -369,10 +537,89 @@ void DbConnection::close() {
                     << "Closing database connection:"
                     << *this;
         }
+        {
+            const QMutexLocker locker(&s_openConnectionsMutex);
+            s_openConnections.remove(name());
+        }
+        // All cached statements must be released before closing
+        DEBUG_ASSERT(std::none_of(m_cachedStatements.begin(),
+                m_cachedStatements.end(),
+                [](const auto& entry) { return entry.second.inUse; }));
+        m_cachedStatements.clear();
         m_sqlDatabase.close();
     }
 }
 
+//static
+DbConnection::CachedQuery DbConnection::cachedQuery(
+        const QSqlDatabase& database,
+        const QString& statement) {
+    DbConnection* pConnection;
+    {
+        const QMutexLocker locker(&s_openConnectionsMutex);
+        pConnection = s_openConnections.value(database.connectionName());
+    }
+    if (pConnection) {
+        auto& cachedStatements = pConnection->m_cachedStatements;
+        auto it = cachedStatements.find(statement);
+        if (it == cachedStatements.end() &&
+                cachedStatements.size() < kMaxCachedStatements) {
+            auto pQuery = std::make_unique<FwdSqlQuery>(database, statement);
+            if (!pQuery->isPrepared()) {
+                return CachedQuery(std::move(pQuery));
+            }
+            it = cachedStatements.emplace(statement,
+                                         CachedStatement{std::move(pQuery)})
+                         .first;
+        }
+        if (it != cachedStatements.end() && !it->second.inUse) {
+            return CachedQuery(it->second.pQuery.get(), &it->second.inUse);
+        }
+    }
+    return CachedQuery(std::make_unique<FwdSqlQuery>(database, statement));
+}
+
+DbConnection::CachedQuery::CachedQuery(FwdSqlQuery* pQuery, bool* pInUse)
+        : m_pQuery(pQuery),
+          m_pInUse(pInUse) {
+    DEBUG_ASSERT(!*m_pInUse);
+    *m_pInUse = true;
+}
+
+DbConnection::CachedQuery::CachedQuery(std::unique_ptr<FwdSqlQuery> pQuery)
+        : m_pUncachedQuery(std::move(pQuery)),
+          m_pQuery(m_pUncachedQuery.get()),
+          m_pInUse(nullptr) {
+}
+
+DbConnection::CachedQuery::CachedQuery(CachedQuery&& other)
+        : m_pUncachedQuery(std::move(other.m_pUncachedQuery)),
+          m_pQuery(other.m_pQuery),
+          m_pInUse(other.m_pInUse) {
+    other.m_pQuery = nullptr;
+    other.m_pInUse = nullptr;
+}
+
+DbConnection::CachedQuery::~CachedQuery() {
+    if (m_pInUse) {
+        // Free the resources of the prepared statement until
+        // the next execution
+        SqlQueryFinisher(m_pQuery).tryFinish();
+        *m_pInUse = false;
+    }
+}
+
+//static
+DbConnection::Statistics DbConnection::statistics() {
+    Statistics statistics;
+#ifdef __SQLITE3__
+    statistics.lockWaits = sLockWaitCount.loadAcquire();
+    statistics.lockTimeouts = sLockTimeoutCount.loadAcquire();
+    statistics.slowStatements = sSlowStatementCount.loadAcquire();
+#endif // __SQLITE3__
+    return statistics;
+}
+
 //static
 QString DbConnection::collateLexicographically(const QString& orderByQuery) {
 #ifdef __SQLITE3__
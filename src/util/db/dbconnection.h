@@ -1,8 +1,12 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QtDebug>
+#include <map>
+#include <memory>
 
+#include "util/db/fwdsqlquery.h"
 #include "util/string.h"
 
 namespace mixxx {
@@ -22,6 +26,56 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    /// A prepared statement that has been borrowed from the statement
+    /// cache of a connection. The query is finished and returned to the
+    /// cache when going out of scope. It must not outlive the scope in
+    /// which it has been borrowed.
+    class CachedQuery final {
+      public:
+        CachedQuery(CachedQuery&& other);
+        ~CachedQuery();
+
+        FwdSqlQuery* operator->() const {
+            return m_pQuery;
+        }
+        FwdSqlQuery& operator*() const {
+            return *m_pQuery;
+        }
+
+      private:
+        friend class DbConnection;
+        CachedQuery(FwdSqlQuery* pQuery, bool* pInUse);
+        explicit CachedQuery(std::unique_ptr<FwdSqlQuery> pQuery);
+
+        CachedQuery(const CachedQuery&) = delete;
+        CachedQuery& operator=(const CachedQuery&) = delete;
+        CachedQuery& operator=(CachedQuery&&) = delete;
+
+        std::unique_ptr<FwdSqlQuery> m_pUncachedQuery;
+        FwdSqlQuery* m_pQuery;
+        bool* m_pInUse;
+    };
+
+    /// Borrows a prepared query for a constant statement from the cache
+    /// of the connection. The statement is only prepared once per
+    /// connection, which for simple queries takes longer than executing
+    /// them. Falls back to a freshly prepared query if the database is
+    /// not managed by a DbConnection or if the cached query is in use.
+    ///
+    /// Must only be invoked from the thread that owns the connection.
+    static CachedQuery cachedQuery(
+            const QSqlDatabase& database,
+            const QString& statement);
+
+    /// Process-wide statistics about lock waits and slow statements
+    /// of all connections to SQLite databases since the start.
+    struct Statistics {
+        int lockWaits = 0;
+        int lockTimeouts = 0;
+        int slowStatements = 0;
+    };
+    static Statistics statistics();
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -29,6 +83,9 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        // Statements like "PRAGMA cache_size=-16384" that are executed
+        // for each connection after it has been opened
+        QStringList pragmas;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -61,8 +118,21 @@ class DbConnection final {
     DbConnection(const DbConnection&) = delete;
     DbConnection(const DbConnection&&) = delete;
 
+    struct CachedStatement {
+        std::unique_ptr<FwdSqlQuery> pQuery;
+        bool inUse = false;
+    };
+
+    void applyPragmas();
+
     QSqlDatabase m_sqlDatabase;
     mixxx::StringCollator m_collator;
+    QStringList m_pragmas;
+
+    // Only accessed from the thread that owns the connection.
+    // The nodes of std::map are stable while new statements are
+    // inserted, the QSqlQuery objects are not copyable.
+    std::map<QString, CachedStatement> m_cachedStatements;
 };
 
 } // namespace mixxx
@@ -8,13 +8,17 @@
 #include <QReadWriteLock>
 
 #include "util/compatibility/qmutex.h"
+#include "util/realtimeguard.h"
 #include "util/thread_annotations.h"
 
 class CAPABILITY("mutex") MMutex {
   public:
     MMutex() = default;
 
-    inline void lock() ACQUIRE() { m_mutex.lock(); }
+    inline void lock() ACQUIRE() {
+        mixxx::RealtimeGuard::checkViolation("MMutex::lock");
+        m_mutex.lock();
+    }
     inline void unlock() RELEASE() { m_mutex.unlock(); }
     inline bool tryLock() TRY_ACQUIRE(true) {
         return m_mutex.tryLock();
@@ -31,12 +35,18 @@ class CAPABILITY("mutex") MReadWriteLock {
             : m_lock(mode) {
     }
 
-    void lockForRead() ACQUIRE_SHARED() { m_lock.lockForRead(); }
+    void lockForRead() ACQUIRE_SHARED() {
+        mixxx::RealtimeGuard::checkViolation("MReadWriteLock::lockForRead");
+        m_lock.lockForRead();
+    }
     bool tryLockForRead() TRY_ACQUIRE_SHARED(true) {
         return m_lock.tryLockForRead();
     }
 
-    void lockForWrite() ACQUIRE() { m_lock.lockForWrite(); }
+    void lockForWrite() ACQUIRE() {
+        mixxx::RealtimeGuard::checkViolation("MReadWriteLock::lockForWrite");
+        m_lock.lockForWrite();
+    }
     bool tryLockForWrite() TRY_ACQUIRE(true) {
         return m_lock.tryLockForWrite();
     }
@@ -51,7 +61,10 @@ class CAPABILITY("mutex") MReadWriteLock {
 
 class SCOPED_CAPABILITY MMutexLocker {
   public:
-    MMutexLocker(MMutex* mu) ACQUIRE(mu) : m_locker(&mu->m_mutex) {}
+    MMutexLocker(MMutex* mu) ACQUIRE(mu)
+            : m_locker((mixxx::RealtimeGuard::checkViolation("MMutexLocker"),
+                      &mu->m_mutex)) {
+    }
     ~MMutexLocker() RELEASE() {}
 
     inline void unlock() RELEASE() { m_locker.unlock(); }
@@ -62,7 +75,10 @@ class SCOPED_CAPABILITY MMutexLocker {
 
 class SCOPED_CAPABILITY MWriteLocker {
   public:
-    MWriteLocker(MReadWriteLock* mu) ACQUIRE(mu) : m_locker(&mu->m_lock) {}
+    MWriteLocker(MReadWriteLock* mu) ACQUIRE(mu)
+            : m_locker((mixxx::RealtimeGuard::checkViolation("MWriteLocker"),
+                      &mu->m_lock)) {
+    }
     ~MWriteLocker() RELEASE() {}
 
     inline void unlock() RELEASE() { m_locker.unlock(); }
@@ -74,7 +90,9 @@ class SCOPED_CAPABILITY MWriteLocker {
 class SCOPED_CAPABILITY MReadLocker {
   public:
     MReadLocker(MReadWriteLock* mu) ACQUIRE_SHARED(mu)
-            : m_locker(&mu->m_lock) {}
+            : m_locker((mixxx::RealtimeGuard::checkViolation("MReadLocker"),
+                      &mu->m_lock)) {
+    }
     ~MReadLocker() RELEASE() {}
 
     inline void unlock() RELEASE() { m_locker.unlock(); }
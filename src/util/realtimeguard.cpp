@@ -0,0 +1,180 @@
+#include "util/realtimeguard.h"
+
+#ifdef MIXXX_REALTIME_GUARD
+
+#include <QtDebug>
+#include <atomic>
+#include <cstdlib>
+
+#ifdef __GLIBC__
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "util/compatibility/qmutex.h"
+#endif
+
+namespace {
+
+// Only trivially initialized thread locals must be used here, because they
+// are accessed from within malloc, possibly before any other initialization
+// of the thread has happened.
+thread_local int s_realtimeSectionDepth = 0;
+thread_local int s_suspendDepth = 0;
+
+std::atomic<int> s_violationCount(0);
+
+constexpr int kMaxStackTraceDepth = 32;
+
+} // anonymous namespace
+
+namespace mixxx {
+
+// static
+bool RealtimeGuard::isRealtimeThread() {
+    return s_realtimeSectionDepth > 0 && s_suspendDepth == 0;
+}
+
+// static
+void RealtimeGuard::checkViolation(const char* operation) {
+    if (!isRealtimeThread()) {
+        return;
+    }
+    s_violationCount.fetch_add(1);
+
+    // Reporting the violation allocates memory itself
+    ScopedRealtimeGuardSuspender suspender;
+    qWarning() << "RealtimeGuard:" << operation << "in realtime section";
+#ifdef __GLIBC__
+    void* stackTrace[kMaxStackTraceDepth];
+    const int depth = backtrace(stackTrace, kMaxStackTraceDepth);
+    backtrace_symbols_fd(stackTrace, depth, STDERR_FILENO);
+#endif
+}
+
+// static
+int RealtimeGuard::violationCount() {
+    return s_violationCount.load();
+}
+
+// static
+void RealtimeGuard::resetViolationCount() {
+    s_violationCount.store(0);
+}
+
+// static
+void RealtimeGuard::enterRealtimeSection() {
+    ++s_realtimeSectionDepth;
+}
+
+// static
+void RealtimeGuard::leaveRealtimeSection() {
+    --s_realtimeSectionDepth;
+}
+
+// static
+void RealtimeGuard::suspend() {
+    ++s_suspendDepth;
+}
+
+// static
+void RealtimeGuard::resume() {
+    --s_suspendDepth;
+}
+
+} // namespace mixxx
+
+#ifdef __GLIBC__
+
+// Replace the glibc allocator entry points, which are also used by the
+// default implementation of operator new and by Qt's containers.
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    mixxx::RealtimeGuard::checkViolation("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    mixxx::RealtimeGuard::checkViolation("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    mixxx::RealtimeGuard::checkViolation("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    mixxx::RealtimeGuard::checkViolation("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pPtr, size_t alignment, size_t size) {
+    mixxx::RealtimeGuard::checkViolation("posix_memalign");
+    // The alignment must be a power of two and a multiple of sizeof(void*)
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *pPtr = ptr;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    mixxx::RealtimeGuard::checkViolation("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        mixxx::RealtimeGuard::checkViolation("free");
+    }
+    __libc_free(ptr);
+}
+
+// Used by std::mutex and other mutexes based on pthreads
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    mixxx::RealtimeGuard::checkViolation("pthread_mutex_lock");
+    using LockFunction = int (*)(pthread_mutex_t*);
+    static const auto originalLock = [] {
+        // dlsym() may allocate memory
+        mixxx::ScopedRealtimeGuardSuspender suspender;
+        return reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    }();
+    return originalLock(mutex);
+}
+
+} // extern "C"
+
+// QMutex is implemented with futexes on Linux. Locking it only calls into
+// QtCore if the mutex is contended, i.e. when the calling thread is about to
+// block. Replacing that function detects blocking on any QMutex, including
+// the ones that are not wrapped in MMutex. Uncontended locks are detected
+// only for QMutexes that are locked with lockMutex().
+void QBasicMutex::lockInternal() QT_MUTEX_LOCK_NOEXCEPT {
+    mixxx::RealtimeGuard::checkViolation("QMutex::lock (contended)");
+    using LockInternalFunction = void (*)(QBasicMutex*);
+    static const auto originalLockInternal = [] {
+        // dlsym() may allocate memory
+        mixxx::ScopedRealtimeGuardSuspender suspender;
+        return reinterpret_cast<LockInternalFunction>(
+                dlsym(RTLD_NEXT, "_ZN11QBasicMutex12lockInternalEv"));
+    }();
+    originalLockInternal(this);
+}
+
+#endif // __GLIBC__
+
+#endif // MIXXX_REALTIME_GUARD
@@ -0,0 +1,92 @@
+#pragma once
+
+/// RealtimeGuard detects operations that may block the audio callback thread
+/// for an unbounded time, i.e. heap allocations and blocking on mutexes.
+/// These cause rare xruns that are hard to reproduce otherwise.
+///
+/// Code that must be realtime safe is marked with a ScopedRealtimeSection.
+/// The detection is only compiled in when building with the REALTIME_GUARD
+/// CMake option, which is meant for debug builds and the test suite. Otherwise
+/// all functions are no-ops that are optimized out.
+///
+/// When enabled, every violation inside a realtime section is counted and
+/// logged with a stack trace. Memory allocations are intercepted by replacing
+/// malloc and friends, which is only supported with glibc. Locks are checked
+/// in the MMutex and MReadWriteLock wrappers from util/mutex.h and in
+/// lockMutex() from util/compatibility/qmutex.h. With glibc, blocking on any
+/// other QMutex and on pthread mutexes, e.g. std::mutex, is detected as well.
+namespace mixxx {
+
+class RealtimeGuard {
+  public:
+    static constexpr bool isEnabled() {
+#ifdef MIXXX_REALTIME_GUARD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef MIXXX_REALTIME_GUARD
+    /// Returns true if the calling thread is inside a realtime section and
+    /// violations are not suspended.
+    static bool isRealtimeThread();
+
+    /// Counts and logs a violation if called from a realtime section.
+    static void checkViolation(const char* operation);
+
+    /// The number of violations since the last reset, from all threads
+    static int violationCount();
+    static void resetViolationCount();
+
+    static void enterRealtimeSection();
+    static void leaveRealtimeSection();
+    static void suspend();
+    static void resume();
+#else
+    static constexpr bool isRealtimeThread() {
+        return false;
+    }
+    static void checkViolation(const char*) {
+    }
+    static constexpr int violationCount() {
+        return 0;
+    }
+    static void resetViolationCount() {
+    }
+    static void enterRealtimeSection() {
+    }
+    static void leaveRealtimeSection() {
+    }
+    static void suspend() {
+    }
+    static void resume() {
+    }
+#endif
+};
+
+/// Marks the enclosing scope as realtime critical, e.g. the processing of
+/// one audio buffer. Sections may be nested.
+class ScopedRealtimeSection {
+  public:
+    ScopedRealtimeSection() {
+        RealtimeGuard::enterRealtimeSection();
+    }
+    ~ScopedRealtimeSection() {
+        RealtimeGuard::leaveRealtimeSection();
+    }
+};
+
+/// Temporarily allows violations inside a realtime section, for known and
+/// accepted exceptions that are not fixed yet.
+class ScopedRealtimeGuardSuspender {
+  public:
+    ScopedRealtimeGuardSuspender() {
+        RealtimeGuard::suspend();
+    }
+    ~ScopedRealtimeGuardSuspender() {
+        RealtimeGuard::resume();
+    }
+};
+
+} // namespace mixxx
@@ -426,6 +426,18 @@ SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
     return clipping;
 }
 
+// static
+bool SampleUtil::isSilent(const CSAMPLE* pBuffer, SINT numSamples) {
+    // Summing up the absolute values instead of returning early
+    // allows vectorizing the loop.
+    CSAMPLE fAbs = CSAMPLE_ZERO;
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        fAbs += fabs(pBuffer[i]);
+    }
+    return fAbs == CSAMPLE_ZERO;
+}
+
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
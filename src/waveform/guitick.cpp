@@ -1,6 +1,7 @@
 #include <QTimer>
 
 #include "waveform/guitick.h"
+#include "control/controlchangebus.h"
 #include "control/controlobject.h"
 
 GuiTick::GuiTick() {
@@ -20,4 +21,10 @@ void GuiTick::process() {
         m_lastUpdateTime = m_cpuTimeLastTick;
         m_pCOGuiTick50ms->set(cpuTimeLastTickSeconds);
     }
+
+    // Deliver the coalesced control changes once per tick
+    ControlChangeBus* pChangeBus = ControlChangeBus::existingInstance();
+    if (pChangeBus) {
+        pChangeBus->process();
+    }
 }
@@ -2,13 +2,15 @@
 
 #include <QtDebug>
 
+#include "control/controlproxy.h"
 #include "effects/effectsmanager.h"
 #include "moc_weffectname.cpp"
 #include "widget/effectwidgetutils.h"
 
 WEffectName::WEffectName(QWidget* pParent, EffectsManager* pEffectsManager)
         : WLabel(pParent),
-          m_pEffectsManager(pEffectsManager) {
+          m_pEffectsManager(pEffectsManager),
+          m_pCpuLoad(nullptr) {
     effectUpdated();
 }
 
@@ -31,22 +33,36 @@ void WEffectName::setEffectSlot(EffectSlotPointer pEffectSlot) {
     if (pEffectSlot) {
         m_pEffectSlot = pEffectSlot;
         connect(pEffectSlot.data(), &EffectSlot::effectChanged, this, &WEffectName::effectUpdated);
+        m_pCpuLoad = new ControlProxy(pEffectSlot->getGroup(),
+                "cpu_load",
+                this,
+                ControlFlag::NoAssertIfMissing);
+        m_pCpuLoad->connectValueChanged(this, &WEffectName::updateTooltip);
         effectUpdated();
     }
 }
 
 void WEffectName::effectUpdated() {
     QString name;
-    QString description;
     if (m_pEffectSlot && m_pEffectSlot->isLoaded()) {
         EffectManifestPointer pManifest = m_pEffectSlot->getManifest();
         name = pManifest->displayName();
         //: %1 = effect name; %2 = effect description
-        description = tr("%1: %2").arg(pManifest->name(), pManifest->description());
+        m_description = tr("%1: %2").arg(pManifest->name(), pManifest->description());
     } else {
         name = kNoEffectString;
-        description = tr("No effect loaded.");
+        m_description = tr("No effect loaded.");
     }
     setText(name);
-    setBaseTooltip(description);
+    updateTooltip();
+}
+
+void WEffectName::updateTooltip() {
+    QString tooltip = m_description;
+    if (m_pCpuLoad && m_pEffectSlot && m_pEffectSlot->isLoaded()) {
+        //: %1 = share of the audio buffer duration spent processing the effect
+        tooltip += QChar('\n') +
+                tr("CPU load: %1 %").arg(m_pCpuLoad->get() * 100, 0, 'f', 1);
+    }
+    setBaseTooltip(tooltip);
 }
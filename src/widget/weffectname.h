@@ -6,6 +6,7 @@
 #include "skin/legacy/skincontext.h"
 #include "widget/wlabel.h"
 
+class ControlProxy;
 class EffectsManager;
 
 class WEffectName : public WLabel {
@@ -17,10 +18,14 @@ class WEffectName : public WLabel {
 
   private slots:
     void effectUpdated();
+    void updateTooltip();
 
   private:
     void setEffectSlot(EffectSlotPointer pEffectSlot);
 
     EffectsManager* m_pEffectsManager;
     EffectSlotPointer m_pEffectSlot;
+    // The "cpu_load" control of the effect slot, shown in the tooltip
+    ControlProxy* m_pCpuLoad;
+    QString m_description;
 };
@@ -7,6 +7,7 @@
 #include <QModelIndex>
 #include <QVBoxLayout>
 
+#include "analyzer/analyzerfingerprint.h"
 #include "control/controlobject.h"
 #include "control/controlproxy.h"
 #include "library/coverartutils.h"
@@ -184,6 +185,17 @@ void WTrackMenu::createMenus() {
         m_pRemoveFromDiskMenu = new QMenu(this);
         m_pRemoveFromDiskMenu->setTitle(tr("Delete Track Files"));
     }
+
+    if (featureIsEnabled(Feature::FindDuplicates) && m_pLibrary &&
+            AnalyzerFingerprint::isEnabled(m_pConfig)) {
+        m_pDuplicatesMenu = new QMenu(this);
+        //: Submenu with the tracks that contain the same recording
+        m_pDuplicatesMenu->setTitle(tr("Duplicates"));
+        connect(m_pDuplicatesMenu,
+                &QMenu::aboutToShow,
+                this,
+                &WTrackMenu::slotPopulateDuplicatesMenu);
+    }
 }
 
 void WTrackMenu::createActions() {
@@ -426,8 +438,13 @@ void WTrackMenu::setupActions() {
         addAction(m_pSelectInLibraryAct);
     }
 
+    if (m_pDuplicatesMenu) {
+        addMenu(m_pDuplicatesMenu);
+    }
+
     if (featureIsEnabled(Feature::SearchRelated) ||
-            featureIsEnabled(Feature::SelectInLibrary)) {
+            featureIsEnabled(Feature::SelectInLibrary) ||
+            m_pDuplicatesMenu) {
         addSeparator();
     }
 
@@ -997,6 +1014,37 @@ void WTrackMenu::slotSelectInLibrary() {
     }
 }
 
+void WTrackMenu::slotPopulateDuplicatesMenu() {
+    m_pDuplicatesMenu->clear();
+    const auto pTrack = getFirstTrackPointer();
+    if (!pTrack || !pTrack->getId().isValid()) {
+        return;
+    }
+    TrackCollectionManager* pTrackCollectionManager = m_pLibrary->trackCollectionManager();
+    const QList<TrackId> duplicateIds = pTrackCollectionManager->internalCollection()
+                                                ->getFingerprintDAO()
+                                                .findDuplicates(pTrack->getId());
+    for (const auto& duplicateId : duplicateIds) {
+        const TrackPointer pDuplicate = pTrackCollectionManager->getTrackById(duplicateId);
+        if (!pDuplicate) {
+            continue;
+        }
+        QAction* pAction = m_pDuplicatesMenu->addAction(
+                mixxx::escapeTextPropertyWithoutShortcuts(pDuplicate->getInfo()));
+        pAction->setToolTip(pDuplicate->getLocation());
+        connect(pAction,
+                &QAction::triggered,
+                this,
+                [this, duplicateId] {
+                    emit m_pLibrary->selectTrack(duplicateId);
+                });
+    }
+    if (m_pDuplicatesMenu->isEmpty()) {
+        QAction* pAction = m_pDuplicatesMenu->addAction(tr("No duplicates found"));
+        pAction->setEnabled(false);
+    }
+}
+
 namespace {
 
 class ImportMetadataFromFileTagsTrackPointerOperation : public mixxx::TrackPointerOperation {
@@ -2163,6 +2211,8 @@ bool WTrackMenu::featureIsEnabled(Feature flag) const {
         return m_pLibrary != nullptr;
     case Feature::SelectInLibrary:
         return m_pTrack != nullptr;
+    case Feature::FindDuplicates:
+        return m_pLibrary != nullptr;
     default:
         DEBUG_ASSERT(!"unreachable");
         return false;
@@ -51,10 +51,13 @@ class WTrackMenu : public QMenu {
         SearchRelated = 1 << 13,
         UpdateReplayGainFromPregain = 1 << 14,
         SelectInLibrary = 1 << 15,
+        // Only available if the fingerprint analyzer is enabled
+        FindDuplicates = 1 << 16,
         TrackModelFeatures = Remove | HideUnhidePurge,
         All = AutoDJ | LoadTo | Playlist | Crate | Remove | Metadata | Reset |
                 BPM | Color | HideUnhidePurge | RemoveFromDisk | FileBrowser |
-                Properties | SearchRelated | UpdateReplayGainFromPregain | SelectInLibrary
+                Properties | SearchRelated | UpdateReplayGainFromPregain | SelectInLibrary |
+                FindDuplicates
     };
     Q_DECLARE_FLAGS(Features, Feature)
 
@@ -90,6 +93,7 @@ class WTrackMenu : public QMenu {
     // File
     void slotOpenInFileBrowser();
     void slotSelectInLibrary();
+    void slotPopulateDuplicatesMenu();
 
     // Row color
     void slotColorPicked(const mixxx::RgbColor::optional_t& color);
@@ -220,6 +224,7 @@ class WTrackMenu : public QMenu {
     QMenu* m_pColorMenu{};
     WCoverArtMenu* m_pCoverMenu{};
     parented_ptr<WSearchRelatedTracksMenu> m_pSearchRelatedMenu;
+    QMenu* m_pDuplicatesMenu{};
     QMenu* m_pRemoveFromDiskMenu{};
 
     // Update ReplayGain from Track
@@ -7,6 +7,7 @@
 #include <QUrl>
 
 #include "control/controlobject.h"
+#include "library/basesqltablemodel.h"
 #include "library/dao/trackschema.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -99,6 +100,29 @@ void WTrackTableView::enableCachedOnly() {
 
 void WTrackTableView::slotScrollValueChanged(int /*unused*/) {
     enableCachedOnly();
+    slotPrefetchVisibleRows();
+}
+
+void WTrackTableView::slotPrefetchVisibleRows() {
+    TrackModel* trackModel = getTrackModel();
+    if (!trackModel) {
+        return;
+    }
+    const int firstRow = rowAt(0);
+    if (firstRow < 0) {
+        return;
+    }
+    int lastRow = rowAt(viewport()->height() - 1);
+    if (lastRow < 0) {
+        // The rows do not fill the viewport
+        lastRow = model()->rowCount() - 1;
+    }
+    QModelIndexList indices;
+    indices.reserve(lastRow - firstRow + 1);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        indices.append(model()->index(row, 0));
+    }
+    trackModel->prefetchRows(indices);
 }
 
 void WTrackTableView::selectionChanged(
@@ -164,11 +188,16 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
                 horizontalHeader()->sortIndicatorOrder());
 
         if (restoreState) {
-            restoreCurrentViewState();
+            invokeAfterSelect([this] {
+                restoreCurrentViewState();
+            });
         }
         return;
     }
 
+    // A state that is pending for the previous model must not be restored
+    disconnect(m_afterSelectConnection);
+
     setVisible(false);
 
     // Save the previous track model's header state
@@ -211,6 +240,25 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
 
     setModel(model);
     setHorizontalHeader(header);
+    // The rows are prefetched after the view has processed the changes.
+    // The connections are unique, because a model is loaded repeatedly.
+    const auto prefetchConnectionType =
+            static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::UniqueConnection);
+    connect(model,
+            &QAbstractItemModel::modelReset,
+            this,
+            &WTrackTableView::slotPrefetchVisibleRows,
+            prefetchConnectionType);
+    connect(model,
+            &QAbstractItemModel::layoutChanged,
+            this,
+            &WTrackTableView::slotPrefetchVisibleRows,
+            prefetchConnectionType);
+    connect(model,
+            &QAbstractItemModel::rowsInserted,
+            this,
+            &WTrackTableView::slotPrefetchVisibleRows,
+            prefetchConnectionType);
     header->setSectionsMovable(true);
     header->setSectionsClickable(true);
     // Setting this to true would render all column labels BOLD as soon as the
@@ -319,7 +367,9 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
 
     // trigger restoring scrollBar position, selection etc.
     if (restoreState) {
-        restoreCurrentViewState();
+        invokeAfterSelect([this] {
+            restoreCurrentViewState();
+        });
     }
     initTrackMenu();
 }
@@ -510,24 +560,46 @@ void WTrackTableView::onSearch(const QString& text) {
             prevColumn = currentIndex().column();
         }
         trackModel->search(text);
-        if (queryIsLessSpecific) {
-            // If the user removed query terms, we try to select the same
-            // tracks as before
-            setCurrentTrackId(prevTrack, prevColumn);
-            setSelectedTracks(selectedTracks);
-        } else {
-            // The user created a more specific search query, try to restore a
-            // previous state
-            if (!restoreCurrentViewState()) {
-                // We found no saved state for this query, try to select the
-                // tracks last active, if they are part of the result set
+        invokeAfterSelect([this,
+                                  queryIsLessSpecific,
+                                  selectedTracks,
+                                  prevTrack,
+                                  prevColumn] {
+            if (queryIsLessSpecific) {
+                // If the user removed query terms, we try to select the same
+                // tracks as before
                 setCurrentTrackId(prevTrack, prevColumn);
                 setSelectedTracks(selectedTracks);
+            } else {
+                // The user created a more specific search query, try to restore a
+                // previous state
+                if (!restoreCurrentViewState()) {
+                    // We found no saved state for this query, try to select the
+                    // tracks last active, if they are part of the result set
+                    setCurrentTrackId(prevTrack, prevColumn);
+                    setSelectedTracks(selectedTracks);
+                }
             }
-        }
+        });
     }
 }
 
+void WTrackTableView::invokeAfterSelect(std::function<void()> function) {
+    disconnect(m_afterSelectConnection);
+    auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model());
+    if (!pSqlTableModel || !pSqlTableModel->isSelectPending()) {
+        function();
+        return;
+    }
+    m_afterSelectConnection = connect(pSqlTableModel,
+            &BaseSqlTableModel::selectFinished,
+            this,
+            [this, function = std::move(function)] {
+                disconnect(m_afterSelectConnection);
+                function();
+            });
+}
+
 void WTrackTableView::onShow() {
 }
 
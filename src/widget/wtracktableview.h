@@ -2,6 +2,7 @@
 
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
+#include <functional>
 
 #include "control/controlproxy.h"
 #include "library/dao/playlistdao.h"
@@ -84,6 +85,8 @@ class WTrackTableView : public WLibraryTableView {
     // Signalled 20 times per second (every 50ms) by GuiTick.
     void slotGuiTick50ms(double);
     void slotScrollValueChanged(int);
+    // Passes the visible rows to TrackModel::prefetchRows()
+    void slotPrefetchVisibleRows();
 
     void slotSortingChanged(int headerSection, Qt::SortOrder order);
     void keyNotationChanged();
@@ -112,6 +115,10 @@ class WTrackTableView : public WLibraryTableView {
 
     void hideOrRemoveSelectedTracks();
 
+    // Invokes the function immediately or, if the track model selects its
+    // rows in the background, after the pending select() has finished.
+    void invokeAfterSelect(std::function<void()> function);
+
     const UserSettingsPointer m_pConfig;
     Library* const m_pLibrary;
 
@@ -131,4 +138,6 @@ class WTrackTableView : public WLibraryTableView {
     ControlProxy* m_pKeyNotation;
     ControlProxy* m_pSortColumn;
     ControlProxy* m_pSortOrder;
+
+    QMetaObject::Connection m_afterSelectConnection;
 };